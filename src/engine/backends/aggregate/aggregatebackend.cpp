@@ -0,0 +1,440 @@
+#include "aggregatebackend.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace AudioEngine {
+
+AggregateBackend::AggregateBackend(std::unique_ptr<IAudioBackend> outputMaster,
+                                   std::unique_ptr<IAudioBackend> inputFollower)
+    : m_master(std::move(outputMaster))
+    , m_follower(std::move(inputFollower))
+{
+    if (!m_master || !m_follower) {
+        throw AudioException(AudioErrorCode::AudioBackendInitFailed,
+                             "Aggregate backend needs an input and an output backend");
+    }
+}
+
+AggregateBackend::~AggregateBackend() {
+    try {
+        stop();
+    } catch (...) {
+        // Destructor shouldn't throw
+    }
+}
+
+std::unique_ptr<AggregateBackend> AggregateBackend::create(BackendType outputType,
+                                                           BackendType inputType) {
+    return std::make_unique<AggregateBackend>(AudioBackendFactory::createBackend(outputType),
+                                              AudioBackendFactory::createBackend(inputType));
+}
+
+double AggregateBackend::now() {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool AggregateBackend::isAggregated() const {
+    return m_config.inputChannels > 0 && m_config.outputChannels > 0;
+}
+
+void AggregateBackend::initialize(const StreamConfig& config) {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+
+    if (!config.isValid()) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration,
+                             "Invalid stream configuration");
+    }
+
+    if (isRunning()) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration,
+                             "Cannot reinitialize a running backend");
+    }
+
+    m_config = config;
+    if (!isAggregated()) {
+        m_master->initialize(config);
+        m_initialized = true;
+        return;
+    }
+
+    // Master plays, follower captures
+    StreamConfig outputConfig = config;
+    outputConfig.inputChannels = 0;
+    outputConfig.inputDeviceName.reset();
+
+    StreamConfig inputConfig = config;
+    inputConfig.outputChannels = 0;
+    inputConfig.outputDeviceName.reset();
+
+    m_master->initialize(outputConfig);
+    m_follower->initialize(inputConfig);
+    m_initialized = true;
+    clearError();
+}
+
+void AggregateBackend::start(AudioCallback callback) {
+    if (!callback) {
+        throw AudioException(AudioErrorCode::AudioBackendStartFailed,
+                             "Invalid callback function");
+    }
+
+    if (!m_initialized || !isAggregated()) {
+        m_master->start(std::move(callback));
+        return;
+    }
+
+    // Inputs are already contiguous planar; outputs need a contiguous block
+    const int outputChannels = std::min(m_config.outputChannels, kMaxPlanarChannels);
+    m_contiguousOutput.assign(static_cast<size_t>(outputChannels) * DriftCompensator::kMaxBlockFrames, 0.0f);
+
+    startStreams([this, callback, outputChannels](const float* const* inputs, float* const* outputs,
+                                                  size_t frames, double streamTime) {
+        float* block = m_contiguousOutput.data();
+        callback(inputs[0], block, frames, streamTime);
+        for (int ch = 0; ch < outputChannels; ++ch) {
+            std::memcpy(outputs[ch], block + ch * frames, frames * sizeof(float));
+        }
+    });
+}
+
+void AggregateBackend::startPlanar(PlanarAudioCallback callback) {
+    if (!callback) {
+        throw AudioException(AudioErrorCode::AudioBackendStartFailed,
+                             "Invalid callback function");
+    }
+
+    if (!m_initialized || !isAggregated()) {
+        m_master->startPlanar(std::move(callback));
+        return;
+    }
+
+    startStreams(std::move(callback));
+}
+
+void AggregateBackend::startStreams(PlanarAudioCallback callback) {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+
+    if (isRunning()) {
+        throw AudioException(AudioErrorCode::AudioBackendStartFailed,
+                             "Backend is already running");
+    }
+
+    m_userCallback = std::move(callback);
+    m_bridgeReady = false;
+    m_inputPlanes.assign(static_cast<size_t>(std::min(m_config.inputChannels, kMaxPlanarChannels)) *
+                             DriftCompensator::kMaxBlockFrames, 0.0f);
+
+    // Follower first, so captured audio is waiting once the master runs
+    m_follower->startPlanar([this](const float* const* inputs, float* const*, size_t frames, double) {
+        captureCallback(inputs, frames);
+    });
+
+    try {
+        m_master->startPlanar([this](const float* const*, float* const* outputs, size_t frames,
+                                     double streamTime) {
+            renderCallback(outputs, frames, streamTime);
+        });
+    } catch (const AudioException&) {
+        m_follower->stop();
+        throw;
+    }
+
+    // Rates and periods are only final once both streams are open
+    configureCompensator();
+    resumeBridge();
+}
+
+void AggregateBackend::configureCompensator() {
+    m_compensator.configure(std::min(m_config.inputChannels, kMaxPlanarChannels),
+                            m_follower->getActualSampleRate(), m_master->getActualSampleRate(),
+                            m_follower->getActualBufferSize(), m_master->getActualBufferSize());
+}
+
+void AggregateBackend::suspendBridge() {
+    // Wait out any callback already past the gate
+    m_bridgeReady.store(false);
+    while (m_bridgeUsers.load() > 0) {
+        std::this_thread::yield();
+    }
+}
+
+void AggregateBackend::resumeBridge() {
+    m_bridgeReady.store(true);
+}
+
+void AggregateBackend::stop() {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+
+    suspendBridge();
+    m_master->stop();
+    m_follower->stop();
+    m_userCallback = nullptr;
+}
+
+void AggregateBackend::pause() {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+
+    m_master->pause();
+    if (isAggregated()) {
+        m_follower->pause();
+
+        // Nothing is running, so restart from an empty, re-primed ring
+        suspendBridge();
+        m_compensator.reset();
+        resumeBridge();
+    }
+}
+
+void AggregateBackend::resume() {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+
+    if (isAggregated()) {
+        m_follower->resume();
+    }
+    m_master->resume();
+}
+
+bool AggregateBackend::isRunning() const {
+    return m_master->isRunning();
+}
+
+bool AggregateBackend::isPaused() const {
+    return m_master->isPaused();
+}
+
+// ===== Audio Threads =====
+
+void AggregateBackend::captureCallback(const float* const* inputs, size_t frames) {
+    m_bridgeUsers.fetch_add(1);
+    if (m_bridgeReady.load()) {
+        m_compensator.push(inputs, frames, now());
+    }
+    m_bridgeUsers.fetch_sub(1);
+}
+
+void AggregateBackend::renderCallback(float* const* outputs, size_t frames, double streamTime) {
+    // StreamConfig caps periods at kMaxBlockFrames
+    frames = std::min(frames, DriftCompensator::kMaxBlockFrames);
+    const int inputChannels = std::min(m_config.inputChannels, kMaxPlanarChannels);
+
+    float* inputs[kMaxPlanarChannels];
+    for (int ch = 0; ch < inputChannels; ++ch) {
+        inputs[ch] = m_inputPlanes.data() + static_cast<size_t>(ch) * frames;
+    }
+
+    m_bridgeUsers.fetch_add(1);
+    if (!m_bridgeReady.load() || !m_compensator.pull(inputs, frames, now())) {
+        std::fill(m_inputPlanes.begin(), m_inputPlanes.begin() + inputChannels * frames, 0.0f);
+    }
+    m_bridgeUsers.fetch_sub(1);
+
+    m_userCallback(inputs, outputs, frames, streamTime);
+}
+
+// ===== Stream Information =====
+
+StreamConfig AggregateBackend::getCurrentConfig() const {
+    StreamConfig config = m_config;
+    config.sampleRate = m_master->getActualSampleRate();
+    config.bufferSize = m_master->getActualBufferSize();
+    return config;
+}
+
+int AggregateBackend::getActualSampleRate() const {
+    return m_master->getActualSampleRate();
+}
+
+int AggregateBackend::getActualBufferSize() const {
+    return m_master->getActualBufferSize();
+}
+
+double AggregateBackend::getAddedLatencyMs() const {
+    if (!isAggregated() || !isRunning()) {
+        return 0.0;
+    }
+    return (m_compensator.getTargetLatencyFrames() * 1000.0) /
+           std::max(1, m_follower->getActualSampleRate());
+}
+
+double AggregateBackend::getInputLatencyMs() const {
+    if (!isAggregated()) {
+        return m_master->getInputLatencyMs();
+    }
+    return m_follower->getInputLatencyMs() + getAddedLatencyMs();
+}
+
+double AggregateBackend::getOutputLatencyMs() const {
+    return m_master->getOutputLatencyMs();
+}
+
+double AggregateBackend::getStreamTime() const {
+    return m_master->getStreamTime();
+}
+
+// ===== Dynamic Configuration =====
+
+bool AggregateBackend::changeSampleRate(int newRate) {
+    if (!isAggregated()) {
+        return m_master->changeSampleRate(newRate);
+    }
+
+    // Only the master needs to move; the compensator converts between rates
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    suspendBridge();
+    bool changed = m_master->changeSampleRate(newRate);
+    configureCompensator();
+    resumeBridge();
+    return changed;
+}
+
+bool AggregateBackend::changeBufferSize(int newSize) {
+    if (!isAggregated()) {
+        return m_master->changeBufferSize(newSize);
+    }
+
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    suspendBridge();
+    bool changed = m_master->changeBufferSize(newSize);
+    m_follower->changeBufferSize(newSize);  // Optional: a smaller input period only saves latency
+    configureCompensator();
+    resumeBridge();
+    return changed;
+}
+
+bool AggregateBackend::switchInputDevice(const std::string& deviceId) {
+    if (!isAggregated()) {
+        return m_master->switchInputDevice(deviceId);
+    }
+
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    suspendBridge();
+    bool switched = m_follower->switchInputDevice(deviceId);
+    configureCompensator();
+    resumeBridge();
+    return switched;
+}
+
+bool AggregateBackend::switchOutputDevice(const std::string& deviceId) {
+    if (!isAggregated()) {
+        return m_master->switchOutputDevice(deviceId);
+    }
+
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    suspendBridge();
+    bool switched = m_master->switchOutputDevice(deviceId);
+    configureCompensator();
+    resumeBridge();
+    return switched;
+}
+
+// ===== Performance Monitoring =====
+
+LatencyInfo AggregateBackend::measureLatency() {
+    LatencyInfo info = m_master->measureLatency();
+    if (!isAggregated()) {
+        return info;
+    }
+
+    // Round trip crosses both devices and the compensator
+    LatencyInfo input = m_follower->measureLatency();
+    info.measuredMs += getInputLatencyMs();
+    info.jitterMs = std::max(info.jitterMs, input.jitterMs);
+    info.xruns = getXrunCount();
+
+    return info;
+}
+
+double AggregateBackend::getCpuUsage() const {
+    return m_master->getCpuUsage();
+}
+
+int AggregateBackend::getXrunCount() const {
+    int xruns = m_master->getXrunCount();
+    if (isAggregated()) {
+        xruns += m_follower->getXrunCount() + m_compensator.getUnderrunCount() +
+                 m_compensator.getOverrunCount();
+    }
+    return xruns;
+}
+
+RealtimeStatus AggregateBackend::getRealtimeStatus() const {
+    return m_master->getRealtimeStatus();
+}
+
+const EngineSnapshot& AggregateBackend::readSnapshot() {
+    return m_master->readSnapshot();
+}
+
+DeferredReclaimer& AggregateBackend::getReclaimer() {
+    // The user callback only ever runs on the master's thread
+    return m_master->getReclaimer();
+}
+
+// ===== Device Management =====
+
+std::vector<std::unique_ptr<IAudioDevice>> AggregateBackend::enumerateDevices() const {
+    std::vector<std::unique_ptr<IAudioDevice>> devices = m_master->enumerateDevices();
+
+    for (auto& device : m_follower->enumerateDevices()) {
+        bool duplicate = std::any_of(devices.begin(), devices.end(), [&](const auto& existing) {
+            return existing->getId() == device->getId();
+        });
+        if (!duplicate) {
+            devices.push_back(std::move(device));
+        }
+    }
+    return devices;
+}
+
+std::unique_ptr<IAudioDevice> AggregateBackend::getCurrentInputDevice() const {
+    return isAggregated() ? m_follower->getCurrentInputDevice()
+                          : m_master->getCurrentInputDevice();
+}
+
+std::unique_ptr<IAudioDevice> AggregateBackend::getCurrentOutputDevice() const {
+    return m_master->getCurrentOutputDevice();
+}
+
+BackendType AggregateBackend::getBackendType() const {
+    return m_master->getBackendType();
+}
+
+void* AggregateBackend::getPlatformHandle() const {
+    return m_master->getPlatformHandle();
+}
+
+// ===== Error Handling =====
+
+std::string AggregateBackend::getLastError() const {
+    {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        if (!m_lastError.empty()) {
+            return m_lastError;
+        }
+    }
+
+    std::string error = m_master->getLastError();
+    if (error.empty() && isAggregated()) {
+        error = m_follower->getLastError();
+    }
+    return error;
+}
+
+void AggregateBackend::clearError() {
+    {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        m_lastError.clear();
+    }
+    m_master->clearError();
+    m_follower->clearError();
+}
+
+void AggregateBackend::setError(const std::string& error) const {
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    m_lastError = error;
+}
+
+} // namespace AudioEngine
@@ -0,0 +1,139 @@
+#ifndef AGGREGATEBACKEND_H
+#define AGGREGATEBACKEND_H
+
+#include "../../common/audiobackend.h"
+#include "../../common/audioerror.h"
+#include "../../dsp/driftcompensator.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace AudioEngine {
+
+// Aggregate device: inputs from one backend, outputs on another
+// The output backend is the clock master and runs the user callback. The
+// input backend only captures: its callback pushes into a DriftCompensator,
+// which the master pulls from at its own rate. This adds a fixed, bounded
+// latency to the inputs however far the two clocks drift apart.
+// With no inputs or no outputs configured, everything runs on the master.
+class AggregateBackend : public AudioEngine::IAudioBackend
+{
+public:
+    AggregateBackend(std::unique_ptr<IAudioBackend> outputMaster,
+                     std::unique_ptr<IAudioBackend> inputFollower);
+    ~AggregateBackend() override;
+
+    // Build both sides through AudioBackendFactory
+    static std::unique_ptr<AggregateBackend> create(BackendType outputType, BackendType inputType);
+
+    // Core Audio Operations
+    void initialize(const StreamConfig& config) override;
+    void start(AudioCallback callback) override;
+    void startPlanar(PlanarAudioCallback callback) override;
+    void stop() override;
+
+    // Stream Control
+    void pause() override;
+    void resume() override;
+
+    // Check state
+    bool isRunning() const override;
+    bool isPaused() const override;
+
+    // Stream Information
+    StreamConfig getCurrentConfig() const override;
+    int getActualSampleRate() const override;
+    int getActualBufferSize() const override;
+    double getInputLatencyMs() const override;   // Includes the compensator's buffer
+    double getOutputLatencyMs() const override;
+    double getStreamTime() const override;
+
+    // Dynamic Configuration
+    bool changeSampleRate(int newRate) override;
+    bool changeBufferSize(int newSize) override;
+    bool switchInputDevice(const std::string& deviceId) override;
+    bool switchOutputDevice(const std::string& deviceId) override;
+
+    // Performance Monitoring
+    LatencyInfo measureLatency() override;
+    double getCpuUsage() const override;
+    int getXrunCount() const override;  // Both devices plus compensator under/overruns
+    RealtimeStatus getRealtimeStatus() const override;
+    const EngineSnapshot& readSnapshot() override;
+
+    // Error Handling
+    std::string getLastError() const override;
+    void clearError() override;
+
+    // Live Editing
+    DeferredReclaimer& getReclaimer() override;
+
+    // Device Management
+    std::vector<std::unique_ptr<IAudioDevice>> enumerateDevices() const override;
+    std::unique_ptr<IAudioDevice> getCurrentInputDevice() const override;
+    std::unique_ptr<IAudioDevice> getCurrentOutputDevice() const override;
+
+    // Platform Specific
+    BackendType getBackendType() const override;  // The master's type
+    void* getPlatformHandle() const override;     // The master's handle
+
+    // ===== Aggregate Specific =====
+
+    // Measured drift of the input clock against the master, in ppm
+    double getDriftPpm() const { return m_compensator.getDriftPpm(); }
+
+    // Input frames consumed per output frame right now
+    double getResampleRatio() const { return m_compensator.getRatio(); }
+
+    // Latency the compensator adds to the inputs
+    double getAddedLatencyMs() const;
+
+    IAudioBackend& getOutputBackend() { return *m_master; }
+    IAudioBackend& getInputBackend() { return *m_follower; }
+
+private:
+    bool isAggregated() const;
+    void startStreams(PlanarAudioCallback callback);
+    void configureCompensator();
+
+    // Keep the audio threads off the compensator while it is reconfigured
+    void suspendBridge();
+    void resumeBridge();
+
+    // Audio threads
+    void captureCallback(const float* const* inputs, size_t frames);
+    void renderCallback(float* const* outputs, size_t frames, double streamTime);
+
+    // Error handling
+    void setError(const std::string& error) const;
+
+    static double now();
+
+private:
+    std::unique_ptr<IAudioBackend> m_master;
+    std::unique_ptr<IAudioBackend> m_follower;
+    StreamConfig m_config;
+    bool m_initialized = false;
+
+    DriftCompensator m_compensator;
+    std::atomic<bool> m_bridgeReady{false};
+    std::atomic<int> m_bridgeUsers{0};  // Callbacks currently past the gate
+
+    // Resampled inputs handed to the user callback, channel ch at ch * frames
+    std::vector<float> m_inputPlanes;
+
+    // Contiguous output for start()'s callback
+    std::vector<float> m_contiguousOutput;
+
+    PlanarAudioCallback m_userCallback;
+    mutable std::mutex m_controlMutex;
+
+    // Error handling
+    mutable std::mutex m_errorMutex;
+    mutable std::string m_lastError;
+};
+
+} // namespace AudioEngine
+
+#endif // AGGREGATEBACKEND_H
@@ -0,0 +1,89 @@
+#include "../common/audiobackend.h"
+#include "../common/audioerror.h"
+#include "rtaudiobackend.h"
+#include "file/filebackend.h"
+#include "aggregate/aggregatebackend.h"
+#include <algorithm>
+
+#if defined(__linux__)
+#include "jack/jackbackend.h"
+#include "linux/linuxbackend.h"
+#endif
+
+namespace AudioEngine {
+
+std::unique_ptr<IAudioBackend> AudioBackendFactory::createBackend(const StreamConfig& config) {
+    // Inputs on a second backend: the preferred one stays the clock master
+    if (config.inputBackend) {
+        BackendType output = config.preferredBackend == BackendType::Auto ? getDefaultBackend()
+                                                                           : config.preferredBackend;
+        BackendType input = *config.inputBackend == BackendType::Auto ? getDefaultBackend()
+                                                                       : *config.inputBackend;
+        if (input != output) {
+            return AggregateBackend::create(output, input);
+        }
+    }
+    return createBackend(config.preferredBackend);
+}
+
+std::unique_ptr<IAudioBackend> AudioBackendFactory::createBackend(BackendType type) {
+    if (type == BackendType::Auto) {
+        type = getDefaultBackend();
+    }
+
+    if (type == BackendType::File) {
+        return std::make_unique<FileBackend>();
+    }
+
+#if defined(__linux__)
+    // Native backends take precedence over the RtAudio wrapper for their API
+    if (type == BackendType::ALSA) {
+        return std::make_unique<LinuxBackend>();
+    }
+    if (type == BackendType::JACK) {
+        return std::make_unique<JackBackend>();
+    }
+#endif
+
+    if (!isBackendAvailable(type)) {
+        throw AudioException(AudioErrorCode::AudioBackendInitFailed,
+                             "Backend not available on this platform");
+    }
+    return std::make_unique<RtAudioBackend>(type);
+}
+
+std::vector<BackendType> AudioBackendFactory::getAvailableBackends() {
+    std::vector<BackendType> backends = {BackendType::RtAudio, BackendType::File};
+
+#if defined(__linux__)
+    backends.push_back(BackendType::ALSA);
+    backends.push_back(BackendType::JACK);
+#endif
+
+    // Everything else comes through whichever APIs RtAudio was built with
+    std::vector<RtAudio::Api> apis;
+    RtAudio::getCompiledApi(apis);
+    for (RtAudio::Api api : apis) {
+        BackendType type = RtAudioBackend::convertRtAudioApi(api);
+        if (std::find(backends.begin(), backends.end(), type) == backends.end()) {
+            backends.push_back(type);
+        }
+    }
+
+    return backends;
+}
+
+BackendType AudioBackendFactory::getDefaultBackend() {
+    // RtAudio picks the best compiled API at runtime
+    return BackendType::RtAudio;
+}
+
+bool AudioBackendFactory::isBackendAvailable(BackendType type) {
+    if (type == BackendType::Auto) {
+        return true;
+    }
+    auto backends = getAvailableBackends();
+    return std::find(backends.begin(), backends.end(), type) != backends.end();
+}
+
+} // namespace AudioEngine
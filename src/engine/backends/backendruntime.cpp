@@ -0,0 +1,153 @@
+#include "backendruntime.h"
+#include "../realtime/realtimethread.h"
+#include "../common/audioerror.h"
+#include <algorithm>
+#include <thread>
+
+namespace AudioEngine {
+
+void BackendRuntime::prepare(const StreamConfig& config) {
+    m_sampleRate = std::max(1, config.sampleRate);
+
+    m_realtimeReady = false;
+    m_streamTime = 0.0;
+    m_cpuUsage = 0.0;
+    m_xrunCount = 0;
+
+    m_periodCount = 0;
+    m_framePosition = 0;
+    m_lastXrunFrame = 0;
+    m_peakDspLoad = 0.0;
+    m_pendingXrun = false;
+
+    // One meter reading per UI frame (~60 Hz)
+    m_outputMeters.configure(config.outputChannels,
+                             static_cast<size_t>(std::max(1, config.sampleRate / 60)));
+
+    // Integrated loudness covers one stream: a new stream starts a new measurement
+    m_loudness.reset();
+    if (config.loudnessMetering && config.outputChannels > 0) {
+        m_loudness = std::make_unique<LoudnessMeter>(config.sampleRate, config.outputChannels);
+    }
+
+    // Lock pages before the audio thread starts touching them
+    if (config.lockMemory && !m_memoryLocked) {
+        m_memoryLocked = RealtimeThread::lockProcessMemory();
+    }
+
+    m_reclaimer.startHousekeeping();
+}
+
+void BackendRuntime::shutdown() {
+    // Audio thread is gone, so everything retired can go too
+    m_reclaimer.stopHousekeeping();
+    m_reclaimer.collect();
+}
+
+std::string BackendRuntime::verifyRealtimeSetup(const StreamConfig& config) {
+    // Give the audio thread a few periods to run its setup
+    double periodMs = (config.bufferSize * 1000.0) / std::max(1, config.sampleRate);
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(100 + static_cast<int>(periodMs * 4));
+    while (!m_realtimeReady.load(std::memory_order_acquire) &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    RealtimeStatus status = getRealtimeStatus();
+    if (config.realtimePriority <= 0 || status.isRealtime) {
+        return std::string();
+    }
+
+    std::string message = RealtimeThread::describe(status, config.realtimePriority);
+    if (config.requireRealtimePriority) {
+        throw AudioException(AudioErrorCode::RealTimePriorityFailed, message);
+    }
+    return message;
+}
+
+RealtimeStatus BackendRuntime::getRealtimeStatus() const {
+    RealtimeStatus status;
+    if (m_realtimeReady.load(std::memory_order_acquire)) {
+        status = m_realtimeStatus;
+    }
+    status.memoryLocked = m_memoryLocked;
+    return status;
+}
+
+BackendRuntime::Period::Period(BackendRuntime& runtime, const StreamConfig& config, size_t frames)
+    : m_runtime(runtime)
+    , m_reclaimScope(runtime.m_reclaimer)
+    , m_frames(frames)
+{
+    // First period on a new stream thread: apply and verify real-time setup
+    if (!m_runtime.m_realtimeReady.load(std::memory_order_acquire)) {
+        m_runtime.m_realtimeStatus = RealtimeThread::setupAudioThread(config);
+        m_runtime.m_realtimeReady.store(true, std::memory_order_release);
+    }
+
+    m_runtime.m_streamTime.store(
+        m_runtime.m_streamTime.load(std::memory_order_relaxed) +
+            frames / static_cast<double>(m_runtime.m_sampleRate),
+        std::memory_order_relaxed);
+
+    m_start = std::chrono::steady_clock::now();
+}
+
+void BackendRuntime::noteXrun() {
+    m_xrunCount.fetch_add(1, std::memory_order_relaxed);
+    m_pendingXrun.store(true, std::memory_order_relaxed);
+}
+
+void BackendRuntime::Period::addXrun() {
+    m_runtime.noteXrun();
+}
+
+void BackendRuntime::Period::finish(const float* const* outputs, int outputChannels) {
+    MeterBank& meters = m_runtime.m_outputMeters;
+    if (outputs) {
+        const int count = std::min(outputChannels, meters.meterCount());
+        for (int ch = 0; ch < count; ++ch) {
+            meters.process(ch, outputs[ch], m_frames);
+        }
+    }
+    meters.endPeriod(m_frames);
+
+    LoudnessMeter* loudness = m_runtime.m_loudness.get();
+    if (loudness && outputs && outputChannels >= loudness->channels()) {
+        loudness->process(outputs, m_frames);
+    }
+
+    // DSP load: time spent in this period relative to its length
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - m_start).count();
+    double expectedTime = m_frames / static_cast<double>(m_runtime.m_sampleRate);
+    double dspLoad = std::min(100.0, (elapsed / expectedTime) * 100.0);
+    m_runtime.m_cpuUsage.store(dspLoad, std::memory_order_relaxed);
+
+    m_runtime.publish(m_frames, dspLoad);
+}
+
+void BackendRuntime::publish(size_t frames, double dspLoad) {
+    m_framePosition += frames;
+    m_peakDspLoad = std::max(m_peakDspLoad, dspLoad);
+    if (m_pendingXrun.exchange(false, std::memory_order_relaxed)) {
+        m_lastXrunFrame = m_framePosition;
+    }
+
+    EngineSnapshot& snapshot = m_snapshot.writeBuffer();
+    snapshot.sequence = ++m_periodCount;
+    snapshot.framePosition = m_framePosition;
+    snapshot.streamTime = m_streamTime.load(std::memory_order_relaxed);
+    snapshot.sampleRate = m_sampleRate;
+    snapshot.bufferSize = static_cast<int>(frames);
+    snapshot.dspLoad = dspLoad;
+    snapshot.peakDspLoad = m_peakDspLoad;
+    snapshot.xruns = m_xrunCount.load(std::memory_order_relaxed);
+    snapshot.lastXrunFrame = m_lastXrunFrame;
+    m_outputMeters.writeTo(snapshot);
+    snapshot.loudness = m_loudness ? m_loudness->reading() : LoudnessReading{};
+    m_snapshot.publish();
+}
+
+} // namespace AudioEngine
@@ -0,0 +1,112 @@
+#ifndef BACKENDRUNTIME_H
+#define BACKENDRUNTIME_H
+
+#include "../common/audioconfig.h"
+#include "../common/enginesnapshot.h"
+#include "../dsp/loudnessmeter.h"
+#include "../dsp/meterbank.h"
+#include "../realtime/deferredreclaimer.h"
+#include "../realtime/denormalguard.h"
+#include "../realtime/triplebuffer.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace AudioEngine {
+
+// Per-stream bookkeeping shared by all backends
+// Owns everything a backend does around the user callback each period: the
+// real-time thread setup, denormal and reclamation scopes, DSP load, output
+// metering and the snapshot published to the UI. Backends only move samples.
+class BackendRuntime {
+public:
+    BackendRuntime() = default;
+
+    // ===== Control Thread =====
+
+    // Reset counters and size meters for a new stream (audio thread not running)
+    void prepare(const StreamConfig& config);
+
+    // Stream closed: stop housekeeping and free everything retired
+    void shutdown();
+
+    // Flag that the next period runs on a new thread (e.g. stream reopened)
+    void resetThreadSetup() { m_realtimeReady = false; }
+
+    // Wait briefly for the audio thread to report its scheduling. Never falls
+    // back to SCHED_OTHER silently: throws RealTimePriorityFailed when
+    // config.requireRealtimePriority is set, otherwise returns a description
+    // of the problem for the backend's error (empty if real-time was granted)
+    std::string verifyRealtimeSetup(const StreamConfig& config);
+
+    // ===== Audio Thread =====
+
+    // Count an xrun detected outside a period (device recovery, or a
+    // server notification arriving on another thread)
+    void noteXrun();
+
+    // Scope for one period of audio processing
+    class Period {
+    public:
+        Period(BackendRuntime& runtime, const StreamConfig& config, size_t frames);
+
+        void addXrun();
+
+        // Meter the outputs (and their loudness, when enabled), measure DSP
+        // load and publish the snapshot
+        void finish(const float* const* outputs, int outputChannels);
+
+    private:
+        BackendRuntime& m_runtime;
+        ScopedDenormalGuard m_denormalGuard;
+        DeferredReclaimer::CallbackScope m_reclaimScope;
+        size_t m_frames;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    // ===== Any Thread =====
+
+    double getStreamTime() const { return m_streamTime.load(std::memory_order_relaxed); }
+    double getCpuUsage() const { return m_cpuUsage.load(std::memory_order_relaxed); }
+    int getXrunCount() const { return m_xrunCount.load(std::memory_order_relaxed); }
+    RealtimeStatus getRealtimeStatus() const;
+    DeferredReclaimer& getReclaimer() { return m_reclaimer; }
+
+    // UI thread only
+    const EngineSnapshot& readSnapshot() { return m_snapshot.read(); }
+
+private:
+    BackendRuntime(const BackendRuntime&) = delete;
+    BackendRuntime& operator=(const BackendRuntime&) = delete;
+
+    void publish(size_t frames, double dspLoad);
+
+    int m_sampleRate = 48000;
+
+    // Real-time setup (written once per stream thread)
+    RealtimeStatus m_realtimeStatus;
+    std::atomic<bool> m_realtimeReady{false};
+    bool m_memoryLocked = false;
+
+    // Scalar readouts
+    std::atomic<double> m_streamTime{0.0};
+    std::atomic<double> m_cpuUsage{0.0};
+    std::atomic<int> m_xrunCount{0};
+
+    // Audio thread state
+    uint64_t m_periodCount = 0;
+    uint64_t m_framePosition = 0;
+    uint64_t m_lastXrunFrame = 0;
+    double m_peakDspLoad = 0.0;
+    std::atomic<bool> m_pendingXrun{false};
+    MeterBank m_outputMeters;
+    std::unique_ptr<LoudnessMeter> m_loudness;     // Null unless StreamConfig::loudnessMetering
+
+    TripleBuffer<EngineSnapshot> m_snapshot;
+    DeferredReclaimer m_reclaimer;
+};
+
+} // namespace AudioEngine
+
+#endif // BACKENDRUNTIME_H
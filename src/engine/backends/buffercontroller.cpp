@@ -0,0 +1,237 @@
+#include "buffercontroller.h"
+#include <algorithm>
+#include <chrono>
+
+namespace AudioEngine {
+
+namespace {
+
+// StreamConfig::isValid() limits
+constexpr int kMinBufferSize = 16;
+constexpr int kMaxBufferSize = 8192;
+
+}
+
+DeviceCapabilities BufferController::findCapabilities(const IAudioBackend& backend, const StreamConfig& config) {
+    std::vector<std::unique_ptr<IAudioDevice>> devices;
+    try {
+        devices = backend.enumerateDevices();
+    } catch (const std::exception&) {
+        return DeviceCapabilities{};
+    }
+
+    auto matches = [](const IAudioDevice& device, const std::optional<std::string>& name) {
+        return name && (device.getId() == *name || device.getName() == *name);
+    };
+
+    for (const auto& device : devices) {
+        if (config.outputChannels > 0 && matches(*device, config.outputDeviceName)) {
+            return device->getCapabilities();
+        }
+    }
+    for (const auto& device : devices) {
+        if (config.inputChannels > 0 && matches(*device, config.inputDeviceName)) {
+            return device->getCapabilities();
+        }
+    }
+    for (const auto& device : devices) {
+        if ((config.outputChannels > 0 && device->isDefaultOutput()) ||
+            (config.outputChannels == 0 && device->isDefaultInput())) {
+            return device->getCapabilities();
+        }
+    }
+    return DeviceCapabilities{};
+}
+
+std::vector<int> BufferController::candidateSizes(const DeviceCapabilities& caps) {
+    std::vector<int> sizes;
+    for (int size : caps.supportedBufferSizes) {
+        if (size >= kMinBufferSize && size <= kMaxBufferSize) {
+            sizes.push_back(size);
+        }
+    }
+
+    // Nothing probed: powers of two across the valid range
+    if (sizes.empty()) {
+        for (int size = kMinBufferSize; size <= kMaxBufferSize; size *= 2) {
+            sizes.push_back(size);
+        }
+    }
+
+    std::sort(sizes.begin(), sizes.end());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+    return sizes;
+}
+
+StreamConfig BufferController::resolve(const StreamConfig& requested, const DeviceCapabilities& caps) {
+    StreamConfig resolved = requested;
+    const std::vector<int> sizes = candidateSizes(caps);
+
+    switch (requested.bufferStrategy) {
+    case BufferStrategy::Fixed:
+        break;
+
+    case BufferStrategy::LowLatency:
+        resolved.bufferSize = sizes.front();
+        resolved.periodCount = 2;
+        break;
+
+    case BufferStrategy::Adaptive:
+        // poll() resizes the running stream, which backends refuse unless allowed
+        resolved.bufferSize = sizes.front();
+        resolved.periodCount = std::max(2, requested.periodCount);
+        resolved.allowBufferSizeChange = true;
+        break;
+
+    case BufferStrategy::Stable: {
+        auto it = std::lower_bound(sizes.begin(), sizes.end(), 2 * requested.bufferSize);
+        resolved.bufferSize = (it != sizes.end()) ? *it : sizes.back();
+        resolved.periodCount = std::min(16, std::max(3, requested.periodCount + 1));
+        break;
+    }
+    }
+
+    return resolved;
+}
+
+void BufferController::initialize(IAudioBackend& backend, const StreamConfig& requested) {
+    const DeviceCapabilities caps = findCapabilities(backend, requested);
+    const StreamConfig resolved = resolve(requested, caps);
+
+    backend.initialize(resolved);
+    configure(requested.bufferStrategy, candidateSizes(caps), resolved.bufferSize, now());
+}
+
+void BufferController::configure(BufferStrategy strategy, std::vector<int> candidates,
+                                 int currentSize, double now) {
+    m_strategy = strategy;
+    m_candidates = std::move(candidates);
+    std::sort(m_candidates.begin(), m_candidates.end());
+    m_stableRequired = m_thresholds.stableSecondsToStepDown;
+    m_lastStepDownTime = -1.0;
+    m_currentSize = 0;
+    setCurrentSize(currentSize, now);
+}
+
+void BufferController::setCurrentSize(int size, double now) {
+    // A step up soon after a step down means the smaller period failed
+    if (m_currentSize > 0 && size > m_currentSize && m_lastStepDownTime >= 0.0 &&
+        now - m_lastStepDownTime < m_stableRequired) {
+        m_stableRequired = std::min(2.0 * m_stableRequired, m_thresholds.maxStableSeconds);
+        m_lastStepDownTime = -1.0;
+    }
+    if (m_currentSize > 0 && size < m_currentSize) {
+        m_lastStepDownTime = now;
+    }
+
+    m_currentSize = size;
+    auto it = std::lower_bound(m_candidates.begin(), m_candidates.end(), size);
+    m_index = static_cast<size_t>(it - m_candidates.begin());
+    if (m_index >= m_candidates.size() && !m_candidates.empty()) {
+        m_index = m_candidates.size() - 1;
+    }
+
+    // Statistics from the old period no longer apply
+    m_xrunTimes.clear();
+    m_haveLoad = false;
+    m_loadAverage = 0.0;
+    m_lastSequence = 0;
+    m_settleUntil = now + m_thresholds.settleSeconds;
+    m_stableSince = now;
+}
+
+int BufferController::evaluate(const EngineSnapshot& snapshot, double now) {
+    if (m_strategy != BufferStrategy::Adaptive || m_candidates.empty()) {
+        return m_currentSize;
+    }
+
+    // Nothing new published (or nothing yet)
+    if (snapshot.sequence == 0 || snapshot.sequence == m_lastSequence) {
+        return m_currentSize;
+    }
+
+    // A restarted stream counts from zero again
+    const bool restarted = snapshot.sequence < m_lastSequence || snapshot.xruns < m_lastXruns;
+    const int newXruns = (m_lastSequence == 0 || restarted) ? 0 : snapshot.xruns - m_lastXruns;
+    m_lastSequence = snapshot.sequence;
+    m_lastXruns = snapshot.xruns;
+
+    // Let a new period settle: the restart itself may xrun
+    if (now < m_settleUntil) {
+        m_stableSince = now;
+        return m_currentSize;
+    }
+
+    for (int i = 0; i < newXruns; ++i) {
+        m_xrunTimes.push_back(now);
+    }
+    while (!m_xrunTimes.empty() && now - m_xrunTimes.front() > m_thresholds.xrunWindowSeconds) {
+        m_xrunTimes.pop_front();
+    }
+
+    if (!m_haveLoad) {
+        m_loadAverage = snapshot.dspLoad;
+        m_haveLoad = true;
+    } else {
+        const double dt = std::max(0.0, now - m_lastSampleTime);
+        const double alpha = dt / (m_thresholds.loadTimeConstant + dt);
+        m_loadAverage += alpha * (snapshot.dspLoad - m_loadAverage);
+    }
+    m_lastSampleTime = now;
+
+    // A step down that has held this long has proven itself
+    if (m_lastStepDownTime >= 0.0 && now - m_lastStepDownTime >= m_stableRequired) {
+        m_lastStepDownTime = -1.0;
+        m_stableRequired = m_thresholds.stableSecondsToStepDown;
+    }
+
+    const int recentXruns = static_cast<int>(m_xrunTimes.size());
+    if (recentXruns >= m_thresholds.xrunsToStepUp || m_loadAverage > m_thresholds.loadToStepUp) {
+        m_stableSince = now;
+        return (m_index + 1 < m_candidates.size()) ? m_candidates[m_index + 1] : m_currentSize;
+    }
+
+    if (recentXruns > 0 || m_loadAverage > m_thresholds.loadToStepDown) {
+        m_stableSince = now;
+        return m_currentSize;
+    }
+
+    if (m_index > 0 && now - m_stableSince >= m_stableRequired) {
+        return m_candidates[m_index - 1];
+    }
+    return m_currentSize;
+}
+
+bool BufferController::poll(IAudioBackend& backend) {
+    return poll(backend, now());
+}
+
+bool BufferController::poll(IAudioBackend& backend, double now) {
+    if (m_strategy != BufferStrategy::Adaptive || !backend.isRunning()) {
+        return false;
+    }
+
+    const int next = evaluate(backend.readSnapshot(), now);
+    if (next == m_currentSize) {
+        return false;
+    }
+
+    if (!backend.changeBufferSize(next)) {
+        // The device won't run this size (e.g. fixed by a server): stop asking
+        m_candidates.erase(std::remove(m_candidates.begin(), m_candidates.end(), next),
+                           m_candidates.end());
+        setCurrentSize(m_currentSize, now);
+        return false;
+    }
+
+    const int previous = m_currentSize;
+    setCurrentSize(backend.getActualBufferSize(), now);
+    return m_currentSize != previous;
+}
+
+double BufferController::now() {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace AudioEngine
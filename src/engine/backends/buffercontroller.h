@@ -0,0 +1,101 @@
+#ifndef BUFFERCONTROLLER_H
+#define BUFFERCONTROLLER_H
+
+#include "../common/audiobackend.h"
+#include "../common/audioconfig.h"
+#include "../common/enginesnapshot.h"
+#include <deque>
+#include <vector>
+
+namespace AudioEngine {
+
+// Applies StreamConfig::bufferStrategy
+// Fixed runs the requested period. LowLatency runs the smallest period the
+// device probed with the minimum period count. Stable runs at least twice the
+// requested period with an extra period of headroom. Adaptive starts at the
+// smallest period, steps up when xruns or DSP load cross their thresholds and
+// steps back down after a stable stretch; a step down that fails doubles the
+// stable stretch required before the next attempt.
+// Control thread only.
+class BufferController {
+public:
+    struct Thresholds {
+        int xrunsToStepUp = 1;              // Xruns within xrunWindowSeconds
+        double xrunWindowSeconds = 10.0;
+        double loadToStepUp = 75.0;         // Smoothed DSP load, % of the period
+        double loadToStepDown = 40.0;
+        double stableSecondsToStepDown = 30.0;
+        double maxStableSeconds = 600.0;    // Backoff limit
+        double settleSeconds = 2.0;         // Ignore statistics after a change
+        double loadTimeConstant = 1.0;      // Seconds
+    };
+
+    BufferController() = default;
+
+    // ===== Strategy Resolution =====
+
+    // Capabilities of the device the config selects (output first, then input,
+    // then the defaults); empty if the backend can't enumerate
+    static DeviceCapabilities findCapabilities(const IAudioBackend& backend, const StreamConfig& config);
+
+    // Period sizes the device can run, ascending, within StreamConfig's limits
+    static std::vector<int> candidateSizes(const DeviceCapabilities& caps);
+
+    // Concrete bufferSize and periodCount for the requested strategy
+    static StreamConfig resolve(const StreamConfig& requested, const DeviceCapabilities& caps);
+
+    // Resolve against the backend's selected device and initialize it
+    void initialize(IAudioBackend& backend, const StreamConfig& requested);
+
+    // ===== Adaptation =====
+
+    // Reset for a stream running currentSize out of the given candidates
+    void configure(BufferStrategy strategy, std::vector<int> candidates,
+                   int currentSize, double now);
+
+    // Call a few times a second while the stream runs. Reads the backend's
+    // snapshot and changes its buffer size when evaluate() asks for it;
+    // returns true if the size changed
+    bool poll(IAudioBackend& backend);
+    bool poll(IAudioBackend& backend, double now);
+
+    // The period size to run next, given the latest snapshot
+    int evaluate(const EngineSnapshot& snapshot, double now);
+
+    // Record the size actually in effect after a change
+    void setCurrentSize(int size, double now);
+
+    void setThresholds(const Thresholds& thresholds) { m_thresholds = thresholds; }
+    const Thresholds& getThresholds() const { return m_thresholds; }
+
+    BufferStrategy getStrategy() const { return m_strategy; }
+    int getCurrentSize() const { return m_currentSize; }
+    double getSmoothedLoad() const { return m_loadAverage; }
+    double getStableSecondsRequired() const { return m_stableRequired; }
+
+private:
+    static double now();
+
+    BufferStrategy m_strategy = BufferStrategy::Fixed;
+    Thresholds m_thresholds;
+    std::vector<int> m_candidates;
+    size_t m_index = 0;
+    int m_currentSize = 0;
+
+    // Statistics since the last change
+    uint64_t m_lastSequence = 0;
+    int m_lastXruns = 0;
+    std::deque<double> m_xrunTimes;
+    double m_loadAverage = 0.0;
+    double m_lastSampleTime = 0.0;
+    bool m_haveLoad = false;
+
+    double m_settleUntil = 0.0;
+    double m_stableSince = 0.0;
+    double m_stableRequired = 0.0;
+    double m_lastStepDownTime = -1.0;
+};
+
+} // namespace AudioEngine
+
+#endif // BUFFERCONTROLLER_H
@@ -0,0 +1,605 @@
+#include "filebackend.h"
+#include "../../devices/filedevice.h"
+#include <algorithm>
+#include <cstring>
+
+namespace AudioEngine {
+
+FileBackend::FileBackend() {}
+
+FileBackend::~FileBackend() {
+    try {
+        stop();     // Also reaps the thread of a render that finished
+    } catch (...) {
+        // Destructor shouldn't throw
+    }
+}
+
+void FileBackend::initialize(const StreamConfig& config) {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+
+    if (!config.isValid()) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration,
+                             "Invalid stream configuration");
+    }
+
+    if (isRunning()) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration,
+                             "Cannot reinitialize a running backend");
+    }
+
+    m_config = config;
+    if (config.inputDeviceName) {
+        m_inputPaths = {pathFromDeviceId(*config.inputDeviceName)};
+    }
+    if (config.outputDeviceName) {
+        m_outputPath = pathFromDeviceId(*config.outputDeviceName);
+    }
+    m_initialized = true;
+    clearError();
+}
+
+void FileBackend::start(AudioCallback callback) {
+    if (!callback) {
+        throw AudioException(AudioErrorCode::AudioBackendStartFailed,
+                             "Invalid callback function");
+    }
+
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    m_userCallback = std::move(callback);
+    m_planarCallback = nullptr;
+    restartStream();
+}
+
+void FileBackend::startPlanar(PlanarAudioCallback callback) {
+    if (!callback) {
+        throw AudioException(AudioErrorCode::AudioBackendStartFailed,
+                             "Invalid callback function");
+    }
+
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    m_planarCallback = std::move(callback);
+    m_userCallback = nullptr;
+    restartStream();
+}
+
+void FileBackend::restartStream() {
+    if (!m_initialized) {
+        throw AudioException(AudioErrorCode::AudioBackendStartFailed,
+                             "Backend not initialized");
+    }
+    if (isRunning()) {
+        throw AudioException(AudioErrorCode::AudioBackendStartFailed,
+                             "Backend is already running");
+    }
+
+    // Reap a clock thread that ended with a finished render
+    stopThread();
+
+    try {
+        openFiles();
+    } catch (const AudioException& e) {
+        setError(e.what());
+        closeFiles();
+        throw;
+    }
+
+    m_inputBuffer.assign(static_cast<size_t>(m_config.inputChannels) * m_config.bufferSize, 0.0f);
+    m_outputBuffer.assign(static_cast<size_t>(m_config.outputChannels) * m_config.bufferSize, 0.0f);
+
+    // A free-running clock spins flat out; never let it hold SCHED_FIFO
+    m_threadConfig = m_config;
+    if (m_clock == FileClock::FreeRunning) {
+        m_threadConfig.realtimePriority = 0;
+    }
+
+    m_jitterRng.seed(m_jitter.seed);
+    m_framePosition = 0;
+    {
+        std::lock_guard<std::mutex> finishedLock(m_finishedMutex);
+        m_finished = false;
+    }
+
+    m_runtime.prepare(m_config);
+    m_isRunning = true;
+    m_isPaused = false;
+    startThread();
+
+    try {
+        const std::string realtime = m_runtime.verifyRealtimeSetup(m_threadConfig);
+        if (!realtime.empty()) {
+            setError(realtime);
+        }
+    } catch (const AudioException&) {
+        stopThread();
+        closeFiles();
+        m_isRunning = false;
+        m_runtime.shutdown();
+        throw;
+    }
+}
+
+void FileBackend::stop() {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+
+    // A finished render is no longer running but its thread is still joinable
+    if (!isRunning() && !m_clockThread.joinable()) {
+        return;
+    }
+
+    stopThread();
+    closeFiles();
+
+    m_isRunning = false;
+    m_isPaused = false;
+    m_userCallback = nullptr;
+    m_planarCallback = nullptr;
+    m_runtime.shutdown();
+}
+
+void FileBackend::pause() {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+
+    if (!isRunning() || isPaused()) {
+        return;
+    }
+
+    // Files stay open and positioned; nothing is produced while paused
+    stopThread();
+    m_isPaused = true;
+}
+
+void FileBackend::resume() {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+
+    if (!isRunning() || !isPaused()) {
+        return;
+    }
+
+    m_isPaused = false;
+    startThread();
+    try {
+        const std::string realtime = m_runtime.verifyRealtimeSetup(m_threadConfig);
+        if (!realtime.empty()) {
+            setError(realtime);
+        }
+    } catch (const AudioException&) {
+        // Stay paused rather than run without the required scheduling
+        stopThread();
+        m_isPaused = true;
+        throw;
+    }
+}
+
+bool FileBackend::isRunning() const {
+    return m_isRunning.load();
+}
+
+bool FileBackend::isPaused() const {
+    return m_isPaused.load();
+}
+
+// ===== File Specific =====
+
+void FileBackend::setInputFiles(const std::vector<std::string>& paths) {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    m_inputPaths = paths;
+}
+
+void FileBackend::setOutputFile(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    m_outputPath = path;
+}
+
+bool FileBackend::waitUntilFinished(int timeoutMs) {
+    std::unique_lock<std::mutex> lock(m_finishedMutex);
+    return m_finishedCondition.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                                        [this] { return m_finished; });
+}
+
+// ===== Stream Setup =====
+
+void FileBackend::openFiles() {
+    closeFiles();
+
+    // Every input must run at the stream rate, unless we may adopt theirs
+    for (const std::string& path : m_inputPaths) {
+        auto reader = std::make_unique<WavReader>();
+        reader->open(path);
+
+        const int rate = reader->format().sampleRate;
+        if (rate != m_config.sampleRate) {
+            if (!m_config.allowSampleRateChange || !m_readers.empty()) {
+                throw AudioException(AudioErrorCode::SampleRateUnsupported,
+                                     path + " is " + std::to_string(rate) + " Hz, stream is " +
+                                         std::to_string(m_config.sampleRate) + " Hz");
+            }
+            m_config.sampleRate = rate;
+        }
+        m_readers.push_back(std::move(reader));
+    }
+
+    if (!m_outputPath.empty() && m_config.outputChannels > 0) {
+        WavFormat format;
+        format.sampleRate = m_config.sampleRate;
+        format.channels = m_config.outputChannels;
+        format.format = m_config.format;
+        format.dither = m_config.dither;
+        m_writer.open(m_outputPath, format);
+    }
+}
+
+void FileBackend::closeFiles() {
+    m_readers.clear();
+    m_writer.close();
+}
+
+// ===== Clock Thread =====
+
+void FileBackend::startThread() {
+    // A new thread needs its own scheduling, pinning and prefaulting
+    m_runtime.resetThreadSetup();
+    m_threadRunning = true;
+    m_clockThread = std::thread(&FileBackend::clockThreadLoop, this);
+}
+
+void FileBackend::stopThread() {
+    m_threadRunning = false;
+    if (m_clockThread.joinable()) {
+        m_clockThread.join();
+    }
+}
+
+
+void FileBackend::clockThreadLoop() {
+    using Clock = std::chrono::steady_clock;
+
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(m_config.bufferSize / static_cast<double>(m_config.sampleRate)));
+    // The simulated ring holds periodCount periods: the one being played plus
+    // periodCount - 1 queued, which is how late a wake-up can be
+    const auto slack = period * std::max(1, m_config.periodCount - 1);
+    std::normal_distribution<double> delay(m_jitter.meanMs, std::max(m_jitter.deviationMs, 1e-9));
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+    // Deadlines restart from here after every resume
+    const Clock::time_point origin = Clock::now();
+    uint64_t periodIndex = 0;
+
+    while (m_threadRunning) {
+        size_t frames = static_cast<size_t>(m_config.bufferSize);
+        if (m_renderLength > 0) {
+            const uint64_t position = m_framePosition.load();
+            if (position >= m_renderLength) {
+                // Done: finalise the output file, then the stream has stopped
+                m_writer.close();
+                m_isPaused = false;
+                m_isRunning = false;
+                std::lock_guard<std::mutex> lock(m_finishedMutex);
+                m_finished = true;
+                m_finishedCondition.notify_all();
+                break;
+            }
+            frames = static_cast<size_t>(std::min<uint64_t>(frames, m_renderLength - position));
+        }
+
+        if (m_clock == FileClock::RealTime) {
+            // Wake after the deadline by the simulated scheduling delay
+            double lateMs = std::max(0.0, delay(m_jitterRng));
+            if (chance(m_jitterRng) < m_jitter.spikeProbability) {
+                lateMs += m_jitter.spikeMs;
+            }
+
+            const Clock::time_point deadline = origin + period * static_cast<int64_t>(periodIndex + 1);
+            std::this_thread::sleep_until(deadline + std::chrono::duration_cast<Clock::duration>(
+                                                         std::chrono::duration<double, std::milli>(lateMs)));
+
+            // Hardware would have run dry if we woke later than the ring covers
+            if (Clock::now() - deadline > slack) {
+                m_runtime.noteXrun();
+            }
+        }
+
+        processPeriod(frames);
+        ++periodIndex;
+    }
+}
+
+void FileBackend::readInputs(float* const* channels, size_t frames) {
+    // channels holds one pointer per planar channel, as processPeriod builds it
+    const int inputCount = std::min(m_config.inputChannels, kMaxPlanarChannels);
+    int channel = 0;
+
+    for (auto& reader : m_readers) {
+        const int count = std::min(reader->format().channels, inputCount - channel);
+        if (count <= 0) {
+            break;
+        }
+
+        size_t got = reader->read(channels + channel, count, frames);
+        while (got < frames && m_loopInput && reader->frameCount() > 0) {
+            float* rest[kMaxPlanarChannels];
+            for (int ch = 0; ch < count; ++ch) {
+                rest[ch] = channels[channel + ch] + got;
+            }
+            reader->seek(0);
+            got += reader->read(rest, count, frames - got);
+        }
+        channel += count;
+    }
+
+    // Channels no file covers are silent
+    for (; channel < inputCount; ++channel) {
+        std::fill(channels[channel], channels[channel] + frames, 0.0f);
+    }
+}
+
+void FileBackend::processPeriod(size_t frames) {
+    const int inputCount = std::min(m_config.inputChannels, kMaxPlanarChannels);
+    const int outputCount = std::min(m_config.outputChannels, kMaxPlanarChannels);
+    float* inputs[kMaxPlanarChannels];
+    float* outputs[kMaxPlanarChannels];
+
+    // Contiguous planar layout for this period's length
+    for (int ch = 0; ch < inputCount; ++ch) {
+        inputs[ch] = m_inputBuffer.data() + static_cast<size_t>(ch) * frames;
+    }
+    for (int ch = 0; ch < outputCount; ++ch) {
+        outputs[ch] = m_outputBuffer.data() + static_cast<size_t>(ch) * frames;
+    }
+
+    // File I/O stands in for the device's DMA, so it stays outside the period
+    readInputs(inputs, frames);
+
+    {
+        BackendRuntime::Period period(m_runtime, m_threadConfig, frames);
+
+        try {
+            if (m_planarCallback) {
+                m_planarCallback(inputs, outputs, frames, m_runtime.getStreamTime());
+            } else if (m_userCallback) {
+                m_userCallback(inputCount ? m_inputBuffer.data() : nullptr,
+                               outputCount ? m_outputBuffer.data() : nullptr,
+                               frames, m_runtime.getStreamTime());
+            }
+        } catch (const std::exception& e) {
+            setError(std::string("Audio callback error: ") + e.what());
+            std::fill(m_outputBuffer.begin(), m_outputBuffer.end(), 0.0f);
+        } catch (...) {
+            setError("Unknown error in audio callback");
+            std::fill(m_outputBuffer.begin(), m_outputBuffer.end(), 0.0f);
+        }
+
+        period.finish(outputs, outputCount);
+    }
+
+    m_writer.write(outputs, frames);
+    m_framePosition += frames;
+}
+
+// ===== Stream Information =====
+
+StreamConfig FileBackend::getCurrentConfig() const {
+    return m_config;
+}
+
+int FileBackend::getActualSampleRate() const {
+    return m_config.sampleRate;
+}
+
+int FileBackend::getActualBufferSize() const {
+    return m_config.bufferSize;
+}
+
+double FileBackend::getInputLatencyMs() const {
+    if (!isRunning() || m_config.inputChannels == 0) {
+        return 0.0;
+    }
+    // Modelled on a period-based device: capture is one period old
+    return (m_config.bufferSize * 1000.0) / m_config.sampleRate;
+}
+
+double FileBackend::getOutputLatencyMs() const {
+    if (!isRunning() || m_config.outputChannels == 0) {
+        return 0.0;
+    }
+    // ...and playback sits behind the whole simulated ring
+    return (static_cast<double>(m_config.bufferSize) * m_config.periodCount * 1000.0) /
+           m_config.sampleRate;
+}
+
+double FileBackend::getStreamTime() const {
+    return m_runtime.getStreamTime();
+}
+
+// ===== Dynamic Configuration =====
+
+bool FileBackend::changeSampleRate(int newRate) {
+    // The files fix the rate
+    return newRate == m_config.sampleRate;
+}
+
+bool FileBackend::changeBufferSize(int newSize) {
+    if (!m_config.allowBufferSizeChange || newSize < 16 || newSize > 8192) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+
+    const bool restart = isRunning() && !isPaused();
+    stopThread();
+    m_config.bufferSize = newSize;
+    m_threadConfig.bufferSize = newSize;
+    m_inputBuffer.assign(static_cast<size_t>(m_config.inputChannels) * newSize, 0.0f);
+    m_outputBuffer.assign(static_cast<size_t>(m_config.outputChannels) * newSize, 0.0f);
+    if (restart) {
+        startThread();
+    }
+    return true;
+}
+
+std::string FileBackend::pathFromDeviceId(const std::string& deviceId) {
+    // Accept FileDevice ids ("<type>_<path>") as well as plain paths
+    const std::string prefix = std::to_string(static_cast<int>(BackendType::File)) + "_";
+    if (deviceId.compare(0, prefix.size(), prefix) == 0) {
+        return deviceId.substr(prefix.size());
+    }
+    return deviceId;
+}
+
+bool FileBackend::switchInputDevice(const std::string& deviceId) {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    m_inputPaths = {pathFromDeviceId(deviceId)};
+
+    if (!isRunning()) {
+        return true;
+    }
+
+    const bool restart = !isPaused();
+    stopThread();
+    try {
+        auto reader = std::make_unique<WavReader>();
+        reader->open(m_inputPaths.front());
+        if (reader->format().sampleRate != m_config.sampleRate) {
+            throw AudioException(AudioErrorCode::SampleRateUnsupported,
+                                 m_inputPaths.front() + " does not match the stream rate");
+        }
+        m_readers.clear();
+        m_readers.push_back(std::move(reader));
+    } catch (const AudioException& e) {
+        setError(std::string("Failed to switch input device: ") + e.what());
+        if (restart) startThread();
+        return false;
+    }
+    if (restart) startThread();
+    return true;
+}
+
+bool FileBackend::switchOutputDevice(const std::string& deviceId) {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    m_outputPath = pathFromDeviceId(deviceId);
+
+    if (!isRunning()) {
+        return true;
+    }
+
+    const bool restart = !isPaused();
+    stopThread();
+    try {
+        // Finalizes the previous file
+        m_writer.open(m_outputPath, m_writer.format());
+    } catch (const AudioException& e) {
+        setError(std::string("Failed to switch output device: ") + e.what());
+        if (restart) startThread();
+        return false;
+    }
+    if (restart) startThread();
+    return true;
+}
+
+// ===== Performance Monitoring =====
+
+LatencyInfo FileBackend::measureLatency() {
+    LatencyInfo info;
+
+    info.theoreticalMs = (m_config.bufferSize * 1000.0) / m_config.sampleRate;
+    info.measuredMs = getInputLatencyMs() + getOutputLatencyMs();
+    info.jitterMs = (m_clock == FileClock::RealTime) ? m_jitter.deviationMs : 0.0;
+
+    info.cpuUsage = m_runtime.getCpuUsage();
+    info.xruns = m_runtime.getXrunCount();
+
+    return info;
+}
+
+double FileBackend::getCpuUsage() const {
+    return m_runtime.getCpuUsage();
+}
+
+int FileBackend::getXrunCount() const {
+    return m_runtime.getXrunCount();
+}
+
+RealtimeStatus FileBackend::getRealtimeStatus() const {
+    return m_runtime.getRealtimeStatus();
+}
+
+const EngineSnapshot& FileBackend::readSnapshot() {
+    return m_runtime.readSnapshot();
+}
+
+DeferredReclaimer& FileBackend::getReclaimer() {
+    return m_runtime.getReclaimer();
+}
+
+// ===== Device Management =====
+
+std::vector<std::unique_ptr<IAudioDevice>> FileBackend::enumerateDevices() const {
+    std::vector<std::unique_ptr<IAudioDevice>> devices;
+
+    for (const std::string& path : m_inputPaths) {
+        try {
+            WavReader reader;
+            reader.open(path);
+            devices.push_back(std::make_unique<FileDevice>(path, reader.format(), true,
+                                                           reader.frameCount()));
+        } catch (const AudioException&) {
+            // Unreadable files are simply not listed
+        }
+    }
+
+    if (auto output = getCurrentOutputDevice()) {
+        devices.push_back(std::move(output));
+    }
+    return devices;
+}
+
+std::unique_ptr<IAudioDevice> FileBackend::getCurrentInputDevice() const {
+    if (!isRunning() || m_readers.empty()) {
+        return nullptr;
+    }
+    const WavReader& reader = *m_readers.front();
+    return std::make_unique<FileDevice>(m_inputPaths.front(), reader.format(), true,
+                                        reader.frameCount());
+}
+
+std::unique_ptr<IAudioDevice> FileBackend::getCurrentOutputDevice() const {
+    if (m_outputPath.empty()) {
+        return nullptr;
+    }
+
+    WavFormat format;
+    format.sampleRate = m_config.sampleRate;
+    format.channels = m_config.outputChannels;
+    format.format = m_config.format;
+    format.dither = m_config.dither;
+    return std::make_unique<FileDevice>(m_outputPath, format, false,
+                                        m_framePosition.load());
+}
+
+BackendType FileBackend::getBackendType() const {
+    return BackendType::File;
+}
+
+void* FileBackend::getPlatformHandle() const {
+    return nullptr;
+}
+
+// ===== Error Handling =====
+
+std::string FileBackend::getLastError() const {
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    return m_lastError;
+}
+
+void FileBackend::clearError() {
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    m_lastError.clear();
+}
+
+void FileBackend::setError(const std::string& error) const {
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    m_lastError = error;
+}
+
+} // namespace AudioEngine
@@ -0,0 +1,186 @@
+#ifndef FILEBACKEND_H
+#define FILEBACKEND_H
+
+#include "../../common/audiobackend.h"
+#include "../../common/audioerror.h"
+#include "../../io/wavfile.h"
+#include "../backendruntime.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace AudioEngine {
+
+// How the virtual device paces its periods
+enum class FileClock {
+    RealTime,    // One period per period-length of wall time, like hardware
+    FreeRunning  // Periods back to back, as fast as the callback allows
+};
+
+// Simulated wake-up lateness for the real-time clock.
+// The same seed always produces the same sequence of delays.
+struct JitterProfile {
+    double meanMs = 0.0;            // Average delay after each period deadline
+    double deviationMs = 0.0;       // Standard deviation of that delay
+    double spikeProbability = 0.0;  // Chance per period of an extra spike
+    double spikeMs = 0.0;           // Length of a spike
+    uint32_t seed = 1;
+};
+
+// WAV-file virtual device
+// Reads capture channels from WAV files and writes playback channels to a WAV
+// file on its own clock thread. Sample data does not depend on the clock, so
+// the output is bit-identical from run to run. Use it for tests on machines
+// without a sound card and to replay recorded inputs through the engine.
+// Files default to StreamConfig::inputDeviceName / outputDeviceName.
+class FileBackend : public AudioEngine::IAudioBackend
+{
+public:
+    FileBackend();
+    ~FileBackend() override;
+
+    // Core Audio Operations
+    void initialize(const StreamConfig& config) override;
+    void start(AudioCallback callback) override;
+    void startPlanar(PlanarAudioCallback callback) override;
+    void stop() override;
+
+    // Stream Control
+    void pause() override;
+    void resume() override;
+
+    // Check state
+    bool isRunning() const override;
+    bool isPaused() const override;
+
+    // Stream Information
+    StreamConfig getCurrentConfig() const override;
+    int getActualSampleRate() const override;
+    int getActualBufferSize() const override;
+    double getInputLatencyMs() const override;
+    double getOutputLatencyMs() const override;
+    double getStreamTime() const override;
+
+    // Dynamic Configuration
+    bool changeSampleRate(int newRate) override;
+    bool changeBufferSize(int newSize) override;
+    bool switchInputDevice(const std::string& deviceId) override;
+    bool switchOutputDevice(const std::string& deviceId) override;
+
+    // Performance Monitoring
+    LatencyInfo measureLatency() override;
+    double getCpuUsage() const override;
+    int getXrunCount() const override;
+    RealtimeStatus getRealtimeStatus() const override;
+    const EngineSnapshot& readSnapshot() override;
+
+    // Error Handling
+    std::string getLastError() const override;
+    void clearError() override;
+
+    // Live Editing
+    DeferredReclaimer& getReclaimer() override;
+
+    // Device Management
+    std::vector<std::unique_ptr<IAudioDevice>> enumerateDevices() const override;
+    std::unique_ptr<IAudioDevice> getCurrentInputDevice() const override;
+    std::unique_ptr<IAudioDevice> getCurrentOutputDevice() const override;
+
+    // Platform Specific
+    BackendType getBackendType() const override;
+    void* getPlatformHandle() const override;  // Always null
+
+    // ===== File Specific (set before start) =====
+
+    // Capture channels are the files' channels in order; missing ones are silent
+    void setInputFiles(const std::vector<std::string>& paths);
+    void setOutputFile(const std::string& path);
+
+    void setClock(FileClock clock) { m_clock = clock; }
+    void setJitterProfile(const JitterProfile& profile) { m_jitter = profile; }
+
+    // Restart inputs from the top when they run out (default: silence)
+    void setLoopInput(bool loop) { m_loopInput = loop; }
+
+    // Stop producing periods after this many frames (0 = until stop())
+    void setRenderLength(uint64_t frames) { m_renderLength = frames; }
+
+    // Frames delivered to the callback since start()
+    uint64_t getFramePosition() const { return m_framePosition.load(); }
+
+    // Block until the render length is reached; false on timeout
+    bool waitUntilFinished(int timeoutMs);
+
+private:
+    // Stream setup
+    void openFiles();
+    void closeFiles();
+    void restartStream();
+
+    // Clock thread
+    void startThread();
+    void stopThread();
+    void clockThreadLoop();
+    void processPeriod(size_t frames);
+    void readInputs(float* const* channels, size_t frames);
+
+    // Error handling
+    void setError(const std::string& error) const;
+
+    static std::string pathFromDeviceId(const std::string& deviceId);
+
+private:
+    StreamConfig m_config;
+    StreamConfig m_threadConfig;  // What the clock thread applies to itself
+    bool m_initialized = false;
+
+    // Files
+    std::vector<std::string> m_inputPaths;
+    std::string m_outputPath;
+    std::vector<std::unique_ptr<WavReader>> m_readers;
+    WavWriter m_writer;
+
+    // Planar scratch, channel ch at ch * frames of the current period
+    std::vector<float> m_inputBuffer;
+    std::vector<float> m_outputBuffer;
+
+    // Clock
+    FileClock m_clock = FileClock::RealTime;
+    JitterProfile m_jitter;
+    std::mt19937 m_jitterRng;
+    bool m_loopInput = false;
+    uint64_t m_renderLength = 0;
+    std::atomic<uint64_t> m_framePosition{0};
+
+    // Callbacks (exactly one is set while running)
+    PlanarAudioCallback m_planarCallback;
+    AudioCallback m_userCallback;
+
+    // Thread and state
+    std::thread m_clockThread;
+    std::atomic<bool> m_threadRunning{false};
+    std::atomic<bool> m_isRunning{false};
+    std::atomic<bool> m_isPaused{false};
+    mutable std::mutex m_controlMutex;
+
+    // Render completion
+    std::mutex m_finishedMutex;
+    std::condition_variable m_finishedCondition;
+    bool m_finished = false;
+
+    // Timing, performance, snapshots and reclamation
+    BackendRuntime m_runtime;
+
+    // Error handling
+    mutable std::mutex m_errorMutex;
+    mutable std::string m_lastError;
+};
+
+} // namespace AudioEngine
+
+#endif // FILEBACKEND_H
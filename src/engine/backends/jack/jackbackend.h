@@ -0,0 +1,170 @@
+#ifndef JACKBACKEND_H
+#define JACKBACKEND_H
+
+#include "../../common/audiobackend.h"
+#include "../../common/audioerror.h"
+#include "../backendruntime.h"
+#include "jackportadapter.h"
+#include <jack/jack.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace AudioEngine {
+
+// Latency of one of our ports as JACK reports it, in frames
+struct JackPortLatency {
+    std::string portName;
+    bool isInput = false;
+    int minFrames = 0;
+    int maxFrames = 0;
+};
+
+// Native JACK client backend
+// Each channel is a JACK port. The planar callback receives the pointers from
+// jack_port_get_buffer() directly, so nothing is copied at any port count.
+// The contiguous start() callback still works but goes through scratch buffers.
+// The server owns rate, period and scheduling; we follow its notifications.
+// A rate change re-prepares the runtime on the notification thread while the
+// process callback outputs silence, so meters and DSP load use the new rate.
+class JackBackend : public AudioEngine::IAudioBackend
+{
+public:
+    JackBackend();
+    ~JackBackend() override;
+
+    // Core Audio Operations
+    void initialize(const StreamConfig& config) override;
+    void start(AudioCallback callback) override;
+    void startPlanar(PlanarAudioCallback callback) override;
+    void stop() override;
+
+    // Stream Control
+    void pause() override;
+    void resume() override;
+
+    // Check state
+    bool isRunning() const override;
+    bool isPaused() const override;
+
+    // Stream Information
+    StreamConfig getCurrentConfig() const override;
+    int getActualSampleRate() const override;
+    int getActualBufferSize() const override;
+    double getInputLatencyMs() const override;
+    double getOutputLatencyMs() const override;
+    double getStreamTime() const override;
+
+    // Dynamic Configuration
+    bool changeSampleRate(int newRate) override;
+    bool changeBufferSize(int newSize) override;
+    bool switchInputDevice(const std::string& deviceId) override;
+    bool switchOutputDevice(const std::string& deviceId) override;
+
+    // Performance Monitoring
+    LatencyInfo measureLatency() override;
+    double getCpuUsage() const override;
+    int getXrunCount() const override;
+    RealtimeStatus getRealtimeStatus() const override;
+    const EngineSnapshot& readSnapshot() override;
+
+    // Error Handling
+    std::string getLastError() const override;
+    void clearError() override;
+
+    // Live Editing
+    DeferredReclaimer& getReclaimer() override;
+
+    // Device Management
+    std::vector<std::unique_ptr<IAudioDevice>> enumerateDevices() const override;
+    std::unique_ptr<IAudioDevice> getCurrentInputDevice() const override;
+    std::unique_ptr<IAudioDevice> getCurrentOutputDevice() const override;
+
+    // Platform Specific
+    BackendType getBackendType() const override;
+    void* getPlatformHandle() const override;  // jack_client_t*
+
+    // ===== JACK Specific =====
+
+    // Freewheel: the server drops real-time pacing and runs our process
+    // callback back to back, for offline renders. Affects the whole server.
+    bool setFreewheel(bool enabled);
+    bool isFreewheeling() const { return m_freewheeling.load(); }
+
+    // Latency our processing adds between inputs and outputs, in frames.
+    // Reported upstream/downstream through the latency callback.
+    void setProcessingLatency(int frames);
+
+    // Current latency range of every registered port
+    std::vector<JackPortLatency> getPortLatencies() const;
+
+private:
+    // JACK callbacks (static methods that route to instance)
+    static int processCallback(jack_nframes_t nframes, void* arg);
+    static int bufferSizeCallback(jack_nframes_t nframes, void* arg);
+    static int sampleRateCallback(jack_nframes_t nframes, void* arg);
+    static int xrunCallback(void* arg);
+    static void freewheelCallback(int starting, void* arg);
+    static void latencyCallback(jack_latency_callback_mode_t mode, void* arg);
+    static void shutdownCallback(void* arg);
+
+    // Instance handlers
+    int handleProcess(jack_nframes_t nframes);
+    void handleLatency(jack_latency_callback_mode_t mode);
+
+    // Client and port setup
+    void openClient();
+    void closeClient();
+    void registerPorts();
+    void connectPorts();
+    void activate();
+    void restartStream();
+
+    // Error handling
+    void setError(const std::string& error) const;
+
+    // Target client for a device id ("<type>_<client>" or a bare client name)
+    static std::string clientNameFromDeviceId(const std::string& deviceId);
+
+private:
+    StreamConfig m_config;
+    bool m_initialized = false;
+
+    jack_client_t* m_client = nullptr;
+    std::vector<jack_port_t*> m_inputPorts;
+    std::vector<jack_port_t*> m_outputPorts;
+
+    // User callback and the contiguous scratch it may need
+    JackPortAdapter m_ports;
+
+    // The process thread's copy of the config, written only while it holds
+    // m_runtimeMutex or is not running; m_config belongs to the control thread
+    StreamConfig m_processConfig;
+
+    // Server state (written from JACK's notification threads)
+    std::atomic<jack_nframes_t> m_sampleRate{0};
+    std::atomic<jack_nframes_t> m_bufferSize{0};
+    std::atomic<jack_nframes_t> m_captureLatency{0};
+    std::atomic<jack_nframes_t> m_playbackLatency{0};
+    std::atomic<int> m_processingLatency{0};
+    std::atomic<bool> m_freewheeling{false};
+
+    // Stream state
+    std::atomic<bool> m_isRunning{false};
+    std::atomic<bool> m_isPaused{false};
+    mutable std::mutex m_controlMutex;
+
+    // Timing, performance, snapshots and reclamation. The process callback
+    // only try-locks m_runtimeMutex: held elsewhere, the cycle is silence.
+    BackendRuntime m_runtime;
+    std::mutex m_runtimeMutex;
+
+    // Error handling
+    mutable std::mutex m_errorMutex;
+    mutable std::string m_lastError;
+};
+
+} // namespace AudioEngine
+
+#endif // JACKBACKEND_H
@@ -0,0 +1,57 @@
+#include "jackportadapter.h"
+#include <algorithm>
+#include <cstring>
+
+namespace AudioEngine {
+
+void JackPortAdapter::configure(int inputChannels, int outputChannels) {
+    m_inputChannels = std::clamp(inputChannels, 0, kMaxPlanarChannels);
+    m_outputChannels = std::clamp(outputChannels, 0, kMaxPlanarChannels);
+    m_inputScratch.assign(static_cast<size_t>(m_inputChannels) * kMaxPeriodFrames, 0.0f);
+    m_outputScratch.assign(static_cast<size_t>(m_outputChannels) * kMaxPeriodFrames, 0.0f);
+}
+
+void JackPortAdapter::setCallback(AudioCallback callback) {
+    m_callback = std::move(callback);
+    m_planarCallback = nullptr;
+}
+
+void JackPortAdapter::setPlanarCallback(PlanarAudioCallback callback) {
+    m_planarCallback = std::move(callback);
+    m_callback = nullptr;
+}
+
+void JackPortAdapter::clearCallbacks() {
+    m_planarCallback = nullptr;
+    m_callback = nullptr;
+}
+
+void JackPortAdapter::process(const float* const* inputs, float* const* outputs,
+                              size_t frames, double streamTime) {
+    if (m_planarCallback) {
+        m_planarCallback(inputs, outputs, frames, streamTime);
+        return;
+    }
+    if (!m_callback || frames > kMaxPeriodFrames) {
+        silence(outputs, frames);
+        return;
+    }
+
+    for (int ch = 0; ch < m_inputChannels; ++ch) {
+        std::memcpy(&m_inputScratch[static_cast<size_t>(ch) * frames], inputs[ch], frames * sizeof(float));
+    }
+    m_callback(m_inputChannels ? m_inputScratch.data() : nullptr,
+               m_outputChannels ? m_outputScratch.data() : nullptr,
+               frames, streamTime);
+    for (int ch = 0; ch < m_outputChannels; ++ch) {
+        std::memcpy(outputs[ch], &m_outputScratch[static_cast<size_t>(ch) * frames], frames * sizeof(float));
+    }
+}
+
+void JackPortAdapter::silence(float* const* outputs, size_t frames) const {
+    for (int ch = 0; ch < m_outputChannels; ++ch) {
+        std::memset(outputs[ch], 0, frames * sizeof(float));
+    }
+}
+
+} // namespace AudioEngine
@@ -0,0 +1,54 @@
+#ifndef JACKPORTADAPTER_H
+#define JACKPORTADAPTER_H
+
+#include "../../common/audiobackend.h"
+#include <cstddef>
+#include <vector>
+
+namespace AudioEngine {
+
+// Hands one JACK cycle's port buffers to the user callback
+// The planar callback gets the port pointers as they are. The contiguous
+// callback gets channel-major scratch (channel ch at ch * frames) that is
+// sized for the largest period JACK allows, so a server period change never
+// allocates on the process thread. Kept apart from the JACK calls so the
+// adaptation can run without a server.
+class JackPortAdapter {
+public:
+    // JACK's largest period (BUFFER_SIZE_MAX)
+    static constexpr size_t kMaxPeriodFrames = 8192;
+
+    // ===== Control Thread (process callback not running) =====
+
+    void configure(int inputChannels, int outputChannels);
+
+    // Exactly one callback is set; setting one clears the other
+    void setCallback(AudioCallback callback);
+    void setPlanarCallback(PlanarAudioCallback callback);
+    void clearCallbacks();
+
+    bool isPlanar() const { return static_cast<bool>(m_planarCallback); }
+
+    // ===== Audio Thread =====
+
+    // Run the callback for one cycle. Outputs are zeroed when no callback is
+    // set or a contiguous period exceeds kMaxPeriodFrames. Exceptions from
+    // the callback propagate; the outputs are then undefined.
+    void process(const float* const* inputs, float* const* outputs, size_t frames, double streamTime);
+
+    // Zero every output port buffer
+    void silence(float* const* outputs, size_t frames) const;
+
+private:
+    int m_inputChannels = 0;
+    int m_outputChannels = 0;
+    std::vector<float> m_inputScratch;
+    std::vector<float> m_outputScratch;
+
+    PlanarAudioCallback m_planarCallback;
+    AudioCallback m_callback;
+};
+
+} // namespace AudioEngine
+
+#endif // JACKPORTADAPTER_H
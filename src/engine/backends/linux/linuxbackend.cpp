@@ -1,7 +1,886 @@
 #include "linuxbackend.h"
+#include "../../devices/alsadevice.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <poll.h>
 
 namespace AudioEngine {
 
+namespace {
+
+// Start of a channel's samples at a ring offset
+inline char* areaPointer(const snd_pcm_channel_area_t& area, snd_pcm_uframes_t offset) {
+    return static_cast<char*>(area.addr) + area.first / 8 + offset * (area.step / 8);
+}
+
+// Area holds contiguous native floats we can hand to the callback as-is
+inline bool isDirect(const snd_pcm_channel_area_t& area, snd_pcm_format_t format) {
+    return format == SND_PCM_FORMAT_FLOAT && area.step == 32 && area.first % 8 == 0;
+}
+
+void readArea(const snd_pcm_channel_area_t& area, snd_pcm_uframes_t offset,
+              snd_pcm_uframes_t frames, snd_pcm_format_t format, float* dst) {
+    const char* src = areaPointer(area, offset);
+    const size_t stride = area.step / 8;
+
+    switch (format) {
+    case SND_PCM_FORMAT_FLOAT:
+        for (snd_pcm_uframes_t i = 0; i < frames; ++i, src += stride) {
+            std::memcpy(&dst[i], src, sizeof(float));
+        }
+        break;
+    case SND_PCM_FORMAT_S32:
+        for (snd_pcm_uframes_t i = 0; i < frames; ++i, src += stride) {
+            int32_t value;
+            std::memcpy(&value, src, sizeof(value));
+            dst[i] = value * (1.0f / 2147483648.0f);
+        }
+        break;
+    case SND_PCM_FORMAT_S24_3LE:
+        for (snd_pcm_uframes_t i = 0; i < frames; ++i, src += stride) {
+            const unsigned char* b = reinterpret_cast<const unsigned char*>(src);
+            int32_t value = (b[0] << 8) | (b[1] << 16) | (b[2] << 24);
+            dst[i] = value * (1.0f / 2147483648.0f);
+        }
+        break;
+    case SND_PCM_FORMAT_S16:
+        for (snd_pcm_uframes_t i = 0; i < frames; ++i, src += stride) {
+            int16_t value;
+            std::memcpy(&value, src, sizeof(value));
+            dst[i] = value * (1.0f / 32768.0f);
+        }
+        break;
+    default:
+        std::memset(dst, 0, frames * sizeof(float));
+        break;
+    }
+}
+
+void writeArea(const snd_pcm_channel_area_t& area, snd_pcm_uframes_t offset,
+               snd_pcm_uframes_t frames, snd_pcm_format_t format, const float* src,
+               DitherConverter& dither) {
+    char* dst = areaPointer(area, offset);
+    const size_t stride = area.step / 8;
+
+    // Scaling, dither and the store in one pass over the ring
+    switch (format) {
+    case SND_PCM_FORMAT_FLOAT:
+        dither.convert(src, 1, frames, SampleFormat::Float32, dst, stride);
+        break;
+    case SND_PCM_FORMAT_S32:
+        dither.convert(src, 1, frames, SampleFormat::Int32, dst, stride);
+        break;
+    case SND_PCM_FORMAT_S24_3LE:
+        dither.convert(src, 1, frames, SampleFormat::Int24, dst, stride);
+        break;
+    case SND_PCM_FORMAT_S16:
+        dither.convert(src, 1, frames, SampleFormat::Int16, dst, stride);
+        break;
+    default:
+        break;
+    }
+}
+
+snd_pcm_format_t toAlsaFormat(SampleFormat format) {
+    switch (format) {
+    case SampleFormat::Float32: return SND_PCM_FORMAT_FLOAT;
+    case SampleFormat::Int16:   return SND_PCM_FORMAT_S16;
+    case SampleFormat::Int24:   return SND_PCM_FORMAT_S24_3LE;
+    case SampleFormat::Int32:   return SND_PCM_FORMAT_S32;
+    default: return SND_PCM_FORMAT_FLOAT;
+    }
+}
+
+}
+
 LinuxBackend::LinuxBackend() {}
 
+LinuxBackend::~LinuxBackend() {
+    try {
+        stop();     // Also reaps a thread that stopped on a stream failure
+        closeStreams();
+    } catch (...) {
+        // Destructor shouldn't throw
+    }
+}
+
+void LinuxBackend::initialize(const StreamConfig& config) {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+
+    if (!config.isValid()) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration,
+                             "Invalid stream configuration");
+    }
+
+    if (isRunning()) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration,
+                             "Cannot reinitialize a running backend");
+    }
+
+    m_config = config;
+    m_initialized = true;
+    clearError();
+}
+
+void LinuxBackend::start(AudioCallback callback) {
+    if (!callback) {
+        throw AudioException(AudioErrorCode::AudioBackendStartFailed,
+                             "Invalid callback function");
+    }
+
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    m_userCallback = std::move(callback);
+    m_planarCallback = nullptr;
+    restartStream();
+}
+
+void LinuxBackend::startPlanar(PlanarAudioCallback callback) {
+    if (!callback) {
+        throw AudioException(AudioErrorCode::AudioBackendStartFailed,
+                             "Invalid callback function");
+    }
+
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    m_planarCallback = std::move(callback);
+    m_userCallback = nullptr;
+    restartStream();
+}
+
+void LinuxBackend::restartStream() {
+    if (!m_initialized) {
+        throw AudioException(AudioErrorCode::AudioBackendStartFailed,
+                             "Backend not initialized");
+    }
+    if (isRunning()) {
+        throw AudioException(AudioErrorCode::AudioBackendStartFailed,
+                             "Backend is already running");
+    }
+
+    try {
+        stopThread();       // Reap a thread that stopped on a stream failure
+        openStreams();
+        m_runtime.prepare(m_config);
+        checkAlsa(startStreams(), "Failed to start ALSA stream",
+                  AudioErrorCode::AudioBackendStartFailed);
+        m_isRunning = true;
+        m_isPaused = false;
+        startThread();
+        const std::string realtime = m_runtime.verifyRealtimeSetup(m_config);
+        if (!realtime.empty()) {
+            setError(realtime);
+        }
+    } catch (const AudioException&) {
+        stopThread();
+        closeStreams();
+        m_isRunning = false;
+        m_runtime.shutdown();
+        throw;
+    }
+}
+
+void LinuxBackend::stop() {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+
+    // A failed stream is no longer running but still holds its PCMs
+    if (!isRunning() && !m_audioThread.joinable()) {
+        return;
+    }
+
+    stopThread();
+    closeStreams();
+
+    m_isRunning = false;
+    m_isPaused = false;
+    m_userCallback = nullptr;
+    m_planarCallback = nullptr;
+    m_runtime.shutdown();
+}
+
+void LinuxBackend::pause() {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+
+    if (!isRunning() || isPaused()) {
+        return;
+    }
+
+    stopThread();
+    if (m_playback.pcm) snd_pcm_drop(m_playback.pcm);
+    if (m_capture.pcm && !m_linked) snd_pcm_drop(m_capture.pcm);
+    m_isPaused = true;
+}
+
+void LinuxBackend::resume() {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+
+    if (!isRunning() || !isPaused()) {
+        return;
+    }
+
+    checkAlsa(startStreams(), "Error resuming stream",
+              AudioErrorCode::AudioBackendStartFailed);
+    m_isPaused = false;
+    startThread();
+    try {
+        const std::string realtime = m_runtime.verifyRealtimeSetup(m_config);
+        if (!realtime.empty()) {
+            setError(realtime);
+        }
+    } catch (const AudioException&) {
+        // Stay paused rather than run without the required scheduling
+        stopThread();
+        if (m_playback.pcm) snd_pcm_drop(m_playback.pcm);
+        if (m_capture.pcm && !m_linked) snd_pcm_drop(m_capture.pcm);
+        m_isPaused = true;
+        throw;
+    }
+}
+
+bool LinuxBackend::isRunning() const {
+    return m_isRunning.load();
+}
+
+bool LinuxBackend::isPaused() const {
+    return m_isPaused.load();
+}
+
+// ===== Stream Setup =====
+
+void LinuxBackend::checkAlsa(int result, const std::string& context, AudioErrorCode code) {
+    if (result < 0) {
+        setError(context + ": " + snd_strerror(result));
+        throw AudioException(code, getLastError());
+    }
+}
+
+void LinuxBackend::configurePcm(PcmStream& stream, snd_pcm_stream_t direction,
+                                const std::string& pcmName, int channels) {
+    const bool isPlayback = (direction == SND_PCM_STREAM_PLAYBACK);
+    const std::string label = std::string(isPlayback ? "playback" : "capture") +
+                              " device '" + pcmName + "'";
+
+    int err = snd_pcm_open(&stream.pcm, pcmName.c_str(), direction, SND_PCM_NONBLOCK);
+    if (err < 0) {
+        stream.pcm = nullptr;
+        setError("Cannot open " + label + ": " + snd_strerror(err));
+        throw AudioException(AudioErrorCode::DeviceUnavailable, getLastError());
+    }
+    stream.channels = channels;
+
+    snd_pcm_hw_params_t* hw;
+    snd_pcm_hw_params_alloca(&hw);
+    checkAlsa(snd_pcm_hw_params_any(stream.pcm, hw), "No configurations for " + label);
+
+    // Non-interleaved lets the callback work in the ring directly
+    if (snd_pcm_hw_params_set_access(stream.pcm, hw, SND_PCM_ACCESS_MMAP_NONINTERLEAVED) == 0) {
+        stream.access = SND_PCM_ACCESS_MMAP_NONINTERLEAVED;
+    } else {
+        checkAlsa(snd_pcm_hw_params_set_access(stream.pcm, hw, SND_PCM_ACCESS_MMAP_INTERLEAVED),
+                  "No mmap access for " + label);
+        stream.access = SND_PCM_ACCESS_MMAP_INTERLEAVED;
+    }
+
+    // Requested format first, then whatever converts best
+    const snd_pcm_format_t candidates[] = {
+        toAlsaFormat(m_config.format), SND_PCM_FORMAT_FLOAT, SND_PCM_FORMAT_S32,
+        SND_PCM_FORMAT_S24_3LE, SND_PCM_FORMAT_S16
+    };
+    err = -EINVAL;
+    for (snd_pcm_format_t format : candidates) {
+        err = snd_pcm_hw_params_set_format(stream.pcm, hw, format);
+        if (err == 0) {
+            stream.format = format;
+            break;
+        }
+    }
+    checkAlsa(err, "No supported sample format for " + label);
+
+    checkAlsa(snd_pcm_hw_params_set_channels(stream.pcm, hw, channels),
+              "Channel count unsupported by " + label,
+              AudioErrorCode::InvalidConfiguration);
+
+    unsigned int rate = m_config.sampleRate;
+    checkAlsa(snd_pcm_hw_params_set_rate_near(stream.pcm, hw, &rate, nullptr),
+              "Sample rate unsupported by " + label, AudioErrorCode::SampleRateUnsupported);
+    if (rate != static_cast<unsigned int>(m_config.sampleRate) && !m_config.allowSampleRateChange) {
+        setError(label + " runs at " + std::to_string(rate) + " Hz");
+        throw AudioException(AudioErrorCode::SampleRateUnsupported, getLastError());
+    }
+    // Duplex: one period drives both directions, so they must share a clock rate
+    if (m_actualRate && rate != m_actualRate) {
+        setError("Capture and playback disagree on sample rate (" + std::to_string(m_actualRate) +
+                 " vs " + std::to_string(rate) + " Hz)");
+        throw AudioException(AudioErrorCode::SampleRateUnsupported, getLastError());
+    }
+
+    // Duplex: capture must follow the period playback negotiated
+    snd_pcm_uframes_t period = m_periodFrames ? m_periodFrames : m_config.bufferSize;
+    unsigned int periods = std::max(2, m_config.periodCount);
+    checkAlsa(snd_pcm_hw_params_set_period_size_near(stream.pcm, hw, &period, nullptr),
+              "Period size unsupported by " + label, AudioErrorCode::BufferSizeUnsupported);
+    checkAlsa(snd_pcm_hw_params_set_periods_near(stream.pcm, hw, &periods, nullptr),
+              "Period count unsupported by " + label, AudioErrorCode::BufferSizeUnsupported);
+
+    checkAlsa(snd_pcm_hw_params(stream.pcm, hw), "Cannot configure " + label);
+
+    snd_pcm_uframes_t bufferFrames = 0;
+    snd_pcm_hw_params_get_period_size(hw, &period, nullptr);
+    snd_pcm_hw_params_get_buffer_size(hw, &bufferFrames);
+
+    if (m_periodFrames && period != m_periodFrames) {
+        setError("Capture and playback disagree on period size");
+        throw AudioException(AudioErrorCode::BufferSizeUnsupported, getLastError());
+    }
+    m_periodFrames = period;
+    m_actualRate = rate;
+    if (isPlayback || !m_bufferFrames) {
+        m_bufferFrames = bufferFrames;
+    }
+
+    // Wake once per period; we start the stream explicitly after prefill
+    snd_pcm_sw_params_t* sw;
+    snd_pcm_sw_params_alloca(&sw);
+    checkAlsa(snd_pcm_sw_params_current(stream.pcm, sw), "Cannot read sw params for " + label);
+    checkAlsa(snd_pcm_sw_params_set_avail_min(stream.pcm, sw, period),
+              "Cannot set wakeup threshold for " + label);
+    checkAlsa(snd_pcm_sw_params_set_start_threshold(stream.pcm, sw, bufferFrames * 2),
+              "Cannot set start threshold for " + label);
+    checkAlsa(snd_pcm_sw_params(stream.pcm, sw), "Cannot configure " + label);
+
+    stream.scratch.assign(static_cast<size_t>(channels) * period, 0.0f);
+    stream.dither.clear();
+    for (int ch = 0; ch < channels; ++ch) {
+        stream.dither.emplace_back(m_config.dither, static_cast<uint32_t>(ch + 1));
+    }
+    stream.pollCount = snd_pcm_poll_descriptors_count(stream.pcm);
+}
+
+void LinuxBackend::openStreams() {
+    closeStreams();
+
+    const std::string outputName = m_config.outputDeviceName.value_or("default");
+    const std::string inputName = m_config.inputDeviceName.value_or("default");
+
+    if (m_config.outputChannels > 0) {
+        configurePcm(m_playback, SND_PCM_STREAM_PLAYBACK, outputName,
+                     std::min(m_config.outputChannels, kMaxPlanarChannels));
+    }
+    if (m_config.inputChannels > 0) {
+        configurePcm(m_capture, SND_PCM_STREAM_CAPTURE, inputName,
+                     std::min(m_config.inputChannels, kMaxPlanarChannels));
+    }
+
+    // Same clock domain: start, stop and prepare together
+    if (m_playback.pcm && m_capture.pcm) {
+        m_linked = snd_pcm_link(m_capture.pcm, m_playback.pcm) == 0;
+    }
+
+    m_config.bufferSize = static_cast<int>(m_periodFrames);
+    m_config.sampleRate = static_cast<int>(m_actualRate);
+
+    // Playback descriptors first, then capture
+    m_pollFds.assign(static_cast<size_t>(m_playback.pollCount + m_capture.pollCount), pollfd{});
+    if (m_playback.pcm) {
+        snd_pcm_poll_descriptors(m_playback.pcm, m_pollFds.data(), m_playback.pollCount);
+    }
+    if (m_capture.pcm) {
+        snd_pcm_poll_descriptors(m_capture.pcm, m_pollFds.data() + m_playback.pollCount,
+                                 m_capture.pollCount);
+    }
+}
+
+void LinuxBackend::closeStreams() {
+    if (m_linked && m_capture.pcm) {
+        snd_pcm_unlink(m_capture.pcm);
+    }
+    m_linked = false;
+
+    for (PcmStream* stream : {&m_playback, &m_capture}) {
+        if (stream->pcm) {
+            snd_pcm_drop(stream->pcm);
+            snd_pcm_close(stream->pcm);
+        }
+        *stream = PcmStream{};
+    }
+
+    m_pollFds.clear();
+    m_periodFrames = 0;
+    m_bufferFrames = 0;
+    m_actualRate = 0;
+}
+
+int LinuxBackend::startStreams() {
+    for (PcmStream* stream : {&m_playback, &m_capture}) {
+        if (stream->pcm && snd_pcm_state(stream->pcm) != SND_PCM_STATE_PREPARED) {
+            int err = snd_pcm_prepare(stream->pcm);
+            if (err < 0) return err;
+        }
+    }
+
+    // Prefill the whole playback ring with silence
+    if (m_playback.pcm) {
+        while (true) {
+            snd_pcm_sframes_t avail = snd_pcm_avail_update(m_playback.pcm);
+            if (avail < 0) return static_cast<int>(avail);
+            if (avail == 0) break;
+
+            const snd_pcm_channel_area_t* areas;
+            snd_pcm_uframes_t offset;
+            snd_pcm_uframes_t frames = static_cast<snd_pcm_uframes_t>(avail);
+            int err = snd_pcm_mmap_begin(m_playback.pcm, &areas, &offset, &frames);
+            if (err < 0) return err;
+            snd_pcm_areas_silence(areas, offset, m_playback.channels, frames, m_playback.format);
+            snd_pcm_sframes_t committed = snd_pcm_mmap_commit(m_playback.pcm, offset, frames);
+            if (committed < 0) return static_cast<int>(committed);
+        }
+    }
+
+    // Linked streams start together from either handle
+    if (m_playback.pcm) {
+        int err = snd_pcm_start(m_playback.pcm);
+        if (err < 0) return err;
+    }
+    if (m_capture.pcm && !m_linked) {
+        int err = snd_pcm_start(m_capture.pcm);
+        if (err < 0) return err;
+    }
+    return 0;
+}
+
+// ===== Audio Thread =====
+
+void LinuxBackend::startThread() {
+    // A new thread needs its own scheduling, pinning and prefaulting
+    m_runtime.resetThreadSetup();
+    m_threadRunning = true;
+    m_audioThread = std::thread(&LinuxBackend::audioThreadLoop, this);
+}
+
+void LinuxBackend::stopThread() {
+    m_threadRunning = false;
+    if (m_audioThread.joinable()) {
+        m_audioThread.join();
+    }
+}
+
+
+void LinuxBackend::audioThreadLoop() {
+    // Wake at least every 100 ms to notice stop requests
+    const int timeoutMs = 100;
+    bool failed = false;
+
+    while (m_threadRunning && !failed) {
+        int ready = poll(m_pollFds.data(), m_pollFds.size(), timeoutMs);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            setError(std::string("poll() failed: ") + std::strerror(errno));
+            failed = true;
+            break;
+        }
+        if (ready == 0) {
+            continue;
+        }
+
+        // Let ALSA translate the raw events; POLLERR means an xrun or suspend
+        unsigned short revents = 0;
+        if (m_playback.pcm) {
+            unsigned short playbackEvents = 0;
+            snd_pcm_poll_descriptors_revents(m_playback.pcm, m_pollFds.data(),
+                                             m_playback.pollCount, &playbackEvents);
+            revents |= playbackEvents;
+        }
+        if (m_capture.pcm) {
+            unsigned short captureEvents = 0;
+            snd_pcm_poll_descriptors_revents(m_capture.pcm,
+                                             m_pollFds.data() + m_playback.pollCount,
+                                             m_capture.pollCount, &captureEvents);
+            revents |= captureEvents;
+        }
+        if (revents & POLLERR) {
+            failed = !recoverFromXrun();
+            continue;
+        }
+
+        // Run every whole period both directions have ready
+        while (m_threadRunning) {
+            snd_pcm_sframes_t avail = static_cast<snd_pcm_sframes_t>(m_bufferFrames);
+            for (PcmStream* stream : {&m_playback, &m_capture}) {
+                if (stream->pcm) {
+                    avail = std::min(avail, snd_pcm_avail_update(stream->pcm));
+                }
+            }
+
+            if (avail < 0) {
+                failed = !recoverFromXrun();
+                break;
+            }
+            if (avail < static_cast<snd_pcm_sframes_t>(m_periodFrames)) {
+                break;
+            }
+            if (!processPeriod(m_periodFrames)) {
+                failed = true;
+                break;
+            }
+        }
+    }
+
+    if (failed) {
+        // The stream is dead: say so instead of leaving isRunning() true.
+        // stop() or the next start reaps this thread and closes the PCMs.
+        setError("Audio stream stopped: " + getLastError());
+        m_threadRunning = false;
+        m_isPaused = false;
+        m_isRunning = false;
+    }
+}
+
+bool LinuxBackend::processPeriod(snd_pcm_uframes_t frames) {
+    const float* inputs[kMaxPlanarChannels];
+    float* outputs[kMaxPlanarChannels];
+    const bool contiguous = static_cast<bool>(m_userCallback);
+
+    // Map both rings; a wrap can shorten the contiguous region
+    const snd_pcm_channel_area_t* captureAreas = nullptr;
+    const snd_pcm_channel_area_t* playbackAreas = nullptr;
+    snd_pcm_uframes_t captureOffset = 0;
+    snd_pcm_uframes_t playbackOffset = 0;
+
+    if (m_capture.pcm) {
+        int err = snd_pcm_mmap_begin(m_capture.pcm, &captureAreas, &captureOffset, &frames);
+        if (err < 0) return recoverFromXrun();
+    }
+    if (m_playback.pcm) {
+        int err = snd_pcm_mmap_begin(m_playback.pcm, &playbackAreas, &playbackOffset, &frames);
+        if (err < 0) return recoverFromXrun();
+    }
+
+    BackendRuntime::Period period(m_runtime, m_config, frames);
+
+    // Inputs: the ring itself when possible, else converted into scratch
+    for (int ch = 0; ch < m_capture.channels; ++ch) {
+        const snd_pcm_channel_area_t& area = captureAreas[ch];
+        float* scratch = m_capture.scratch.data() + static_cast<size_t>(ch) * frames;
+        if (!contiguous && isDirect(area, m_capture.format)) {
+            inputs[ch] = reinterpret_cast<const float*>(areaPointer(area, captureOffset));
+        } else {
+            readArea(area, captureOffset, frames, m_capture.format, scratch);
+            inputs[ch] = scratch;
+        }
+    }
+
+    bool playbackDirect = !contiguous;
+    for (int ch = 0; ch < m_playback.channels; ++ch) {
+        const snd_pcm_channel_area_t& area = playbackAreas[ch];
+        if (playbackDirect && isDirect(area, m_playback.format)) {
+            outputs[ch] = reinterpret_cast<float*>(areaPointer(area, playbackOffset));
+        } else {
+            playbackDirect = false;
+        }
+    }
+    if (!playbackDirect) {
+        for (int ch = 0; ch < m_playback.channels; ++ch) {
+            outputs[ch] = m_playback.scratch.data() + static_cast<size_t>(ch) * frames;
+        }
+    }
+
+    try {
+        if (m_planarCallback) {
+            m_planarCallback(inputs, outputs, frames, m_runtime.getStreamTime());
+        } else if (m_userCallback) {
+            m_userCallback(m_capture.pcm ? m_capture.scratch.data() : nullptr,
+                           m_playback.pcm ? m_playback.scratch.data() : nullptr,
+                           frames, m_runtime.getStreamTime());
+        } else {
+            for (int ch = 0; ch < m_playback.channels; ++ch) {
+                std::memset(outputs[ch], 0, frames * sizeof(float));
+            }
+        }
+    } catch (const std::exception& e) {
+        setError(std::string("Audio callback error: ") + e.what());
+        return false;
+    } catch (...) {
+        setError("Unknown error in audio callback");
+        return false;
+    }
+
+    if (!playbackDirect) {
+        for (int ch = 0; ch < m_playback.channels; ++ch) {
+            writeArea(playbackAreas[ch], playbackOffset, frames, m_playback.format, outputs[ch],
+                      m_playback.dither[static_cast<size_t>(ch)]);
+        }
+    }
+
+    period.finish(outputs, m_playback.channels);
+
+    snd_pcm_sframes_t committed = frames;
+    if (m_capture.pcm) {
+        committed = snd_pcm_mmap_commit(m_capture.pcm, captureOffset, frames);
+    }
+    if (committed >= 0 && m_playback.pcm) {
+        committed = snd_pcm_mmap_commit(m_playback.pcm, playbackOffset, frames);
+    }
+    if (committed < 0 || static_cast<snd_pcm_uframes_t>(committed) != frames) {
+        return recoverFromXrun();
+    }
+
+    return true;
+}
+
+bool LinuxBackend::recoverFromXrun() {
+    m_runtime.noteXrun();
+
+    if (m_capture.pcm) snd_pcm_drop(m_capture.pcm);
+    if (m_playback.pcm && !m_linked) snd_pcm_drop(m_playback.pcm);
+
+    int err = startStreams();
+    if (err < 0) {
+        setError(std::string("Cannot recover from xrun: ") + snd_strerror(err));
+        return false;
+    }
+    return true;
+}
+
+// ===== Stream Information =====
+
+StreamConfig LinuxBackend::getCurrentConfig() const {
+    return m_config;
+}
+
+int LinuxBackend::getActualSampleRate() const {
+    return m_actualRate ? static_cast<int>(m_actualRate) : m_config.sampleRate;
+}
+
+int LinuxBackend::getActualBufferSize() const {
+    return m_periodFrames ? static_cast<int>(m_periodFrames) : m_config.bufferSize;
+}
+
+int LinuxBackend::getPeriodCount() const {
+    return m_periodFrames ? static_cast<int>(m_bufferFrames / m_periodFrames) : m_config.periodCount;
+}
+
+bool LinuxBackend::isZeroCopy() const {
+    return m_playback.access == SND_PCM_ACCESS_MMAP_NONINTERLEAVED &&
+           m_playback.format == SND_PCM_FORMAT_FLOAT &&
+           m_capture.access == SND_PCM_ACCESS_MMAP_NONINTERLEAVED &&
+           m_capture.format == SND_PCM_FORMAT_FLOAT &&
+           !m_userCallback;
+}
+
+double LinuxBackend::getInputLatencyMs() const {
+    if (!isRunning() || !m_capture.pcm) {
+        return 0.0;
+    }
+    // Captured samples wait at most one period before the callback sees them
+    return (m_periodFrames * 1000.0) / getActualSampleRate();
+}
+
+double LinuxBackend::getOutputLatencyMs() const {
+    if (!isRunning() || !m_playback.pcm) {
+        return 0.0;
+    }
+    // Whole playback ring is queued ahead of the DAC
+    return (m_bufferFrames * 1000.0) / getActualSampleRate();
+}
+
+double LinuxBackend::getStreamTime() const {
+    return m_runtime.getStreamTime();
+}
+
+// ===== Dynamic Configuration =====
+
+bool LinuxBackend::changeSampleRate(int newRate) {
+    if (!isRunning() || !m_config.allowSampleRateChange) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    const int previousRate = m_config.sampleRate;
+    try {
+        stopThread();
+        closeStreams();
+        m_isRunning = false;
+        m_config.sampleRate = newRate;
+        restartStream();
+        return true;
+    } catch (const AudioException& e) {
+        setError(std::string("Failed to change sample rate: ") + e.what());
+        m_config.sampleRate = previousRate;
+        return false;
+    }
+}
+
+bool LinuxBackend::changeBufferSize(int newSize) {
+    if (!isRunning() || !m_config.allowBufferSizeChange) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    const int previousSize = m_config.bufferSize;
+    try {
+        stopThread();
+        closeStreams();
+        m_isRunning = false;
+        m_config.bufferSize = newSize;
+        restartStream();
+        return true;
+    } catch (const AudioException& e) {
+        setError(std::string("Failed to change buffer size: ") + e.what());
+        m_config.bufferSize = previousSize;
+        return false;
+    }
+}
+
+std::string LinuxBackend::pcmNameFromDeviceId(const std::string& deviceId) {
+    // Accept AlsaDevice ids ("<type>_<pcm>") as well as raw PCM names
+    const std::string prefix = std::to_string(static_cast<int>(BackendType::ALSA)) + "_";
+    if (deviceId.compare(0, prefix.size(), prefix) == 0) {
+        return deviceId.substr(prefix.size());
+    }
+    return deviceId;
+}
+
+bool LinuxBackend::switchInputDevice(const std::string& deviceId) {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    m_config.inputDeviceName = pcmNameFromDeviceId(deviceId);
+
+    if (!isRunning()) {
+        return true;
+    }
+
+    try {
+        stopThread();
+        closeStreams();
+        m_isRunning = false;
+        restartStream();
+        return true;
+    } catch (const AudioException& e) {
+        setError(std::string("Failed to switch input device: ") + e.what());
+        return false;
+    }
+}
+
+bool LinuxBackend::switchOutputDevice(const std::string& deviceId) {
+    std::lock_guard<std::mutex> lock(m_controlMutex);
+    m_config.outputDeviceName = pcmNameFromDeviceId(deviceId);
+
+    if (!isRunning()) {
+        return true;
+    }
+
+    try {
+        stopThread();
+        closeStreams();
+        m_isRunning = false;
+        restartStream();
+        return true;
+    } catch (const AudioException& e) {
+        setError(std::string("Failed to switch output device: ") + e.what());
+        return false;
+    }
+}
+
+// ===== Performance Monitoring =====
+
+LatencyInfo LinuxBackend::measureLatency() {
+    LatencyInfo info;
+
+    info.theoreticalMs = (getActualBufferSize() * 1000.0) / getActualSampleRate();
+
+    // Frames queued ahead of the DAC right now, plus one capture period
+    snd_pcm_sframes_t delay = 0;
+    if (m_playback.pcm && isRunning() && snd_pcm_delay(m_playback.pcm, &delay) == 0) {
+        info.measuredMs = ((delay + (m_capture.pcm ? m_periodFrames : 0)) * 1000.0) /
+                          getActualSampleRate();
+    } else {
+        info.measuredMs = info.theoreticalMs;
+    }
+    info.jitterMs = (m_periodFrames * 1000.0) / getActualSampleRate();
+
+    info.cpuUsage = m_runtime.getCpuUsage();
+    info.xruns = m_runtime.getXrunCount();
+
+    return info;
+}
+
+double LinuxBackend::getCpuUsage() const {
+    return m_runtime.getCpuUsage();
+}
+
+int LinuxBackend::getXrunCount() const {
+    return m_runtime.getXrunCount();
+}
+
+RealtimeStatus LinuxBackend::getRealtimeStatus() const {
+    return m_runtime.getRealtimeStatus();
+}
+
+const EngineSnapshot& LinuxBackend::readSnapshot() {
+    return m_runtime.readSnapshot();
+}
+
+DeferredReclaimer& LinuxBackend::getReclaimer() {
+    return m_runtime.getReclaimer();
+}
+
+// ===== Device Management =====
+
+std::vector<std::unique_ptr<IAudioDevice>> LinuxBackend::enumerateDevices() const {
+    return AlsaDevice::enumerate();
+}
+
+std::unique_ptr<IAudioDevice> LinuxBackend::getCurrentInputDevice() const {
+    if (!isRunning() || !m_capture.pcm) {
+        return nullptr;
+    }
+
+    // The device is busy with our stream, so report what we negotiated
+    const std::string name = m_config.inputDeviceName.value_or("default");
+    DeviceCapabilities caps{};
+    caps.supportedSampleRates = {m_actualRate};
+    caps.supportedBufferSizes = {static_cast<int>(m_periodFrames)};
+    caps.maxInputChannels = m_capture.channels;
+    caps.supportsInput = true;
+    return std::make_unique<AlsaDevice>(name, name, caps);
+}
+
+std::unique_ptr<IAudioDevice> LinuxBackend::getCurrentOutputDevice() const {
+    if (!isRunning() || !m_playback.pcm) {
+        return nullptr;
+    }
+
+    const std::string name = m_config.outputDeviceName.value_or("default");
+    DeviceCapabilities caps{};
+    caps.supportedSampleRates = {m_actualRate};
+    caps.supportedBufferSizes = {static_cast<int>(m_periodFrames)};
+    caps.maxOutputChannels = m_playback.channels;
+    caps.supportsOutput = true;
+    return std::make_unique<AlsaDevice>(name, name, caps);
+}
+
+BackendType LinuxBackend::getBackendType() const {
+    return BackendType::ALSA;
+}
+
+void* LinuxBackend::getPlatformHandle() const {
+    return m_playback.pcm ? m_playback.pcm : m_capture.pcm;
+}
+
+// ===== Error Handling =====
+
+std::string LinuxBackend::getLastError() const {
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    return m_lastError;
+}
+
+void LinuxBackend::clearError() {
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    m_lastError.clear();
+}
+
+void LinuxBackend::setError(const std::string& error) const {
+    std::lock_guard<std::mutex> lock(m_errorMutex);
+    m_lastError = error;
+}
+
 } // namespace AudioEngine
@@ -2,12 +2,150 @@
 #define LINUXBACKEND_H
 
 #include "../../common/audiobackend.h"
+#include "../../common/audioerror.h"
+#include "../backendruntime.h"
+#include "../../dsp/dither.h"
+#include <alsa/asoundlib.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 namespace AudioEngine {
 
+// Native ALSA backend
+// Talks to the PCM directly: the audio thread sleeps in poll() on the PCM
+// descriptors, then maps the hardware ring with snd_pcm_mmap_begin/commit.
+// When the device runs non-interleaved Float32 the planar callback reads and
+// writes the ring in place; otherwise samples go through one conversion pass.
+// Duplex streams are linked so capture and playback start in the same cycle.
 class LinuxBackend : public AudioEngine::IAudioBackend
 {
 public:
     LinuxBackend();
+    ~LinuxBackend() override;
+
+    // Core Audio Operations
+    void initialize(const StreamConfig& config) override;
+    void start(AudioCallback callback) override;
+    void startPlanar(PlanarAudioCallback callback) override;
+    void stop() override;
+
+    // Stream Control
+    void pause() override;
+    void resume() override;
+
+    // Check state
+    bool isRunning() const override;
+    bool isPaused() const override;
+
+    // Stream Information
+    StreamConfig getCurrentConfig() const override;
+    int getActualSampleRate() const override;
+    int getActualBufferSize() const override;
+    double getInputLatencyMs() const override;
+    double getOutputLatencyMs() const override;
+    double getStreamTime() const override;
+
+    // Dynamic Configuration
+    bool changeSampleRate(int newRate) override;
+    bool changeBufferSize(int newSize) override;
+    bool switchInputDevice(const std::string& deviceId) override;
+    bool switchOutputDevice(const std::string& deviceId) override;
+
+    // Performance Monitoring
+    LatencyInfo measureLatency() override;
+    double getCpuUsage() const override;
+    int getXrunCount() const override;
+    RealtimeStatus getRealtimeStatus() const override;
+    const EngineSnapshot& readSnapshot() override;
+
+    // Error Handling
+    std::string getLastError() const override;
+    void clearError() override;
+
+    // Live Editing
+    DeferredReclaimer& getReclaimer() override;
+
+    // Device Management
+    std::vector<std::unique_ptr<IAudioDevice>> enumerateDevices() const override;
+    std::unique_ptr<IAudioDevice> getCurrentInputDevice() const override;
+    std::unique_ptr<IAudioDevice> getCurrentOutputDevice() const override;
+
+    // Platform Specific
+    BackendType getBackendType() const override;
+    void* getPlatformHandle() const override;  // snd_pcm_t* (playback, else capture)
+
+    // Actual ring geometry negotiated with the driver
+    int getPeriodFrames() const { return static_cast<int>(m_periodFrames); }
+    int getPeriodCount() const;
+
+    // True when the callback reads/writes the hardware ring without a copy
+    bool isZeroCopy() const;
+
+private:
+    // One direction of the stream
+    struct PcmStream {
+        snd_pcm_t* pcm = nullptr;
+        int channels = 0;
+        snd_pcm_format_t format = SND_PCM_FORMAT_FLOAT;
+        snd_pcm_access_t access = SND_PCM_ACCESS_MMAP_NONINTERLEAVED;
+        std::vector<float> scratch;   // Planar, channel ch at ch * periodFrames
+        std::vector<DitherConverter> dither;    // Playback, per channel
+        int pollCount = 0;
+    };
+
+    // Stream setup
+    void openStreams();
+    void closeStreams();
+    void configurePcm(PcmStream& stream, snd_pcm_stream_t direction,
+                      const std::string& pcmName, int channels);
+    int startStreams();
+    void restartStream();
+    void checkAlsa(int result, const std::string& context,
+                   AudioErrorCode code = AudioErrorCode::AudioBackendInitFailed);
+
+    // Audio thread
+    void startThread();
+    void stopThread();
+    void audioThreadLoop();
+    bool processPeriod(snd_pcm_uframes_t frames);
+    bool recoverFromXrun();
+
+    // Error handling
+    void setError(const std::string& error) const;
+
+    static std::string pcmNameFromDeviceId(const std::string& deviceId);
+
+private:
+    StreamConfig m_config;
+    bool m_initialized = false;
+
+    PcmStream m_playback;
+    PcmStream m_capture;
+    bool m_linked = false;
+    snd_pcm_uframes_t m_periodFrames = 0;
+    snd_pcm_uframes_t m_bufferFrames = 0;
+    unsigned int m_actualRate = 0;
+    std::vector<pollfd> m_pollFds;
+
+    // Callbacks (exactly one is set while running)
+    PlanarAudioCallback m_planarCallback;
+    AudioCallback m_userCallback;
+
+    // Thread and state
+    std::thread m_audioThread;
+    std::atomic<bool> m_threadRunning{false};
+    std::atomic<bool> m_isRunning{false};
+    std::atomic<bool> m_isPaused{false};
+    mutable std::mutex m_controlMutex;
+
+    // Timing, performance, snapshots and reclamation
+    BackendRuntime m_runtime;
+
+    // Error handling
+    mutable std::mutex m_errorMutex;
+    mutable std::string m_lastError;
 };
 
 } // namespace AudioEngine
@@ -0,0 +1,128 @@
+#include "periodtuner.h"
+#include "buffercontroller.h"
+#include "../common/audioerror.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace AudioEngine {
+
+std::vector<PeriodTuner::Trial> PeriodTuner::candidates(const StreamConfig& base,
+                                                        const std::vector<int>& bufferSizes,
+                                                        const Options& options) {
+    std::vector<Trial> layouts;
+    for (int size : bufferSizes) {
+        for (int count : options.periodCounts) {
+            if (count < 2 || count > 16) {
+                continue;
+            }
+
+            Trial trial;
+            trial.bufferSize = size;
+            trial.periodCount = count;
+            trial.latencyMs = (static_cast<double>(size) * count * 1000.0) / base.sampleRate;
+            if (trial.latencyMs <= options.maxLatencyMs) {
+                layouts.push_back(trial);
+            }
+        }
+    }
+
+    // Lowest latency first; on a tie, fewer wake-ups (the larger period)
+    std::stable_sort(layouts.begin(), layouts.end(), [](const Trial& a, const Trial& b) {
+        if (a.latencyMs != b.latencyMs) {
+            return a.latencyMs < b.latencyMs;
+        }
+        return a.bufferSize > b.bufferSize;
+    });
+    return layouts;
+}
+
+PeriodTuner::Result PeriodTuner::tune(IAudioBackend& backend, const StreamConfig& base) {
+    return tune(backend, base, Options{});
+}
+
+PeriodTuner::Result PeriodTuner::tune(IAudioBackend& backend, const StreamConfig& base,
+                                      const Options& options) {
+    if (backend.isRunning()) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration,
+                             "Cannot tune a running backend");
+    }
+
+    std::vector<int> sizes = options.bufferSizes;
+    if (sizes.empty()) {
+        sizes = BufferController::candidateSizes(BufferController::findCapabilities(backend, base));
+    }
+
+    Result result;
+    result.config = base;
+
+    for (Trial trial : candidates(base, sizes, options)) {
+        StreamConfig config = base;
+        config.bufferSize = trial.bufferSize;
+        config.periodCount = trial.periodCount;
+        config.bufferStrategy = BufferStrategy::Fixed;
+        config.minimizeLatency = false;
+
+        const bool passed = runTrial(backend, config, options, trial);
+        result.trials.push_back(trial);
+
+        if (passed) {
+            result.found = true;
+            result.config.bufferSize = trial.bufferSize;
+            result.config.periodCount = trial.periodCount;
+            result.config.bufferStrategy = BufferStrategy::Fixed;
+            break;
+        }
+    }
+
+    return result;
+}
+
+bool PeriodTuner::runTrial(IAudioBackend& backend, const StreamConfig& config,
+                           const Options& options, Trial& trial) {
+    using Clock = std::chrono::steady_clock;
+
+    const double periodSeconds = static_cast<double>(config.bufferSize) / config.sampleRate;
+    const auto busy = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(periodSeconds * options.stressLoad / 100.0));
+    const int outputChannels = std::min(config.outputChannels, kMaxPlanarChannels);
+
+    try {
+        backend.initialize(config);
+        backend.startPlanar([busy, outputChannels](const float* const*, float* const* outputs,
+                                                   size_t frames, double) {
+            // Stand-in for a real graph: hold the audio thread for the load
+            const Clock::time_point until = Clock::now() + busy;
+            while (Clock::now() < until) {
+            }
+            for (int ch = 0; ch < outputChannels; ++ch) {
+                if (outputs[ch]) {
+                    std::memset(outputs[ch], 0, frames * sizeof(float));
+                }
+            }
+        });
+    } catch (const AudioException&) {
+        trial.started = false;
+        backend.clearError();
+        return false;
+    }
+    trial.started = true;
+
+    // The device may have rounded the layout
+    const StreamConfig actual = backend.getCurrentConfig();
+    trial.bufferSize = backend.getActualBufferSize();
+    trial.periodCount = actual.periodCount;
+    trial.latencyMs = (static_cast<double>(trial.bufferSize) * trial.periodCount * 1000.0) /
+                      std::max(1, backend.getActualSampleRate());
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.warmupSeconds));
+    const int startXruns = backend.getXrunCount();
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.stressSeconds));
+    trial.xruns = backend.getXrunCount() - startXruns;
+
+    backend.stop();
+    return trial.xruns <= options.maxXruns;
+}
+
+} // namespace AudioEngine
@@ -0,0 +1,59 @@
+#ifndef PERIODTUNER_H
+#define PERIODTUNER_H
+
+#include "../common/audiobackend.h"
+#include "../common/audioconfig.h"
+#include <vector>
+
+namespace AudioEngine {
+
+// Finds the lowest-latency period layout a device sustains
+// Whether three periods of 64 frames beat two of 128 depends on the card and
+// the machine, so each candidate layout is tried in order of total latency
+// (period size x period count) under a synthetic DSP load on the audio
+// thread. The first layout that runs its stress period without xruns wins.
+// Control thread only; the backend must not be running.
+class PeriodTuner {
+public:
+    struct Options {
+        std::vector<int> bufferSizes;               // Empty: the device's probed sizes
+        std::vector<int> periodCounts = {2, 3, 4};
+        double warmupSeconds = 0.25;                // Not counted: stream startup may xrun
+        double stressSeconds = 2.0;
+        double stressLoad = 50.0;                   // Busy time per callback, % of the period
+        int maxXruns = 0;                           // Xruns a layout may show and still pass
+        double maxLatencyMs = 100.0;                // Don't try layouts above this
+    };
+
+    // One layout tried
+    struct Trial {
+        int bufferSize = 0;
+        int periodCount = 0;
+        double latencyMs = 0.0;     // Period size x count
+        bool started = false;       // The backend accepted the layout
+        int xruns = 0;
+    };
+
+    struct Result {
+        bool found = false;
+        StreamConfig config;        // Base config with the winning layout
+        std::vector<Trial> trials;  // Everything tried, in order
+    };
+
+    // Candidate layouts in the order they are tried
+    static std::vector<Trial> candidates(const StreamConfig& base, const std::vector<int>& bufferSizes,
+                                         const Options& options);
+
+    // Try layouts on the backend until one survives. The backend is left
+    // stopped; initialize it with result.config to run the chosen layout.
+    static Result tune(IAudioBackend& backend, const StreamConfig& base, const Options& options);
+    static Result tune(IAudioBackend& backend, const StreamConfig& base);
+
+private:
+    static bool runTrial(IAudioBackend& backend, const StreamConfig& config,
+                         const Options& options, Trial& trial);
+};
+
+} // namespace AudioEngine
+
+#endif // PERIODTUNER_H
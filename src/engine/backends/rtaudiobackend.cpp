@@ -74,85 +74,111 @@ void RtAudioBackend::start(AudioCallback callback) {
     m_userCallback = std::move(callback);
 
     try {
-        // Configure RtAudio stream parameters
-        RtAudio::StreamParameters inputParams;
-        RtAudio::StreamParameters outputParams;
-
-        // Input device
-        if (m_config.inputChannels > 0 && m_config.inputDeviceName.has_value()) {
-            inputParams.deviceId = findDeviceIdByName(
-                m_config.inputDeviceName.value(), true);
-            inputParams.nChannels = m_config.inputChannels;
-            inputParams.firstChannel = 0;
-        }
-
-        // Output device
-        if (m_config.outputChannels > 0 && m_config.outputDeviceName.has_value()) {
-            outputParams.deviceId = findDeviceIdByName(
-                m_config.outputDeviceName.value(), false);
-            outputParams.nChannels = m_config.outputChannels;
-            outputParams.firstChannel = 0;
-        }
-
-        // Get default devices if not specified
-        if (inputParams.nChannels > 0 && inputParams.deviceId == -1) {
-            inputParams.deviceId = m_rtAudio->getDefaultInputDevice();
-        }
-        if (outputParams.nChannels > 0 && outputParams.deviceId == -1) {
-            outputParams.deviceId = m_rtAudio->getDefaultOutputDevice();
-        }
-
-        // Buffer size
-        unsigned int bufferFrames = m_config.bufferSize;
-
-        // Sample rate
-        unsigned int sampleRate = m_config.sampleRate;
-
-        // Format
-        RtAudioFormat format = RtAudioDevice::convertToRtAudioFormat(m_config.format);
-
-        // Open the stream
-        RtAudio::StreamOptions options;
-        options.flags = RTAUDIO_NONINTERLEAVED;
-        options.numberOfBuffers = 2; // Double buffering
-        options.streamName = "Cadence DAW";
-        options.priority = 90; // High priority for audio thread
-
-        if (m_config.exclusiveMode) {
-            options.flags |= RTAUDIO_HOG_DEVICE;
-        }
-
-        m_rtAudio->openStream(
-            m_config.outputChannels > 0 ? &outputParams : nullptr,
-            m_config.inputChannels > 0 ? &inputParams : nullptr,
-            format,
-            sampleRate,
-            &bufferFrames,
-            &RtAudioBackend::rtAudioCallback,
-            this,
-            &options
-        );
-
-        // Update actual buffer size (RtAudio may adjust it)
-        m_config.bufferSize = bufferFrames;
+        openStream();
 
         // Reset performance counters
-        resetPerformanceCounters();
+        m_runtime.prepare(m_config);
 
         // Start the stream
         m_rtAudio->startStream();
         m_isRunning = true;
         m_isPaused = false;
 
-        m_lastCallbackTime = std::chrono::high_resolution_clock::now();
+        try {
+            const std::string realtime = m_runtime.verifyRealtimeSetup(m_config);
+            if (!realtime.empty()) {
+                setError(realtime);
+            }
+        } catch (const AudioException&) {
+            m_isRunning = false;
+            m_rtAudio->abortStream();
+            m_rtAudio->closeStream();
+            m_userCallback = nullptr;
+            m_runtime.shutdown();
+            throw;
+        }
 
     } catch (const RtAudioError& e) {
         setError(std::string("Failed to start audio stream: ") + e.getMessage());
         m_isRunning = false;
+        m_runtime.shutdown();
         throw AudioException(AudioErrorCode::AudioBackendStartFailed, getLastError());
     }
 }
 
+RtAudio::StreamOptions RtAudioBackend::makeStreamOptions(const StreamConfig& config) {
+    RtAudio::StreamOptions options;
+    options.flags = RTAUDIO_NONINTERLEAVED;
+    options.numberOfBuffers = static_cast<unsigned int>(config.periodCount);
+    options.streamName = "Cadence DAW";
+    options.priority = config.realtimePriority;
+
+    if (config.realtimePriority > 0) {
+        options.flags |= RTAUDIO_SCHEDULE_REALTIME;
+    }
+    if (config.exclusiveMode) {
+        options.flags |= RTAUDIO_HOG_DEVICE;
+    }
+    if (config.minimizeLatency) {
+        // The API picks its smallest period count; periodCount is ignored
+        options.flags |= RTAUDIO_MINIMIZE_LATENCY;
+    }
+    return options;
+}
+
+void RtAudioBackend::openStream() {
+    RtAudio::StreamParameters inputParams;
+    RtAudio::StreamParameters outputParams;
+
+    // Input device
+    if (m_config.inputChannels > 0) {
+        inputParams.deviceId = m_config.inputDeviceName.has_value()
+            ? findDeviceIdByName(m_config.inputDeviceName.value(), true)
+            : -1;
+        inputParams.nChannels = m_config.inputChannels;
+        inputParams.firstChannel = 0;
+    }
+
+    // Output device
+    if (m_config.outputChannels > 0) {
+        outputParams.deviceId = m_config.outputDeviceName.has_value()
+            ? findDeviceIdByName(m_config.outputDeviceName.value(), false)
+            : -1;
+        outputParams.nChannels = m_config.outputChannels;
+        outputParams.firstChannel = 0;
+    }
+
+    // Get default devices if not specified
+    if (inputParams.nChannels > 0 && inputParams.deviceId == -1) {
+        inputParams.deviceId = m_rtAudio->getDefaultInputDevice();
+    }
+    if (outputParams.nChannels > 0 && outputParams.deviceId == -1) {
+        outputParams.deviceId = m_rtAudio->getDefaultOutputDevice();
+    }
+
+    unsigned int bufferFrames = m_config.bufferSize;
+    unsigned int sampleRate = m_config.sampleRate;
+    RtAudioFormat format = RtAudioDevice::convertToRtAudioFormat(m_config.format);
+    RtAudio::StreamOptions options = makeStreamOptions(m_config);
+
+    m_rtAudio->openStream(
+        m_config.outputChannels > 0 ? &outputParams : nullptr,
+        m_config.inputChannels > 0 ? &inputParams : nullptr,
+        format,
+        sampleRate,
+        &bufferFrames,
+        &RtAudioBackend::rtAudioCallback,
+        this,
+        &options
+    );
+
+    // RtAudio reports back the period size and count it actually used
+    m_config.bufferSize = bufferFrames;
+    if (options.numberOfBuffers >= 2) {
+        m_config.periodCount = static_cast<int>(options.numberOfBuffers);
+    }
+}
+
 void RtAudioBackend::stop() {
     std::lock_guard<std::mutex> lock(m_callbackMutex);
 
@@ -171,6 +197,7 @@ void RtAudioBackend::stop() {
     m_isRunning = false;
     m_isPaused = false;
     m_userCallback = nullptr;
+    m_runtime.shutdown();
 }
 
 void RtAudioBackend::pause() {
@@ -195,7 +222,6 @@ void RtAudioBackend::resume() {
     try {
         m_rtAudio->startStream();
         m_isPaused = false;
-        m_lastCallbackTime = std::chrono::high_resolution_clock::now();
     } catch (const RtAudioError& e) {
         setError(std::string("Error resuming stream: ") + e.getMessage());
         throw AudioException(AudioErrorCode::AudioBackendStartFailed, getLastError());
@@ -253,12 +279,7 @@ double RtAudioBackend::getOutputLatencyMs() const {
 }
 
 double RtAudioBackend::getStreamTime() const {
-    return m_streamTime.load();
-}
-
-void RtAudioBackend::updateStreamTime(unsigned int framesProcessed) {
-    double increment = framesProcessed / static_cast<double>(m_config.sampleRate);
-    m_streamTime.store(m_streamTime.load() + increment);
+    return m_runtime.getStreamTime();
 }
 
 bool RtAudioBackend::changeSampleRate(int newRate) {
@@ -276,45 +297,10 @@ bool RtAudioBackend::changeSampleRate(int newRate) {
 
         m_rtAudio->closeStream();
         m_config.sampleRate = newRate;
+        m_runtime.prepare(m_config);
 
         // Reopen stream with new sample rate
-        RtAudio::StreamParameters inputParams, outputParams;
-
-        // Configure parameters (similar to start())
-
-
-        // Buffer size
-        unsigned int bufferFrames = m_config.bufferSize;
-
-
-        // Sample rate
-        unsigned int sampleRate = m_config.sampleRate;
-
-        // Format
-        RtAudioFormat format = RtAudioDevice::convertToRtAudioFormat(m_config.format);
-
-        // Open the stream
-        RtAudio::StreamOptions options;
-        options.flags = RTAUDIO_NONINTERLEAVED;
-        options.numberOfBuffers = 2; // Double buffering
-        options.streamName = "Cadence DAW";
-        options.priority = 90; // High priority for audio thread
-
-        if (m_config.exclusiveMode) {
-            options.flags |= RTAUDIO_HOG_DEVICE;
-        }
-
-        m_rtAudio->openStream(
-            m_config.outputChannels > 0 ? &outputParams : nullptr,
-            m_config.inputChannels > 0 ? &inputParams : nullptr,
-            format,
-            sampleRate,
-            &bufferFrames,
-            &RtAudioBackend::rtAudioCallback,
-            this,
-            &options
-            );
-
+        openStream();
 
         if (!wasPaused) {
             resume();
@@ -344,44 +330,10 @@ bool RtAudioBackend::changeBufferSize(int newSize) {
 
         m_rtAudio->closeStream();
         m_config.bufferSize = newSize;
+        m_runtime.resetThreadSetup();
 
         // Reopen stream with new buffer size
-        RtAudio::StreamParameters inputParams, outputParams;
-
-        // Configure parameters (similar to start())
-
-        // Buffer size
-        unsigned int bufferFrames = newSize;
-
-
-
-        // Sample rate
-        unsigned int sampleRate = m_config.sampleRate;
-
-        // Format
-        RtAudioFormat format = RtAudioDevice::convertToRtAudioFormat(m_config.format);
-
-        // Open the stream
-        RtAudio::StreamOptions options;
-        options.flags = RTAUDIO_NONINTERLEAVED;
-        options.numberOfBuffers = 2; // Double buffering
-        options.streamName = "Cadence DAW";
-        options.priority = 90; // High priority for audio thread
-
-        if (m_config.exclusiveMode) {
-            options.flags |= RTAUDIO_HOG_DEVICE;
-        }
-
-        m_rtAudio->openStream(
-            m_config.outputChannels > 0 ? &outputParams : nullptr,
-            m_config.inputChannels > 0 ? &inputParams : nullptr,
-            format,
-            sampleRate,
-            &bufferFrames,
-            &RtAudioBackend::rtAudioCallback,
-            this,
-            &options
-        );
+        openStream();
 
         if (!wasPaused) {
             resume();
@@ -429,29 +381,15 @@ int RtAudioBackend::handleAudioCallback(void* outputBuffer, void* inputBuffer,
                                         unsigned int nFrames,
                                         double streamTime,
                                         RtAudioStreamStatus status) {
+    BackendRuntime::Period period(m_runtime, m_config, nFrames);
+
     // Handle xruns (buffer over/under runs)
     if (status & RTAUDIO_INPUT_OVERFLOW) {
-        m_xrunCount++;
+        period.addXrun();
     }
     if (status & RTAUDIO_OUTPUT_UNDERFLOW) {
-        m_xrunCount++;
-    }
-
-    // Update CPU usage measurement
-    auto now = std::chrono::high_resolution_clock::now();
-    auto elapsed = std::chrono::duration<double>(now - m_lastCallbackTime).count();
-    double expectedTime = nFrames / static_cast<double>(m_config.sampleRate);
-
-    if (elapsed > expectedTime) {
-        // We're running late
-        m_cpuUsage.store(100.0); // 100% CPU usage (we missed our deadline)
-    } else {
-        m_cpuUsage.store((elapsed / expectedTime) * 100.0);
+        period.addXrun();
     }
-    m_lastCallbackTime = now;
-
-    // Update stream time
-    updateStreamTime(nFrames);
 
     // Call user callback if we have one
     if (m_userCallback) {
@@ -466,7 +404,7 @@ int RtAudioBackend::handleAudioCallback(void* outputBuffer, void* inputBuffer,
             m_userCallback(static_cast<float*>(inputBuffer),
                            static_cast<float*>(outputBuffer),
                            nFrames,
-                           m_streamTime.load());
+                           m_runtime.getStreamTime());
         } catch (const std::exception& e) {
             setError(std::string("Audio callback error: ") + e.what());
             return 1; // Return non-zero to stop stream
@@ -482,6 +420,15 @@ int RtAudioBackend::handleAudioCallback(void* outputBuffer, void* inputBuffer,
         std::memset(outputBuffer, 0, bufferSize);
     }
 
+    // Non-interleaved output: one plane per channel
+    float* planes = static_cast<float*>(outputBuffer);
+    const float* outputs[EngineSnapshot::kMaxMeters];
+    const int meteredChannels = planes ? std::min(m_config.outputChannels, EngineSnapshot::kMaxMeters) : 0;
+    for (int ch = 0; ch < meteredChannels; ++ch) {
+        outputs[ch] = planes + static_cast<size_t>(ch) * nFrames;
+    }
+    period.finish(planes ? outputs : nullptr, meteredChannels);
+
     return 0;
 }
 
@@ -497,22 +444,31 @@ LatencyInfo RtAudioBackend::measureLatency() {
     info.jitterMs = info.theoreticalMs * 0.05; // 5% jitter
 
     // CPU usage
-    info.cpuUsage = m_cpuUsage.load();
+    info.cpuUsage = m_runtime.getCpuUsage();
 
     // Xrun count
-    info.xruns = m_xrunCount.load();
+    info.xruns = m_runtime.getXrunCount();
 
     return info;
 }
 
 double RtAudioBackend::getCpuUsage() const {
-    return m_cpuUsage.load();
+    return m_runtime.getCpuUsage();
 }
 
 int RtAudioBackend::getXrunCount() const {
-    return m_xrunCount.load();
+    return m_runtime.getXrunCount();
 }
 
+const EngineSnapshot& RtAudioBackend::readSnapshot() {
+    return m_runtime.readSnapshot();
+}
+
+RealtimeStatus RtAudioBackend::getRealtimeStatus() const {
+    return m_runtime.getRealtimeStatus();
+}
+
+
 
 std::vector<std::unique_ptr<IAudioDevice>> RtAudioBackend::enumerateDevices() const {
     std::vector<std::unique_ptr<IAudioDevice>> devices;
@@ -656,6 +612,10 @@ void* RtAudioBackend::getPlatformHandle() const {
     return nullptr;
 }
 
+DeferredReclaimer& RtAudioBackend::getReclaimer() {
+    return m_runtime.getReclaimer();
+}
+
 std::string RtAudioBackend::getLastError() const {
     std::lock_guard<std::mutex> lock(m_errorMutex);
     return m_lastError;
@@ -679,10 +639,4 @@ void RtAudioBackend::checkAndThrowRtAudioError(const std::string& context) const
     }
 }
 
-void RtAudioBackend::resetPerformanceCounters() {
-    m_xrunCount = 0;
-    m_cpuUsage = 0.0;
-    m_streamTime = 0.0;
-}
-
 }
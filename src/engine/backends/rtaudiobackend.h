@@ -2,6 +2,7 @@
 #define RTAUDIOBACKEND_H
 #include "../common/audiobackend.h"
 #include "../devices/rtaudiodevice.h"
+#include "backendruntime.h"
 #include <RtAudio.h>
 #include <atomic>
 #include <mutex>
@@ -45,11 +46,16 @@ public:
     LatencyInfo measureLatency() override;
     double getCpuUsage() const override;
     int getXrunCount() const override;
+    RealtimeStatus getRealtimeStatus() const override;
+    const EngineSnapshot& readSnapshot() override;
 
     // Error Handling
     std::string getLastError() const override;
     void clearError() override;
 
+    // Live Editing
+    DeferredReclaimer& getReclaimer() override;
+
     // Device Management
     std::vector<std::unique_ptr<IAudioDevice>> enumerateDevices() const override;
     std::unique_ptr<IAudioDevice> getCurrentInputDevice() const override;
@@ -77,6 +83,10 @@ private:
                             double streamTime,
                             RtAudioStreamStatus status);
 
+    // Stream setup shared by start() and the reconfiguration paths
+    void openStream();
+    static RtAudio::StreamOptions makeStreamOptions(const StreamConfig& config);
+
     // Device management
     std::unique_ptr<IAudioDevice> createDeviceFromRtAudioId(int deviceId) const;
     int findDeviceIdByName(const std::string& name, bool isInput) const;
@@ -85,10 +95,6 @@ private:
     void setError(const std::string& error) const;
     void checkAndThrowRtAudioError(const std::string& context) const;
 
-    // State management
-    void updateStreamTime(unsigned int framesProcessed);
-    void resetPerformanceCounters();
-
 private:
     std::unique_ptr<RtAudio> m_rtAudio;
     BackendType m_backendType;
@@ -98,14 +104,11 @@ private:
     AudioCallback m_userCallback;
     std::atomic<bool> m_isRunning{false};
     std::atomic<bool> m_isPaused{false};
-    std::atomic<int> m_xrunCount{0};
-
-    // Timing and performance
-    std::atomic<double> m_streamTime{0.0};
-    std::chrono::high_resolution_clock::time_point m_lastCallbackTime;
-    std::atomic<double> m_cpuUsage{0.0};
     mutable std::mutex m_callbackMutex;
 
+    // Timing, performance, snapshots and reclamation
+    BackendRuntime m_runtime;
+
     // Error handling
     mutable std::mutex m_errorMutex;
     mutable std::string m_lastError;
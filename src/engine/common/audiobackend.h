@@ -3,12 +3,16 @@
 
 #include "audiodevice.h"
 #include "audioconfig.h"
+#include "enginesnapshot.h"
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <vector>
 
 namespace AudioEngine {
 
+class DeferredReclaimer;
+
 // Audio callback function type
 // Args: inputBuffer, outputBuffer, framesPerBuffer, streamTime (seconds)
 using AudioCallback = std::function<void(
@@ -18,6 +22,18 @@ using AudioCallback = std::function<void(
     double streamTime
     )>;
 
+// Planar audio callback: one pointer per channel
+// Backends that can expose device memory directly (ALSA mmap areas, JACK port
+// buffers) hand it to the callback without copying through their own buffers.
+using PlanarAudioCallback = std::function<void(
+    const float* const* inputs,
+    float* const* outputs,
+    size_t frames,
+    double streamTime
+    )>;
+
+// Upper bound on channels passed through a planar callback
+constexpr int kMaxPlanarChannels = 256;
 
 
 // Audio backend abstraction
@@ -33,6 +49,10 @@ public:
     // Start audio processing with callback
     virtual void start(AudioCallback callback) = 0;
 
+    // Start with a planar callback. The default adapts it onto start()'s
+    // contiguous non-interleaved layout; zero-copy backends override it.
+    virtual void startPlanar(PlanarAudioCallback callback);
+
     // Stop audio processing
     virtual void stop() = 0;
 
@@ -76,11 +96,24 @@ public:
     virtual double getCpuUsage() const = 0;
     virtual int getXrunCount() const = 0;  // Buffer over/under runs
 
+    // Scheduling, affinity and memory locking actually in effect on the audio thread
+    virtual RealtimeStatus getRealtimeStatus() const = 0;
+
+    // Latest per-period engine state (playhead, DSP load, xruns) as one
+    // consistent snapshot. Single reader: call from the UI thread only.
+    virtual const EngineSnapshot& readSnapshot() = 0;
+
     // ===== Error Handling =====
 
     virtual std::string getLastError() const = 0;
     virtual void clearError() = 0;
 
+    // ===== Live Editing =====
+
+    // Retire objects unlinked from the running graph here instead of deleting
+    // them; they are freed once the audio thread has left its callback
+    virtual DeferredReclaimer& getReclaimer() = 0;
+
     // ===== Device Management =====
 
     virtual std::vector<std::unique_ptr<IAudioDevice>>
@@ -107,6 +140,30 @@ private:
     IAudioBackend& operator=(const IAudioBackend&) = delete;
 };
 
+inline void IAudioBackend::startPlanar(PlanarAudioCallback callback) {
+    if (!callback) {
+        start(nullptr);
+        return;
+    }
+
+    const StreamConfig config = getCurrentConfig();
+    const int inputChannels = std::min(config.inputChannels, kMaxPlanarChannels);
+    const int outputChannels = std::min(config.outputChannels, kMaxPlanarChannels);
+
+    start([callback, inputChannels, outputChannels](const float* input, float* output,
+                                                    size_t frames, double streamTime) {
+        const float* inputs[kMaxPlanarChannels];
+        float* outputs[kMaxPlanarChannels];
+        for (int ch = 0; ch < inputChannels; ++ch) {
+            inputs[ch] = input ? input + ch * frames : nullptr;
+        }
+        for (int ch = 0; ch < outputChannels; ++ch) {
+            outputs[ch] = output ? output + ch * frames : nullptr;
+        }
+        callback(inputs, outputs, frames, streamTime);
+    });
+}
+
 // Factory for creating backends
 class AudioBackendFactory {
 public:
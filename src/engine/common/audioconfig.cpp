@@ -0,0 +1,40 @@
+#include "audioconfig.h"
+#include <sstream>
+
+namespace AudioEngine {
+
+bool StreamConfig::isValid() const {
+    if (sampleRate < 8000 || sampleRate > 384000) {
+        return false;
+    }
+    if (bufferSize < 16 || bufferSize > 8192) {
+        return false;
+    }
+    if (inputChannels < 0 || outputChannels < 0) {
+        return false;
+    }
+    if (inputChannels == 0 && outputChannels == 0) {
+        return false;
+    }
+    if (periodCount < 2 || periodCount > 16) {
+        return false;
+    }
+    return true;
+}
+
+std::string StreamConfig::toString() const {
+    std::stringstream ss;
+    ss << "StreamConfig: " << sampleRate << " Hz"
+       << ", " << bufferSize << " frames x " << periodCount
+       << ", In: " << inputChannels
+       << ", Out: " << outputChannels;
+    if (inputDeviceName) {
+        ss << ", Input device: " << *inputDeviceName;
+    }
+    if (outputDeviceName) {
+        ss << ", Output device: " << *outputDeviceName;
+    }
+    return ss.str();
+}
+
+} // namespace AudioEngine
@@ -15,7 +15,14 @@ enum class SampleFormat {
     Int32       // 32-bit integer
 };
 
-// Buffer behavior
+// Dither added when output is quantized to Int16/Int24
+enum class DitherMode {
+    None,       // Plain rounding
+    Triangular, // TPDF, +-1 LSB: error independent of the signal
+    Shaped      // TPDF with error feedback pushing the noise above ~10 kHz
+};
+
+// Buffer behavior (applied by BufferController)
 enum class BufferStrategy {
     Fixed,      // Fixed buffer size (simpler)
     Adaptive,   // Adapt to system capabilities
@@ -33,7 +40,8 @@ enum class BackendType {
     JACK,       // Linux JACK
     ALSA,       // Linux ALSA
     Pulse,      // Linux PulseAudio
-    RtAudio     // RtAudio wrapper (our default)
+    RtAudio,    // RtAudio wrapper (our default)
+    File        // WAV-file virtual device (CI, replay)
 };
 
 // Device capabilities
@@ -61,20 +69,32 @@ struct StreamConfig {
     // Stream parameters
     int sampleRate = 48000;
     int bufferSize = 512;     // Frames per buffer
+    int periodCount = 2;      // Periods queued between the callback and the device (JACK: set by the server)
     int inputChannels = 2;
     int outputChannels = 2;
 
     // Format
     SampleFormat format = SampleFormat::Float32;
+    DitherMode dither = DitherMode::Triangular;  // When the device or the file backend's WAV runs Int16/Int24
 
     // Behavior
     BufferStrategy bufferStrategy = BufferStrategy::Stable;
     bool allowSampleRateChange = false;
     bool allowBufferSizeChange = false;
     bool exclusiveMode = false;  // Exclusive hardware access
+    bool minimizeLatency = false;  // Let the API choose its smallest period count (RTAUDIO_MINIMIZE_LATENCY)
+    bool loudnessMetering = false;  // EBU R128 loudness and true peak of the outputs in the snapshot
 
     // Platform specific
     BackendType preferredBackend = BackendType::Auto;
+    std::optional<BackendType> inputBackend;  // Capture on another backend, clocked to the output (aggregate)
+
+    // Real-time thread setup
+    int realtimePriority = 90;              // SCHED_FIFO priority for the audio thread (0 = don't request)
+    bool requireRealtimePriority = false;   // Fail start() instead of running under SCHED_OTHER
+    bool lockMemory = true;                 // mlockall() and prefault the audio thread stack
+    std::vector<int> audioThreadCpus;       // Cores the audio thread is pinned to (empty = any)
+    std::vector<int> workerThreadCpus;      // Cores engine workers are pinned to (empty = any)
 
     // Validation
     bool isValid() const;
@@ -90,5 +110,17 @@ struct LatencyInfo {
     int xruns;                // Buffer over/under runs
 };
 
+// Real-time setup actually in effect on the audio thread
+struct RealtimeStatus {
+    bool configured = false;        // Audio thread has run its setup
+    bool memoryLocked = false;      // mlockall() succeeded
+    bool stackPrefaulted = false;   // Stack pages touched before first use
+    bool affinityApplied = false;   // Thread pinned to the requested cores
+    bool isRealtime = false;        // SCHED_FIFO/SCHED_RR in effect
+    int schedulingPolicy = 0;       // Policy reported by the OS
+    int priority = 0;               // Priority reported by the OS
+    int maxPermittedPriority = -1;  // RLIMIT_RTPRIO (-1 = unknown/unlimited)
+};
+
 }
 #endif
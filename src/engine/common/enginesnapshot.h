@@ -0,0 +1,52 @@
+#ifndef ENGINESNAPSHOT_H
+#define ENGINESNAPSHOT_H
+
+#include <cstdint>
+#include <limits>
+
+namespace AudioEngine {
+
+// One meter's reading for the last completed metering window
+struct MeterReading {
+    float peak = 0.0f;          // Linear peak |x|
+    float rms = 0.0f;           // Linear RMS
+    uint32_t clipCount = 0;     // Windows that reached 0 dBFS; UI holds the clip light on change
+};
+
+// EBU R128 loudness of the master bus (see LoudnessMeter)
+// -inf until measured, and always when StreamConfig::loudnessMetering is off.
+struct LoudnessReading {
+    float momentary = -std::numeric_limits<float>::infinity();     // LUFS, 400 ms
+    float shortTerm = -std::numeric_limits<float>::infinity();     // LUFS, 3 s
+    float integrated = -std::numeric_limits<float>::infinity();    // LUFS, gated, since the stream started
+    float truePeak = -std::numeric_limits<float>::infinity();      // dBTP, since the stream started
+};
+
+// Engine state published once per period by the audio thread
+// Read by the UI through IAudioBackend::readSnapshot(); every field belongs to
+// the same period, so readouts are always mutually consistent.
+struct EngineSnapshot {
+    uint64_t sequence = 0;          // Periods published since the stream started
+    uint64_t framePosition = 0;     // Playhead in frames
+    double streamTime = 0.0;        // Playhead in seconds
+
+    int sampleRate = 0;
+    int bufferSize = 0;
+
+    double dspLoad = 0.0;           // Callback time as % of the period
+    double peakDspLoad = 0.0;       // Highest dspLoad since the stream started
+
+    int xruns = 0;                  // Buffer over/under runs
+    uint64_t lastXrunFrame = 0;     // framePosition of the most recent xrun
+
+    // Per-channel/bus meters, raw values (ballistics are applied by the UI)
+    static constexpr int kMaxMeters = 128;
+    int meterCount = 0;
+    MeterReading meters[kMaxMeters];
+
+    LoudnessReading loudness;
+};
+
+} // namespace AudioEngine
+
+#endif // ENGINESNAPSHOT_H
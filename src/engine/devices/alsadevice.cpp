@@ -0,0 +1,226 @@
+#include "alsadevice.h"
+#include <alsa/asoundlib.h>
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+namespace AudioEngine {
+
+namespace {
+
+// Query one direction of a PCM; returns false if it cannot be opened
+bool probeStream(const std::string& pcmName, snd_pcm_stream_t stream,
+                 DeviceCapabilities& caps, int& maxChannels)
+{
+    snd_pcm_t* pcm = nullptr;
+    if (snd_pcm_open(&pcm, pcmName.c_str(), stream, SND_PCM_NONBLOCK) < 0) {
+        return false;
+    }
+
+    snd_pcm_hw_params_t* params;
+    snd_pcm_hw_params_alloca(&params);
+    if (snd_pcm_hw_params_any(pcm, params) < 0) {
+        snd_pcm_close(pcm);
+        return false;
+    }
+
+    for (unsigned int rate : {22050u, 32000u, 44100u, 48000u, 88200u, 96000u, 176400u, 192000u}) {
+        if (snd_pcm_hw_params_test_rate(pcm, params, rate, 0) == 0 &&
+            std::find(caps.supportedSampleRates.begin(), caps.supportedSampleRates.end(), rate)
+                == caps.supportedSampleRates.end()) {
+            caps.supportedSampleRates.push_back(rate);
+        }
+    }
+
+    unsigned int channels = 0;
+    snd_pcm_hw_params_get_channels_max(params, &channels);
+    maxChannels = static_cast<int>(std::min(channels, 256u));
+
+    snd_pcm_uframes_t minPeriod = 0;
+    snd_pcm_uframes_t maxPeriod = 0;
+    int dir = 0;
+    snd_pcm_hw_params_get_period_size_min(params, &minPeriod, &dir);
+    snd_pcm_hw_params_get_period_size_max(params, &maxPeriod, &dir);
+    for (snd_pcm_uframes_t size = 16; size <= 8192; size *= 2) {
+        if (size >= minPeriod && size <= maxPeriod &&
+            std::find(caps.supportedBufferSizes.begin(), caps.supportedBufferSizes.end(),
+                      static_cast<int>(size)) == caps.supportedBufferSizes.end()) {
+            caps.supportedBufferSizes.push_back(static_cast<int>(size));
+        }
+    }
+
+    const std::pair<snd_pcm_format_t, SampleFormat> formats[] = {
+        {SND_PCM_FORMAT_FLOAT, SampleFormat::Float32},
+        {SND_PCM_FORMAT_S32, SampleFormat::Int32},
+        {SND_PCM_FORMAT_S24_3LE, SampleFormat::Int24},
+        {SND_PCM_FORMAT_S16, SampleFormat::Int16},
+    };
+    for (const auto& format : formats) {
+        if (snd_pcm_hw_params_test_format(pcm, params, format.first) == 0 &&
+            std::find(caps.supportedFormats.begin(), caps.supportedFormats.end(), format.second)
+                == caps.supportedFormats.end()) {
+            caps.supportedFormats.push_back(format.second);
+        }
+    }
+
+    if (minPeriod > 0 && !caps.supportedSampleRates.empty()) {
+        double bestRate = caps.supportedSampleRates.back();
+        caps.minLatencyMs = std::min(caps.minLatencyMs, (2.0 * minPeriod * 1000.0) / bestRate);
+    }
+
+    snd_pcm_close(pcm);
+    return true;
+}
+
+}
+
+AlsaDevice::AlsaDevice(const std::string& pcmName, const std::string& description,
+                       const DeviceCapabilities& capabilities)
+    : m_pcmName(pcmName)
+    , m_description(description)
+    , m_capabilities(capabilities)
+{
+}
+
+std::unique_ptr<AlsaDevice> AlsaDevice::probe(const std::string& pcmName,
+                                              const std::string& description) {
+    DeviceCapabilities caps{};
+    caps.minLatencyMs = 100.0;
+    caps.maxLatencyMs = 100.0;
+
+    int maxInput = 0;
+    int maxOutput = 0;
+    caps.supportsInput = probeStream(pcmName, SND_PCM_STREAM_CAPTURE, caps, maxInput);
+    caps.supportsOutput = probeStream(pcmName, SND_PCM_STREAM_PLAYBACK, caps, maxOutput);
+    if (!caps.supportsInput && !caps.supportsOutput) {
+        return nullptr;
+    }
+
+    std::sort(caps.supportedSampleRates.begin(), caps.supportedSampleRates.end());
+    std::sort(caps.supportedBufferSizes.begin(), caps.supportedBufferSizes.end());
+    caps.maxInputChannels = caps.supportsInput ? maxInput : 0;
+    caps.maxOutputChannels = caps.supportsOutput ? maxOutput : 0;
+    caps.supportsDuplex = caps.supportsInput && caps.supportsOutput;
+    caps.isDefaultInput = (pcmName == "default");
+    caps.isDefaultOutput = (pcmName == "default");
+
+    return std::make_unique<AlsaDevice>(pcmName, description, caps);
+}
+
+std::vector<std::unique_ptr<IAudioDevice>> AlsaDevice::enumerate() {
+    std::vector<std::unique_ptr<IAudioDevice>> devices;
+
+    if (auto device = probe("default", "Default ALSA device")) {
+        devices.push_back(std::move(device));
+    }
+
+    void** hints = nullptr;
+    if (snd_device_name_hint(-1, "pcm", &hints) < 0) {
+        return devices;
+    }
+
+    for (void** hint = hints; *hint; ++hint) {
+        char* name = snd_device_name_get_hint(*hint, "NAME");
+        char* desc = snd_device_name_get_hint(*hint, "DESC");
+
+        if (name && std::string(name) != "default" && std::string(name) != "null") {
+            std::string description = desc ? desc : name;
+            std::replace(description.begin(), description.end(), '\n', ' ');
+            if (auto device = probe(name, description)) {
+                devices.push_back(std::move(device));
+            }
+        }
+
+        free(name);
+        free(desc);
+    }
+
+    snd_device_name_free_hint(hints);
+    return devices;
+}
+
+std::string AlsaDevice::getId() const {
+    // PCM names are already unique: backend-type_pcm-name
+    std::stringstream ss;
+    ss << static_cast<int>(BackendType::ALSA) << "_" << m_pcmName;
+    return ss.str();
+}
+
+std::string AlsaDevice::getName() const {
+    return m_pcmName;
+}
+
+std::string AlsaDevice::getVendor() const {
+    // The description's first line usually names the card
+    return m_description;
+}
+
+BackendType AlsaDevice::getBackendType() const {
+    return BackendType::ALSA;
+}
+
+DeviceCapabilities AlsaDevice::getCapabilities() const {
+    return m_capabilities;
+}
+
+bool AlsaDevice::isAvailable() const {
+    // Probing succeeded when the device was created
+    return true;
+}
+
+bool AlsaDevice::isDefaultInput() const {
+    return m_capabilities.isDefaultInput;
+}
+
+bool AlsaDevice::isDefaultOutput() const {
+    return m_capabilities.isDefaultOutput;
+}
+
+bool AlsaDevice::supportsSampleRate(int rate) const {
+    unsigned int sampleRate = static_cast<unsigned int>(rate);
+    return std::find(m_capabilities.supportedSampleRates.begin(),
+                     m_capabilities.supportedSampleRates.end(),
+                     sampleRate) != m_capabilities.supportedSampleRates.end();
+}
+
+bool AlsaDevice::supportsBufferSize(int size) const {
+    return std::find(m_capabilities.supportedBufferSizes.begin(),
+                     m_capabilities.supportedBufferSizes.end(),
+                     size) != m_capabilities.supportedBufferSizes.end();
+}
+
+bool AlsaDevice::supportsFormat(SampleFormat format) const {
+    return std::find(m_capabilities.supportedFormats.begin(),
+                     m_capabilities.supportedFormats.end(),
+                     format) != m_capabilities.supportedFormats.end();
+}
+
+double AlsaDevice::getDefaultInputLatencyMs() const {
+    return m_capabilities.supportsInput ? m_capabilities.minLatencyMs : 0.0;
+}
+
+double AlsaDevice::getDefaultOutputLatencyMs() const {
+    return m_capabilities.supportsOutput ? m_capabilities.minLatencyMs : 0.0;
+}
+
+bool AlsaDevice::operator==(const IAudioDevice& other) const {
+    const AlsaDevice* otherAlsa = dynamic_cast<const AlsaDevice*>(&other);
+    if (!otherAlsa) return false;
+    return m_pcmName == otherAlsa->m_pcmName;
+}
+
+bool AlsaDevice::operator!=(const IAudioDevice& other) const {
+    return !(*this == other);
+}
+
+std::string AlsaDevice::toString() const {
+    std::stringstream ss;
+    ss << "AlsaDevice: " << m_pcmName
+       << " (" << m_description
+       << ", In: " << m_capabilities.maxInputChannels
+       << ", Out: " << m_capabilities.maxOutputChannels
+       << ")";
+    return ss.str();
+}
+
+} // namespace AudioEngine
@@ -0,0 +1,61 @@
+#ifndef ALSADEVICE_H
+#define ALSADEVICE_H
+#include "../common/audiodevice.h"
+namespace AudioEngine {
+
+
+class AlsaDevice : public IAudioDevice {
+public:
+    // Constructor from an ALSA PCM name and its probed capabilities
+    AlsaDevice(const std::string& pcmName, const std::string& description,
+               const DeviceCapabilities& capabilities);
+
+    // Device identification
+    std::string getId() const override;
+    std::string getName() const override;
+    std::string getVendor() const override;
+    BackendType getBackendType() const override;
+
+    // Capabilities
+    DeviceCapabilities getCapabilities() const override;
+
+    // Status
+    bool isAvailable() const override;
+    bool isDefaultInput() const override;
+    bool isDefaultOutput() const override;
+
+    // Format queries
+    bool supportsSampleRate(int rate) const override;
+    bool supportsBufferSize(int size) const override;
+    bool supportsFormat(SampleFormat format) const override;
+
+    // Latency information
+    double getDefaultInputLatencyMs() const override;
+    double getDefaultOutputLatencyMs() const override;
+
+    // Comparison
+    bool operator==(const IAudioDevice& other) const override;
+    bool operator!=(const IAudioDevice& other) const override;
+
+    // String representation
+    std::string toString() const override;
+
+    // ALSA-specific accessors
+    const std::string& getPcmName() const { return m_pcmName; }
+
+    // Open the PCM briefly and query rates, channels and period sizes
+    static std::unique_ptr<AlsaDevice> probe(const std::string& pcmName,
+                                             const std::string& description);
+
+    // All PCMs from ALSA's device name hints, plus "default"
+    static std::vector<std::unique_ptr<IAudioDevice>> enumerate();
+
+private:
+    std::string m_pcmName;
+    std::string m_description;
+    DeviceCapabilities m_capabilities;
+};
+
+} // namespace AudioEngine
+
+#endif // ALSADEVICE_H
@@ -0,0 +1,103 @@
+#include "filedevice.h"
+#include <sstream>
+
+namespace AudioEngine {
+
+FileDevice::FileDevice(const std::string& path, const WavFormat& format, bool isInput,
+                       uint64_t frameCount)
+    : m_path(path)
+    , m_format(format)
+    , m_isInput(isInput)
+    , m_frameCount(frameCount)
+{
+}
+
+std::string FileDevice::getId() const {
+    // Paths are unique: backend-type_path
+    std::stringstream ss;
+    ss << static_cast<int>(BackendType::File) << "_" << m_path;
+    return ss.str();
+}
+
+std::string FileDevice::getName() const {
+    return m_path;
+}
+
+std::string FileDevice::getVendor() const {
+    return "WAV file";
+}
+
+BackendType FileDevice::getBackendType() const {
+    return BackendType::File;
+}
+
+DeviceCapabilities FileDevice::getCapabilities() const {
+    DeviceCapabilities caps{};
+    caps.supportedSampleRates = {static_cast<unsigned int>(m_format.sampleRate)};
+    caps.supportedFormats = {m_format.format};
+    caps.maxInputChannels = m_isInput ? m_format.channels : 0;
+    caps.maxOutputChannels = m_isInput ? 0 : m_format.channels;
+    caps.supportsInput = m_isInput;
+    caps.supportsOutput = !m_isInput;
+    caps.supportsDuplex = false;
+    caps.minLatencyMs = 0.0;
+    caps.maxLatencyMs = 0.0;
+    caps.isDefaultInput = m_isInput;
+    caps.isDefaultOutput = !m_isInput;
+    return caps;
+}
+
+bool FileDevice::isAvailable() const {
+    return true;
+}
+
+bool FileDevice::isDefaultInput() const {
+    return m_isInput;
+}
+
+bool FileDevice::isDefaultOutput() const {
+    return !m_isInput;
+}
+
+bool FileDevice::supportsSampleRate(int rate) const {
+    return rate == m_format.sampleRate;
+}
+
+bool FileDevice::supportsBufferSize(int size) const {
+    // Any period works, there is no hardware behind it
+    return size > 0;
+}
+
+bool FileDevice::supportsFormat(SampleFormat format) const {
+    // Input is converted on read; output can be written in any format
+    return m_isInput ? format == m_format.format : true;
+}
+
+double FileDevice::getDefaultInputLatencyMs() const {
+    return 0.0;
+}
+
+double FileDevice::getDefaultOutputLatencyMs() const {
+    return 0.0;
+}
+
+bool FileDevice::operator==(const IAudioDevice& other) const {
+    const FileDevice* otherFile = dynamic_cast<const FileDevice*>(&other);
+    if (!otherFile) return false;
+    return m_path == otherFile->m_path && m_isInput == otherFile->m_isInput;
+}
+
+bool FileDevice::operator!=(const IAudioDevice& other) const {
+    return !(*this == other);
+}
+
+std::string FileDevice::toString() const {
+    std::stringstream ss;
+    ss << "FileDevice: " << m_path
+       << " (" << (m_isInput ? "In: " : "Out: ") << m_format.channels
+       << ", " << m_format.sampleRate << " Hz"
+       << ", " << m_frameCount << " frames)";
+    return ss.str();
+}
+
+} // namespace AudioEngine
@@ -0,0 +1,58 @@
+#ifndef FILEDEVICE_H
+#define FILEDEVICE_H
+#include "../common/audiodevice.h"
+#include "../io/wavfile.h"
+namespace AudioEngine {
+
+
+class FileDevice : public IAudioDevice {
+public:
+    // Constructor from a WAV path; the file is a capture source or a
+    // playback sink, never both
+    FileDevice(const std::string& path, const WavFormat& format, bool isInput,
+               uint64_t frameCount);
+
+    // Device identification
+    std::string getId() const override;
+    std::string getName() const override;
+    std::string getVendor() const override;
+    BackendType getBackendType() const override;
+
+    // Capabilities
+    DeviceCapabilities getCapabilities() const override;
+
+    // Status
+    bool isAvailable() const override;
+    bool isDefaultInput() const override;
+    bool isDefaultOutput() const override;
+
+    // Format queries
+    bool supportsSampleRate(int rate) const override;
+    bool supportsBufferSize(int size) const override;
+    bool supportsFormat(SampleFormat format) const override;
+
+    // Latency information
+    double getDefaultInputLatencyMs() const override;
+    double getDefaultOutputLatencyMs() const override;
+
+    // Comparison
+    bool operator==(const IAudioDevice& other) const override;
+    bool operator!=(const IAudioDevice& other) const override;
+
+    // String representation
+    std::string toString() const override;
+
+    // File-specific accessors
+    const std::string& getPath() const { return m_path; }
+    uint64_t getFrameCount() const { return m_frameCount; }
+
+private:
+    std::string m_path;
+    WavFormat m_format;
+    bool m_isInput;
+    uint64_t m_frameCount;
+};
+
+} // namespace AudioEngine
+
+#endif // FILEDEVICE_H
@@ -0,0 +1,156 @@
+#include "jackdevice.h"
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+namespace AudioEngine {
+
+JackDevice::JackDevice(const std::string& clientName, std::vector<std::string> capturePorts,
+                       std::vector<std::string> playbackPorts, unsigned int sampleRate,
+                       int bufferSize, bool isPhysical)
+    : m_clientName(clientName)
+    , m_capturePorts(std::move(capturePorts))
+    , m_playbackPorts(std::move(playbackPorts))
+    , m_sampleRate(sampleRate)
+    , m_bufferSize(bufferSize)
+    , m_isPhysical(isPhysical)
+{
+}
+
+std::vector<std::unique_ptr<IAudioDevice>> JackDevice::enumerate(jack_client_t* client) {
+    std::vector<std::unique_ptr<IAudioDevice>> devices;
+    if (!client) {
+        return devices;
+    }
+
+    struct Ports {
+        std::vector<std::string> capture;
+        std::vector<std::string> playback;
+        bool physical = false;
+    };
+    std::map<std::string, Ports> clients;
+    const std::string self = jack_get_client_name(client);
+
+    // Output ports are our capture sources, input ports our playback sinks
+    for (unsigned long direction : {static_cast<unsigned long>(JackPortIsOutput),
+                                    static_cast<unsigned long>(JackPortIsInput)}) {
+        const char** names = jack_get_ports(client, nullptr, JACK_DEFAULT_AUDIO_TYPE, direction);
+        if (!names) continue;
+
+        for (const char** name = names; *name; ++name) {
+            std::string port = *name;
+            std::string owner = port.substr(0, port.find(':'));
+            if (owner == self) continue;
+
+            Ports& ports = clients[owner];
+            (direction == JackPortIsOutput ? ports.capture : ports.playback).push_back(port);
+
+            jack_port_t* handle = jack_port_by_name(client, *name);
+            if (handle && (jack_port_flags(handle) & JackPortIsPhysical)) {
+                ports.physical = true;
+            }
+        }
+        jack_free(names);
+    }
+
+    const unsigned int rate = jack_get_sample_rate(client);
+    const int period = static_cast<int>(jack_get_buffer_size(client));
+    for (auto& entry : clients) {
+        devices.push_back(std::make_unique<JackDevice>(
+            entry.first, std::move(entry.second.capture), std::move(entry.second.playback),
+            rate, period, entry.second.physical));
+    }
+    return devices;
+}
+
+std::string JackDevice::getId() const {
+    // Client names are unique on a server: backend-type_client-name
+    std::stringstream ss;
+    ss << static_cast<int>(BackendType::JACK) << "_" << m_clientName;
+    return ss.str();
+}
+
+std::string JackDevice::getName() const {
+    return m_clientName;
+}
+
+std::string JackDevice::getVendor() const {
+    return m_isPhysical ? "JACK hardware" : "JACK client";
+}
+
+BackendType JackDevice::getBackendType() const {
+    return BackendType::JACK;
+}
+
+DeviceCapabilities JackDevice::getCapabilities() const {
+    DeviceCapabilities caps{};
+    caps.supportedSampleRates = {m_sampleRate};
+    caps.supportedBufferSizes = {m_bufferSize};
+    caps.supportedFormats = {SampleFormat::Float32};
+    caps.maxInputChannels = static_cast<int>(m_capturePorts.size());
+    caps.maxOutputChannels = static_cast<int>(m_playbackPorts.size());
+    caps.supportsInput = !m_capturePorts.empty();
+    caps.supportsOutput = !m_playbackPorts.empty();
+    caps.supportsDuplex = caps.supportsInput && caps.supportsOutput;
+    caps.minLatencyMs = (m_bufferSize * 1000.0) / std::max(1u, m_sampleRate);
+    caps.maxLatencyMs = caps.minLatencyMs;
+    caps.isDefaultInput = isDefaultInput();
+    caps.isDefaultOutput = isDefaultOutput();
+    return caps;
+}
+
+bool JackDevice::isAvailable() const {
+    // Ports were live when the device was enumerated
+    return true;
+}
+
+bool JackDevice::isDefaultInput() const {
+    return m_isPhysical && !m_capturePorts.empty();
+}
+
+bool JackDevice::isDefaultOutput() const {
+    return m_isPhysical && !m_playbackPorts.empty();
+}
+
+bool JackDevice::supportsSampleRate(int rate) const {
+    return static_cast<unsigned int>(rate) == m_sampleRate;
+}
+
+bool JackDevice::supportsBufferSize(int size) const {
+    // The server can be asked to change period, but only to a power of two
+    return size > 0 && (size & (size - 1)) == 0;
+}
+
+bool JackDevice::supportsFormat(SampleFormat format) const {
+    return format == SampleFormat::Float32;
+}
+
+double JackDevice::getDefaultInputLatencyMs() const {
+    return m_capturePorts.empty() ? 0.0 : (m_bufferSize * 1000.0) / std::max(1u, m_sampleRate);
+}
+
+double JackDevice::getDefaultOutputLatencyMs() const {
+    return m_playbackPorts.empty() ? 0.0 : (m_bufferSize * 1000.0) / std::max(1u, m_sampleRate);
+}
+
+bool JackDevice::operator==(const IAudioDevice& other) const {
+    const JackDevice* otherJack = dynamic_cast<const JackDevice*>(&other);
+    if (!otherJack) return false;
+    return m_clientName == otherJack->m_clientName;
+}
+
+bool JackDevice::operator!=(const IAudioDevice& other) const {
+    return !(*this == other);
+}
+
+std::string JackDevice::toString() const {
+    std::stringstream ss;
+    ss << "JackDevice: " << m_clientName
+       << " (In: " << m_capturePorts.size()
+       << ", Out: " << m_playbackPorts.size()
+       << (m_isPhysical ? ", physical" : "")
+       << ")";
+    return ss.str();
+}
+
+} // namespace AudioEngine
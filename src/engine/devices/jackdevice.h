@@ -0,0 +1,65 @@
+#ifndef JACKDEVICE_H
+#define JACKDEVICE_H
+#include "../common/audiodevice.h"
+#include <jack/jack.h>
+namespace AudioEngine {
+
+
+class JackDevice : public IAudioDevice {
+public:
+    // Constructor from a JACK client name and the ports it exposes to us
+    JackDevice(const std::string& clientName, std::vector<std::string> capturePorts,
+               std::vector<std::string> playbackPorts, unsigned int sampleRate,
+               int bufferSize, bool isPhysical);
+
+    // Device identification
+    std::string getId() const override;
+    std::string getName() const override;
+    std::string getVendor() const override;
+    BackendType getBackendType() const override;
+
+    // Capabilities
+    DeviceCapabilities getCapabilities() const override;
+
+    // Status
+    bool isAvailable() const override;
+    bool isDefaultInput() const override;
+    bool isDefaultOutput() const override;
+
+    // Format queries
+    bool supportsSampleRate(int rate) const override;
+    bool supportsBufferSize(int size) const override;
+    bool supportsFormat(SampleFormat format) const override;
+
+    // Latency information
+    double getDefaultInputLatencyMs() const override;
+    double getDefaultOutputLatencyMs() const override;
+
+    // Comparison
+    bool operator==(const IAudioDevice& other) const override;
+    bool operator!=(const IAudioDevice& other) const override;
+
+    // String representation
+    std::string toString() const override;
+
+    // JACK-specific accessors
+    // Full port names ("client:port") we read from and write to
+    const std::vector<std::string>& getCapturePorts() const { return m_capturePorts; }
+    const std::vector<std::string>& getPlaybackPorts() const { return m_playbackPorts; }
+
+    // Group every audio port on the server by owning client.
+    // The server runs one rate and period, so every device reports the same.
+    static std::vector<std::unique_ptr<IAudioDevice>> enumerate(jack_client_t* client);
+
+private:
+    std::string m_clientName;
+    std::vector<std::string> m_capturePorts;   // Ports that output audio to us
+    std::vector<std::string> m_playbackPorts;  // Ports that accept audio from us
+    unsigned int m_sampleRate;
+    int m_bufferSize;
+    bool m_isPhysical;
+};
+
+} // namespace AudioEngine
+
+#endif // JACKDEVICE_H
@@ -0,0 +1,357 @@
+#include "biquadbank.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define CADENCE_BIQUAD_SSE 1
+#endif
+
+namespace AudioEngine {
+
+namespace {
+
+struct Design {
+    double cosW;
+    double alpha;
+};
+
+Design design(double sampleRate, double frequency, double q) {
+    const double nyquistGuard = 0.49 * sampleRate;
+    const double f = std::clamp(frequency, 1.0, nyquistGuard);
+    const double w0 = 2.0 * M_PI * f / sampleRate;
+    return {std::cos(w0), std::sin(w0) / (2.0 * std::max(q, 1e-3))};
+}
+
+BiquadCoefficients normalize(double b0, double b1, double b2, double a0, double a1, double a2) {
+    BiquadCoefficients c;
+    c.b0 = static_cast<float>(b0 / a0);
+    c.b1 = static_cast<float>(b1 / a0);
+    c.b2 = static_cast<float>(b2 / a0);
+    c.a1 = static_cast<float>(a1 / a0);
+    c.a2 = static_cast<float>(a2 / a0);
+    return c;
+}
+
+}
+
+// ===== Designs =====
+
+BiquadCoefficients BiquadCoefficients::lowPass(double sampleRate, double frequency, double q) {
+    const Design d = design(sampleRate, frequency, q);
+    return normalize((1.0 - d.cosW) / 2.0, 1.0 - d.cosW, (1.0 - d.cosW) / 2.0,
+                     1.0 + d.alpha, -2.0 * d.cosW, 1.0 - d.alpha);
+}
+
+BiquadCoefficients BiquadCoefficients::highPass(double sampleRate, double frequency, double q) {
+    const Design d = design(sampleRate, frequency, q);
+    return normalize((1.0 + d.cosW) / 2.0, -(1.0 + d.cosW), (1.0 + d.cosW) / 2.0,
+                     1.0 + d.alpha, -2.0 * d.cosW, 1.0 - d.alpha);
+}
+
+BiquadCoefficients BiquadCoefficients::bandPass(double sampleRate, double frequency, double q) {
+    // Constant 0 dB peak gain
+    const Design d = design(sampleRate, frequency, q);
+    return normalize(d.alpha, 0.0, -d.alpha, 1.0 + d.alpha, -2.0 * d.cosW, 1.0 - d.alpha);
+}
+
+BiquadCoefficients BiquadCoefficients::notch(double sampleRate, double frequency, double q) {
+    const Design d = design(sampleRate, frequency, q);
+    return normalize(1.0, -2.0 * d.cosW, 1.0, 1.0 + d.alpha, -2.0 * d.cosW, 1.0 - d.alpha);
+}
+
+BiquadCoefficients BiquadCoefficients::peaking(double sampleRate, double frequency, double q,
+                                               double gainDb) {
+    const Design d = design(sampleRate, frequency, q);
+    const double A = std::pow(10.0, gainDb / 40.0);
+    return normalize(1.0 + d.alpha * A, -2.0 * d.cosW, 1.0 - d.alpha * A,
+                     1.0 + d.alpha / A, -2.0 * d.cosW, 1.0 - d.alpha / A);
+}
+
+BiquadCoefficients BiquadCoefficients::lowShelf(double sampleRate, double frequency, double q,
+                                                double gainDb) {
+    const Design d = design(sampleRate, frequency, q);
+    const double A = std::pow(10.0, gainDb / 40.0);
+    const double k = 2.0 * std::sqrt(A) * d.alpha;
+    return normalize(A * ((A + 1.0) - (A - 1.0) * d.cosW + k),
+                     2.0 * A * ((A - 1.0) - (A + 1.0) * d.cosW),
+                     A * ((A + 1.0) - (A - 1.0) * d.cosW - k),
+                     (A + 1.0) + (A - 1.0) * d.cosW + k,
+                     -2.0 * ((A - 1.0) + (A + 1.0) * d.cosW),
+                     (A + 1.0) + (A - 1.0) * d.cosW - k);
+}
+
+BiquadCoefficients BiquadCoefficients::highShelf(double sampleRate, double frequency, double q,
+                                                 double gainDb) {
+    const Design d = design(sampleRate, frequency, q);
+    const double A = std::pow(10.0, gainDb / 40.0);
+    const double k = 2.0 * std::sqrt(A) * d.alpha;
+    return normalize(A * ((A + 1.0) + (A - 1.0) * d.cosW + k),
+                     -2.0 * A * ((A - 1.0) + (A + 1.0) * d.cosW),
+                     A * ((A + 1.0) + (A - 1.0) * d.cosW - k),
+                     (A + 1.0) - (A - 1.0) * d.cosW + k,
+                     2.0 * ((A - 1.0) - (A + 1.0) * d.cosW),
+                     (A + 1.0) - (A - 1.0) * d.cosW - k);
+}
+
+double BiquadCoefficients::magnitude(double sampleRate, double frequency) const {
+    const double w = 2.0 * M_PI * frequency / sampleRate;
+    const std::complex<double> z1 = std::polar(1.0, -w);
+    const std::complex<double> z2 = z1 * z1;
+    const std::complex<double> num = static_cast<double>(b0) + static_cast<double>(b1) * z1 +
+                                     static_cast<double>(b2) * z2;
+    const std::complex<double> den = 1.0 + static_cast<double>(a1) * z1 + static_cast<double>(a2) * z2;
+    return std::abs(num / den);
+}
+
+// ===== Bank =====
+
+BiquadBank::BiquadBank(int channels, int stages, int rampFrames) {
+    configure(channels, stages, rampFrames);
+}
+
+void BiquadBank::configure(int channels, int stages, int rampFrames) {
+    m_channels = std::max(0, channels);
+    m_stages = std::max(0, stages);
+    m_groups = (m_channels + kLanes - 1) / kLanes;
+    m_rampFrames = std::max(0, rampFrames);
+
+    StageLanes passThrough{};
+    for (int lane = 0; lane < kLanes; ++lane) {
+        passThrough.current[B0][lane] = 1.0f;
+        passThrough.target[B0][lane] = 1.0f;
+    }
+    m_lanes.assign(static_cast<size_t>(m_groups) * m_stages, passThrough);
+}
+
+BiquadBank::StageLanes& BiquadBank::stageFor(int channel, int stage) {
+    return m_lanes[static_cast<size_t>(channel / kLanes) * m_stages + stage];
+}
+
+void BiquadBank::startRamp(StageLanes& lanes) {
+    // Every lane of the group finishes together, over a full ramp from here
+    const float inverse = 1.0f / static_cast<float>(m_rampFrames);
+    for (int k = 0; k < kCoefficientCount; ++k) {
+        for (int lane = 0; lane < kLanes; ++lane) {
+            lanes.step[k][lane] = (lanes.target[k][lane] - lanes.current[k][lane]) * inverse;
+        }
+    }
+    lanes.rampRemaining = m_rampFrames;
+}
+
+void BiquadBank::setCoefficients(int channel, int stage, const BiquadCoefficients& coefficients) {
+    if (channel < 0 || channel >= m_channels || stage < 0 || stage >= m_stages) {
+        return;
+    }
+    if (m_rampFrames == 0) {
+        setCoefficientsImmediate(channel, stage, coefficients);
+        return;
+    }
+
+    StageLanes& lanes = stageFor(channel, stage);
+    const int lane = channel % kLanes;
+    lanes.target[B0][lane] = coefficients.b0;
+    lanes.target[B1][lane] = coefficients.b1;
+    lanes.target[B2][lane] = coefficients.b2;
+    lanes.target[A1][lane] = coefficients.a1;
+    lanes.target[A2][lane] = coefficients.a2;
+    startRamp(lanes);
+}
+
+void BiquadBank::setCoefficientsImmediate(int channel, int stage,
+                                          const BiquadCoefficients& coefficients) {
+    if (channel < 0 || channel >= m_channels || stage < 0 || stage >= m_stages) {
+        return;
+    }
+
+    StageLanes& lanes = stageFor(channel, stage);
+    const int lane = channel % kLanes;
+    const float values[kCoefficientCount] = {coefficients.b0, coefficients.b1, coefficients.b2,
+                                             coefficients.a1, coefficients.a2};
+    for (int k = 0; k < kCoefficientCount; ++k) {
+        lanes.current[k][lane] = values[k];
+        lanes.target[k][lane] = values[k];
+    }
+
+    // Other lanes may still be mid-ramp; restart theirs from where they are
+    if (lanes.rampRemaining > 0) {
+        startRamp(lanes);
+    }
+}
+
+void BiquadBank::reset() {
+    for (StageLanes& lanes : m_lanes) {
+        std::fill(std::begin(lanes.s1), std::end(lanes.s1), 0.0f);
+        std::fill(std::begin(lanes.s2), std::end(lanes.s2), 0.0f);
+    }
+}
+
+void BiquadBank::process(float* const* channels, size_t frames) {
+#if defined(CADENCE_BIQUAD_SSE)
+    processGroups<true>(channels, frames);
+#else
+    processGroups<false>(channels, frames);
+#endif
+}
+
+void BiquadBank::processScalar(float* const* channels, size_t frames) {
+    processGroups<false>(channels, frames);
+}
+
+template <bool Simd>
+void BiquadBank::processGroups(float* const* channels, size_t frames) {
+    if (!channels || m_stages == 0) {
+        return;
+    }
+
+    for (int group = 0; group < m_groups; ++group) {
+        float* lanesIn[kLanes] = {};
+        for (int lane = 0; lane < kLanes; ++lane) {
+            const int channel = group * kLanes + lane;
+            lanesIn[lane] = channel < m_channels ? channels[channel] : nullptr;
+        }
+        StageLanes* stages = &m_lanes[static_cast<size_t>(group) * m_stages];
+
+        for (size_t offset = 0; offset < frames; offset += kBlockFrames) {
+            const size_t count = std::min(kBlockFrames, frames - offset);
+
+            // Interleave: one frame of the group per vector
+            for (int lane = 0; lane < kLanes; ++lane) {
+                const float* src = lanesIn[lane] ? lanesIn[lane] + offset : nullptr;
+                float* dst = m_scratch + lane;
+                for (size_t i = 0; i < count; ++i, dst += kLanes) {
+                    *dst = src ? src[i] : 0.0f;
+                }
+            }
+
+            for (int stage = 0; stage < m_stages; ++stage) {
+                if (Simd) {
+                    runStageSimd(stages[stage], m_scratch, count);
+                } else {
+                    runStageScalar(stages[stage], m_scratch, count);
+                }
+            }
+
+            for (int lane = 0; lane < kLanes; ++lane) {
+                if (!lanesIn[lane]) {
+                    continue;
+                }
+                float* dst = lanesIn[lane] + offset;
+                const float* src = m_scratch + lane;
+                for (size_t i = 0; i < count; ++i, src += kLanes) {
+                    dst[i] = *src;
+                }
+            }
+        }
+    }
+}
+
+void BiquadBank::runStageScalar(StageLanes& lanes, float* data, size_t frames) {
+    size_t i = 0;
+
+    if (lanes.rampRemaining > 0) {
+        const size_t ramp = std::min(frames, static_cast<size_t>(lanes.rampRemaining));
+        for (; i < ramp; ++i) {
+            float* x = data + i * kLanes;
+            for (int lane = 0; lane < kLanes; ++lane) {
+                for (int k = 0; k < kCoefficientCount; ++k) {
+                    lanes.current[k][lane] += lanes.step[k][lane];
+                }
+                const float y = lanes.current[B0][lane] * x[lane] + lanes.s1[lane];
+                lanes.s1[lane] = lanes.current[B1][lane] * x[lane] - lanes.current[A1][lane] * y + lanes.s2[lane];
+                lanes.s2[lane] = lanes.current[B2][lane] * x[lane] - lanes.current[A2][lane] * y;
+                x[lane] = y;
+            }
+        }
+        lanes.rampRemaining -= static_cast<int>(ramp);
+        if (lanes.rampRemaining == 0) {
+            std::memcpy(lanes.current, lanes.target, sizeof(lanes.current));
+        }
+    }
+
+    for (; i < frames; ++i) {
+        float* x = data + i * kLanes;
+        for (int lane = 0; lane < kLanes; ++lane) {
+            const float y = lanes.current[B0][lane] * x[lane] + lanes.s1[lane];
+            lanes.s1[lane] = lanes.current[B1][lane] * x[lane] - lanes.current[A1][lane] * y + lanes.s2[lane];
+            lanes.s2[lane] = lanes.current[B2][lane] * x[lane] - lanes.current[A2][lane] * y;
+            x[lane] = y;
+        }
+    }
+}
+
+#if defined(CADENCE_BIQUAD_SSE)
+
+void BiquadBank::runStageSimd(StageLanes& lanes, float* data, size_t frames) {
+    __m128 s1 = _mm_load_ps(lanes.s1);
+    __m128 s2 = _mm_load_ps(lanes.s2);
+    size_t i = 0;
+
+    if (lanes.rampRemaining > 0) {
+        __m128 b0 = _mm_load_ps(lanes.current[B0]);
+        __m128 b1 = _mm_load_ps(lanes.current[B1]);
+        __m128 b2 = _mm_load_ps(lanes.current[B2]);
+        __m128 a1 = _mm_load_ps(lanes.current[A1]);
+        __m128 a2 = _mm_load_ps(lanes.current[A2]);
+        const __m128 db0 = _mm_load_ps(lanes.step[B0]);
+        const __m128 db1 = _mm_load_ps(lanes.step[B1]);
+        const __m128 db2 = _mm_load_ps(lanes.step[B2]);
+        const __m128 da1 = _mm_load_ps(lanes.step[A1]);
+        const __m128 da2 = _mm_load_ps(lanes.step[A2]);
+
+        const size_t ramp = std::min(frames, static_cast<size_t>(lanes.rampRemaining));
+        for (; i < ramp; ++i) {
+            b0 = _mm_add_ps(b0, db0);
+            b1 = _mm_add_ps(b1, db1);
+            b2 = _mm_add_ps(b2, db2);
+            a1 = _mm_add_ps(a1, da1);
+            a2 = _mm_add_ps(a2, da2);
+
+            const __m128 x = _mm_load_ps(data + i * kLanes);
+            const __m128 y = _mm_add_ps(_mm_mul_ps(b0, x), s1);
+            s1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), s2);
+            s2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+            _mm_store_ps(data + i * kLanes, y);
+        }
+
+        lanes.rampRemaining -= static_cast<int>(ramp);
+        if (lanes.rampRemaining == 0) {
+            std::memcpy(lanes.current, lanes.target, sizeof(lanes.current));
+        } else {
+            _mm_store_ps(lanes.current[B0], b0);
+            _mm_store_ps(lanes.current[B1], b1);
+            _mm_store_ps(lanes.current[B2], b2);
+            _mm_store_ps(lanes.current[A1], a1);
+            _mm_store_ps(lanes.current[A2], a2);
+        }
+    }
+
+    const __m128 b0 = _mm_load_ps(lanes.current[B0]);
+    const __m128 b1 = _mm_load_ps(lanes.current[B1]);
+    const __m128 b2 = _mm_load_ps(lanes.current[B2]);
+    const __m128 a1 = _mm_load_ps(lanes.current[A1]);
+    const __m128 a2 = _mm_load_ps(lanes.current[A2]);
+
+    for (; i < frames; ++i) {
+        const __m128 x = _mm_load_ps(data + i * kLanes);
+        const __m128 y = _mm_add_ps(_mm_mul_ps(b0, x), s1);
+        s1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), s2);
+        s2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+        _mm_store_ps(data + i * kLanes, y);
+    }
+
+    _mm_store_ps(lanes.s1, s1);
+    _mm_store_ps(lanes.s2, s2);
+}
+
+#else
+
+void BiquadBank::runStageSimd(StageLanes& lanes, float* data, size_t frames) {
+    runStageScalar(lanes, data, frames);
+}
+
+#endif
+
+} // namespace AudioEngine
@@ -0,0 +1,105 @@
+#ifndef BIQUADBANK_H
+#define BIQUADBANK_H
+
+#include <cstddef>
+#include <vector>
+
+namespace AudioEngine {
+
+// Normalized biquad coefficients (a0 = 1)
+// Designs follow the RBJ Audio EQ Cookbook; frequencies are clamped below Nyquist.
+struct BiquadCoefficients {
+    float b0 = 1.0f;
+    float b1 = 0.0f;
+    float b2 = 0.0f;
+    float a1 = 0.0f;
+    float a2 = 0.0f;
+
+    static BiquadCoefficients lowPass(double sampleRate, double frequency, double q);
+    static BiquadCoefficients highPass(double sampleRate, double frequency, double q);
+    static BiquadCoefficients bandPass(double sampleRate, double frequency, double q);
+    static BiquadCoefficients notch(double sampleRate, double frequency, double q);
+    static BiquadCoefficients peaking(double sampleRate, double frequency, double q, double gainDb);
+    static BiquadCoefficients lowShelf(double sampleRate, double frequency, double q, double gainDb);
+    static BiquadCoefficients highShelf(double sampleRate, double frequency, double q, double gainDb);
+
+    // Magnitude response at a frequency, for UI curves and tests
+    double magnitude(double sampleRate, double frequency) const;
+};
+
+// Cascaded biquads for many channels at once
+// Each channel runs its own cascade of stages (transposed direct form II).
+// Channels are grouped kLanes at a time and a group's samples are interleaved
+// into one SIMD vector per frame, so four channel strips cost roughly what one
+// does. To run several independent filters on one signal, feed it to several
+// channels.
+// Coefficient changes ramp linearly over rampFrames samples. The stability
+// region of (a1, a2) is convex, so every intermediate filter is stable and
+// sweeps are free of zipper noise.
+class BiquadBank {
+public:
+    static constexpr int kLanes = 4;
+    static constexpr size_t kBlockFrames = 256;   // Frames interleaved at a time
+
+    BiquadBank() = default;
+    BiquadBank(int channels, int stages, int rampFrames = 64);
+
+    // ===== Control Thread (audio thread not processing) =====
+
+    // Size for channels x stages; every stage starts as a pass-through
+    void configure(int channels, int stages, int rampFrames = 64);
+
+    int channelCount() const { return m_channels; }
+    int stageCount() const { return m_stages; }
+
+    // ===== Audio Thread =====
+
+    // Glide a stage to new coefficients over rampFrames samples
+    void setCoefficients(int channel, int stage, const BiquadCoefficients& coefficients);
+
+    // Jump straight to new coefficients (setup, or after reset())
+    void setCoefficientsImmediate(int channel, int stage, const BiquadCoefficients& coefficients);
+
+    // Clear filter memory on every channel
+    void reset();
+
+    // Filter each channel in place through its cascade (null channels are skipped)
+    void process(float* const* channels, size_t frames);
+
+    // Same filtering with a portable per-lane loop; reference for tests and benchmarks
+    void processScalar(float* const* channels, size_t frames);
+
+private:
+    enum Coefficient { B0, B1, B2, A1, A2, kCoefficientCount };
+
+    // One stage for one group of lanes
+    struct alignas(16) StageLanes {
+        float current[kCoefficientCount][kLanes];
+        float target[kCoefficientCount][kLanes];
+        float step[kCoefficientCount][kLanes];
+        float s1[kLanes];
+        float s2[kLanes];
+        int rampRemaining;
+    };
+
+    StageLanes& stageFor(int channel, int stage);
+    void startRamp(StageLanes& lanes);
+
+    template <bool Simd>
+    void processGroups(float* const* channels, size_t frames);
+
+    static void runStageScalar(StageLanes& lanes, float* data, size_t frames);
+    static void runStageSimd(StageLanes& lanes, float* data, size_t frames);
+
+    int m_channels = 0;
+    int m_stages = 0;
+    int m_groups = 0;
+    int m_rampFrames = 64;
+    std::vector<StageLanes> m_lanes;    // [group][stage]
+
+    alignas(16) float m_scratch[kBlockFrames * kLanes];
+};
+
+} // namespace AudioEngine
+
+#endif // BIQUADBANK_H
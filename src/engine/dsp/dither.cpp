@@ -0,0 +1,183 @@
+#include "dither.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CADENCE_DITHER_SSE2 1
+#endif
+
+namespace AudioEngine {
+
+namespace {
+
+// F-weighted error feedback (Wannamaker, 3 taps), newest error first
+constexpr float kShape[3] = {1.623f, -0.982f, 0.109f};
+
+// Keeps the feedback loop bounded when the output clips
+constexpr float kMaxError = 2.0f;
+
+// Two uniform 16-bit draws from one xorshift32 word, summed: triangular in (-1, 1) LSB
+inline float tpdf(uint32_t x) {
+    const int32_t sum = static_cast<int32_t>((x >> 16) + (x & 0xffffu)) - 65535;
+    return static_cast<float>(sum) * (1.0f / 65536.0f);
+}
+
+#if defined(CADENCE_DITHER_SSE2)
+
+inline __m128 tpdf(__m128i x) {
+    const __m128i sum = _mm_sub_epi32(_mm_add_epi32(_mm_srli_epi32(x, 16), _mm_and_si128(x, _mm_set1_epi32(0xffff))),
+                                      _mm_set1_epi32(65535));
+    return _mm_mul_ps(_mm_cvtepi32_ps(sum), _mm_set1_ps(1.0f / 65536.0f));
+}
+
+#endif
+
+}
+
+DitherConverter::DitherConverter(DitherMode mode, uint32_t seed)
+    : m_mode(mode)
+{
+    reset(seed);
+}
+
+void DitherConverter::reset(uint32_t seed) {
+    m_random.reset(seed);
+    std::fill(std::begin(m_error), std::end(m_error), 0.0f);
+}
+
+void DitherConverter::noise(float* out, size_t count) {
+#if defined(CADENCE_DITHER_SSE2)
+    __m128i x = m_random.load();
+    for (size_t i = 0; i < count; i += 4) {
+        x = XorShift4::step(x);
+        _mm_store_ps(out + i, tpdf(x));
+    }
+    m_random.store(x);
+#else
+    for (size_t i = 0; i < count; i += 4) {
+        for (int k = 0; k < 4; ++k) {
+            out[i + k] = tpdf(m_random.next(k));
+        }
+    }
+#endif
+}
+
+// count is a multiple of four
+void DitherConverter::quantize(const float* in, size_t count, float scale, int32_t* out) {
+    if (m_mode == DitherMode::Shaped) {
+        alignas(16) float d[kBlockFrames];
+        noise(d, count);
+        float e0 = m_error[0], e1 = m_error[1], e2 = m_error[2];
+        for (size_t i = 0; i < count; ++i) {
+            const float v = in[i] * scale - (kShape[0] * e0 + kShape[1] * e1 + kShape[2] * e2);
+            const float y = std::nearbyint(std::clamp(v + d[i], -scale, scale));
+            e2 = e1;
+            e1 = e0;
+            e0 = std::clamp(y - v, -kMaxError, kMaxError);
+            out[i] = static_cast<int32_t>(y);
+        }
+        m_error[0] = e0;
+        m_error[1] = e1;
+        m_error[2] = e2;
+        return;
+    }
+
+    const bool dither = m_mode == DitherMode::Triangular;
+#if defined(CADENCE_DITHER_SSE2)
+    const __m128 high = _mm_set1_ps(scale);
+    const __m128 low = _mm_set1_ps(-scale);
+    __m128i x = m_random.load();
+    for (size_t i = 0; i < count; i += 4) {
+        __m128 v = _mm_mul_ps(_mm_loadu_ps(in + i), high);
+        if (dither) {
+            x = XorShift4::step(x);
+            v = _mm_add_ps(v, tpdf(x));
+        }
+        v = _mm_min_ps(_mm_max_ps(v, low), high);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_cvtps_epi32(v));
+    }
+    m_random.store(x);
+#else
+    for (size_t i = 0; i < count; i += 4) {
+        for (int k = 0; k < 4; ++k) {
+            float v = in[i + k] * scale;
+            if (dither) {
+                v += tpdf(m_random.next(k));
+            }
+            out[i + k] = static_cast<int32_t>(std::nearbyint(std::clamp(v, -scale, scale)));
+        }
+    }
+#endif
+}
+
+void DitherConverter::convert(const float* src, size_t srcStride, size_t frames,
+                              SampleFormat format, void* dst, size_t dstStride) {
+    unsigned char* bytes = static_cast<unsigned char*>(dst);
+
+    if (format == SampleFormat::Float32 || format == SampleFormat::Int32) {
+        for (size_t i = 0; i < frames; ++i) {
+            const float sample = src ? src[i * srcStride] : 0.0f;
+            if (format == SampleFormat::Float32) {
+                std::memcpy(bytes + i * dstStride, &sample, sizeof(sample));
+            } else {
+                const float clamped = std::clamp(sample, -1.0f, 1.0f);
+                const int32_t value = static_cast<int32_t>(std::lrint(clamped * 2147483392.0));
+                std::memcpy(bytes + i * dstStride, &value, sizeof(value));
+            }
+        }
+        return;
+    }
+
+    const bool is16 = format == SampleFormat::Int16;
+    const float scale = is16 ? 32767.0f : 8388607.0f;
+    alignas(16) float block[kBlockFrames];
+    alignas(16) int32_t q[kBlockFrames];
+
+    for (size_t offset = 0; offset < frames; offset += kBlockFrames) {
+        const size_t n = std::min(kBlockFrames, frames - offset);
+        const size_t padded = (n + 3) & ~size_t{3};
+
+        // Read in place when possible; otherwise gather into the block
+        const float* in = block;
+        if (src && srcStride == 1 && n == padded) {
+            in = src + offset;
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                block[i] = src ? src[(offset + i) * srcStride] : 0.0f;
+            }
+            std::fill(block + n, block + padded, 0.0f);
+        }
+
+        quantize(in, padded, scale, q);
+
+        unsigned char* out = bytes + offset * dstStride;
+        size_t i = 0;
+        if (is16) {
+#if defined(CADENCE_DITHER_SSE2)
+            if (dstStride == sizeof(int16_t)) {
+                // Values are already clamped, so the saturating pack is exact
+                for (; i + 8 <= n; i += 8) {
+                    const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(q + i));
+                    const __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(q + i + 4));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * sizeof(int16_t)), _mm_packs_epi32(a, b));
+                }
+            }
+#endif
+            for (; i < n; ++i) {
+                const int16_t value = static_cast<int16_t>(q[i]);
+                std::memcpy(out + i * dstStride, &value, sizeof(value));
+            }
+        } else {
+            for (; i < n; ++i) {
+                unsigned char* b = out + i * dstStride;
+                b[0] = q[i] & 0xff;
+                b[1] = (q[i] >> 8) & 0xff;
+                b[2] = (q[i] >> 16) & 0xff;
+            }
+        }
+    }
+}
+
+} // namespace AudioEngine
@@ -0,0 +1,53 @@
+#ifndef DITHER_H
+#define DITHER_H
+
+#include "../common/audioconfig.h"
+#include "xorshift.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace AudioEngine {
+
+// Float to integer sample conversion with the dither fused in
+// Scaling, dither, rounding, clamping and the store happen in one pass over
+// the output, a short block at a time, rather than dithering a float buffer
+// and converting it afterwards. Triangular (TPDF) dither takes two uniform
+// draws per 32-bit word of XorShift4 (shared with NoiseGenerator) and runs
+// four samples per SIMD instruction. Shaped dither adds error feedback
+// through a 3-tap F-weighted filter (Wannamaker), which is sequential per
+// sample; its noise is still generated four lanes at a time.
+// Dither applies to Int16 and Int24. Int32 and Float32 carry more precision
+// than the float samples, so they convert without it.
+// Keep one converter per channel: shaping state and the noise sequence are
+// per channel, and uncorrelated noise across channels stays decorrelated.
+class DitherConverter {
+public:
+    static constexpr size_t kBlockFrames = 64;
+
+    explicit DitherConverter(DitherMode mode = DitherMode::Triangular, uint32_t seed = 1);
+
+    void setMode(DitherMode mode) { m_mode = mode; }
+    DitherMode mode() const { return m_mode; }
+
+    // Clear the shaping filter history and restart the noise from seed
+    void reset(uint32_t seed = 1);
+
+    // ===== Audio Thread =====
+
+    // Convert frames samples, read every srcStride floats (null reads
+    // silence), to format written little-endian every dstStride bytes
+    void convert(const float* src, size_t srcStride, size_t frames,
+                 SampleFormat format, void* dst, size_t dstStride);
+
+private:
+    void quantize(const float* in, size_t count, float scale, int32_t* out);
+    void noise(float* out, size_t count);
+
+    DitherMode m_mode;
+    XorShift4 m_random;
+    float m_error[3] = {};      // Newest first
+};
+
+} // namespace AudioEngine
+
+#endif // DITHER_H
@@ -0,0 +1,200 @@
+#include "driftcompensator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace AudioEngine {
+
+namespace {
+
+// Controller loop: ~0.1 Hz bandwidth, close to critically damped. Slow enough
+// that ratio changes are inaudible, fast enough to settle within seconds.
+constexpr double kLoopBandwidthHz = 0.1;
+constexpr double kLoopDamping = 0.7;
+
+// Catmull-Rom between x0 and x1
+inline float interpolate(float xm1, float x0, float x1, float x2, float t) {
+    const float c1 = 0.5f * (x1 - xm1);
+    const float c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+    const float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+    return ((c3 * t + c2) * t + c1) * t + x0;
+}
+
+}
+
+void DriftCompensator::configure(int channels, int inputRate, int outputRate,
+                                 int inputPeriod, int outputPeriod) {
+    m_channels = std::max(1, channels);
+    m_inputRate = std::max(1, inputRate);
+    m_outputRate = std::max(1, outputRate);
+    m_nominalRatio = m_inputRate / m_outputRate;
+    m_inputPeriodTime = inputPeriod / m_inputRate;
+
+    // Fill swings by one period of each side as the callbacks interleave;
+    // the target leaves half of that swing spare below the consumer's demand
+    const double swing = inputPeriod + outputPeriod * m_nominalRatio;
+    m_targetFill = 1.5 * swing + 8.0;
+
+    // Second-order loop: de/dt = rate * (drift - correction)
+    const double omega = 2.0 * M_PI * kLoopBandwidthHz;
+    const double loopGain = m_outputRate * m_nominalRatio;
+    m_kp = 2.0 * kLoopDamping * omega / loopGain;
+    m_ki = omega * omega / loopGain;
+
+    const size_t capacityFrames = static_cast<size_t>(
+        std::max(4.0 * m_targetFill, 2.0 * swing + kMaxBlockFrames));
+    m_ring = std::make_unique<SpscQueue<float>>(capacityFrames * m_channels);
+
+    const size_t maxConsumed = static_cast<size_t>(
+        kMaxBlockFrames * m_nominalRatio * (1.0 + kMaxCorrection)) + 2;
+    m_staging.assign(maxConsumed * m_channels, 0.0f);
+    m_interleaved.assign(kMaxBlockFrames * m_channels, 0.0f);
+    m_history.assign(4 * static_cast<size_t>(m_channels), 0.0f);
+
+    m_integral = 0.0;
+    m_driftPpm = 0.0;
+    m_underruns = 0;
+    m_overruns = 0;
+    reset();
+}
+
+void DriftCompensator::reset() {
+    if (m_ring) {
+        float discard;
+        while (m_ring->pop(discard)) {}
+    }
+    std::fill(m_history.begin(), m_history.end(), 0.0f);
+    m_phase = 1.0;
+    m_primed = false;
+    m_smoothedFill = m_targetFill;
+    m_lastPushTime = -1.0;
+    m_ratio = m_nominalRatio * (1.0 + m_integral);
+}
+
+bool DriftCompensator::push(const float* const* channels, size_t frames, double time) {
+    if (!m_ring) {
+        return false;
+    }
+    frames = std::min(frames, kMaxBlockFrames);
+
+    // Whole blocks only, so the ring always holds whole frames
+    const size_t samples = frames * m_channels;
+    if (m_ring->capacity() - m_ring->size() < samples) {
+        m_overruns.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    for (int ch = 0; ch < m_channels; ++ch) {
+        const float* src = channels[ch];
+        float* dst = m_interleaved.data() + ch;
+        for (size_t i = 0; i < frames; ++i, dst += m_channels) {
+            *dst = src ? src[i] : 0.0f;
+        }
+    }
+    m_ring->push(m_interleaved.data(), samples);
+    m_lastPushTime.store(time, std::memory_order_release);
+    return true;
+}
+
+double DriftCompensator::measureFill(double time) const {
+    // Read the fill between two reads of the push time so they agree
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        const double before = m_lastPushTime.load(std::memory_order_acquire);
+        const double fill = static_cast<double>(m_ring->size() / m_channels);
+        const double after = m_lastPushTime.load(std::memory_order_acquire);
+        if (before != after) {
+            continue;
+        }
+        if (before < 0.0) {
+            return fill;
+        }
+
+        // Add what the producer has captured but not yet delivered
+        const double pending = std::clamp(time - before, 0.0, 2.0 * m_inputPeriodTime);
+        return fill + pending * m_inputRate;
+    }
+    return static_cast<double>(m_ring->size() / m_channels);
+}
+
+void DriftCompensator::updateController(size_t frames, double fill) {
+    const double dt = frames / m_outputRate;
+
+    // Smooth what jitter in callback timing leaves on the fill
+    const double alpha = dt / (m_fillTimeConstant + dt);
+    m_smoothedFill += alpha * (fill - m_smoothedFill);
+
+    const double error = m_smoothedFill - m_targetFill;
+    m_integral = std::clamp(m_integral + m_ki * error * dt, -kMaxCorrection, kMaxCorrection);
+    const double correction = std::clamp(m_kp * error + m_integral,
+                                         -kMaxCorrection, kMaxCorrection);
+
+    m_ratio.store(m_nominalRatio * (1.0 + correction), std::memory_order_relaxed);
+    m_driftPpm.store(m_integral * 1e6, std::memory_order_relaxed);
+    m_fillEstimate.store(m_smoothedFill, std::memory_order_relaxed);
+}
+
+bool DriftCompensator::pull(float* const* channels, size_t frames, double time) {
+    frames = std::min(frames, kMaxBlockFrames);
+    const size_t fill = m_ring ? m_ring->size() / m_channels : 0;
+
+    auto silence = [&] {
+        for (int ch = 0; ch < m_channels; ++ch) {
+            std::memset(channels[ch], 0, frames * sizeof(float));
+        }
+    };
+
+    // Hold off until the ring reaches its working level
+    if (!m_primed) {
+        if (fill < m_targetFill) {
+            silence();
+            return false;
+        }
+        m_primed = true;
+        m_smoothedFill = measureFill(time);
+    }
+
+    updateController(frames, measureFill(time));
+    const double ratio = m_ratio.load(std::memory_order_relaxed);
+
+    // Same phase arithmetic as below, to pop exactly what will be consumed
+    size_t consume = 0;
+    double phase = m_phase;
+    for (size_t i = 0; i < frames; ++i) {
+        while (phase >= 1.0) {
+            phase -= 1.0;
+            ++consume;
+        }
+        phase += ratio;
+    }
+
+    if (consume > fill) {
+        m_underruns.fetch_add(1, std::memory_order_relaxed);
+        m_primed = false;
+        silence();
+        return false;
+    }
+    m_ring->pop(m_staging.data(), consume * m_channels);
+
+    const size_t stride = static_cast<size_t>(m_channels);
+    float* const xm1 = m_history.data();
+    const float* next = m_staging.data();
+    for (size_t i = 0; i < frames; ++i) {
+        while (m_phase >= 1.0) {
+            m_phase -= 1.0;
+            std::memmove(xm1, xm1 + stride, 3 * stride * sizeof(float));
+            std::memcpy(xm1 + 3 * stride, next, stride * sizeof(float));
+            next += stride;
+        }
+
+        const float t = static_cast<float>(m_phase);
+        for (size_t ch = 0; ch < stride; ++ch) {
+            channels[ch][i] = interpolate(xm1[ch], xm1[stride + ch],
+                                          xm1[2 * stride + ch], xm1[3 * stride + ch], t);
+        }
+        m_phase += ratio;
+    }
+
+    return true;
+}
+
+} // namespace AudioEngine
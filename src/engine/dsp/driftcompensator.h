@@ -0,0 +1,102 @@
+#ifndef DRIFTCOMPENSATOR_H
+#define DRIFTCOMPENSATOR_H
+
+#include "../realtime/spscqueue.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace AudioEngine {
+
+// Bridges audio between two devices on independent clocks
+// The producer (follower device's audio thread) pushes captured frames into a
+// lock-free ring; the consumer (clock master's audio thread) pulls exactly the
+// frames it needs through a cubic resampler. A PI controller on the ring fill
+// steers the resampling ratio, so the fill, and with it the added latency,
+// settles at a fixed target whatever the drift between the clocks. The
+// controller's integral term converges on the drift itself.
+// Both sides pass a timestamp from a shared monotonic clock. The fill is
+// corrected by the frames the producer has captured since its last push, which
+// removes the sawtooth its period leaves and the slow beat between the two
+// period sizes that would otherwise leak into the ratio.
+class DriftCompensator {
+public:
+    DriftCompensator() = default;
+
+    // ===== Control Thread (neither side running) =====
+
+    // Size the ring and tune the controller for the two streams
+    void configure(int channels, int inputRate, int outputRate,
+                   int inputPeriod, int outputPeriod);
+
+    // Drop buffered audio and re-prime; keeps the drift estimate
+    void reset();
+
+    // ===== Producer Thread =====
+
+    // Queue captured frames; false if the ring was full and they were dropped.
+    // time: seconds on the clock both sides use
+    bool push(const float* const* channels, size_t frames, double time);
+
+    // ===== Consumer Thread =====
+
+    // Produce frames at the output rate; false (and silence) while priming
+    // or after an underrun
+    bool pull(float* const* channels, size_t frames, double time);
+
+    // ===== Any Thread =====
+
+    double getRatio() const { return m_ratio.load(std::memory_order_relaxed); }
+    double getDriftPpm() const { return m_driftPpm.load(std::memory_order_relaxed); }
+    double getTargetLatencyFrames() const { return m_targetFill; }
+    double getFillFrames() const { return m_fillEstimate.load(std::memory_order_relaxed); }
+    int getUnderrunCount() const { return m_underruns.load(std::memory_order_relaxed); }
+    int getOverrunCount() const { return m_overruns.load(std::memory_order_relaxed); }
+
+    // Most frames a single push or pull may carry
+    static constexpr size_t kMaxBlockFrames = 8192;
+
+    // Steering range around the nominal ratio
+    static constexpr double kMaxCorrection = 0.005;
+
+private:
+    double measureFill(double time) const;
+    void updateController(size_t frames, double fill);
+
+    int m_channels = 0;
+    double m_nominalRatio = 1.0;   // Input frames per output frame
+    double m_targetFill = 0.0;     // Frames
+    double m_inputRate = 48000.0;
+    double m_outputRate = 48000.0;
+    double m_inputPeriodTime = 0.0;  // Seconds
+
+    // Controller gains and state (consumer thread)
+    double m_kp = 0.0;
+    double m_ki = 0.0;
+    double m_integral = 0.0;
+    double m_smoothedFill = 0.0;
+    double m_fillTimeConstant = 0.25;  // Seconds
+
+    // Resampler state (consumer thread)
+    std::vector<float> m_history;  // 4 frames, interleaved: x[-1], x[0], x[1], x[2]
+    std::vector<float> m_staging;  // Interleaved input for one pull
+    double m_phase = 1.0;
+    bool m_primed = false;
+
+    // Producer scratch
+    std::vector<float> m_interleaved;
+
+    std::unique_ptr<SpscQueue<float>> m_ring;
+    std::atomic<double> m_lastPushTime{-1.0};
+
+    std::atomic<double> m_ratio{1.0};
+    std::atomic<double> m_driftPpm{0.0};
+    std::atomic<double> m_fillEstimate{0.0};
+    std::atomic<int> m_underruns{0};
+    std::atomic<int> m_overruns{0};
+};
+
+} // namespace AudioEngine
+
+#endif // DRIFTCOMPENSATOR_H
@@ -0,0 +1,354 @@
+#include "fft.h"
+#include "../common/audioerror.h"
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define CADENCE_FFT_SSE 1
+#endif
+
+namespace AudioEngine {
+
+namespace {
+
+// W(L)^k = e^(-2*pi*i*k/L)
+void twiddle(size_t k, size_t length, float& re, float& im) {
+    const double angle = 2.0 * M_PI * static_cast<double>(k) / static_cast<double>(length);
+    re = static_cast<float>(std::cos(angle));
+    im = static_cast<float>(-std::sin(angle));
+}
+
+// Two radix-2 stages at once: spans half and 2 * half
+template <bool Inverse>
+void fusedPassScalar(float* re, float* im, size_t n, size_t half, const float* wRe, const float* wIm,
+                     const float* vRe, const float* vIm) {
+    const float sign = Inverse ? -1.0f : 1.0f;
+    for (size_t start = 0; start < n; start += 4 * half) {
+        for (size_t k = 0; k < half; ++k) {
+            const size_t i0 = start + k;
+            const size_t i1 = i0 + half;
+            const size_t i2 = i1 + half;
+            const size_t i3 = i2 + half;
+            const float wr = wRe[k], wi = sign * wIm[k];
+            const float vr = vRe[k], vi = sign * vIm[k];
+
+            const float tr = re[i1] * wr - im[i1] * wi;
+            const float ti = re[i1] * wi + im[i1] * wr;
+            const float b0r = re[i0] + tr, b0i = im[i0] + ti;
+            const float b1r = re[i0] - tr, b1i = im[i0] - ti;
+
+            const float ur = re[i3] * wr - im[i3] * wi;
+            const float ui = re[i3] * wi + im[i3] * wr;
+            const float b2r = re[i2] + ur, b2i = im[i2] + ui;
+            const float b3r = re[i2] - ur, b3i = im[i2] - ui;
+
+            const float pr = b2r * vr - b2i * vi;
+            const float pi = b2r * vi + b2i * vr;
+
+            // Second twiddle of the upper pair is W(4 * half)^k times -i (+i inverse)
+            const float qr = b3r * vr - b3i * vi;
+            const float qi = b3r * vi + b3i * vr;
+            const float sr = sign * qi;
+            const float si = -sign * qr;
+
+            re[i0] = b0r + pr; im[i0] = b0i + pi;
+            re[i2] = b0r - pr; im[i2] = b0i - pi;
+            re[i1] = b1r + sr; im[i1] = b1i + si;
+            re[i3] = b1r - sr; im[i3] = b1i - si;
+        }
+    }
+}
+
+template <bool Inverse>
+void radix2PassScalar(float* re, float* im, size_t n, size_t half, const float* wRe, const float* wIm) {
+    const float sign = Inverse ? -1.0f : 1.0f;
+    for (size_t start = 0; start < n; start += 2 * half) {
+        for (size_t k = 0; k < half; ++k) {
+            const size_t i0 = start + k;
+            const size_t i1 = i0 + half;
+            const float wr = wRe[k], wi = sign * wIm[k];
+            const float tr = re[i1] * wr - im[i1] * wi;
+            const float ti = re[i1] * wi + im[i1] * wr;
+            re[i1] = re[i0] - tr; im[i1] = im[i0] - ti;
+            re[i0] += tr; im[i0] += ti;
+        }
+    }
+}
+
+#if defined(CADENCE_FFT_SSE)
+
+// Complex multiply, split format
+inline void multiply(__m128 ar, __m128 ai, __m128 br, __m128 bi, __m128& outR, __m128& outI) {
+    outR = _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi));
+    outI = _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br));
+}
+
+// Same passes, four butterflies per instruction (half a multiple of 4)
+template <bool Inverse>
+void fusedPassSse(float* re, float* im, size_t n, size_t half, const float* wRe, const float* wIm,
+                  const float* vRe, const float* vIm) {
+    const __m128 sign = _mm_set1_ps(Inverse ? -1.0f : 1.0f);
+    for (size_t start = 0; start < n; start += 4 * half) {
+        for (size_t k = 0; k < half; k += 4) {
+            const size_t i0 = start + k;
+            const size_t i1 = i0 + half;
+            const size_t i2 = i1 + half;
+            const size_t i3 = i2 + half;
+            const __m128 wr = _mm_load_ps(wRe + k);
+            const __m128 wi = _mm_mul_ps(sign, _mm_load_ps(wIm + k));
+            const __m128 vr = _mm_load_ps(vRe + k);
+            const __m128 vi = _mm_mul_ps(sign, _mm_load_ps(vIm + k));
+
+            const __m128 a0r = _mm_loadu_ps(re + i0), a0i = _mm_loadu_ps(im + i0);
+            const __m128 a1r = _mm_loadu_ps(re + i1), a1i = _mm_loadu_ps(im + i1);
+            const __m128 a2r = _mm_loadu_ps(re + i2), a2i = _mm_loadu_ps(im + i2);
+            const __m128 a3r = _mm_loadu_ps(re + i3), a3i = _mm_loadu_ps(im + i3);
+
+            __m128 tr, ti, ur, ui;
+            multiply(a1r, a1i, wr, wi, tr, ti);
+            multiply(a3r, a3i, wr, wi, ur, ui);
+            const __m128 b0r = _mm_add_ps(a0r, tr), b0i = _mm_add_ps(a0i, ti);
+            const __m128 b1r = _mm_sub_ps(a0r, tr), b1i = _mm_sub_ps(a0i, ti);
+            const __m128 b2r = _mm_add_ps(a2r, ur), b2i = _mm_add_ps(a2i, ui);
+            const __m128 b3r = _mm_sub_ps(a2r, ur), b3i = _mm_sub_ps(a2i, ui);
+
+            __m128 pr, pi, qr, qi;
+            multiply(b2r, b2i, vr, vi, pr, pi);
+            multiply(b3r, b3i, vr, vi, qr, qi);
+            const __m128 sr = _mm_mul_ps(sign, qi);
+            const __m128 si = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(sign, qr));
+
+            _mm_storeu_ps(re + i0, _mm_add_ps(b0r, pr));
+            _mm_storeu_ps(im + i0, _mm_add_ps(b0i, pi));
+            _mm_storeu_ps(re + i2, _mm_sub_ps(b0r, pr));
+            _mm_storeu_ps(im + i2, _mm_sub_ps(b0i, pi));
+            _mm_storeu_ps(re + i1, _mm_add_ps(b1r, sr));
+            _mm_storeu_ps(im + i1, _mm_add_ps(b1i, si));
+            _mm_storeu_ps(re + i3, _mm_sub_ps(b1r, sr));
+            _mm_storeu_ps(im + i3, _mm_sub_ps(b1i, si));
+        }
+    }
+}
+
+template <bool Inverse>
+void radix2PassSse(float* re, float* im, size_t n, size_t half, const float* wRe, const float* wIm) {
+    const __m128 sign = _mm_set1_ps(Inverse ? -1.0f : 1.0f);
+    for (size_t start = 0; start < n; start += 2 * half) {
+        for (size_t k = 0; k < half; k += 4) {
+            const size_t i0 = start + k;
+            const size_t i1 = i0 + half;
+            const __m128 wr = _mm_load_ps(wRe + k);
+            const __m128 wi = _mm_mul_ps(sign, _mm_load_ps(wIm + k));
+
+            __m128 tr, ti;
+            multiply(_mm_loadu_ps(re + i1), _mm_loadu_ps(im + i1), wr, wi, tr, ti);
+            const __m128 ar = _mm_loadu_ps(re + i0);
+            const __m128 ai = _mm_loadu_ps(im + i0);
+            _mm_storeu_ps(re + i0, _mm_add_ps(ar, tr));
+            _mm_storeu_ps(im + i0, _mm_add_ps(ai, ti));
+            _mm_storeu_ps(re + i1, _mm_sub_ps(ar, tr));
+            _mm_storeu_ps(im + i1, _mm_sub_ps(ai, ti));
+        }
+    }
+}
+
+#endif
+
+}
+
+// ===== Plans =====
+
+Fft::Fft(size_t size)
+    : m_size(size)
+{
+    if (!isPowerOfTwo(size) || size > (size_t(1) << 30)) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration,
+                             "FFT size must be a power of two");
+    }
+
+    m_complex.build(size);
+    if (size >= 2) {
+        m_half.build(size / 2);
+        for (size_t k = 0; k <= size / 4; ++k) {
+            float re, im;
+            twiddle(k, size, re, im);
+            m_realRe.push_back(re);
+            m_realIm.push_back(im);
+        }
+    }
+}
+
+std::shared_ptr<const Fft> Fft::get(size_t size) {
+    static std::mutex cacheMutex;
+    static std::map<size_t, std::shared_ptr<const Fft>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto& plan = cache[size];
+    if (!plan) {
+        plan = std::make_shared<const Fft>(size);
+    }
+    return plan;
+}
+
+void Fft::Kernel::build(size_t n) {
+    size = n;
+
+    int bits = 0;
+    while ((size_t(1) << bits) < n) {
+        ++bits;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        size_t reversed = 0;
+        for (int b = 0; b < bits; ++b) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        if (i < reversed) {
+            swaps.push_back(static_cast<uint32_t>(i));
+            swaps.push_back(static_cast<uint32_t>(reversed));
+        }
+    }
+
+    for (size_t half = 1; half < n;) {
+        Pass pass;
+        pass.half = half;
+        pass.fused = 4 * half <= n;
+        for (size_t k = 0; k < half; ++k) {
+            float re, im;
+            twiddle(k, 2 * half, re, im);
+            pass.wRe.push_back(re);
+            pass.wIm.push_back(im);
+            if (pass.fused) {
+                twiddle(k, 4 * half, re, im);
+                pass.vRe.push_back(re);
+                pass.vIm.push_back(im);
+            }
+        }
+        half *= pass.fused ? 4 : 2;
+        passes.push_back(std::move(pass));
+    }
+}
+
+template <bool Inverse>
+void Fft::Kernel::run(float* re, float* im) const {
+    for (size_t i = 0; i < swaps.size(); i += 2) {
+        std::swap(re[swaps[i]], re[swaps[i + 1]]);
+        std::swap(im[swaps[i]], im[swaps[i + 1]]);
+    }
+
+    for (const Pass& pass : passes) {
+#if defined(CADENCE_FFT_SSE)
+        if (pass.half % 4 == 0) {
+            if (pass.fused) {
+                fusedPassSse<Inverse>(re, im, size, pass.half, pass.wRe.data(), pass.wIm.data(),
+                                      pass.vRe.data(), pass.vIm.data());
+            } else {
+                radix2PassSse<Inverse>(re, im, size, pass.half, pass.wRe.data(), pass.wIm.data());
+            }
+            continue;
+        }
+#endif
+        if (pass.fused) {
+            fusedPassScalar<Inverse>(re, im, size, pass.half, pass.wRe.data(), pass.wIm.data(),
+                                     pass.vRe.data(), pass.vIm.data());
+        } else {
+            radix2PassScalar<Inverse>(re, im, size, pass.half, pass.wRe.data(), pass.wIm.data());
+        }
+    }
+}
+
+// ===== Complex =====
+
+void Fft::forward(float* re, float* im) const {
+    m_complex.run<false>(re, im);
+}
+
+void Fft::inverse(float* re, float* im) const {
+    m_complex.run<true>(re, im);
+}
+
+// ===== Real =====
+
+void Fft::forwardReal(const float* input, float* re, float* im) const {
+    const size_t M = m_size / 2;
+    if (M == 0) {
+        re[0] = input[0];
+        im[0] = 0.0f;
+        return;
+    }
+
+    // Even samples as real part, odd as imaginary: one half-size transform
+    for (size_t j = 0; j < M; ++j) {
+        re[j] = input[2 * j];
+        im[j] = input[2 * j + 1];
+    }
+    m_half.run<false>(re, im);
+
+    const float z0r = re[0], z0i = im[0];
+    re[0] = z0r + z0i;
+    im[0] = 0.0f;
+    re[M] = z0r - z0i;
+    im[M] = 0.0f;
+
+    // Split the packed spectrum: X[k] = E + W^k O, with bins k and M - k together
+    for (size_t k = 1; k <= M / 2; ++k) {
+        const size_t j = M - k;
+        const float Ar = re[k], Ai = im[k];
+        const float Br = re[j], Bi = -im[j];
+        const float Er = 0.5f * (Ar + Br), Ei = 0.5f * (Ai + Bi);
+        const float Dr = 0.5f * (Ar - Br), Di = 0.5f * (Ai - Bi);
+        const float c = m_realRe[k], s = m_realIm[k];
+
+        // O = -i D
+        const float Or = Di, Oi = -Dr;
+        re[k] = Er + (c * Or - s * Oi);
+        im[k] = Ei + (c * Oi + s * Or);
+
+        // Bin M - k: E' = conj(E), O' = i conj(D), W^(M-k) = -conj(W^k)
+        const float Pr = Di, Pi = Dr;
+        re[j] = Er + (-c * Pr - s * Pi);
+        im[j] = -Ei + (-c * Pi + s * Pr);
+    }
+}
+
+void Fft::inverseReal(float* re, float* im, float* output) const {
+    const size_t M = m_size / 2;
+    if (M == 0) {
+        output[0] = re[0];
+        return;
+    }
+
+    const float x0 = re[0], xM = re[M];
+    re[0] = x0 + xM;
+    im[0] = x0 - xM;
+
+    // Undo the split: Z[k] = 2E + i 2O
+    for (size_t k = 1; k <= M / 2; ++k) {
+        const size_t j = M - k;
+        const float Xkr = re[k], Xki = im[k];
+        const float Xjr = re[j], Xji = im[j];
+        const float c = m_realRe[k], s = m_realIm[k];
+
+        // 2E = X[k] + conj(X[j]); 2O = conj(W^k) (X[k] - conj(X[j]))
+        const float Er = Xkr + Xjr, Ei = Xki - Xji;
+        const float Tr = Xkr - Xjr, Ti = Xki + Xji;
+        const float Or = c * Tr + s * Ti, Oi = c * Ti - s * Tr;
+        re[k] = Er - Oi;
+        im[k] = Ei + Or;
+
+        // Bin M - k: 2E' = conj(2E), 2O' = W^k conj(T)
+        const float Pr = c * Tr + s * Ti, Pi = s * Tr - c * Ti;
+        re[j] = Er - Pi;
+        im[j] = -Ei + Pr;
+    }
+
+    m_half.run<true>(re, im);
+    for (size_t j = 0; j < M; ++j) {
+        output[2 * j] = re[j];
+        output[2 * j + 1] = im[j];
+    }
+}
+
+} // namespace AudioEngine
@@ -0,0 +1,76 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include "alignedbuffer.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace AudioEngine {
+
+// FFT plan for one power-of-two size
+// Data is in split format (separate real and imaginary arrays), which lets
+// the SIMD kernels run four butterflies per instruction without shuffles.
+// Radix-2 stages are fused in pairs into radix-2^2 passes, which halves the
+// passes over memory. Each pass has its own contiguous twiddle tables.
+// This is radix-2^2, not split-radix: split-radix needs slightly fewer
+// multiplies, but its L-shaped butterflies mix radix-2 and radix-4 index
+// patterns within a pass, which don't map onto uniform four-wide SIMD.
+// Radix-2^2 has the radix-4 multiply count with radix-2's regular access.
+// Real transforms run as a half-size complex transform plus a twiddle pass.
+// Plans are immutable once built: one cached plan may be used from any
+// number of threads, and the transforms never allocate. Building a plan
+// allocates, so call get() off the audio thread. Inverses are unscaled, so a
+// round trip multiplies by size().
+class Fft {
+public:
+    explicit Fft(size_t size);
+
+    // Shared plan for this size, built on first use
+    static std::shared_ptr<const Fft> get(size_t size);
+
+    size_t size() const { return m_size; }
+
+    // ===== Complex (size() points, in place) =====
+
+    void forward(float* re, float* im) const;
+    void inverse(float* re, float* im) const;
+
+    // ===== Real (size() samples <-> size()/2 + 1 bins) =====
+
+    // Bins 0 and size()/2 come out purely real
+    void forwardReal(const float* input, float* re, float* im) const;
+
+    // re/im are used as scratch and do not survive the call
+    void inverseReal(float* re, float* im, float* output) const;
+
+    static bool isPowerOfTwo(size_t n) { return n != 0 && (n & (n - 1)) == 0; }
+
+private:
+    struct Pass {
+        size_t half = 0;                // Butterfly span of the first fused stage
+        bool fused = false;             // Radix-2^2 (two stages) or a lone radix-2 stage
+        AlignedVector<float> wRe, wIm;  // W(2 * half)^k
+        AlignedVector<float> vRe, vIm;  // W(4 * half)^k (fused passes)
+    };
+
+    struct Kernel {
+        size_t size = 0;
+        std::vector<uint32_t> swaps;    // Bit-reversal pairs
+        std::vector<Pass> passes;
+
+        void build(size_t n);
+        template <bool Inverse>
+        void run(float* re, float* im) const;
+    };
+
+    size_t m_size;
+    Kernel m_complex;                       // size()
+    Kernel m_half;                          // size() / 2, for real transforms
+    AlignedVector<float> m_realRe, m_realIm;  // W(size())^k, k <= size() / 4
+};
+
+} // namespace AudioEngine
+
+#endif // FFT_H
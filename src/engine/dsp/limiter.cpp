@@ -0,0 +1,195 @@
+#include "limiter.h"
+#include "../common/audioerror.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CADENCE_LIMITER_SSE 1
+#endif
+
+namespace AudioEngine {
+
+Limiter::Limiter(double sampleRate, int channels)
+    : Limiter(sampleRate, channels, Options())
+{
+}
+
+Limiter::Limiter(double sampleRate, int channels, const Options& options)
+    : m_sampleRate(sampleRate)
+    , m_channels(channels)
+    , m_lookahead(static_cast<size_t>(std::lround(std::max(0.0, options.lookaheadMs) * sampleRate / 1000.0)))
+{
+    if (sampleRate <= 0.0 || channels < 1) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration,
+                             "Limiter needs a positive sample rate and at least one channel");
+    }
+
+    m_history.resize(static_cast<size_t>(channels));
+    m_blockPointers.resize(static_cast<size_t>(channels));
+    for (auto& history : m_history) {
+        history.assign(m_lookahead + kBlockFrames, 0.0f);
+    }
+    m_dequeFrames.assign(m_lookahead + 1, 0);
+    m_dequePeaks.assign(m_lookahead + 1, 0.0f);
+    m_averageRing.assign(m_lookahead + 1, 1.0f);
+    m_peaks.assign(kBlockFrames, 0.0f);
+    m_gains.assign(kBlockFrames, 1.0f);
+
+    setCeilingDb(options.ceilingDb);
+    setReleaseMs(options.releaseMs);
+    reset();
+}
+
+void Limiter::setCeilingDb(double ceilingDb) {
+    m_ceiling = static_cast<float>(std::pow(10.0, std::min(ceilingDb, 0.0) / 20.0));
+}
+
+void Limiter::setReleaseMs(double releaseMs) {
+    const double frames = std::max(1.0, releaseMs * m_sampleRate / 1000.0);
+    m_releaseCoefficient = 1.0 - std::exp(-1.0 / frames);
+}
+
+void Limiter::reset() {
+    for (auto& history : m_history) {
+        std::fill(history.begin(), history.end(), 0.0f);
+    }
+    m_dequeHead = 0;
+    m_dequeSize = 0;
+    m_frame = 0;
+    std::fill(m_averageRing.begin(), m_averageRing.end(), 1.0f);
+    m_averagePos = 0;
+    m_averageSum = static_cast<double>(m_averageRing.size());
+    m_release = 1.0;
+    m_gainReductionDb = 0.0f;
+}
+
+void Limiter::process(float* const* channels, size_t frames) {
+#if defined(CADENCE_LIMITER_SSE)
+    processBlocks<true>(channels, frames);
+#else
+    processBlocks<false>(channels, frames);
+#endif
+}
+
+void Limiter::processScalar(float* const* channels, size_t frames) {
+    processBlocks<false>(channels, frames);
+}
+
+template <bool Simd>
+void Limiter::processBlocks(float* const* channels, size_t frames) {
+    for (size_t offset = 0; offset < frames; offset += kBlockFrames) {
+        for (int ch = 0; ch < m_channels; ++ch) {
+            m_blockPointers[static_cast<size_t>(ch)] = channels[ch] + offset;
+        }
+        processBlock<Simd>(m_blockPointers.data(), std::min(kBlockFrames, frames - offset));
+    }
+}
+
+template <bool Simd>
+void Limiter::processBlock(float* const* channels, size_t frames) {
+    float* peaks = m_peaks.data();
+    float* gains = m_gains.data();
+    size_t vectorFrames = 0;
+#if defined(CADENCE_LIMITER_SSE)
+    if (Simd) {
+        vectorFrames = frames & ~size_t{3};
+    }
+#endif
+
+    // Peak across channels per frame, and the input into the delay line
+    std::fill(peaks, peaks + frames, 0.0f);
+    for (int ch = 0; ch < m_channels; ++ch) {
+        const float* in = channels[ch];
+        size_t i = 0;
+#if defined(CADENCE_LIMITER_SSE)
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        for (; i < vectorFrames; i += 4) {
+            const __m128 x = _mm_and_ps(_mm_loadu_ps(in + i), absMask);
+            _mm_store_ps(peaks + i, _mm_max_ps(_mm_load_ps(peaks + i), x));
+        }
+#endif
+        for (; i < frames; ++i) {
+            peaks[i] = std::max(peaks[i], std::abs(in[i]));
+        }
+        std::memcpy(m_history[static_cast<size_t>(ch)].data() + m_lookahead, in, frames * sizeof(float));
+    }
+
+    // Sliding maximum over the last lookahead + 1 frames. Entries that can
+    // never be the maximum again leave from the back; expired ones from the front.
+    const size_t capacity = m_dequePeaks.size();
+    for (size_t i = 0; i < frames; ++i, ++m_frame) {
+        if (m_dequeSize > 0 && m_dequeFrames[m_dequeHead] + capacity <= m_frame) {
+            m_dequeHead = m_dequeHead + 1 == capacity ? 0 : m_dequeHead + 1;
+            --m_dequeSize;
+        }
+        const float peak = peaks[i];
+        while (m_dequeSize > 0 && m_dequePeaks[(m_dequeHead + m_dequeSize - 1) % capacity] <= peak) {
+            --m_dequeSize;
+        }
+        const size_t back = (m_dequeHead + m_dequeSize) % capacity;
+        m_dequeFrames[back] = m_frame;
+        m_dequePeaks[back] = peak;
+        ++m_dequeSize;
+        peaks[i] = m_dequePeaks[m_dequeHead];
+    }
+
+    // Gain each window needs
+    {
+        size_t i = 0;
+#if defined(CADENCE_LIMITER_SSE)
+        const __m128 ceiling = _mm_set1_ps(m_ceiling);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 tiny = _mm_set1_ps(1e-30f);
+        for (; i < vectorFrames; i += 4) {
+            const __m128 peak = _mm_max_ps(_mm_load_ps(peaks + i), tiny);
+            _mm_store_ps(gains + i, _mm_min_ps(one, _mm_div_ps(ceiling, peak)));
+        }
+#endif
+        for (; i < frames; ++i) {
+            gains[i] = std::min(1.0f, m_ceiling / std::max(peaks[i], 1e-30f));
+        }
+    }
+
+    // Instant attack, exponential release, then the moving average that
+    // ramps the gain down across the lookahead
+    const size_t window = m_averageRing.size();
+    const double scale = 1.0 / static_cast<double>(window);
+    double release = m_release;
+    double sum = m_averageSum;
+    size_t pos = m_averagePos;
+    float lowest = 1.0f;
+    for (size_t i = 0; i < frames; ++i) {
+        const double target = gains[i];
+        release = target < release ? target : release + (target - release) * m_releaseCoefficient;
+        const float held = static_cast<float>(release);
+        sum += static_cast<double>(held) - m_averageRing[pos];
+        m_averageRing[pos] = held;
+        pos = pos + 1 == window ? 0 : pos + 1;
+        gains[i] = std::min(1.0f, static_cast<float>(sum * scale));
+        lowest = std::min(lowest, gains[i]);
+    }
+    m_release = release;
+    m_averageSum = sum;
+    m_averagePos = pos;
+    m_gainReductionDb = static_cast<float>(20.0 * std::log10(static_cast<double>(lowest)));
+
+    // Delayed audio times the gain, then keep the newest lookahead frames
+    for (int ch = 0; ch < m_channels; ++ch) {
+        float* history = m_history[static_cast<size_t>(ch)].data();
+        float* out = channels[ch];
+        size_t i = 0;
+#if defined(CADENCE_LIMITER_SSE)
+        for (; i < vectorFrames; i += 4) {
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(history + i), _mm_load_ps(gains + i)));
+        }
+#endif
+        for (; i < frames; ++i) {
+            out[i] = history[i] * gains[i];
+        }
+        std::memmove(history, history + frames, m_lookahead * sizeof(float));
+    }
+}
+
+} // namespace AudioEngine
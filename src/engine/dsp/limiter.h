@@ -0,0 +1,96 @@
+#ifndef LIMITER_H
+#define LIMITER_H
+
+#include "alignedbuffer.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AudioEngine {
+
+// Lookahead brickwall limiter for the master bus
+// The audio is delayed by the lookahead so the gain can start falling before
+// a peak arrives. Per block:
+//   1. SIMD: the peak across channels of each incoming frame
+//   2. A sliding-window maximum of that peak over lookahead + 1 frames, kept
+//      in a monotonic deque (O(1) amortized per frame however long the window)
+//   3. SIMD: the gain that window needs, min(1, ceiling / max)
+//   4. Instant attack / exponential release, then a moving average over the
+//      same window (running sum) that turns gain steps into ramps
+//   5. SIMD: the delayed audio times the gain
+// Every frame in the averaging window is at or below the gain the peak
+// needs, so the output never exceeds the ceiling. The delay is latency()
+// frames, for plugin delay compensation.
+class Limiter {
+public:
+    struct Options {
+        double lookaheadMs = 5.0;
+        double releaseMs = 80.0;
+        double ceilingDb = -1.0;    // dBFS sample peak
+    };
+
+    static constexpr size_t kBlockFrames = 256;
+
+    Limiter(double sampleRate, int channels);
+    Limiter(double sampleRate, int channels, const Options& options);
+
+    int channels() const { return m_channels; }
+
+    // Lookahead delay in frames
+    int latency() const { return static_cast<int>(m_lookahead); }
+
+    // ===== Audio Thread =====
+
+    void setCeilingDb(double ceilingDb);
+    void setReleaseMs(double releaseMs);
+
+    // Clear the delay line and envelope (gain back to unity)
+    void reset();
+
+    // Limit each channel in place; output is delayed by latency() frames
+    void process(float* const* channels, size_t frames);
+
+    // Same limiting without SIMD; reference for tests and benchmarks
+    void processScalar(float* const* channels, size_t frames);
+
+    // Deepest gain reduction in the last processed block, dB (<= 0), for metering
+    float gainReductionDb() const { return m_gainReductionDb; }
+
+private:
+    template <bool Simd>
+    void processBlocks(float* const* channels, size_t frames);
+
+    template <bool Simd>
+    void processBlock(float* const* channels, size_t frames);
+
+    double m_sampleRate;
+    int m_channels;
+    size_t m_lookahead;
+    float m_ceiling = 1.0f;
+    double m_releaseCoefficient = 0.0;
+
+    // Per channel, linear: m_lookahead frames of delay, then the block
+    std::vector<AlignedVector<float>> m_history;
+    std::vector<float*> m_blockPointers;
+
+    // Sliding maximum: ring of (frame, peak) pairs with decreasing peaks
+    std::vector<uint64_t> m_dequeFrames;
+    std::vector<float> m_dequePeaks;
+    size_t m_dequeHead = 0;
+    size_t m_dequeSize = 0;
+    uint64_t m_frame = 0;
+
+    // Moving average of the released gain over m_lookahead + 1 frames
+    std::vector<float> m_averageRing;
+    size_t m_averagePos = 0;
+    double m_averageSum = 0.0;
+    double m_release = 1.0;
+
+    AlignedVector<float> m_peaks;
+    AlignedVector<float> m_gains;
+    float m_gainReductionDb = 0.0f;
+};
+
+} // namespace AudioEngine
+
+#endif // LIMITER_H
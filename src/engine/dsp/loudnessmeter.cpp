@@ -0,0 +1,235 @@
+#include "loudnessmeter.h"
+#include "meterbank.h"
+#include "../common/audioerror.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace AudioEngine {
+
+namespace {
+
+constexpr double kNegativeInfinity = -std::numeric_limits<double>::infinity();
+
+double toLufs(double energy) {
+    return energy > 0.0 ? -0.691 + 10.0 * std::log10(energy) : kNegativeInfinity;
+}
+
+// BS.1770 pre-filter (high shelf, +4 dB above ~1.7 kHz). The analog
+// prototype is re-derived for the rate so 44.1/88.2/96 kHz match the
+// published 48 kHz coefficients.
+BiquadCoefficients shelfStage(double sampleRate) {
+    const double f0 = 1681.974450955533;
+    const double gainDb = 3.999843853973347;
+    const double q = 0.7071752369554196;
+    const double k = std::tan(M_PI * f0 / sampleRate);
+    const double vh = std::pow(10.0, gainDb / 20.0);
+    const double vb = std::pow(vh, 0.4996667741545416);
+    const double a0 = 1.0 + k / q + k * k;
+
+    BiquadCoefficients c;
+    c.b0 = static_cast<float>((vh + vb * k / q + k * k) / a0);
+    c.b1 = static_cast<float>(2.0 * (k * k - vh) / a0);
+    c.b2 = static_cast<float>((vh - vb * k / q + k * k) / a0);
+    c.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+    c.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    return c;
+}
+
+// BS.1770 RLB weighting (second-order high-pass at ~38 Hz)
+BiquadCoefficients highPassStage(double sampleRate) {
+    const double f0 = 38.13547087602444;
+    const double q = 0.5003270373238773;
+    const double k = std::tan(M_PI * f0 / sampleRate);
+    const double a0 = 1.0 + k / q + k * k;
+
+    BiquadCoefficients c;
+    c.b0 = 1.0f;
+    c.b1 = -2.0f;
+    c.b2 = 1.0f;
+    c.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+    c.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    return c;
+}
+
+}
+
+LoudnessMeter::LoudnessMeter(double sampleRate, int channels, size_t maxBlockFrames)
+    : m_sampleRate(sampleRate)
+    , m_channels(channels)
+    , m_maxBlockFrames(maxBlockFrames)
+    , m_subBlockFrames(static_cast<size_t>(std::lround(sampleRate / 10.0)))
+    , m_filters(channels, 2, 0)
+    , m_oversampler(channels, kOversampling, Oversampler::Quality::High, maxBlockFrames)
+    , m_weights(static_cast<size_t>(channels), 1.0)
+    , m_scratch(static_cast<size_t>(channels))
+    , m_scratchPointers(static_cast<size_t>(channels))
+    , m_inputPointers(static_cast<size_t>(channels))
+    , m_sumSquares(static_cast<size_t>(channels), 0.0)
+    , m_histogram(static_cast<size_t>(std::lround((kHistogramMax - kHistogramMin) / kBinWidth)))
+    , m_integrated(kNegativeInfinity)
+{
+    if (sampleRate < 8000.0 || channels < 1 || maxBlockFrames == 0) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration,
+                             "Loudness metering needs a rate of at least 8 kHz and one channel");
+    }
+
+    for (int ch = 0; ch < channels; ++ch) {
+        m_filters.setCoefficientsImmediate(ch, 0, shelfStage(sampleRate));
+        m_filters.setCoefficientsImmediate(ch, 1, highPassStage(sampleRate));
+        m_scratch[static_cast<size_t>(ch)].assign(maxBlockFrames, 0.0f);
+        m_scratchPointers[static_cast<size_t>(ch)] = m_scratch[static_cast<size_t>(ch)].data();
+    }
+
+    // L, R, C, LFE, Ls, Rs
+    if (channels == 6) {
+        m_weights = {1.0, 1.0, 1.0, 0.0, 1.41, 1.41};
+    }
+}
+
+void LoudnessMeter::setChannelWeight(int channel, double weight) {
+    if (channel < 0 || channel >= m_channels) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration, "Loudness channel out of range");
+    }
+    m_weights[static_cast<size_t>(channel)] = weight;
+}
+
+void LoudnessMeter::reset() {
+    m_filters.reset();
+    m_oversampler.reset();
+    std::fill(m_sumSquares.begin(), m_sumSquares.end(), 0.0);
+    m_subBlockFill = 0;
+    std::fill(std::begin(m_ring), std::end(m_ring), 0.0);
+    m_ringPos = 0;
+    m_subBlockCount = 0;
+    std::fill(m_histogram.begin(), m_histogram.end(), Bin{});
+    m_blockCount = 0;
+    m_gatedCount = 0;
+    m_gatedEnergy = 0.0;
+    m_integrated = kNegativeInfinity;
+    m_peak = 0.0f;
+}
+
+void LoudnessMeter::process(const float* const* channels, size_t frames) {
+    size_t offset = 0;
+    while (offset < frames) {
+        // Never straddle a sub-block boundary, so each chunk belongs to one sub-block
+        const size_t n = std::min({frames - offset, m_maxBlockFrames, m_subBlockFrames - m_subBlockFill});
+        for (int ch = 0; ch < m_channels; ++ch) {
+            m_inputPointers[static_cast<size_t>(ch)] = channels[ch] + offset;
+        }
+        processChunk(m_inputPointers.data(), n);
+        offset += n;
+
+        m_subBlockFill += n;
+        if (m_subBlockFill == m_subBlockFrames) {
+            endSubBlock();
+        }
+    }
+}
+
+void LoudnessMeter::processChunk(const float* const* channels, size_t frames) {
+    for (int ch = 0; ch < m_channels; ++ch) {
+        std::copy(channels[ch], channels[ch] + frames, m_scratchPointers[static_cast<size_t>(ch)]);
+    }
+    m_filters.process(m_scratchPointers.data(), frames);
+
+    float peak = m_peak;
+    for (int ch = 0; ch < m_channels; ++ch) {
+        float unusedPeak = 0.0f;
+        double sum = 0.0;
+        MeterBank::reduce(m_scratchPointers[static_cast<size_t>(ch)], frames, unusedPeak, sum);
+        m_sumSquares[static_cast<size_t>(ch)] += sum;
+    }
+
+    // Inter-sample peaks: the oversampled copy also carries every original
+    // sample (up to the filter's ripple), so its peak covers the sample peak
+    float* const* upsampled = m_oversampler.upsample(channels, frames);
+    for (int ch = 0; ch < m_channels; ++ch) {
+        float channelPeak = 0.0f;
+        double unusedSum = 0.0;
+        MeterBank::reduce(upsampled[ch], frames * kOversampling, channelPeak, unusedSum);
+        peak = std::max(peak, channelPeak);
+    }
+    m_peak = peak;
+}
+
+void LoudnessMeter::endSubBlock() {
+    double energy = 0.0;
+    for (int ch = 0; ch < m_channels; ++ch) {
+        energy += m_weights[static_cast<size_t>(ch)] * m_sumSquares[static_cast<size_t>(ch)];
+        m_sumSquares[static_cast<size_t>(ch)] = 0.0;
+    }
+    m_ring[m_ringPos] = energy / static_cast<double>(m_subBlockFrames);
+    m_ringPos = (m_ringPos + 1) % kSubBlocks;
+    m_subBlockFill = 0;
+
+    // Gating blocks are 400 ms with 75% overlap: one per sub-block once four exist
+    if (++m_subBlockCount >= kMomentaryBlocks) {
+        addGatingBlock(windowEnergy(kMomentaryBlocks));
+    }
+}
+
+void LoudnessMeter::addGatingBlock(double energy) {
+    ++m_blockCount;
+    const double lufs = toLufs(energy);
+    if (!(lufs > kAbsoluteGate)) {
+        return;
+    }
+
+    const double position = (lufs - kHistogramMin) / kBinWidth;
+    const size_t bin = std::min(static_cast<size_t>(position), m_histogram.size() - 1);
+    ++m_histogram[bin].count;
+    m_histogram[bin].energy += energy;
+    ++m_gatedCount;
+    m_gatedEnergy += energy;
+    updateIntegrated();
+}
+
+void LoudnessMeter::updateIntegrated() {
+    // Relative gate from the absolute-gated mean, then the mean of the blocks above it
+    const double threshold = toLufs(m_gatedEnergy / static_cast<double>(m_gatedCount)) + kRelativeGate;
+    size_t first = 0;
+    if (threshold > kHistogramMin) {
+        first = std::min(static_cast<size_t>((threshold - kHistogramMin) / kBinWidth), m_histogram.size() - 1);
+    }
+
+    uint64_t count = 0;
+    double energy = 0.0;
+    for (size_t i = first; i < m_histogram.size(); ++i) {
+        count += m_histogram[i].count;
+        energy += m_histogram[i].energy;
+    }
+    m_integrated = count > 0 ? toLufs(energy / static_cast<double>(count)) : kNegativeInfinity;
+}
+
+double LoudnessMeter::windowEnergy(int blocks) const {
+    double sum = 0.0;
+    for (int i = 1; i <= blocks; ++i) {
+        sum += m_ring[(m_ringPos - i + kSubBlocks) % kSubBlocks];
+    }
+    return sum / blocks;
+}
+
+double LoudnessMeter::momentary() const {
+    return toLufs(windowEnergy(kMomentaryBlocks));
+}
+
+double LoudnessMeter::shortTerm() const {
+    return toLufs(windowEnergy(kSubBlocks));
+}
+
+double LoudnessMeter::truePeak() const {
+    return m_peak > 0.0f ? 20.0 * std::log10(static_cast<double>(m_peak)) : kNegativeInfinity;
+}
+
+LoudnessReading LoudnessMeter::reading() const {
+    LoudnessReading r;
+    r.momentary = static_cast<float>(momentary());
+    r.shortTerm = static_cast<float>(shortTerm());
+    r.integrated = static_cast<float>(m_integrated);
+    r.truePeak = static_cast<float>(truePeak());
+    return r;
+}
+
+} // namespace AudioEngine
@@ -0,0 +1,114 @@
+#ifndef LOUDNESSMETER_H
+#define LOUDNESSMETER_H
+
+#include "alignedbuffer.h"
+#include "biquadbank.h"
+#include "oversampler.h"
+#include "../common/enginesnapshot.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AudioEngine {
+
+// EBU R128 / ITU-R BS.1770 loudness and true-peak meter
+// Channels are K-weighted by a two-stage BiquadBank (the BS.1770 shelf and
+// high-pass, recomputed for the stream's rate) and their mean squares are
+// summed every 100 ms. Momentary (400 ms) and short-term (3 s) loudness are
+// sliding sums over a ring of those sub-blocks. Every 100 ms a 400 ms gating
+// block lands in a histogram of 0.01 LU bins, so the gated integrated
+// loudness costs one pass over the bins per block no matter how long the
+// programme runs, and memory is fixed up front. True peak is the sample peak
+// of a 4x oversampled copy (BS.1770 Annex 2).
+// The same object meters the master bus live (BackendRuntime, when
+// StreamConfig::loudnessMetering is set) and offline renders, where process()
+// simply takes large blocks.
+class LoudnessMeter {
+public:
+    static constexpr double kAbsoluteGate = -70.0;      // LUFS
+    static constexpr double kRelativeGate = -10.0;      // LU below the ungated level
+    static constexpr int kOversampling = 4;
+
+    LoudnessMeter(double sampleRate, int channels, size_t maxBlockFrames = 4096);
+
+    int channels() const { return m_channels; }
+    double sampleRate() const { return m_sampleRate; }
+
+    // ===== Control Thread (audio thread not processing) =====
+
+    // BS.1770 channel weight: 1.0 for front channels, 1.41 for surrounds,
+    // 0 to exclude (LFE). Six channels default to the 5.1 layout.
+    void setChannelWeight(int channel, double weight);
+
+    // ===== Audio Thread =====
+
+    // Start a new measurement: clears the integrated history and true peak
+    void reset();
+
+    // Meter frames of planar audio (any length; split internally)
+    void process(const float* const* channels, size_t frames);
+
+    // Loudness in LUFS, -inf before any signal (or below the absolute gate
+    // for integrated); true peak in dBTP since reset()
+    double momentary() const;
+    double shortTerm() const;
+    double integrated() const { return m_integrated; }
+    double truePeak() const;
+
+    LoudnessReading reading() const;
+
+    // Gating blocks measured since reset(), 10 per second
+    uint64_t blockCount() const { return m_blockCount; }
+
+private:
+    static constexpr int kSubBlocks = 30;           // 3 s of 100 ms sub-blocks
+    static constexpr int kMomentaryBlocks = 4;      // 400 ms
+    static constexpr double kHistogramMin = -70.0;
+    static constexpr double kHistogramMax = 10.0;
+    static constexpr double kBinWidth = 0.01;
+
+    struct Bin {
+        uint64_t count = 0;
+        double energy = 0.0;
+    };
+
+    void processChunk(const float* const* channels, size_t frames);
+    void endSubBlock();
+    void addGatingBlock(double energy);
+    void updateIntegrated();
+    double windowEnergy(int blocks) const;
+
+    double m_sampleRate;
+    int m_channels;
+    size_t m_maxBlockFrames;
+    size_t m_subBlockFrames;
+
+    BiquadBank m_filters;
+    Oversampler m_oversampler;
+    std::vector<double> m_weights;
+    std::vector<AlignedVector<float>> m_scratch;
+    std::vector<float*> m_scratchPointers;
+    std::vector<const float*> m_inputPointers;
+
+    // Current 100 ms sub-block
+    std::vector<double> m_sumSquares;
+    size_t m_subBlockFill = 0;
+
+    // Ring of weighted mean-square energies, newest at m_ringPos - 1
+    double m_ring[kSubBlocks] = {};
+    int m_ringPos = 0;
+    uint64_t m_subBlockCount = 0;
+
+    // Gating histogram; m_gatedCount/m_gatedEnergy cover blocks above the absolute gate
+    std::vector<Bin> m_histogram;
+    uint64_t m_blockCount = 0;
+    uint64_t m_gatedCount = 0;
+    double m_gatedEnergy = 0.0;
+    double m_integrated;
+
+    float m_peak = 0.0f;
+};
+
+} // namespace AudioEngine
+
+#endif // LOUDNESSMETER_H
@@ -0,0 +1,106 @@
+#include "meterbank.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CADENCE_METER_SSE 1
+#endif
+
+namespace AudioEngine {
+
+MeterBank::MeterBank(int meterCount, size_t windowFrames)
+    : m_windowFrames(windowFrames)
+{
+    configure(meterCount, windowFrames);
+}
+
+void MeterBank::configure(int meterCount, size_t windowFrames) {
+    m_meters.assign(static_cast<size_t>(std::max(0, meterCount)), Accumulator{});
+    m_windowFrames = std::max<size_t>(1, windowFrames);
+    m_framesInWindow = 0;
+}
+
+void MeterBank::reduce(const float* samples, size_t frames, float& peak, double& sumSquares) {
+    size_t i = 0;
+    float blockPeak = 0.0f;
+    double blockSum = 0.0;
+
+#if defined(CADENCE_METER_SSE)
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 peak0 = _mm_setzero_ps();
+    __m128 peak1 = _mm_setzero_ps();
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+
+    // Two independent accumulator chains hide the add latency
+    for (; i + 8 <= frames; i += 8) {
+        __m128 a = _mm_loadu_ps(samples + i);
+        __m128 b = _mm_loadu_ps(samples + i + 4);
+        peak0 = _mm_max_ps(peak0, _mm_and_ps(a, absMask));
+        peak1 = _mm_max_ps(peak1, _mm_and_ps(b, absMask));
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(a, a));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(b, b));
+    }
+
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, _mm_max_ps(peak0, peak1));
+    blockPeak = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    _mm_store_ps(lanes, _mm_add_ps(sum0, sum1));
+    blockSum = static_cast<double>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+#endif
+
+    for (; i < frames; ++i) {
+        float x = samples[i];
+        blockPeak = std::max(blockPeak, std::fabs(x));
+        blockSum += static_cast<double>(x) * x;
+    }
+
+    peak = blockPeak;
+    sumSquares = blockSum;
+}
+
+void MeterBank::process(int meter, const float* samples, size_t frames) {
+    if (meter < 0 || meter >= meterCount() || !samples) {
+        return;
+    }
+
+    float peak;
+    double sumSquares;
+    reduce(samples, frames, peak, sumSquares);
+
+    Accumulator& acc = m_meters[static_cast<size_t>(meter)];
+    acc.peak = std::max(acc.peak, peak);
+    acc.sumSquares += sumSquares;
+    acc.clipped = acc.clipped || peak >= 1.0f;
+}
+
+void MeterBank::endPeriod(size_t frames) {
+    m_framesInWindow += frames;
+    if (m_framesInWindow < m_windowFrames) {
+        return;
+    }
+
+    // Window complete: publish readings and start the next one
+    for (Accumulator& acc : m_meters) {
+        acc.reading.peak = acc.peak;
+        acc.reading.rms = static_cast<float>(std::sqrt(acc.sumSquares / m_framesInWindow));
+        if (acc.clipped) {
+            acc.reading.clipCount++;
+        }
+        acc.peak = 0.0f;
+        acc.sumSquares = 0.0;
+        acc.clipped = false;
+    }
+    m_framesInWindow = 0;
+}
+
+void MeterBank::writeTo(EngineSnapshot& snapshot) const {
+    const int count = std::min(meterCount(), EngineSnapshot::kMaxMeters);
+    for (int i = 0; i < count; ++i) {
+        snapshot.meters[i] = m_meters[static_cast<size_t>(i)].reading;
+    }
+    snapshot.meterCount = count;
+}
+
+} // namespace AudioEngine
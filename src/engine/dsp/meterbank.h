@@ -0,0 +1,51 @@
+#ifndef METERBANK_H
+#define METERBANK_H
+
+#include "../common/enginesnapshot.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AudioEngine {
+
+// Peak/RMS/clip metering for a set of channels or buses
+// process() runs on the audio thread once per period per meter and only does
+// SIMD reductions; readings are emitted once per window (decimation) and the
+// UI applies ballistics on its side.
+class MeterBank {
+public:
+    explicit MeterBank(int meterCount = 0, size_t windowFrames = 1024);
+
+    // Control thread: resize storage (never call while the audio thread processes)
+    void configure(int meterCount, size_t windowFrames);
+
+    int meterCount() const { return static_cast<int>(m_meters.size()); }
+
+    // Audio thread: accumulate one period of samples for a meter
+    void process(int meter, const float* samples, size_t frames);
+
+    // Audio thread: advance the window after all meters processed a period
+    void endPeriod(size_t frames);
+
+    // Audio thread: copy the latest completed readings into a snapshot
+    void writeTo(EngineSnapshot& snapshot) const;
+
+    // Peak |x| and sum of x^2 over a block (SIMD where available)
+    static void reduce(const float* samples, size_t frames, float& peak, double& sumSquares);
+
+private:
+    struct Accumulator {
+        float peak = 0.0f;
+        double sumSquares = 0.0;
+        bool clipped = false;
+        MeterReading reading;   // Last completed window
+    };
+
+    std::vector<Accumulator> m_meters;
+    size_t m_windowFrames;
+    size_t m_framesInWindow = 0;
+};
+
+} // namespace AudioEngine
+
+#endif // METERBANK_H
@@ -0,0 +1,265 @@
+#include "oversampler.h"
+#include "../common/audioerror.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define CADENCE_OVERSAMPLER_SSE 1
+#endif
+
+namespace AudioEngine {
+
+namespace {
+
+constexpr size_t kSimdWidth = 4;
+
+// Zeroth-order modified Bessel function, for the Kaiser window
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < 1e-12 * sum) {
+            break;
+        }
+    }
+    return sum;
+}
+
+struct StageDesign {
+    size_t halfTaps;
+    double beta;
+};
+
+// First stage, then every later one. The first stage's transition band is
+// centered on a quarter of its output rate, so its width sets the passband
+// edge; later stages only guard that same passband against images mirrored
+// around a much higher frequency.
+StageDesign designFor(Oversampler::Quality quality, bool first) {
+    switch (quality) {
+    case Oversampler::Quality::Low:
+        return first ? StageDesign{4, 5.0} : StageDesign{3, 5.0};
+    case Oversampler::Quality::Medium:
+        return first ? StageDesign{8, 7.0} : StageDesign{4, 7.0};
+    case Oversampler::Quality::High:
+    default:
+        return first ? StageDesign{20, 9.5} : StageDesign{6, 9.5};
+    }
+}
+
+}
+
+Oversampler::Oversampler(int channels, int factor, Quality quality, size_t maxBlockFrames)
+    : m_channels(channels)
+    , m_factor(factor)
+    , m_quality(quality)
+    , m_maxBlockFrames(maxBlockFrames)
+{
+    if (channels < 1 || maxBlockFrames == 0 || (factor != 1 && factor != 2 && factor != 4 && factor != 8)) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration,
+                             "Oversampling factor must be 1, 2, 4 or 8");
+    }
+
+    int stageCount = 0;
+    while ((1 << stageCount) < factor) {
+        ++stageCount;
+    }
+
+    m_stages.resize(static_cast<size_t>(stageCount));
+    for (int i = 0; i < stageCount; ++i) {
+        const StageDesign design = designFor(quality, i == 0);
+        Stage& stage = m_stages[static_cast<size_t>(i)];
+        stage.design(design.halfTaps, design.beta);
+        stage.allocate(channels, maxBlockFrames << i);
+    }
+
+    // Stage i delays its round trip by 2K - 1 samples at rate 2^i, plus half
+    // of whatever the inner stages add at rate 2^(i+1). An odd inner total
+    // gets one sample of padding so the whole chain lands on base-rate frames.
+    int inner = 0;
+    for (int i = stageCount - 1; i >= 0; --i) {
+        Stage& stage = m_stages[static_cast<size_t>(i)];
+        if (i + 1 < stageCount && inner % 2 != 0) {
+            m_stages[static_cast<size_t>(i + 1)].padOutput = true;
+            ++inner;
+        }
+        inner = static_cast<int>(2 * stage.halfTaps - 1) + inner / 2;
+    }
+    m_latency = inner;
+
+    // Factor 1 still hands out its own buffer, so callers process in place
+    // the same way at every factor
+    const int bufferCount = std::max(1, stageCount);
+    m_buffers.resize(static_cast<size_t>(bufferCount));
+    for (int i = 0; i < bufferCount; ++i) {
+        const size_t frames = maxBlockFrames << (stageCount == 0 ? 0 : i + 1);
+        m_buffers[static_cast<size_t>(i)].assign(static_cast<size_t>(channels), AlignedVector<float>(frames, 0.0f));
+    }
+    m_outputPointers.resize(static_cast<size_t>(channels));
+    for (int ch = 0; ch < channels; ++ch) {
+        m_outputPointers[static_cast<size_t>(ch)] = m_buffers.back()[static_cast<size_t>(ch)].data();
+    }
+}
+
+void Oversampler::reset() {
+    for (Stage& stage : m_stages) {
+        stage.clear();
+    }
+}
+
+float* const* Oversampler::upsample(const float* const* input, size_t frames) {
+    frames = std::min(frames, m_maxBlockFrames);
+    for (int ch = 0; ch < m_channels; ++ch) {
+        const size_t c = static_cast<size_t>(ch);
+        if (m_stages.empty()) {
+            std::memcpy(m_buffers[0][c].data(), input[ch], frames * sizeof(float));
+            continue;
+        }
+
+        const float* source = input[ch];
+        size_t n = frames;
+        for (size_t i = 0; i < m_stages.size(); ++i) {
+            float* destination = m_buffers[i][c].data();
+            m_stages[i].up(ch, source, n, destination);
+            source = destination;
+            n *= 2;
+        }
+    }
+    return m_outputPointers.data();
+}
+
+void Oversampler::downsample(float* const* output, size_t frames) {
+    frames = std::min(frames, m_maxBlockFrames);
+    for (int ch = 0; ch < m_channels; ++ch) {
+        const size_t c = static_cast<size_t>(ch);
+        if (m_stages.empty()) {
+            std::memcpy(output[ch], m_buffers[0][c].data(), frames * sizeof(float));
+            continue;
+        }
+
+        // Innermost first; each stage halves the rate
+        for (size_t i = m_stages.size(); i-- > 0;) {
+            const float* source = m_buffers[i][c].data();
+            float* destination = i == 0 ? output[ch] : m_buffers[i - 1][c].data();
+            m_stages[i].down(ch, source, frames << i, destination);
+        }
+    }
+}
+
+float Oversampler::dot(const float* samples, const float* taps, size_t count) {
+#if defined(CADENCE_OVERSAMPLER_SSE)
+    // count is a multiple of 4 and taps are aligned
+    __m128 sum = _mm_setzero_ps();
+    for (size_t j = 0; j < count; j += kSimdWidth) {
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(samples + j), _mm_load_ps(taps + j)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, sum);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#else
+    float sum = 0.0f;
+    for (size_t j = 0; j < count; ++j) {
+        sum += samples[j] * taps[j];
+    }
+    return sum;
+#endif
+}
+
+// ===== Stage =====
+
+void Oversampler::Stage::design(size_t k, double beta) {
+    halfTaps = k;
+    taps = (2 * k + kSimdWidth - 1) / kSimdWidth * kSimdWidth;
+    reversed.assign(taps, 0.0f);
+
+    // Kaiser-windowed sinc of length 4K - 1, cut off at a quarter of the
+    // rate. Taps at even distances from the center are zero, except the
+    // center itself (0.5), which is the delay phase.
+    const double length = static_cast<double>(4 * k - 1);
+    const double center = static_cast<double>(2 * k - 1);
+    const double norm = besselI0(beta);
+    std::vector<double> phase(2 * k);
+    double sum = 0.0;
+    for (size_t m = 0; m < 2 * k; ++m) {
+        const double n = static_cast<double>(2 * m);
+        const double x = (n - center) / 2.0;
+        const double sinc = std::sin(M_PI * x) / (M_PI * x);
+        const double r = 2.0 * n / (length - 1.0) - 1.0;
+        const double window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+        phase[m] = 0.5 * sinc * window;
+        sum += phase[m];
+    }
+
+    // Exactly unity gain at DC: the FIR phase supplies the other half
+    for (size_t m = 0; m < 2 * k; ++m) {
+        reversed[taps - 1 - m] = static_cast<float>(phase[m] * 0.5 / sum);
+    }
+}
+
+void Oversampler::Stage::allocate(int channels, size_t maxFrames) {
+    const size_t c = static_cast<size_t>(channels);
+    upHistory.assign(c, AlignedVector<float>(taps - 1 + maxFrames, 0.0f));
+    downEven.assign(c, AlignedVector<float>(taps - 1 + maxFrames, 0.0f));
+    downOdd.assign(c, AlignedVector<float>(halfTaps + maxFrames, 0.0f));
+    padState.assign(c, 0.0f);
+}
+
+void Oversampler::Stage::clear() {
+    for (auto& history : upHistory) {
+        std::fill(history.begin(), history.end(), 0.0f);
+    }
+    for (auto& history : downEven) {
+        std::fill(history.begin(), history.end(), 0.0f);
+    }
+    for (auto& history : downOdd) {
+        std::fill(history.begin(), history.end(), 0.0f);
+    }
+    std::fill(padState.begin(), padState.end(), 0.0f);
+}
+
+void Oversampler::Stage::up(int channel, const float* input, size_t frames, float* output) {
+    float* history = upHistory[static_cast<size_t>(channel)].data();
+    const size_t keep = taps - 1;
+    std::memcpy(history + keep, input, frames * sizeof(float));
+
+    // Even outputs from the FIR phase (x2 for the zero stuffing), odd ones
+    // are the input delayed to the filter's center
+    const float* delayed = history + (taps - halfTaps);
+    for (size_t i = 0; i < frames; ++i) {
+        output[2 * i] = 2.0f * dot(history + i, reversed.data(), taps);
+        output[2 * i + 1] = delayed[i];
+    }
+
+    std::memmove(history, history + frames, keep * sizeof(float));
+}
+
+void Oversampler::Stage::down(int channel, const float* input, size_t frames, float* output) {
+    const size_t c = static_cast<size_t>(channel);
+    float* even = downEven[c].data();
+    float* odd = downOdd[c].data();
+    const size_t keep = taps - 1;
+
+    for (size_t i = 0; i < frames; ++i) {
+        even[keep + i] = input[2 * i];
+        odd[halfTaps + i] = input[2 * i + 1];
+    }
+    for (size_t i = 0; i < frames; ++i) {
+        output[i] = dot(even + i, reversed.data(), taps) + 0.5f * odd[i];
+    }
+
+    std::memmove(even, even + frames, keep * sizeof(float));
+    std::memmove(odd, odd + frames, halfTaps * sizeof(float));
+
+    if (padOutput) {
+        float previous = padState[c];
+        for (size_t i = 0; i < frames; ++i) {
+            std::swap(previous, output[i]);
+        }
+        padState[c] = previous;
+    }
+}
+
+} // namespace AudioEngine
@@ -0,0 +1,87 @@
+#ifndef OVERSAMPLER_H
+#define OVERSAMPLER_H
+
+#include "alignedbuffer.h"
+#include <cstddef>
+#include <vector>
+
+namespace AudioEngine {
+
+// 2x/4x/8x oversampling for nonlinear processors
+// A cascade of linear-phase half-band FIR stages, each in polyphase form: a
+// half-band filter has every other tap zero, so going up one phase is a
+// short FIR and the other a plain delay, and going down the same split
+// applies to even and odd input samples. The filters are SIMD dot products
+// over contiguous history. The stage next to the base rate carries the
+// steepest filter; later stages only need to reject images far from the
+// audio band and are much shorter.
+// Usage per period: upsample() returns the oversampled channels, process
+// them in place, then downsample() writes the base-rate result. The round
+// trip delays by latency() base-rate frames, always a whole number, for
+// delay compensation.
+class Oversampler {
+public:
+    enum class Quality {
+        Low,        // ~50 dB image rejection up to 0.25 * rate, shortest latency
+        Medium,     // ~70 dB up to 0.35 * rate
+        High        // ~95 dB up to 0.42 * rate, longest latency
+    };
+
+    Oversampler(int channels, int factor, Quality quality, size_t maxBlockFrames);
+
+    int channels() const { return m_channels; }
+    int factor() const { return m_factor; }
+    Quality quality() const { return m_quality; }
+    size_t maxBlockFrames() const { return m_maxBlockFrames; }
+
+    // Round-trip delay of upsample() + downsample(), in base-rate frames
+    int latency() const { return m_latency; }
+
+    // ===== Audio Thread =====
+
+    void reset();
+
+    // frames base-rate frames in; returns factor() * frames per channel,
+    // owned by the oversampler and valid until the next call
+    float* const* upsample(const float* const* input, size_t frames);
+
+    // Decimate the (processed) upsample() buffers into frames base-rate frames
+    void downsample(float* const* output, size_t frames);
+
+private:
+    struct Stage {
+        size_t halfTaps = 0;                // K: the FIR phase has 2K taps
+        size_t taps = 0;                    // 2K padded to the SIMD width
+        AlignedVector<float> reversed;      // FIR phase, newest sample last
+        bool padOutput = false;             // One extra sample of delay on the way down
+
+        // Per channel, linear: taps - 1 samples of history, then the block
+        std::vector<AlignedVector<float>> upHistory;
+        std::vector<AlignedVector<float>> downEven;
+        std::vector<AlignedVector<float>> downOdd;
+        std::vector<float> padState;
+
+        void design(size_t halfTaps, double beta);
+        void allocate(int channels, size_t maxFrames);
+        void clear();
+        void up(int channel, const float* input, size_t frames, float* output);
+        void down(int channel, const float* input, size_t frames, float* output);
+    };
+
+    static float dot(const float* samples, const float* taps, size_t count);
+
+    int m_channels;
+    int m_factor;
+    Quality m_quality;
+    size_t m_maxBlockFrames;
+    int m_latency = 0;
+    std::vector<Stage> m_stages;
+
+    // m_buffers[i][channel]: output of stage i, at factor 2^(i+1)
+    std::vector<std::vector<AlignedVector<float>>> m_buffers;
+    std::vector<float*> m_outputPointers;
+};
+
+} // namespace AudioEngine
+
+#endif // OVERSAMPLER_H
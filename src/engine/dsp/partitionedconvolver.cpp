@@ -0,0 +1,328 @@
+#include "partitionedconvolver.h"
+#include "../common/audioerror.h"
+#include "../realtime/denormalguard.h"
+#include "../realtime/realtimethread.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace AudioEngine {
+
+PartitionedConvolver::PartitionedConvolver(const float* impulse, size_t length)
+    : PartitionedConvolver(impulse, length, Options{})
+{}
+
+PartitionedConvolver::PartitionedConvolver(const float* impulse, size_t length,
+                                           const Options& options)
+    : m_length(length)
+    , m_headBlock(options.headBlock)
+{
+    if (!Fft::isPowerOfTwo(options.headBlock) || !Fft::isPowerOfTwo(options.growth) ||
+        options.growth < 2 || !Fft::isPowerOfTwo(options.maxPartition) ||
+        options.maxPartition < options.headBlock) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration,
+                             "Convolver partition sizes must be powers of two");
+    }
+
+    m_headTaps.assign(m_headBlock, 0.0f);
+    std::copy(impulse, impulse + std::min(length, m_headBlock), m_headTaps.begin());
+    m_headLine.assign(2 * m_headBlock - 1, 0.0f);
+    m_chunk.assign(m_headBlock, 0.0f);
+
+    buildLevels(impulse, options);
+
+    for (auto& level : m_levels) {
+        if (level->background) {
+            Level* target = level.get();
+            level->worker = std::thread([this, target, config = options.workerConfig] {
+                workerLoop(*target, config);
+            });
+        }
+    }
+}
+
+PartitionedConvolver::~PartitionedConvolver() {
+    for (auto& level : m_levels) {
+        if (level->worker.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(level->mutex);
+                level->quit = true;
+            }
+            level->wake.notify_one();
+            level->worker.join();
+        }
+    }
+}
+
+void PartitionedConvolver::buildLevels(const float* impulse, const Options& options) {
+    // Level 0 covers [B, 2 * N1); level k >= 1 covers [2 * Nk, 2 * Nk+1);
+    // the level that reaches maxPartition takes the rest of the IR
+    size_t block = m_headBlock;
+    size_t offset = m_headBlock;
+
+    for (int index = 0; offset < m_length; ++index) {
+        const size_t next = std::min(block * options.growth, options.maxPartition);
+        const bool last = (block == options.maxPartition) || (next == block);
+        const size_t end = last ? m_length : std::min(m_length, 2 * next);
+
+        auto level = std::make_unique<Level>();
+        level->block = block;
+        level->offset = offset;
+        level->partitions = (end - offset + block - 1) / block;
+        level->background = index > 0 && options.backgroundTail;
+
+        const size_t fftSize = 2 * block;
+        const size_t bins = block + 1;
+        level->fft = Fft::get(fftSize);
+        level->spectraRe.assign(level->partitions * bins, 0.0f);
+        level->spectraIm.assign(level->partitions * bins, 0.0f);
+        level->historyRe.assign(level->partitions * bins, 0.0f);
+        level->historyIm.assign(level->partitions * bins, 0.0f);
+        level->accRe.assign(bins, 0.0f);
+        level->accIm.assign(bins, 0.0f);
+        level->window.assign(fftSize, 0.0f);
+        level->transformed.assign(fftSize, 0.0f);
+        level->collecting.assign(block, 0.0f);
+        level->playing.assign(block, 0.0f);
+        level->input.assign(block, 0.0f);
+        level->result.assign(block, 0.0f);
+
+        // Each partition zero-padded to 2N for overlap-save
+        for (size_t p = 0; p < level->partitions; ++p) {
+            std::fill(level->transformed.begin(), level->transformed.end(), 0.0f);
+            const size_t first = offset + p * block;
+            const size_t count = std::min(block, end - first);
+            std::copy(impulse + first, impulse + first + count, level->transformed.begin());
+            level->fft->forwardReal(level->transformed.data(), &level->spectraRe[p * bins],
+                                    &level->spectraIm[p * bins]);
+        }
+
+        m_levels.push_back(std::move(level));
+        if (last) {
+            break;
+        }
+        offset = end;
+        block = next;
+    }
+}
+
+void PartitionedConvolver::process(const float* input, float* output, size_t frames) {
+    const size_t B = m_headBlock;
+    size_t done = 0;
+
+    while (done < frames) {
+        // Every level boundary is a multiple of B, so no chunk straddles one
+        const size_t phase = m_levels.empty() ? 0 : m_levels.front()->position;
+        const size_t n = std::min(frames - done, B - phase % B);
+        std::memcpy(m_chunk.data(), input + done, n * sizeof(float));
+        float* out = output + done;
+
+        // Direct taps: m_headLine holds B - 1 past inputs, then the chunk
+        std::memcpy(m_headLine.data() + (B - 1), m_chunk.data(), n * sizeof(float));
+        for (size_t i = 0; i < n; ++i) {
+            const float* x = m_headLine.data() + (B - 1) + i;
+            float sum = 0.0f;
+            for (size_t m = 0; m < B; ++m) {
+                sum += m_headTaps[m] * x[-static_cast<ptrdiff_t>(m)];
+            }
+            out[i] = sum;
+        }
+        std::memmove(m_headLine.data(), m_headLine.data() + n, (B - 1) * sizeof(float));
+
+        for (auto& levelPtr : m_levels) {
+            Level& level = *levelPtr;
+            const float* playing = level.playing.data() + level.position;
+            for (size_t i = 0; i < n; ++i) {
+                out[i] += playing[i];
+            }
+            std::memcpy(level.collecting.data() + level.position, m_chunk.data(), n * sizeof(float));
+            level.position += n;
+            if (level.position == level.block) {
+                boundary(level);
+            }
+        }
+
+        done += n;
+    }
+}
+
+void PartitionedConvolver::boundary(Level& level) {
+    level.position = 0;
+
+    if (level.background) {
+        // The previous job's output is due now
+        if (level.completed.load(std::memory_order_acquire) != level.posted.load(std::memory_order_relaxed)) {
+            m_lateBlocks.fetch_add(1, std::memory_order_relaxed);
+            while (level.completed.load(std::memory_order_acquire) !=
+                   level.posted.load(std::memory_order_relaxed)) {
+                std::this_thread::yield();
+            }
+        }
+        level.result.swap(level.playing);
+        level.collecting.swap(level.input);
+        level.posted.fetch_add(1, std::memory_order_release);
+        level.wake.notify_one();
+        return;
+    }
+
+    level.collecting.swap(level.input);
+    if (level.offset == level.block) {
+        // Level 0 starts one block in: heard over the very next block
+        computeBlock(level);
+        level.result.swap(level.playing);
+    } else {
+        // Starts two blocks in: play the previous block's result first
+        level.result.swap(level.playing);
+        computeBlock(level);
+    }
+}
+
+void PartitionedConvolver::computeBlock(Level& level) {
+    const size_t N = level.block;
+    const size_t M = 2 * N;
+
+    // Overlap-save: previous block, then this one
+    std::memmove(level.window.data(), level.window.data() + N, N * sizeof(float));
+    std::memcpy(level.window.data() + N, level.input.data(), N * sizeof(float));
+
+    const size_t bins = N + 1;
+    float* spectrumRe = &level.historyRe[level.historyHead * bins];
+    float* spectrumIm = &level.historyIm[level.historyHead * bins];
+    level.fft->forwardReal(level.window.data(), spectrumRe, spectrumIm);
+
+    // Frequency-domain delay line: partition p meets the input from p blocks ago
+    float* accRe = level.accRe.data();
+    float* accIm = level.accIm.data();
+    std::fill(accRe, accRe + bins, 0.0f);
+    std::fill(accIm, accIm + bins, 0.0f);
+    for (size_t p = 0; p < level.partitions; ++p) {
+        const size_t slot = (level.historyHead + level.partitions - p) % level.partitions;
+        const float* xRe = &level.historyRe[slot * bins];
+        const float* xIm = &level.historyIm[slot * bins];
+        const float* hRe = &level.spectraRe[p * bins];
+        const float* hIm = &level.spectraIm[p * bins];
+        for (size_t k = 0; k < bins; ++k) {
+            accRe[k] += xRe[k] * hRe[k] - xIm[k] * hIm[k];
+            accIm[k] += xRe[k] * hIm[k] + xIm[k] * hRe[k];
+        }
+    }
+    level.historyHead = (level.historyHead + 1) % level.partitions;
+
+    level.fft->inverseReal(accRe, accIm, level.transformed.data());
+    const float scale = 1.0f / static_cast<float>(M);
+    for (size_t i = 0; i < N; ++i) {
+        level.result[i] = level.transformed[N + i] * scale;
+    }
+}
+
+void PartitionedConvolver::workerLoop(Level& level, const StreamConfig& config) {
+    RealtimeThread::setupWorkerThread(config);
+    ScopedDenormalGuard denormalGuard;
+
+    uint64_t finished = 0;
+    while (true) {
+        {
+            // The audio thread notifies without the lock; the timeout covers
+            // a notification landing between the check and the wait
+            std::unique_lock<std::mutex> lock(level.mutex);
+            level.wake.wait_for(lock, std::chrono::microseconds(500), [&] {
+                return level.quit || level.posted.load(std::memory_order_acquire) > finished;
+            });
+            if (level.quit) {
+                return;
+            }
+        }
+        if (level.posted.load(std::memory_order_acquire) == finished) {
+            continue;
+        }
+
+        computeBlock(level);
+        ++finished;
+        level.completed.store(finished, std::memory_order_release);
+    }
+}
+
+// ===== AsyncConvolver =====
+
+AsyncConvolver::AsyncConvolver(DeferredReclaimer& reclaimer,
+                               const PartitionedConvolver::Options& options)
+    : m_reclaimer(reclaimer)
+    , m_options(options)
+    , m_fadeInput(kMaxBlockFrames, 0.0f)
+    , m_fadeOutput(kMaxBlockFrames, 0.0f)
+{}
+
+AsyncConvolver::~AsyncConvolver() {
+    waitForLoad();
+    delete m_pending.exchange(nullptr);
+    delete m_active;
+    delete m_retiring;
+}
+
+void AsyncConvolver::loadImpulseResponse(std::vector<float> impulse) {
+    std::lock_guard<std::mutex> lock(m_loaderMutex);
+    if (m_loader.joinable()) {
+        m_loader.join();
+    }
+
+    m_loader = std::thread([this, impulse = std::move(impulse)] {
+        auto convolver = std::make_unique<PartitionedConvolver>(impulse.data(), impulse.size(), m_options);
+
+        // Never seen by the audio thread if it is replaced before pickup
+        delete m_pending.exchange(convolver.release(), std::memory_order_acq_rel);
+    });
+}
+
+void AsyncConvolver::waitForLoad() {
+    std::lock_guard<std::mutex> lock(m_loaderMutex);
+    if (m_loader.joinable()) {
+        m_loader.join();
+    }
+}
+
+void AsyncConvolver::process(const float* input, float* output, size_t frames) {
+    if (m_retiring && m_reclaimer.retireFromAudioThread(m_retiring)) {
+        m_retiring = nullptr;
+    }
+
+    PartitionedConvolver* next = nullptr;
+    if (!m_retiring) {
+        next = m_pending.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    if (!next) {
+        if (m_active) {
+            m_active->process(input, output, frames);
+        } else {
+            std::memset(output, 0, frames * sizeof(float));
+        }
+        return;
+    }
+
+    // Crossfade from the old IR to the new one over this period
+    PartitionedConvolver* previous = m_active;
+    m_active = next;
+
+    for (size_t done = 0; done < frames; done += kMaxBlockFrames) {
+        const size_t n = std::min(kMaxBlockFrames, frames - done);
+        std::memcpy(m_fadeInput.data(), input + done, n * sizeof(float));
+
+        m_active->process(m_fadeInput.data(), m_fadeOutput.data(), n);
+        if (previous) {
+            previous->process(m_fadeInput.data(), output + done, n);
+        } else {
+            std::memset(output + done, 0, n * sizeof(float));
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            const float t = static_cast<float>(done + i + 1) / static_cast<float>(frames);
+            output[done + i] += t * (m_fadeOutput[i] - output[done + i]);
+        }
+    }
+
+    if (previous && !m_reclaimer.retireFromAudioThread(previous)) {
+        m_retiring = previous;
+    }
+}
+
+} // namespace AudioEngine
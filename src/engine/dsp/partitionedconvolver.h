@@ -0,0 +1,158 @@
+#ifndef PARTITIONEDCONVOLVER_H
+#define PARTITIONEDCONVOLVER_H
+
+#include "fft.h"
+#include "../common/audioconfig.h"
+#include "../realtime/deferredreclaimer.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace AudioEngine {
+
+// Zero-latency convolution with long impulse responses
+// The IR is split into levels of growing partition size. The first headBlock
+// taps run as a direct FIR, so there is no added latency. Level 0 covers the
+// next stretch with headBlock-sized FFT partitions computed in process().
+// Each further level uses partitions growth times larger and starts at twice
+// its partition size. A block handed to such a level at a boundary is
+// therefore not heard until one whole block later, and a worker thread
+// computes it in the meantime. The audio thread only waits if a worker misses
+// that deadline.
+// All spectra are transformed in the constructor; build convolvers off the
+// audio thread (AsyncConvolver does this for you).
+class PartitionedConvolver {
+public:
+    struct Options {
+        size_t headBlock = 64;          // Direct taps and level-0 partition size (power of two)
+        size_t growth = 4;              // Partition size ratio between levels (power of two)
+        size_t maxPartition = 8192;     // Largest partition; the last level repeats it
+        bool backgroundTail = true;     // Levels above 0 on worker threads (false: in process())
+        StreamConfig workerConfig;      // Worker scheduling and cores (setupWorkerThread)
+    };
+
+    PartitionedConvolver(const float* impulse, size_t length, const Options& options);
+    PartitionedConvolver(const float* impulse, size_t length);
+    ~PartitionedConvolver();
+
+    // ===== Audio Thread =====
+
+    // output = input convolved with the IR (wet only); input and output may alias
+    void process(const float* input, float* output, size_t frames);
+
+    // ===== Any Thread =====
+
+    size_t getLength() const { return m_length; }
+    int getLevelCount() const { return static_cast<int>(m_levels.size()); }
+    size_t getPartitionSize(int level) const { return m_levels[level]->block; }
+
+    // Tail blocks the audio thread had to wait for
+    uint64_t getLateBlockCount() const { return m_lateBlocks.load(std::memory_order_relaxed); }
+
+private:
+    PartitionedConvolver(const PartitionedConvolver&) = delete;
+    PartitionedConvolver& operator=(const PartitionedConvolver&) = delete;
+
+    struct Level {
+        size_t block = 0;               // Partition size N; FFT size 2N
+        size_t offset = 0;              // First IR tap this level covers
+        size_t partitions = 0;
+        bool background = false;
+        std::shared_ptr<const Fft> fft;
+
+        // Real spectra in split format, N + 1 bins each
+        AlignedVector<float> spectraRe, spectraIm;  // [partition][N + 1]
+        AlignedVector<float> historyRe, historyIm;  // Input spectra, [partition][N + 1] ring
+        size_t historyHead = 0;
+        AlignedVector<float> window;                // Overlap-save input, 2N
+        AlignedVector<float> accRe, accIm;
+        AlignedVector<float> transformed;           // Inverse transform output, 2N
+
+        // Audio thread: collects input and plays the finished block
+        std::vector<float> collecting;
+        std::vector<float> playing;
+        size_t position = 0;
+
+        // Handed to the computation at a boundary / produced by it
+        std::vector<float> input;
+        std::vector<float> result;
+
+        // Worker handshake: one job in flight at most
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::atomic<uint64_t> posted{0};
+        std::atomic<uint64_t> completed{0};
+        bool quit = false;
+    };
+
+    void buildLevels(const float* impulse, const Options& options);
+    void boundary(Level& level);
+    static void computeBlock(Level& level);
+    void workerLoop(Level& level, const StreamConfig& config);
+
+    size_t m_length;
+    size_t m_headBlock;
+
+    // Direct FIR for the first headBlock taps
+    std::vector<float> m_headTaps;
+    std::vector<float> m_headLine;      // headBlock - 1 past inputs, then the chunk
+    std::vector<float> m_chunk;         // Copy of the input chunk (input may alias output)
+
+    std::vector<std::unique_ptr<Level>> m_levels;
+    std::atomic<uint64_t> m_lateBlocks{0};
+};
+
+// Runs a PartitionedConvolver and swaps in new IRs without touching the audio thread
+// loadImpulseResponse() partitions and transforms the IR on a loader thread.
+// The next process() picks the new convolver up and crossfades into it, and
+// the old one is retired through the DeferredReclaimer, so its worker threads
+// are joined off the audio thread.
+class AsyncConvolver {
+public:
+    explicit AsyncConvolver(DeferredReclaimer& reclaimer,
+                            const PartitionedConvolver::Options& options = PartitionedConvolver::Options{});
+    ~AsyncConvolver();  // Audio thread must no longer call process()
+
+    // ===== Control Thread =====
+
+    // Start building a convolver for this IR; replaces any load still pending
+    void loadImpulseResponse(std::vector<float> impulse);
+
+    // Wait for the loader thread to finish (the swap itself happens in process())
+    void waitForLoad();
+
+    // ===== Audio Thread =====
+
+    // Silence until the first IR has loaded
+    void process(const float* input, float* output, size_t frames);
+
+    // ===== Any Thread =====
+
+    // A loaded IR has not been picked up by process() yet
+    bool hasPendingImpulse() const { return m_pending.load(std::memory_order_acquire) != nullptr; }
+
+    static constexpr size_t kMaxBlockFrames = 8192;
+
+private:
+    DeferredReclaimer& m_reclaimer;
+    PartitionedConvolver::Options m_options;
+
+    std::thread m_loader;
+    std::mutex m_loaderMutex;
+    std::atomic<PartitionedConvolver*> m_pending{nullptr};
+
+    // Audio thread
+    PartitionedConvolver* m_active = nullptr;
+    PartitionedConvolver* m_retiring = nullptr;    // Retire queue was full; retried next period
+    std::vector<float> m_fadeInput;
+    std::vector<float> m_fadeOutput;
+};
+
+} // namespace AudioEngine
+
+#endif // PARTITIONEDCONVOLVER_H
@@ -0,0 +1,393 @@
+#include "signalgenerator.h"
+#include "fft.h"
+#include "../common/audioerror.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CADENCE_GENERATOR_SSE2 1
+#endif
+
+namespace AudioEngine {
+
+namespace {
+
+constexpr double kTwoPi = 2.0 * M_PI;
+
+// PolyBLEP residual for a unit step at phase 0, over one sample either side
+inline float blep(float t, float dt, float inv) {
+    if (t < dt) {
+        const float x = t * inv;
+        return x + x - x * x - 1.0f;
+    }
+    if (t > 1.0f - dt) {
+        const float x = (t - 1.0f) * inv;
+        return x * x + x + x + 1.0f;
+    }
+    return 0.0f;
+}
+
+inline float wrap(float t) {
+    return t - std::floor(t);
+}
+
+#if defined(CADENCE_GENERATOR_SSE2)
+
+inline __m128 blep(__m128 t, __m128 dt, __m128 inv) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 x0 = _mm_mul_ps(t, inv);
+    const __m128 after = _mm_sub_ps(_mm_sub_ps(_mm_add_ps(x0, x0), _mm_mul_ps(x0, x0)), one);
+    const __m128 x1 = _mm_mul_ps(_mm_sub_ps(t, one), inv);
+    const __m128 before = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x1, x1), _mm_add_ps(x1, x1)), one);
+    return _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(t, dt), after),
+                     _mm_and_ps(_mm_cmpgt_ps(t, _mm_sub_ps(one, dt)), before));
+}
+
+// Fractional part of non-negative values
+inline __m128 wrap(__m128 t) {
+    return _mm_sub_ps(t, _mm_cvtepi32_ps(_mm_cvttps_epi32(t)));
+}
+
+#endif
+
+}
+
+// ===== SineOscillator =====
+
+SineOscillator::SineOscillator(double sampleRate, double frequency) {
+    setFrequency(sampleRate, frequency);
+}
+
+void SineOscillator::setFrequency(double sampleRate, double frequency) {
+    m_increment = kTwoPi * frequency / sampleRate;
+}
+
+void SineOscillator::reset(double phase) {
+    m_phase = std::fmod(phase, kTwoPi);
+}
+
+void SineOscillator::generate(float* out, size_t frames, float gain) {
+    for (size_t offset = 0; offset < frames; offset += kAnchorFrames) {
+        generateChunk(out + offset, std::min(kAnchorFrames, frames - offset), gain);
+    }
+}
+
+void SineOscillator::generateChunk(float* out, size_t frames, float gain) {
+    // Lane k holds sample n + k; each step rotates every lane by four samples
+    const double w = m_increment;
+    const float rotCos = static_cast<float>(std::cos(4.0 * w));
+    const float rotSin = static_cast<float>(std::sin(4.0 * w));
+    alignas(16) float c[4], s[4];
+    for (int k = 0; k < 4; ++k) {
+        c[k] = static_cast<float>(std::cos(m_phase + k * w));
+        s[k] = static_cast<float>(std::sin(m_phase + k * w));
+    }
+
+    size_t i = 0;
+#if defined(CADENCE_GENERATOR_SSE2)
+    __m128 vc = _mm_load_ps(c);
+    __m128 vs = _mm_load_ps(s);
+    const __m128 rc = _mm_set1_ps(rotCos);
+    const __m128 rs = _mm_set1_ps(rotSin);
+    const __m128 g = _mm_set1_ps(gain);
+    for (; i + 4 <= frames; i += 4) {
+        _mm_storeu_ps(out + i, _mm_mul_ps(vs, g));
+        const __m128 nc = _mm_sub_ps(_mm_mul_ps(vc, rc), _mm_mul_ps(vs, rs));
+        vs = _mm_add_ps(_mm_mul_ps(vs, rc), _mm_mul_ps(vc, rs));
+        vc = nc;
+    }
+    _mm_store_ps(c, vc);
+    _mm_store_ps(s, vs);
+#else
+    for (; i + 4 <= frames; i += 4) {
+        for (int k = 0; k < 4; ++k) {
+            out[i + k] = s[k] * gain;
+            const float nc = c[k] * rotCos - s[k] * rotSin;
+            s[k] = s[k] * rotCos + c[k] * rotSin;
+            c[k] = nc;
+        }
+    }
+#endif
+    for (int k = 0; i < frames; ++i, ++k) {
+        out[i] = s[k] * gain;
+    }
+
+    m_phase = std::fmod(m_phase + static_cast<double>(frames) * w, kTwoPi);
+}
+
+// ===== BlepOscillator =====
+
+BlepOscillator::BlepOscillator(Shape shape, double sampleRate, double frequency)
+    : m_shape(shape)
+{
+    setFrequency(sampleRate, frequency);
+}
+
+void BlepOscillator::setFrequency(double sampleRate, double frequency) {
+    // The two correction windows must not overlap
+    m_increment = static_cast<float>(std::clamp(frequency / sampleRate, 0.0, 0.49));
+}
+
+void BlepOscillator::reset(double phase) {
+    m_phase = static_cast<float>(phase - std::floor(phase));
+}
+
+void BlepOscillator::generate(float* out, size_t frames, float gain) {
+    const float dt = m_increment;
+    if (dt <= 0.0f) {
+        std::fill(out, out + frames, 0.0f);
+        return;
+    }
+    const float inv = 1.0f / dt;
+    const bool square = m_shape == Shape::Square;
+    float phase = m_phase;
+    size_t i = 0;
+
+#if defined(CADENCE_GENERATOR_SSE2)
+    // Lane k holds the phase of sample i + k
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vinv = _mm_set1_ps(inv);
+    const __m128 step = _mm_set1_ps(4.0f * dt);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 g = _mm_set1_ps(gain);
+    __m128 t = wrap(_mm_add_ps(_mm_set1_ps(phase), _mm_mul_ps(vdt, _mm_set_ps(4.0f, 3.0f, 2.0f, 1.0f))));
+    for (; i + 4 <= frames; i += 4) {
+        __m128 y;
+        if (square) {
+            const __m128 naive = _mm_sub_ps(one, _mm_and_ps(_mm_cmpge_ps(t, half), two));
+            y = _mm_sub_ps(_mm_add_ps(naive, blep(t, vdt, vinv)), blep(wrap(_mm_add_ps(t, half)), vdt, vinv));
+        } else {
+            y = _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(two, t), one), blep(t, vdt, vinv));
+        }
+        _mm_storeu_ps(out + i, _mm_mul_ps(y, g));
+        t = wrap(_mm_add_ps(t, step));
+    }
+    // Back to the phase before the next sample
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, t);
+    phase = wrap(lanes[0] - dt + 1.0f);
+#endif
+
+    for (; i < frames; ++i) {
+        phase = wrap(phase + dt);
+        float y;
+        if (square) {
+            y = (phase < 0.5f ? 1.0f : -1.0f) + blep(phase, dt, inv) - blep(wrap(phase + 0.5f), dt, inv);
+        } else {
+            y = 2.0f * phase - 1.0f - blep(phase, dt, inv);
+        }
+        out[i] = y * gain;
+    }
+    m_phase = phase;
+}
+
+// ===== NoiseGenerator =====
+
+NoiseGenerator::NoiseGenerator(uint32_t seed) {
+    reset(seed);
+}
+
+void NoiseGenerator::reset(uint32_t seed) {
+    m_random.reset(seed);
+    m_b0 = m_b1 = m_b2 = 0.0f;
+}
+
+void NoiseGenerator::white(float* out, size_t frames, float gain) {
+    const float scale = gain / 2147483648.0f;
+    alignas(16) float tail[4];
+#if defined(CADENCE_GENERATOR_SSE2)
+    __m128i x = m_random.load();
+    const __m128 s = _mm_set1_ps(scale);
+    for (size_t i = 0; i < frames; i += 4) {
+        x = XorShift4::step(x);
+        const __m128 y = _mm_mul_ps(_mm_cvtepi32_ps(x), s);
+        if (i + 4 <= frames) {
+            _mm_storeu_ps(out + i, y);
+        } else {
+            _mm_store_ps(tail, y);
+            std::memcpy(out + i, tail, (frames - i) * sizeof(float));
+        }
+    }
+    m_random.store(x);
+#else
+    for (size_t i = 0; i < frames; i += 4) {
+        for (int k = 0; k < 4; ++k) {
+            tail[k] = static_cast<float>(static_cast<int32_t>(m_random.next(k))) * scale;
+        }
+        std::memcpy(out + i, tail, std::min<size_t>(4, frames - i) * sizeof(float));
+    }
+#endif
+}
+
+void NoiseGenerator::pink(float* out, size_t frames, float gain) {
+    white(out, frames, 1.0f);
+
+    // Brings the filter's output RMS back near white's
+    const float scale = 0.34f * gain;
+    float b0 = m_b0, b1 = m_b1, b2 = m_b2;
+    for (size_t i = 0; i < frames; ++i) {
+        const float w = out[i];
+        b0 = 0.99765f * b0 + w * 0.0990460f;
+        b1 = 0.96300f * b1 + w * 0.2965164f;
+        b2 = 0.57000f * b2 + w * 1.0526913f;
+        out[i] = (b0 + b1 + b2 + w * 0.1848f) * scale;
+    }
+    m_b0 = b0;
+    m_b1 = b1;
+    m_b2 = b2;
+}
+
+// ===== LogSweep =====
+
+LogSweep::LogSweep(double sampleRate, double startHz, double endHz, double seconds) {
+    if (sampleRate <= 0.0 || startHz <= 0.0 || endHz <= startHz || seconds <= 0.0) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration, "Invalid sweep range");
+    }
+    m_length = static_cast<size_t>(seconds * sampleRate);
+    const double samplesPerE = static_cast<double>(m_length) / std::log(endHz / startHz);
+    m_scale = kTwoPi * startHz / sampleRate * samplesPerE;
+    m_rate = 1.0 / samplesPerE;
+}
+
+void LogSweep::generate(float* out, size_t frames, float gain) {
+    for (size_t i = 0; i < frames; ++i, ++m_position) {
+        if (m_position >= m_length) {
+            std::fill(out + i, out + frames, 0.0f);
+            m_position += frames - i;
+            return;
+        }
+        const double phase = m_scale * std::expm1(static_cast<double>(m_position) * m_rate);
+        out[i] = gain * static_cast<float>(std::sin(std::fmod(phase, kTwoPi)));
+    }
+}
+
+// ===== Mls =====
+
+Mls::Mls(int order)
+    : m_order(order)
+{
+    // Galois feedback masks of primitive polynomials, one per order
+    static const uint32_t taps[] = {
+        0x3, 0x6, 0xC, 0x14, 0x30, 0x60, 0xB8, 0x110, 0x240, 0x500, 0x829, 0x100D,
+        0x2015, 0x6000, 0xD008, 0x12000, 0x20400, 0x40023, 0x90000, 0x140000,
+        0x300000, 0x420000, 0xE10000};
+    if (order < 2 || order > 24) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration, "MLS order must be 2..24");
+    }
+    m_taps = taps[order - 2];
+}
+
+void Mls::generate(float* out, size_t frames, float gain) {
+    uint32_t state = m_state;
+    for (size_t i = 0; i < frames; ++i) {
+        const uint32_t bit = state & 1u;
+        state >>= 1;
+        state ^= (0u - bit) & m_taps;
+        out[i] = bit ? gain : -gain;
+    }
+    m_state = state;
+}
+
+long Mls::findDelay(const float* reference, size_t referenceLength,
+                    const float* recorded, size_t recordedLength) {
+    if (referenceLength == 0 || recordedLength < referenceLength) {
+        return -1;
+    }
+
+    // Linear cross-correlation: pad so no lag wraps around
+    size_t size = 2;
+    while (size < recordedLength + referenceLength) {
+        size <<= 1;
+    }
+    auto fft = Fft::get(size);
+    const size_t bins = size / 2 + 1;
+
+    std::vector<float> buffer(size, 0.0f);
+    std::vector<float> refRe(bins), refIm(bins), recRe(bins), recIm(bins);
+    std::copy(reference, reference + referenceLength, buffer.begin());
+    fft->forwardReal(buffer.data(), refRe.data(), refIm.data());
+    std::fill(buffer.begin(), buffer.end(), 0.0f);
+    std::copy(recorded, recorded + recordedLength, buffer.begin());
+    fft->forwardReal(buffer.data(), recRe.data(), recIm.data());
+
+    // recorded * conj(reference)
+    for (size_t k = 0; k < bins; ++k) {
+        const float re = recRe[k] * refRe[k] + recIm[k] * refIm[k];
+        const float im = recIm[k] * refRe[k] - recRe[k] * refIm[k];
+        recRe[k] = re;
+        recIm[k] = im;
+    }
+    fft->inverseReal(recRe.data(), recIm.data(), buffer.data());
+
+    const size_t lags = recordedLength - referenceLength + 1;
+    return static_cast<long>(std::max_element(buffer.begin(), buffer.begin() + static_cast<ptrdiff_t>(lags)) -
+                             buffer.begin());
+}
+
+// ===== ToneGenerator =====
+
+ToneGenerator::ToneGenerator(double sampleRate)
+    : m_sampleRate(sampleRate)
+{
+    setFrequency(m_frequency);
+}
+
+void ToneGenerator::setFrequency(double frequency) {
+    m_frequency = frequency;
+    m_sine.setFrequency(m_sampleRate, frequency);
+    m_blep.setFrequency(m_sampleRate, frequency);
+}
+
+void ToneGenerator::generateMono(float* out, size_t frames) {
+    switch (m_waveform) {
+    case Waveform::Sine:
+        m_sine.generate(out, frames, m_gain);
+        break;
+    case Waveform::Saw:
+        m_blep.setShape(BlepOscillator::Shape::Saw);
+        m_blep.generate(out, frames, m_gain);
+        break;
+    case Waveform::Square:
+        m_blep.setShape(BlepOscillator::Shape::Square);
+        m_blep.generate(out, frames, m_gain);
+        break;
+    case Waveform::WhiteNoise:
+        m_noise.white(out, frames, m_gain);
+        break;
+    case Waveform::PinkNoise:
+        m_noise.pink(out, frames, m_gain);
+        break;
+    }
+}
+
+void ToneGenerator::generate(float* const* channels, int channelCount, size_t frames) {
+    if (channelCount < 1) {
+        return;
+    }
+    generateMono(channels[0], frames);
+    for (int ch = 1; ch < channelCount; ++ch) {
+        std::memcpy(channels[ch], channels[0], frames * sizeof(float));
+    }
+}
+
+void ToneGenerator::generateInterleaved(float* out, int channelCount, size_t frames) {
+    const size_t stride = static_cast<size_t>(std::max(channelCount, 0));
+    const size_t chunk = sizeof(m_scratch) / sizeof(m_scratch[0]);
+    for (size_t offset = 0; offset < frames; offset += chunk) {
+        const size_t n = std::min(chunk, frames - offset);
+        generateMono(m_scratch, n);
+        float* dst = out + offset * stride;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t ch = 0; ch < stride; ++ch) {
+                dst[i * stride + ch] = m_scratch[i];
+            }
+        }
+    }
+}
+
+} // namespace AudioEngine
@@ -0,0 +1,164 @@
+#ifndef SIGNALGENERATOR_H
+#define SIGNALGENERATOR_H
+
+#include "xorshift.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace AudioEngine {
+
+// Oscillators and test signals, generated a block at a time
+// The oscillators never call a trig function per sample: the sine is a
+// recursive quadrature oscillator re-anchored every block, the saw and square
+// are polyBLEP, and the noise is xorshift. Their SIMD paths produce four
+// consecutive samples per instruction. Everything except Mls::findDelay() is
+// real-time safe.
+
+// Sine from a rotating phasor: four lanes hold consecutive samples and one
+// complex multiply advances all four. The phase is re-anchored from a double
+// accumulator every kAnchorFrames, so amplitude and phase never drift.
+class SineOscillator {
+public:
+    static constexpr size_t kAnchorFrames = 1024;
+
+    SineOscillator() = default;
+    SineOscillator(double sampleRate, double frequency);
+
+    void setFrequency(double sampleRate, double frequency);
+    void reset(double phase = 0.0);         // Radians
+
+    // Overwrite out with frames samples of gain * sin
+    void generate(float* out, size_t frames, float gain = 1.0f);
+
+private:
+    void generateChunk(float* out, size_t frames, float gain);
+
+    double m_phase = 0.0;
+    double m_increment = 0.0;   // Radians per sample
+};
+
+// Band-limited saw and square: a naive waveform with polyBLEP corrections
+// smoothing each discontinuity over the sample either side
+class BlepOscillator {
+public:
+    enum class Shape { Saw, Square };
+
+    BlepOscillator() = default;
+    BlepOscillator(Shape shape, double sampleRate, double frequency);
+
+    void setShape(Shape shape) { m_shape = shape; }
+    void setFrequency(double sampleRate, double frequency);     // Below Nyquist
+    void reset(double phase = 0.0);         // Cycles, 0..1
+
+    void generate(float* out, size_t frames, float gain = 1.0f);
+
+private:
+    Shape m_shape = Shape::Saw;
+    float m_phase = 0.0f;
+    float m_increment = 0.0f;   // Cycles per sample
+};
+
+// White and pink noise
+// White is uniform in [-1, 1] from four independent xorshift32 streams, one
+// per SIMD lane. Pink filters white through Paul Kellet's economy filter
+// (-3 dB/octave within ±0.5 dB above 40 Hz at 48 kHz), scaled to roughly
+// white's RMS level.
+class NoiseGenerator {
+public:
+    explicit NoiseGenerator(uint32_t seed = 1);
+
+    void reset(uint32_t seed);
+    void white(float* out, size_t frames, float gain = 1.0f);
+    void pink(float* out, size_t frames, float gain = 1.0f);
+
+private:
+    XorShift4 m_random;
+    float m_b0 = 0.0f, m_b1 = 0.0f, m_b2 = 0.0f;
+};
+
+// Exponential sine sweep for impulse response and distortion measurement
+// The instantaneous frequency rises from startHz to endHz over the sweep's
+// length at a constant rate in octaves per second. Past the end the output
+// is silence.
+class LogSweep {
+public:
+    LogSweep(double sampleRate, double startHz, double endHz, double seconds);
+
+    size_t length() const { return m_length; }
+    size_t position() const { return m_position; }
+    void reset() { m_position = 0; }
+
+    void generate(float* out, size_t frames, float gain = 1.0f);
+
+private:
+    // phase(n) = m_scale * (exp(n * m_rate) - 1)
+    double m_scale;
+    double m_rate;
+    size_t m_length;
+    size_t m_position = 0;
+};
+
+// Maximum length sequence (±1) from a Galois LFSR
+// Its circular autocorrelation is length() at lag zero and -1 elsewhere, so
+// correlating a recording against it finds the delay even under noise.
+class Mls {
+public:
+    // order 2..24; length() is 2^order - 1. Throws AudioException otherwise.
+    explicit Mls(int order);
+
+    int order() const { return m_order; }
+    size_t length() const { return (size_t{1} << m_order) - 1; }
+    void reset() { m_state = 1; }
+
+    // Continues the sequence, wrapping every length() samples
+    void generate(float* out, size_t frames, float gain = 1.0f);
+
+    // Offset of reference inside recorded, from the cross-correlation peak;
+    // -1 when recorded is shorter than reference. Uses an FFT, so call it
+    // off the audio thread.
+    static long findDelay(const float* reference, size_t referenceLength,
+                          const float* recorded, size_t recordedLength);
+
+private:
+    int m_order;
+    uint32_t m_taps;
+    uint32_t m_state = 1;
+};
+
+// Built-in tone source: one of the generators above, written to every
+// output channel
+class ToneGenerator {
+public:
+    enum class Waveform { Sine, Saw, Square, WhiteNoise, PinkNoise };
+
+    explicit ToneGenerator(double sampleRate);
+
+    void setWaveform(Waveform waveform) { m_waveform = waveform; }
+    void setFrequency(double frequency);
+    void setGain(float gain) { m_gain = gain; }
+
+    Waveform waveform() const { return m_waveform; }
+    double frequency() const { return m_frequency; }
+    float gain() const { return m_gain; }
+
+    // ===== Audio Thread =====
+
+    void generate(float* const* channels, int channelCount, size_t frames);
+    void generateInterleaved(float* out, int channelCount, size_t frames);
+
+private:
+    void generateMono(float* out, size_t frames);
+
+    double m_sampleRate;
+    Waveform m_waveform = Waveform::Sine;
+    double m_frequency = 440.0;
+    float m_gain = 0.5f;
+    SineOscillator m_sine;
+    BlepOscillator m_blep;
+    NoiseGenerator m_noise;
+    float m_scratch[256];
+};
+
+} // namespace AudioEngine
+
+#endif // SIGNALGENERATOR_H
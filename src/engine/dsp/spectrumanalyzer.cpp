@@ -0,0 +1,209 @@
+#include "spectrumanalyzer.h"
+#include "../common/audioerror.h"
+#include "../realtime/denormalguard.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace AudioEngine {
+
+namespace {
+constexpr size_t kMixChunk = 256;
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer(double sampleRate)
+    : SpectrumAnalyzer(sampleRate, Options{})
+{}
+
+SpectrumAnalyzer::SpectrumAnalyzer(double sampleRate, const Options& options)
+    : m_options(options)
+    , m_ring(options.ringFrames)
+    , m_mix(kMixChunk, 0.0f)
+{
+    if (!Fft::isPowerOfTwo(options.fftSize) || options.fftSize < 64 || options.bandCount < 1 ||
+        sampleRate <= 0.0 || options.minHz <= 0.0f || options.minHz >= options.maxHz ||
+        options.updateHz <= 0.0) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration,
+                             "Invalid spectrum analyzer configuration");
+    }
+
+    const size_t N = options.fftSize;
+    m_fft = Fft::get(N);
+
+    // Hann window; a full-scale sine peaks at N/4 in its bin
+    m_window.resize(N);
+    for (size_t i = 0; i < N; ++i) {
+        m_window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * i / N));
+    }
+    const float peak = static_cast<float>(N) / 4.0f;
+    m_powerScale = 1.0f / (peak * peak);
+
+    m_history.assign(N, 0.0f);
+    m_drainBuffer.assign(N, 0.0f);
+    m_block.assign(N, 0.0f);
+    m_windowed.assign(N, 0.0f);
+    m_re.assign(N / 2 + 1, 0.0f);
+    m_im.assign(N / 2 + 1, 0.0f);
+    m_power.assign(N / 2 + 1, 0.0f);
+
+    buildBands(sampleRate);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer() {
+    stop();
+}
+
+void SpectrumAnalyzer::buildBands(double sampleRate) {
+    const size_t N = m_options.fftSize;
+    const double maxHz = std::min<double>(m_options.maxHz, sampleRate / 2.0);
+    const double minHz = std::min<double>(m_options.minHz, maxHz / 2.0);
+    const double binsPerHz = static_cast<double>(N) / sampleRate;
+    const int count = m_options.bandCount;
+
+    auto edge = [&](int i) { return minHz * std::pow(maxHz / minHz, static_cast<double>(i) / count); };
+
+    m_bands.resize(static_cast<size_t>(count));
+    m_bandCenters.resize(static_cast<size_t>(count));
+    for (int b = 0; b < count; ++b) {
+        const double low = edge(b);
+        const double high = edge(b + 1);
+        const double center = std::sqrt(low * high);
+
+        Band& band = m_bands[static_cast<size_t>(b)];
+        band.firstBin = std::min(N / 2, static_cast<size_t>(std::ceil(low * binsPerHz)));
+        band.lastBin = std::min(N / 2 + 1, static_cast<size_t>(std::ceil(high * binsPerHz)));
+        band.position = static_cast<float>(std::min(center * binsPerHz, static_cast<double>(N / 2 - 1)));
+        m_bandCenters[static_cast<size_t>(b)] = static_cast<float>(center);
+    }
+}
+
+void SpectrumAnalyzer::start() {
+    if (m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = false;
+    }
+    m_thread = std::thread([this] { analysisLoop(); });
+}
+
+void SpectrumAnalyzer::stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void SpectrumAnalyzer::push(const float* samples, size_t frames) {
+    const size_t written = m_ring.push(samples, frames);
+    if (written < frames) {
+        m_droppedFrames.fetch_add(frames - written, std::memory_order_relaxed);
+    }
+}
+
+void SpectrumAnalyzer::pushInterleaved(const float* samples, size_t frames, int channels) {
+    if (channels <= 1) {
+        push(samples, frames);
+        return;
+    }
+
+    const float gain = 1.0f / static_cast<float>(channels);
+    for (size_t done = 0; done < frames; done += kMixChunk) {
+        const size_t n = std::min(kMixChunk, frames - done);
+        const float* in = samples + done * static_cast<size_t>(channels);
+        for (size_t i = 0; i < n; ++i) {
+            float sum = 0.0f;
+            for (int c = 0; c < channels; ++c) {
+                sum += in[i * static_cast<size_t>(channels) + static_cast<size_t>(c)];
+            }
+            m_mix[i] = sum * gain;
+        }
+        push(m_mix.data(), n);
+    }
+}
+
+bool SpectrumAnalyzer::drain() {
+    const size_t N = m_options.fftSize;
+    bool received = false;
+
+    // Only the newest fftSize samples matter; older ones are overwritten
+    while (size_t n = m_ring.pop(m_drainBuffer.data(), N)) {
+        received = true;
+        for (size_t i = 0; i < n; ++i) {
+            m_history[m_historyHead] = m_drainBuffer[i];
+            m_historyHead = (m_historyHead + 1) % N;
+        }
+    }
+    return received;
+}
+
+void SpectrumAnalyzer::analysisLoop() {
+    ScopedDenormalGuard denormalGuard;
+
+    using Clock = std::chrono::steady_clock;
+    const auto interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / m_options.updateHz));
+    auto next = Clock::now();
+    const size_t N = m_options.fftSize;
+
+    while (true) {
+        if (drain()) {
+            std::copy(m_history.begin() + static_cast<ptrdiff_t>(m_historyHead), m_history.end(), m_block.begin());
+            std::copy(m_history.begin(), m_history.begin() + static_cast<ptrdiff_t>(m_historyHead),
+                      m_block.begin() + static_cast<ptrdiff_t>(N - m_historyHead));
+
+            SpectrumFrame& frame = m_frames.writeBuffer();
+            frame.bandsDb.resize(m_bands.size());
+            analyze(m_block.data(), frame.bandsDb.data());
+            frame.sequence = ++m_sequence;
+            m_frames.publish();
+        }
+
+        // Fixed cadence; after a stall, resume from now rather than catching up
+        next += interval;
+        const auto now = Clock::now();
+        if (next < now) {
+            next = now;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_wake.wait_until(lock, next, [this] { return m_quit; })) {
+            return;
+        }
+    }
+}
+
+void SpectrumAnalyzer::analyze(const float* block, float* bandsDb) {
+    const size_t N = m_options.fftSize;
+    for (size_t i = 0; i < N; ++i) {
+        m_windowed[i] = block[i] * m_window[i];
+    }
+    m_fft->forwardReal(m_windowed.data(), m_re.data(), m_im.data());
+    for (size_t k = 0; k <= N / 2; ++k) {
+        m_power[k] = (m_re[k] * m_re[k] + m_im[k] * m_im[k]) * m_powerScale;
+    }
+
+    for (size_t b = 0; b < m_bands.size(); ++b) {
+        const Band& band = m_bands[b];
+        float power;
+        if (band.lastBin > band.firstBin) {
+            // Peak bin, so a tone reads the same whatever the band width
+            power = *std::max_element(m_power.begin() + static_cast<ptrdiff_t>(band.firstBin),
+                                      m_power.begin() + static_cast<ptrdiff_t>(band.lastBin));
+        } else {
+            // Low bands narrower than a bin: interpolate between neighbours
+            const size_t k = static_cast<size_t>(band.position);
+            const float t = band.position - static_cast<float>(k);
+            power = m_power[k] + t * (m_power[k + 1] - m_power[k]);
+        }
+        bandsDb[b] = power > 0.0f ? std::max(kFloorDb, 10.0f * std::log10(power)) : kFloorDb;
+    }
+}
+
+} // namespace AudioEngine
@@ -0,0 +1,126 @@
+#ifndef SPECTRUMANALYZER_H
+#define SPECTRUMANALYZER_H
+
+#include "alignedbuffer.h"
+#include "fft.h"
+#include "../realtime/spscqueue.h"
+#include "../realtime/triplebuffer.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace AudioEngine {
+
+// One analysis result: level per log-spaced band, dBFS (0 = full-scale sine)
+struct SpectrumFrame {
+    std::vector<float> bandsDb;
+    uint64_t sequence = 0;      // Increments with every analysis
+};
+
+// Spectrum analyzer kept off the audio thread
+// The audio callback only copies samples into a lock-free ring. A plain
+// (SCHED_OTHER) analysis thread drains it at the UI rate, windows the latest
+// fftSize samples, runs the FFT and bins the result into log-frequency bands,
+// then publishes the bands through a triple buffer. The UI reads precomputed
+// bands and applies its own ballistics, the same split as MeterBank.
+class SpectrumAnalyzer {
+public:
+    struct Options {
+        size_t fftSize = 4096;
+        int bandCount = 96;
+        float minHz = 20.0f;
+        float maxHz = 20000.0f;     // Clamped to Nyquist
+        double updateHz = 30.0;
+        size_t ringFrames = 16384;  // Audio buffered between analysis ticks
+    };
+
+    static constexpr float kFloorDb = -120.0f;
+
+    explicit SpectrumAnalyzer(double sampleRate);
+    SpectrumAnalyzer(double sampleRate, const Options& options);
+    ~SpectrumAnalyzer();
+
+    const Options& options() const { return m_options; }
+    int bandCount() const { return m_options.bandCount; }
+    float bandCenterHz(int band) const { return m_bandCenters[static_cast<size_t>(band)]; }
+
+    // ===== Control Thread =====
+
+    void start();
+    void stop();
+    bool isRunning() const { return m_thread.joinable(); }
+
+    // ===== Audio Thread =====
+
+    // Never blocks; frames that do not fit in the ring are dropped and counted
+    void push(const float* samples, size_t frames);
+
+    // Channels are averaged to mono first
+    void pushInterleaved(const float* samples, size_t frames, int channels);
+
+    uint64_t getDroppedFrames() const { return m_droppedFrames.load(std::memory_order_relaxed); }
+
+    // ===== UI Thread (single reader) =====
+
+    // Pick up the latest analysis; returns false if nothing new
+    bool update() { return m_frames.update(); }
+    const SpectrumFrame& frame() const { return m_frames.readBuffer(); }
+
+    // ===== Analysis Thread =====
+
+    // fftSize samples, oldest first, into bandCount() levels. Also usable
+    // directly while the analysis thread is stopped.
+    void analyze(const float* block, float* bandsDb);
+
+private:
+    SpectrumAnalyzer(const SpectrumAnalyzer&) = delete;
+    SpectrumAnalyzer& operator=(const SpectrumAnalyzer&) = delete;
+
+    struct Band {
+        size_t firstBin = 0;        // Bins [firstBin, lastBin) fall inside the band
+        size_t lastBin = 0;
+        float position = 0.0f;      // Fractional bin of the center, for bands narrower than a bin
+    };
+
+    void buildBands(double sampleRate);
+    void analysisLoop();
+    bool drain();
+
+    Options m_options;
+    std::shared_ptr<const Fft> m_fft;
+    std::vector<Band> m_bands;
+    std::vector<float> m_bandCenters;
+
+    // Audio thread -> analysis thread
+    SpscQueue<float> m_ring;
+    std::vector<float> m_mix;               // pushInterleaved() mixdown
+    std::atomic<uint64_t> m_droppedFrames{0};
+
+    // Analysis thread state
+    std::vector<float> m_history;           // Circular, fftSize
+    size_t m_historyHead = 0;
+    std::vector<float> m_drainBuffer;
+    std::vector<float> m_block;
+    AlignedVector<float> m_window;
+    AlignedVector<float> m_windowed;
+    AlignedVector<float> m_re, m_im;
+    std::vector<float> m_power;
+    float m_powerScale = 1.0f;
+    uint64_t m_sequence = 0;
+
+    TripleBuffer<SpectrumFrame> m_frames;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_quit = false;
+};
+
+} // namespace AudioEngine
+
+#endif // SPECTRUMANALYZER_H
@@ -0,0 +1,401 @@
+#include "timestretcher.h"
+#include "../common/audioerror.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace AudioEngine {
+
+namespace {
+
+// Spectral flux above this fraction of the previous frame's total is an onset
+constexpr float kOnsetFlux = 0.5f;
+
+// Catmull-Rom between x0 and x1
+inline float interpolate(float xm1, float x0, float x1, float x2, float t) {
+    const float c1 = 0.5f * (x1 - xm1);
+    const float c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+    const float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+    return ((c3 * t + c2) * t + c1) * t + x0;
+}
+
+inline float wrapPhase(float phase) {
+    constexpr float twoPi = static_cast<float>(2.0 * M_PI);
+    return phase - twoPi * std::round(phase / twoPi);
+}
+
+}
+
+TimeStretcher::TimeStretcher(int channels, double sampleRate, Quality quality)
+    : m_channels(channels)
+    , m_quality(quality)
+{
+    if (channels < 1 || sampleRate <= 0.0) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration,
+                             "Invalid time-stretch configuration");
+    }
+
+    // WSOLA grains of ~20 ms; the vocoder resolves pitch with 4x that
+    size_t grain = 256;
+    while (static_cast<double>(grain) < 0.02 * sampleRate) {
+        grain *= 2;
+    }
+    const size_t chans = static_cast<size_t>(channels);
+
+    if (quality == Quality::Playback) {
+        m_frame = grain;
+        m_hop = grain / 2;          // Hann at 50% overlap sums to one
+        m_search = grain / 4;
+    } else {
+        m_frame = 4 * grain;
+        m_hop = m_frame / 4;        // 75% overlap for the vocoder
+        m_search = 0;
+
+        const size_t bins = m_frame / 2 + 1;
+        m_fft = Fft::get(m_frame);
+        m_grain.assign(m_frame, 0.0f);
+        m_re.assign(bins, 0.0f);
+        m_im.assign(bins, 0.0f);
+        m_lastPhase.assign(chans, std::vector<float>(bins, 0.0f));
+        m_synthPhase.assign(chans, std::vector<float>(bins, 0.0f));
+        m_magnitude.assign(chans, std::vector<float>(bins, 0.0f));
+        m_phase.assign(chans, std::vector<float>(bins, 0.0f));
+        m_lastSpectrum.assign(bins, 0.0f);
+        m_spectrum.assign(bins, 0.0f);
+        m_peaks.reserve(bins);
+    }
+
+    m_window.resize(m_frame);
+    for (size_t i = 0; i < m_frame; ++i) {
+        m_window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * i / m_frame));
+    }
+
+    // Worst case: the largest analysis hop plus a full block of new input
+    const size_t maxAnalysisHop = static_cast<size_t>(m_hop * 4);
+    m_in.assign(chans, std::vector<float>(2 * m_frame + 2 * m_search + maxAnalysisHop + kMaxBlockFrames, 0.0f));
+    m_accumulator.assign(chans, std::vector<float>(m_frame, 0.0f));
+    m_stretched.assign(chans, std::vector<float>(2 * m_hop + 4, 0.0f));
+    m_out.assign(chans, std::vector<float>(2 * kMaxBlockFrames + 4 * m_hop, 0.0f));
+    m_continuation.assign(m_hop, 0.0f);
+    m_mono.assign(2 * m_search + m_hop, 0.0f);
+
+    configureRatios();
+    reset();
+}
+
+void TimeStretcher::reset() {
+    // Grains are centered on their nominal input position: prime with half a
+    // grain of silence and drop the matching half grain of output
+    const size_t lead = m_search + m_frame / 2;
+    for (int ch = 0; ch < m_channels; ++ch) {
+        std::fill(m_in[ch].begin(), m_in[ch].begin() + static_cast<ptrdiff_t>(lead), 0.0f);
+        std::fill(m_accumulator[ch].begin(), m_accumulator[ch].end(), 0.0f);
+        m_stretched[ch][0] = 0.0f;  // Resampler history
+    }
+    m_inFrames = lead;
+    m_readPos = static_cast<double>(m_search);
+    m_skip = m_frame / 2;
+    m_stretchedFrames = 1;
+    m_resamplePos = 1.0;
+    m_outFrames = 0;
+    m_lastStart = 0;
+    m_firstGrain = true;
+    std::fill(m_lastSpectrum.begin(), m_lastSpectrum.end(), 0.0f);
+}
+
+void TimeStretcher::setTimeRatio(double ratio) {
+    m_timeRatio = std::clamp(ratio, kMinTimeRatio, kMaxTimeRatio);
+    configureRatios();
+}
+
+void TimeStretcher::setPitchRatio(double ratio) {
+    m_pitchRatio = std::clamp(ratio, kMinPitchRatio, kMaxPitchRatio);
+    configureRatios();
+}
+
+void TimeStretcher::configureRatios() {
+    m_stretch = std::clamp(m_timeRatio * m_pitchRatio, kMinTimeRatio, kMaxTimeRatio);
+    m_analysisHop = static_cast<double>(m_hop) / m_stretch;
+}
+
+size_t TimeStretcher::inputNeeded() const {
+    return static_cast<size_t>(m_readPos) + m_search + m_frame;
+}
+
+bool TimeStretcher::outputBlocked() const {
+    return m_stretchedFrames + m_hop > m_stretched[0].size();
+}
+
+size_t TimeStretcher::getSamplesRequired() const {
+    if (outputBlocked()) {
+        return 0;
+    }
+    const size_t needed = inputNeeded();
+    return needed > m_inFrames ? needed - m_inFrames : 0;
+}
+
+size_t TimeStretcher::process(const float* const* input, size_t frames) {
+    frames = std::min(frames, m_in[0].size() - m_inFrames);
+    for (int ch = 0; ch < m_channels; ++ch) {
+        std::memcpy(m_in[ch].data() + m_inFrames, input[ch], frames * sizeof(float));
+    }
+    m_inFrames += frames;
+
+    produce();
+    return frames;
+}
+
+size_t TimeStretcher::retrieve(float* const* output, size_t frames) {
+    const size_t n = std::min(frames, m_outFrames);
+    for (int ch = 0; ch < m_channels; ++ch) {
+        float* fifo = m_out[ch].data();
+        std::memcpy(output[ch], fifo, n * sizeof(float));
+        std::memmove(fifo, fifo + n, (m_outFrames - n) * sizeof(float));
+    }
+    m_outFrames -= n;
+
+    // Room in the FIFO may unblock grains already covered by the input
+    produce();
+    return n;
+}
+
+void TimeStretcher::produce() {
+    // Resample first: stretched audio held back by a full FIFO is what
+    // blocks the next grain
+    while (true) {
+        resample();
+        if (outputBlocked() || inputNeeded() > m_inFrames) {
+            break;
+        }
+        step();
+    }
+}
+
+void TimeStretcher::step() {
+    const size_t nominal = static_cast<size_t>(m_readPos);
+    if (m_quality == Quality::Playback) {
+        stepWsola(nominal);
+    } else {
+        stepVocoder(nominal);
+    }
+    emitGrain();
+    m_firstGrain = false;
+    m_readPos += m_analysisHop;
+
+    // Keep only what the next grain (and its search range) can reach; a hop
+    // longer than the grain may skip past input not written yet
+    const size_t discard = std::min(static_cast<size_t>(m_readPos) - m_search, m_inFrames);
+    for (int ch = 0; ch < m_channels; ++ch) {
+        std::memmove(m_in[ch].data(), m_in[ch].data() + discard, (m_inFrames - discard) * sizeof(float));
+    }
+    m_inFrames -= discard;
+    m_readPos -= static_cast<double>(discard);
+    m_lastStart -= static_cast<long>(discard);
+}
+
+void TimeStretcher::stepWsola(size_t nominal) {
+    const size_t hop = m_hop;
+    const size_t range = m_search;
+    const float gain = 1.0f / static_cast<float>(m_channels);
+
+    // Mono over every candidate's overlap region
+    const size_t first = nominal - range;
+    for (size_t i = 0; i < m_mono.size(); ++i) {
+        float sum = 0.0f;
+        for (int ch = 0; ch < m_channels; ++ch) {
+            sum += m_in[ch][first + i];
+        }
+        m_mono[i] = sum * gain;
+    }
+
+    // Offset whose start best matches the previous grain's natural
+    // continuation (normalized cross-correlation); coarse pass, then refine
+    long best = 0;
+    if (!m_firstGrain) {
+        auto score = [&](long offset, size_t stride) {
+            const float* candidate = m_mono.data() + (static_cast<long>(range) + offset);
+            float dot = 0.0f;
+            float energy = 1e-9f;
+            for (size_t i = 0; i < hop; i += stride) {
+                dot += m_continuation[i] * candidate[i];
+                energy += candidate[i] * candidate[i];
+            }
+            return dot / std::sqrt(energy);
+        };
+
+        const long limit = static_cast<long>(range);
+        float bestScore = -1e30f;
+        for (long offset = -limit; offset <= limit; offset += 2) {
+            const float s = score(offset, 2);
+            if (s > bestScore) {
+                bestScore = s;
+                best = offset;
+            }
+        }
+        const long coarse = best;
+        bestScore = score(coarse, 1);
+        for (long offset : {coarse - 1, coarse + 1}) {
+            if (offset >= -limit && offset <= limit) {
+                const float s = score(offset, 1);
+                if (s > bestScore) {
+                    bestScore = s;
+                    best = offset;
+                }
+            }
+        }
+    }
+
+    const size_t start = static_cast<size_t>(static_cast<long>(nominal) + best);
+    for (int ch = 0; ch < m_channels; ++ch) {
+        const float* in = m_in[ch].data() + start;
+        float* acc = m_accumulator[ch].data();
+        for (size_t i = 0; i < m_frame; ++i) {
+            acc[i] += in[i] * m_window[i];
+        }
+    }
+
+    // Where this grain would carry on, for the next grain to match
+    for (size_t i = 0; i < hop; ++i) {
+        float sum = 0.0f;
+        for (int ch = 0; ch < m_channels; ++ch) {
+            sum += m_in[ch][start + hop + i];
+        }
+        m_continuation[i] = sum * gain;
+    }
+}
+
+void TimeStretcher::stepVocoder(size_t start) {
+    const size_t N = m_frame;
+    const size_t bins = N / 2 + 1;
+    const long actualHop = m_firstGrain ? static_cast<long>(m_hop) : static_cast<long>(start) - m_lastStart;
+    m_lastStart = static_cast<long>(start);
+    const float hopScale = static_cast<float>(m_hop) / static_cast<float>(std::max<long>(1, actualHop));
+    const float binAdvance = static_cast<float>(2.0 * M_PI * static_cast<double>(actualHop) / N);
+
+    // Analysis of every channel first: onsets are judged on the sum
+    std::fill(m_spectrum.begin(), m_spectrum.end(), 0.0f);
+    for (int ch = 0; ch < m_channels; ++ch) {
+        const float* in = m_in[ch].data() + start;
+        for (size_t i = 0; i < N; ++i) {
+            m_grain[i] = in[i] * m_window[i];
+        }
+        m_fft->forwardReal(m_grain.data(), m_re.data(), m_im.data());
+        for (size_t k = 0; k < bins; ++k) {
+            m_magnitude[ch][k] = std::sqrt(m_re[k] * m_re[k] + m_im[k] * m_im[k]);
+            m_phase[ch][k] = std::atan2(m_im[k], m_re[k]);
+            m_spectrum[k] += m_magnitude[ch][k];
+        }
+    }
+
+    float flux = 0.0f;
+    float previous = 0.0f;
+    float total = 0.0f;
+    for (size_t k = 0; k < bins; ++k) {
+        flux += std::max(0.0f, m_spectrum[k] - m_lastSpectrum[k]);
+        previous += m_lastSpectrum[k];
+        total += m_spectrum[k];
+    }
+    std::swap(m_spectrum, m_lastSpectrum);
+    const bool onset = flux > kOnsetFlux * previous && total > 1e-6f;
+
+    // Synthesis gain: analysis and synthesis Hann at 75% overlap sum to 1.5
+    const float scale = 1.0f / (1.5f * static_cast<float>(N));
+
+    for (int ch = 0; ch < m_channels; ++ch) {
+        const std::vector<float>& magnitude = m_magnitude[ch];
+        const std::vector<float>& phase = m_phase[ch];
+        std::vector<float>& synth = m_synthPhase[ch];
+        std::vector<float>& last = m_lastPhase[ch];
+
+        m_peaks.clear();
+        for (size_t k = 2; k + 2 < bins; ++k) {
+            const float m = magnitude[k];
+            if (m > 1e-9f && m > magnitude[k - 1] && m >= magnitude[k + 1] &&
+                m > magnitude[k - 2] && m >= magnitude[k + 2]) {
+                m_peaks.push_back(k);
+            }
+        }
+
+        if (m_firstGrain || onset || m_peaks.empty()) {
+            // Phase reset: the grain goes out as analyzed, keeping the attack
+            std::copy(phase.begin(), phase.end(), synth.begin());
+        } else {
+            // Peaks advance at their measured frequency over the output hop
+            for (size_t peak : m_peaks) {
+                const float omega = binAdvance * static_cast<float>(peak);
+                const float deviation = wrapPhase(phase[peak] - last[peak] - omega);
+                synth[peak] = wrapPhase(synth[peak] + (omega + deviation) * hopScale);
+            }
+
+            // Every other bin keeps its analysis offset from the nearest peak
+            size_t region = 0;
+            for (size_t k = 0; k < bins; ++k) {
+                while (region + 1 < m_peaks.size() && k > (m_peaks[region] + m_peaks[region + 1]) / 2) {
+                    ++region;
+                }
+                const size_t peak = m_peaks[region];
+                if (k != peak) {
+                    synth[k] = synth[peak] + phase[k] - phase[peak];
+                }
+            }
+        }
+        std::copy(phase.begin(), phase.end(), last.begin());
+
+        for (size_t k = 0; k < bins; ++k) {
+            m_re[k] = magnitude[k] * std::cos(synth[k]);
+            m_im[k] = magnitude[k] * std::sin(synth[k]);
+        }
+        m_fft->inverseReal(m_re.data(), m_im.data(), m_grain.data());
+
+        float* acc = m_accumulator[ch].data();
+        for (size_t i = 0; i < N; ++i) {
+            acc[i] += m_grain[i] * m_window[i] * scale;
+        }
+    }
+}
+
+void TimeStretcher::emitGrain() {
+    // The first hop of the accumulator is complete; anything still owed to
+    // the alignment lead is dropped instead of emitted
+    const size_t skipped = std::min(m_skip, m_hop);
+    const size_t emitted = m_hop - skipped;
+    m_skip -= skipped;
+
+    for (int ch = 0; ch < m_channels; ++ch) {
+        float* acc = m_accumulator[ch].data();
+        std::memcpy(m_stretched[ch].data() + m_stretchedFrames, acc + skipped, emitted * sizeof(float));
+        std::memmove(acc, acc + m_hop, (m_frame - m_hop) * sizeof(float));
+        std::fill(acc + (m_frame - m_hop), acc + m_frame, 0.0f);
+    }
+    m_stretchedFrames += emitted;
+}
+
+void TimeStretcher::resample() {
+    const size_t capacity = m_out[0].size();
+    const double step = m_pitchRatio;
+
+    // Catmull-Rom needs one frame behind and two ahead of the read position
+    size_t produced = 0;
+    double pos = m_resamplePos;
+    while (static_cast<size_t>(pos) + 2 < m_stretchedFrames && m_outFrames + produced < capacity) {
+        const size_t i = static_cast<size_t>(pos);
+        const float t = static_cast<float>(pos - static_cast<double>(i));
+        for (int ch = 0; ch < m_channels; ++ch) {
+            const float* x = m_stretched[ch].data();
+            m_out[ch][m_outFrames + produced] = interpolate(x[i - 1], x[i], x[i + 1], x[i + 2], t);
+        }
+        ++produced;
+        pos += step;
+    }
+    m_outFrames += produced;
+
+    const size_t discard = static_cast<size_t>(pos) - 1;
+    for (int ch = 0; ch < m_channels; ++ch) {
+        float* x = m_stretched[ch].data();
+        std::memmove(x, x + discard, (m_stretchedFrames - discard) * sizeof(float));
+    }
+    m_stretchedFrames -= discard;
+    m_resamplePos = pos - static_cast<double>(discard);
+}
+
+} // namespace AudioEngine
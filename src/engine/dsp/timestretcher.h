@@ -0,0 +1,139 @@
+#ifndef TIMESTRETCHER_H
+#define TIMESTRETCHER_H
+
+#include "alignedbuffer.h"
+#include "fft.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace AudioEngine {
+
+// Real-time time-stretch and pitch-shift for one clip
+// Playback quality is WSOLA: windowed grains overlap-added at a fixed output
+// hop, each one shifted within a small search range to line up with the
+// waveform that the previous grain would have continued into. It is cheap
+// and keeps transients fairly sharp, but can sound phasey on dense material.
+// HighQuality is a phase vocoder with identity phase locking (bins follow the
+// phase of their spectral peak) and a phase reset on detected onsets, so
+// drums stay crisp. It costs several times more and is meant for offline
+// render and the stretch cache.
+// Pitch shifting stretches by timeRatio * pitchRatio and then resamples by
+// pitchRatio. Output is aligned with the input: the first output frame
+// corresponds to the first input frame. Audio flows through internal FIFOs:
+// write input with process() until available() covers the period, then
+// retrieve(). Nothing allocates after construction.
+class TimeStretcher {
+public:
+    enum class Quality {
+        Playback,       // WSOLA
+        HighQuality     // Phase-locked vocoder with transient reset
+    };
+
+    static constexpr double kMinTimeRatio = 0.25;
+    static constexpr double kMaxTimeRatio = 4.0;
+    static constexpr double kMinPitchRatio = 0.5;
+    static constexpr double kMaxPitchRatio = 2.0;
+
+    // Most frames a single process() or retrieve() may carry
+    static constexpr size_t kMaxBlockFrames = 8192;
+
+    TimeStretcher(int channels, double sampleRate, Quality quality);
+
+    int channels() const { return m_channels; }
+    Quality quality() const { return m_quality; }
+
+    // ===== Control Thread =====
+
+    // Drop all buffered audio and restart alignment at the next input frame
+    void reset();
+
+    // ===== Audio Thread =====
+
+    // Output duration over input duration (2 = half speed). Applies from the
+    // next grain; clamped so the internal stretch stays within 0.25..4.
+    void setTimeRatio(double ratio);
+
+    // Frequency multiplier (2 = up an octave)
+    void setPitchRatio(double ratio);
+
+    double getTimeRatio() const { return m_timeRatio; }
+    double getPitchRatio() const { return m_pitchRatio; }
+
+    // Input frames needed before the next grain can be produced; 0 while
+    // the output FIFO is full
+    size_t getSamplesRequired() const;
+
+    // Append input (planar) and produce every grain it allows. Returns the
+    // frames taken: at least min(frames, kMaxBlockFrames), fewer than frames
+    // once the input buffer is full. Send the rest after retrieve().
+    size_t process(const float* const* input, size_t frames);
+
+    size_t available() const { return m_outFrames; }
+
+    // Pop up to frames of output; returns the number written
+    size_t retrieve(float* const* output, size_t frames);
+
+private:
+    void configureRatios();
+    size_t inputNeeded() const;
+    bool outputBlocked() const;
+    void produce();
+    void step();
+    void stepWsola(size_t nominal);
+    void stepVocoder(size_t start);
+    void emitGrain();
+    void resample();
+
+    int m_channels;
+    Quality m_quality;
+    double m_timeRatio = 1.0;
+    double m_pitchRatio = 1.0;
+    double m_stretch = 1.0;         // timeRatio * pitchRatio
+    double m_analysisHop = 0.0;     // Input frames per grain
+
+    size_t m_frame = 0;             // Grain (WSOLA) or FFT (vocoder) length
+    size_t m_hop = 0;               // Output frames per grain
+    size_t m_search = 0;            // WSOLA offset range, +-frames
+    AlignedVector<float> m_window;
+
+    // Input: planar, linear, compacted as grains consume it
+    std::vector<std::vector<float>> m_in;
+    size_t m_inFrames = 0;
+    double m_readPos = 0.0;         // Nominal start of the next grain
+
+    // Overlap-add accumulator, m_frame per channel
+    std::vector<std::vector<float>> m_accumulator;
+    size_t m_skip = 0;              // Stretched frames still to drop for alignment
+
+    // Stretched audio waiting for the pitch resampler
+    std::vector<std::vector<float>> m_stretched;
+    size_t m_stretchedFrames = 0;
+    double m_resamplePos = 1.0;
+
+    // Output FIFO
+    std::vector<std::vector<float>> m_out;
+    size_t m_outFrames = 0;
+
+    // WSOLA: mono of where the previous grain would have continued
+    std::vector<float> m_continuation;
+    std::vector<float> m_mono;
+
+    // Vocoder state, per channel where noted
+    std::shared_ptr<const Fft> m_fft;
+    std::vector<float> m_grain;
+    AlignedVector<float> m_re, m_im;
+    std::vector<std::vector<float>> m_lastPhase;     // Analysis phase, per channel
+    std::vector<std::vector<float>> m_synthPhase;    // Per channel
+    std::vector<std::vector<float>> m_magnitude;     // Per channel
+    std::vector<std::vector<float>> m_phase;         // Per channel
+    std::vector<float> m_lastSpectrum;               // Summed magnitude for onsets
+    std::vector<float> m_spectrum;
+    std::vector<size_t> m_peaks;
+    long m_lastStart = 0;           // Previous grain start, may precede the buffer
+    bool m_firstGrain = true;
+};
+
+} // namespace AudioEngine
+
+#endif // TIMESTRETCHER_H
@@ -0,0 +1,71 @@
+#ifndef XORSHIFT_H
+#define XORSHIFT_H
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CADENCE_XORSHIFT_SSE2 1
+#endif
+
+namespace AudioEngine {
+
+// Four independent xorshift32 streams, one per SIMD lane
+// Shared by the noise generator and dither: cheap, allocation-free and
+// deterministic from a seed, which is all audio noise needs. The SSE2 step
+// advances the four lanes exactly as four scalar steps would, so both paths
+// produce the same sequence.
+class XorShift4 {
+public:
+    explicit XorShift4(uint32_t seed = 1) { reset(seed); }
+
+    // Restart all four lanes from seed; nearby seeds give unrelated streams
+    void reset(uint32_t seed) {
+        for (uint32_t k = 0; k < 4; ++k) {
+            m_state[k] = mix(seed * 4 + k + 1) | 1u;     // xorshift must not start at zero
+        }
+    }
+
+    // Advance one lane and return its new word
+    uint32_t next(int lane) {
+        m_state[lane] = step(m_state[lane]);
+        return m_state[lane];
+    }
+
+    static uint32_t step(uint32_t x) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        return x;
+    }
+
+#if defined(CADENCE_XORSHIFT_SSE2)
+    // Hot loops keep the state in a register: load, step, store back
+    __m128i load() const { return _mm_load_si128(reinterpret_cast<const __m128i*>(m_state)); }
+    void store(__m128i x) { _mm_store_si128(reinterpret_cast<__m128i*>(m_state), x); }
+
+    static __m128i step(__m128i x) {
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+        return x;
+    }
+#endif
+
+private:
+    // Integer hash (lowbias32) to spread small seeds over the state space
+    static uint32_t mix(uint32_t x) {
+        x ^= x >> 16;
+        x *= 0x7feb352dU;
+        x ^= x >> 15;
+        x *= 0x846ca68bU;
+        x ^= x >> 16;
+        return x;
+    }
+
+    alignas(16) uint32_t m_state[4];
+};
+
+} // namespace AudioEngine
+
+#endif // XORSHIFT_H
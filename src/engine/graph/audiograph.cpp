@@ -0,0 +1,373 @@
+#include "audiograph.h"
+#include "../common/audioerror.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace AudioEngine {
+
+AudioGraph::~AudioGraph() = default;
+
+AudioGraph::NodeId AudioGraph::addNode(std::unique_ptr<AudioNode> node) {
+    if (!node) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration, "Cannot add a null node to the graph");
+    }
+    NodeEntry entry;
+    entry.inputs.resize(static_cast<size_t>(node->inputCount()));
+    entry.node = std::move(node);
+    m_nodes.push_back(std::move(entry));
+    m_compiled = false;
+    return static_cast<NodeId>(m_nodes.size() - 1);
+}
+
+void AudioGraph::checkNode(NodeId id) const {
+    if (id < 0 || id >= static_cast<NodeId>(m_nodes.size())) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration, "Unknown graph node " + std::to_string(id));
+    }
+}
+
+void AudioGraph::connect(NodeId source, int output, NodeId destination, int input) {
+    checkNode(source);
+    checkNode(destination);
+    if (output < 0 || output >= m_nodes[static_cast<size_t>(source)].node->outputCount() ||
+        input < 0 || input >= m_nodes[static_cast<size_t>(destination)].node->inputCount()) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration, "Graph connection to a missing port");
+    }
+    m_nodes[static_cast<size_t>(destination)].inputs[static_cast<size_t>(input)] = {source, output};
+    m_compiled = false;
+}
+
+void AudioGraph::connectToOutput(NodeId source, int output, int channel) {
+    checkNode(source);
+    if (output < 0 || output >= m_nodes[static_cast<size_t>(source)].node->outputCount() || channel < 0) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration, "Graph output route to a missing port");
+    }
+    if (static_cast<size_t>(channel) >= m_outputRoutes.size()) {
+        m_outputRoutes.resize(static_cast<size_t>(channel) + 1);
+    }
+    m_outputRoutes[static_cast<size_t>(channel)] = {source, output};
+    m_compiled = false;
+}
+
+void AudioGraph::compile(double sampleRate, size_t maxFrames, int outputChannels) {
+    if (maxFrames == 0 || outputChannels < 0) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration, "Graph needs a block size");
+    }
+    const size_t count = m_nodes.size();
+
+    // Kahn's algorithm; ties keep insertion order so schedules are reproducible
+    std::vector<int> pending(count, 0);
+    std::vector<std::vector<NodeId>> consumers(count);
+    for (size_t id = 0; id < count; ++id) {
+        for (const Port& port : m_nodes[id].inputs) {
+            if (port.node >= 0) {
+                ++pending[id];
+                consumers[static_cast<size_t>(port.node)].push_back(static_cast<NodeId>(id));
+            }
+        }
+    }
+    std::vector<NodeId> order;
+    order.reserve(count);
+    for (size_t id = 0; id < count; ++id) {
+        if (pending[id] == 0) {
+            order.push_back(static_cast<NodeId>(id));
+        }
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (NodeId consumer : consumers[static_cast<size_t>(order[i])]) {
+            if (--pending[static_cast<size_t>(consumer)] == 0) {
+                order.push_back(consumer);
+            }
+        }
+    }
+    if (order.size() != count) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration, "Graph connections form a cycle");
+    }
+
+    // Fusion: a trivial node folds into its consumer when that is trivial
+    // too and takes every output of it, and nothing else reads them
+    std::vector<char> routed(count, 0);
+    for (const Port& route : m_outputRoutes) {
+        if (route.node >= 0) {
+            routed[static_cast<size_t>(route.node)] = 1;
+        }
+    }
+    std::vector<std::vector<int>> portUses(count);
+    for (size_t id = 0; id < count; ++id) {
+        portUses[id].assign(static_cast<size_t>(m_nodes[id].node->outputCount()), 0);
+    }
+    for (size_t id = 0; id < count; ++id) {
+        for (const Port& port : m_nodes[id].inputs) {
+            if (port.node >= 0) {
+                ++portUses[static_cast<size_t>(port.node)][static_cast<size_t>(port.output)];
+            }
+        }
+    }
+    auto fusable = [&](NodeId id) {
+        const AudioNode& node = *m_nodes[static_cast<size_t>(id)].node;
+        switch (m_fusionEnabled ? node.fusion() : AudioNode::Fusion::None) {
+        case AudioNode::Fusion::Elementwise:
+            return node.outputCount() > 0 && node.inputCount() == node.outputCount();
+        case AudioNode::Fusion::Sum:
+            return node.outputCount() > 0 && node.inputCount() % node.outputCount() == 0;
+        default:
+            return false;
+        }
+    };
+
+    std::vector<char> folded(count, 0);
+    std::vector<size_t> depth(count, 0);     // Gains per term, capped for the kernel
+    for (NodeId id : order) {
+        const size_t index = static_cast<size_t>(id);
+        if (!fusable(id)) {
+            continue;
+        }
+        for (const Port& port : m_nodes[index].inputs) {
+            if (port.node >= 0 && folded[static_cast<size_t>(port.node)]) {
+                depth[index] = std::max(depth[index], depth[static_cast<size_t>(port.node)]);
+            }
+        }
+        if (m_nodes[index].node->fusion() == AudioNode::Fusion::Elementwise) {
+            ++depth[index];
+        }
+
+        const std::vector<NodeId>& users = consumers[index];
+        bool fold = !routed[index] && !users.empty() && depth[index] < ElementwiseKernel::kMaxRamps &&
+                    fusable(users.front()) &&
+                    std::all_of(users.begin(), users.end(), [&](NodeId user) { return user == users.front(); });
+        for (int uses : portUses[index]) {
+            fold = fold && uses == 1;
+        }
+        folded[index] = fold;
+    }
+
+    m_maxFrames = maxFrames;
+    m_zeros.assign(maxFrames, 0.0f);
+    m_zeroFlag = true;
+
+    m_buffers.assign(count, {});
+    m_gains.assign(count, {});
+    for (size_t id = 0; id < count; ++id) {
+        m_buffers[id].resize(static_cast<size_t>(m_nodes[id].node->outputCount()));
+        for (Buffer& buffer : m_buffers[id]) {
+            buffer.samples.assign(folded[id] ? 0 : maxFrames, 0.0f);
+            buffer.silent = true;
+        }
+        if (fusable(static_cast<NodeId>(id))) {
+            m_gains[id].resize(static_cast<size_t>(m_nodes[id].node->outputCount()));
+        }
+    }
+
+    // What each trivial node's outputs compute, in terms of unfolded buffers
+    std::vector<std::vector<std::vector<Term>>> expressions(count);
+    auto leafTerms = [&](const Port& input) {
+        if (input.node >= 0 && folded[static_cast<size_t>(input.node)]) {
+            return expressions[static_cast<size_t>(input.node)][static_cast<size_t>(input.output)];
+        }
+        return std::vector<Term>{Term{input, {}}};
+    };
+
+    m_schedule.clear();
+    m_schedule.reserve(count);
+    for (NodeId id : order) {
+        NodeEntry& entry = m_nodes[static_cast<size_t>(id)];
+        entry.node->prepare(sampleRate, maxFrames);
+
+        Step step;
+        if (fusable(id)) {
+            const int outputs = entry.node->outputCount();
+            auto& expression = expressions[static_cast<size_t>(id)];
+            expression.resize(static_cast<size_t>(outputs));
+            for (int o = 0; o < outputs; ++o) {
+                if (entry.node->fusion() == AudioNode::Fusion::Elementwise) {
+                    expression[static_cast<size_t>(o)] = leafTerms(entry.inputs[static_cast<size_t>(o)]);
+                    for (Term& term : expression[static_cast<size_t>(o)]) {
+                        term.gains.push_back({id, o});
+                    }
+                } else {
+                    for (int s = 0; s < entry.node->inputCount() / outputs; ++s) {
+                        std::vector<Term> terms = leafTerms(entry.inputs[static_cast<size_t>(s * outputs + o)]);
+                        expression[static_cast<size_t>(o)].insert(expression[static_cast<size_t>(o)].end(),
+                                                                  terms.begin(), terms.end());
+                    }
+                }
+            }
+            if (folded[static_cast<size_t>(id)]) {
+                continue;
+            }
+            buildFusedStep(step, expression);
+        } else {
+            step.node = entry.node.get();
+            for (const Port& port : entry.inputs) {
+                if (port.node >= 0) {
+                    const Buffer& source = m_buffers[static_cast<size_t>(port.node)][static_cast<size_t>(port.output)];
+                    step.inputs.push_back(source.samples.data());
+                    step.inputFlags.push_back(&source.silent);
+                } else {
+                    step.inputs.push_back(m_zeros.data());
+                    step.inputFlags.push_back(&m_zeroFlag);
+                }
+            }
+        }
+
+        for (Buffer& buffer : m_buffers[static_cast<size_t>(id)]) {
+            step.outputBuffers.push_back(&buffer);
+            step.outputs.push_back(buffer.samples.data());
+        }
+        step.inputSilent.reset(new bool[step.inputs.size() + 1]());
+        step.outputSilent.reset(new bool[step.outputs.size() + 1]());
+        m_schedule.push_back(std::move(step));
+    }
+
+    m_outputTaps.assign(static_cast<size_t>(outputChannels), nullptr);
+    for (size_t ch = 0; ch < m_outputRoutes.size() && ch < m_outputTaps.size(); ++ch) {
+        const Port& route = m_outputRoutes[ch];
+        if (route.node >= 0) {
+            m_outputTaps[ch] = &m_buffers[static_cast<size_t>(route.node)][static_cast<size_t>(route.output)];
+        }
+    }
+
+    m_sleepingNodes.store(0, std::memory_order_relaxed);
+    m_processedNodes.store(0, std::memory_order_relaxed);
+    m_compiled = true;
+}
+
+void AudioGraph::buildFusedStep(Step& step, const std::vector<std::vector<Term>>& expression) {
+    // Leaves read by the kernel, once each, for the sleep check
+    auto addInput = [&](const float* samples, const bool* flag) {
+        if (std::find(step.inputFlags.begin(), step.inputFlags.end(), flag) == step.inputFlags.end()) {
+            step.inputs.push_back(samples);
+            step.inputFlags.push_back(flag);
+        }
+    };
+
+    std::vector<size_t> gainBegin;
+    step.termBegin.push_back(0);
+    for (const std::vector<Term>& terms : expression) {
+        for (const Term& term : terms) {
+            KernelTerm kernelTerm;
+            if (term.leaf.node >= 0) {
+                const Buffer& source =
+                    m_buffers[static_cast<size_t>(term.leaf.node)][static_cast<size_t>(term.leaf.output)];
+                kernelTerm.samples = source.samples.data();
+                kernelTerm.silent = &source.silent;
+            } else {
+                kernelTerm.samples = m_zeros.data();
+                kernelTerm.silent = &m_zeroFlag;
+            }
+            addInput(kernelTerm.samples, kernelTerm.silent);
+
+            gainBegin.push_back(step.termGains.size());
+            for (const Port& gain : term.gains) {
+                GainRamp* ramps = m_gains[static_cast<size_t>(gain.node)].data();
+                step.termGains.push_back(&ramps[gain.output]);
+                const bool known = std::any_of(step.gainSources.begin(), step.gainSources.end(),
+                                               [&](const GainSource& s) { return s.gains == ramps; });
+                if (!known) {
+                    step.gainSources.push_back({m_nodes[static_cast<size_t>(gain.node)].node.get(), ramps});
+                }
+            }
+            kernelTerm.gainCount = term.gains.size();
+            step.terms.push_back(kernelTerm);
+        }
+        step.termBegin.push_back(step.terms.size());
+    }
+
+    // termGains is complete, so its addresses are stable now
+    for (size_t t = 0; t < step.terms.size(); ++t) {
+        step.terms[t].gains = step.termGains.data() + gainBegin[t];
+    }
+}
+
+void AudioGraph::process(float* const* outputs, size_t frames) {
+    if (!m_compiled) {
+        for (size_t ch = 0; ch < m_outputTaps.size(); ++ch) {
+            std::memset(outputs[ch], 0, frames * sizeof(float));
+        }
+        return;
+    }
+    for (size_t offset = 0; offset < frames; offset += m_maxFrames) {
+        processChunk(outputs, std::min(m_maxFrames, frames - offset), offset);
+    }
+}
+
+void AudioGraph::processChunk(float* const* outputs, size_t frames, size_t offset) {
+    int sleeping = 0;
+    uint64_t processed = 0;
+
+    for (Step& step : m_schedule) {
+        const size_t inputCount = step.inputs.size();
+        bool allSilent = inputCount > 0;
+        for (size_t i = 0; i < inputCount; ++i) {
+            step.inputSilent[i] = *step.inputFlags[i];
+            allSilent = allSilent && step.inputSilent[i];
+        }
+
+        if (allSilent && m_sleepEnabled) {
+            const size_t tail = step.node ? step.node->tailFrames() : 0;
+            if (!step.asleep && step.silentFrames >= tail) {
+                // Tail has run out: zero the outputs once and stop processing
+                step.asleep = true;
+                for (Buffer* buffer : step.outputBuffers) {
+                    std::memset(buffer->samples.data(), 0, m_maxFrames * sizeof(float));
+                    buffer->silent = true;
+                }
+            }
+            if (step.asleep) {
+                ++sleeping;
+                continue;
+            }
+            step.silentFrames += frames;
+        } else {
+            step.silentFrames = allSilent ? step.silentFrames + frames : 0;
+            if (step.asleep) {
+                step.asleep = false;
+                if (step.node) {
+                    step.node->wake();
+                } else {
+                    // Fused: wake every node folded into the kernel
+                    for (const GainSource& source : step.gainSources) {
+                        source.node->wake();
+                    }
+                }
+            }
+        }
+
+        const size_t outputCount = step.outputs.size();
+        if (!step.node) {
+            // Fused kernel: fetch this period's gains, then one pass per output
+            for (const GainSource& source : step.gainSources) {
+                source.node->elementwiseGains(frames, source.gains);
+            }
+            for (size_t o = 0; o < outputCount; ++o) {
+                const size_t begin = step.termBegin[o];
+                step.outputBuffers[o]->silent = !ElementwiseKernel::run(
+                    step.terms.data() + begin, step.termBegin[o + 1] - begin, step.outputs[o], frames);
+            }
+            ++processed;
+            continue;
+        }
+
+        std::fill(step.outputSilent.get(), step.outputSilent.get() + outputCount, false);
+        step.node->process({step.inputs.data(), step.inputSilent.get(),
+                            step.outputs.data(), step.outputSilent.get(), frames});
+        for (size_t o = 0; o < outputCount; ++o) {
+            step.outputBuffers[o]->silent = step.outputSilent[o];
+        }
+        ++processed;
+    }
+
+    for (size_t ch = 0; ch < m_outputTaps.size(); ++ch) {
+        const Buffer* tap = m_outputTaps[ch];
+        if (tap && !tap->silent) {
+            std::memcpy(outputs[ch] + offset, tap->samples.data(), frames * sizeof(float));
+        } else {
+            std::memset(outputs[ch] + offset, 0, frames * sizeof(float));
+        }
+    }
+
+    m_sleepingNodes.store(sleeping, std::memory_order_relaxed);
+    m_processedNodes.store(m_processedNodes.load(std::memory_order_relaxed) + processed, std::memory_order_relaxed);
+}
+
+} // namespace AudioEngine
@@ -0,0 +1,154 @@
+#ifndef AUDIOGRAPH_H
+#define AUDIOGRAPH_H
+
+#include "audionode.h"
+#include "elementwisekernel.h"
+#include "../dsp/alignedbuffer.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace AudioEngine {
+
+// Processing graph of AudioNodes
+// Nodes are added and wired on the control thread, then compile() sorts them
+// into a schedule (inputs before consumers), gives every output port its own
+// buffer and resolves each input to the buffer and silence flag it reads.
+// The audio thread only walks that schedule.
+// Silence propagates with the flags: a node whose inputs are all silent runs
+// on for its tail and then sleeps, which flags its outputs silent, which lets
+// the nodes downstream of it sleep in turn. A sleeping node costs a few flag
+// checks per period. Sparse arrangements, where most tracks are silent most
+// of the time, run only the branches that carry signal.
+// compile() also fuses trivial nodes (AudioNode::Fusion). An elementwise or
+// sum node whose outputs all feed one other such node is folded into it, so
+// a track's gain -> pan -> mute chain and the mix bus it feeds become one
+// ElementwiseKernel pass that reads each track buffer once and writes the
+// bus once, instead of a read and a write of every buffer per node.
+class AudioGraph {
+public:
+    using NodeId = int;
+
+    AudioGraph() = default;
+    ~AudioGraph();
+
+    // ===== Control Thread (audio thread not processing) =====
+
+    // Takes ownership; the id indexes the graph's nodes in insertion order
+    NodeId addNode(std::unique_ptr<AudioNode> node);
+    AudioNode& node(NodeId id) { return *m_nodes[static_cast<size_t>(id)].node; }
+    int nodeCount() const { return static_cast<int>(m_nodes.size()); }
+
+    // One source per input; reconnecting an input replaces its source.
+    // Throws AudioException for unknown nodes or ports.
+    void connect(NodeId source, int output, NodeId destination, int input);
+
+    // Route a node output to a channel of process()'s output
+    void connectToOutput(NodeId source, int output, int channel);
+
+    // Build the schedule; throws AudioException if the connections form a cycle
+    void compile(double sampleRate, size_t maxFrames, int outputChannels);
+    bool isCompiled() const { return m_compiled; }
+
+    // Sleeping on by default; off runs every node every period (for comparison)
+    void setSleepEnabled(bool enabled) { m_sleepEnabled = enabled; }
+
+    // Fusion on by default; takes effect at the next compile()
+    void setFusionEnabled(bool enabled) { m_fusionEnabled = enabled; m_compiled = false; }
+
+    // Steps in the compiled schedule: unfused nodes plus fused kernels
+    int getScheduledStepCount() const { return static_cast<int>(m_schedule.size()); }
+
+    // ===== Audio Thread =====
+
+    // Run the graph for frames (any length; split at maxFrames) and write
+    // the routed channels to outputs; unrouted channels get silence
+    void process(float* const* outputs, size_t frames);
+
+    // ===== Any Thread =====
+
+    // Scheduled steps asleep in the last period
+    int getSleepingNodeCount() const { return m_sleepingNodes.load(std::memory_order_relaxed); }
+
+    // Steps run since compile()
+    uint64_t getProcessedNodeCount() const { return m_processedNodes.load(std::memory_order_relaxed); }
+
+private:
+    AudioGraph(const AudioGraph&) = delete;
+    AudioGraph& operator=(const AudioGraph&) = delete;
+
+    struct Port {
+        NodeId node = -1;
+        int output = 0;
+    };
+
+    struct NodeEntry {
+        std::unique_ptr<AudioNode> node;
+        std::vector<Port> inputs;       // node == -1: unconnected
+    };
+
+    // One output port's storage
+    struct Buffer {
+        AlignedVector<float> samples;
+        bool silent = true;
+    };
+
+    // Elementwise node whose gains a fused step fetches each period
+    struct GainSource {
+        AudioNode* node = nullptr;
+        GainRamp* gains = nullptr;
+    };
+
+    // One scheduled node, or a fused kernel (node null), with its ports
+    // resolved to buffers. A fused step's inputs are the distinct buffers
+    // its terms read; output o sums terms [termBegin[o], termBegin[o + 1]).
+    struct Step {
+        AudioNode* node = nullptr;
+        std::vector<const float*> inputs;
+        std::vector<const bool*> inputFlags;        // The source buffers' flags
+        std::vector<Buffer*> outputBuffers;
+        std::vector<float*> outputs;
+        std::unique_ptr<bool[]> inputSilent;        // Gathered each period
+        std::unique_ptr<bool[]> outputSilent;
+        size_t silentFrames = 0;        // Consecutive frames of silent input
+        bool asleep = false;
+
+        std::vector<KernelTerm> terms;
+        std::vector<size_t> termBegin;
+        std::vector<const GainRamp*> termGains;
+        std::vector<GainSource> gainSources;
+    };
+
+    // A fused output while compiling: a producer's buffer times node gains
+    struct Term {
+        Port leaf;                      // node == -1: the zero buffer
+        std::vector<Port> gains;        // (elementwise node, channel)
+    };
+
+    void checkNode(NodeId id) const;
+    void buildFusedStep(Step& step, const std::vector<std::vector<Term>>& expression);
+    void processChunk(float* const* outputs, size_t frames, size_t offset);
+
+    std::vector<NodeEntry> m_nodes;
+    std::vector<Port> m_outputRoutes;       // Per output channel
+    bool m_fusionEnabled = true;
+
+    // Compiled state
+    bool m_compiled = false;
+    size_t m_maxFrames = 0;
+    std::vector<std::vector<Buffer>> m_buffers;     // [node][output], empty samples when folded
+    std::vector<std::vector<GainRamp>> m_gains;     // [node][output], elementwise nodes
+    std::vector<Step> m_schedule;
+    std::vector<const Buffer*> m_outputTaps;        // Per output channel, null = silence
+    AlignedVector<float> m_zeros;
+    bool m_zeroFlag = true;
+    bool m_sleepEnabled = true;
+
+    std::atomic<int> m_sleepingNodes{0};
+    std::atomic<uint64_t> m_processedNodes{0};
+};
+
+} // namespace AudioEngine
+
+#endif // AUDIOGRAPH_H
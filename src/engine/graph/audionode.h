@@ -0,0 +1,100 @@
+#ifndef AUDIONODE_H
+#define AUDIONODE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace AudioEngine {
+
+// One period of a node's buffers
+// Every port is one mono buffer of frames samples. A port flagged silent
+// holds zeros, so a node may skip reading it; unconnected inputs are silent.
+// Output flags start false each period; a node sets one only when that
+// buffer is all zeros (it must write the zeros, or leave a buffer that
+// already holds them).
+struct ProcessBlock {
+    const float* const* inputs;
+    const bool* inputSilent;
+    float* const* outputs;
+    bool* outputSilent;
+    size_t frames;
+};
+
+// A gain that moves linearly across one period: frame i of n gets
+// start + (end - start) * (i + 1) / n, so the last frame is exactly end
+struct GainRamp {
+    float start = 1.0f;
+    float end = 1.0f;
+
+    bool isConstant() const { return start == end; }
+};
+
+// A processor in an AudioGraph
+// A node with inputs whose inputs have all been silent for longer than
+// tailFrames() is put to sleep by the graph: process() is not called, its
+// outputs hold zeros and are flagged silent. It wakes, with a call to
+// wake(), in the first period any input carries signal again, and processes
+// that same period. Nodes without inputs (instruments, players) always run
+// and report their own silence through the output flags.
+// Trivial nodes can declare their arithmetic instead of hiding it in
+// process(), so compile() can fuse chains of them into one pass:
+//   Elementwise: output c = input c * a per-channel GainRamp (gain, pan,
+//                mute, phase invert); inputCount() == outputCount()
+//   Sum:         output c = sum over s of input s * outputCount() + c
+// Their process() must compute exactly that, for unfused schedules.
+class AudioNode {
+public:
+    enum class Fusion {
+        None,
+        Elementwise,
+        Sum
+    };
+
+    // Tail that never ends: the node never sleeps
+    static constexpr size_t kInfiniteTail = SIZE_MAX;
+
+    AudioNode(int inputs, int outputs) : m_inputs(inputs), m_outputs(outputs) {}
+    virtual ~AudioNode() = default;
+
+    int inputCount() const { return m_inputs; }
+    int outputCount() const { return m_outputs; }
+
+    // ===== Control Thread (audio thread not processing) =====
+
+    // Called by AudioGraph::compile(); process() never sees more than maxFrames
+    virtual void prepare(double sampleRate, size_t maxFrames) {
+        (void)sampleRate;
+        (void)maxFrames;
+    }
+
+    // ===== Audio Thread =====
+
+    virtual void process(const ProcessBlock& block) = 0;
+
+    // Frames the outputs can carry signal after the inputs fall silent
+    // (filter ring-out, delay lines, reverb)
+    virtual size_t tailFrames() const { return 0; }
+
+    // Back from sleep: everything since the node went to sleep was silence
+    virtual void wake() {}
+
+    virtual Fusion fusion() const { return Fusion::None; }
+
+    // Elementwise nodes: the per-output gains for the coming period of frames.
+    // Called once per period, by process() or instead of it when fused.
+    virtual void elementwiseGains(size_t frames, GainRamp* gains) {
+        (void)frames;
+        (void)gains;
+    }
+
+private:
+    AudioNode(const AudioNode&) = delete;
+    AudioNode& operator=(const AudioNode&) = delete;
+
+    int m_inputs;
+    int m_outputs;
+};
+
+} // namespace AudioEngine
+
+#endif // AUDIONODE_H
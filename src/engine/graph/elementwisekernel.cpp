@@ -0,0 +1,69 @@
+#include "elementwisekernel.h"
+#include <cstring>
+
+namespace AudioEngine {
+
+bool ElementwiseKernel::run(const KernelTerm* terms, size_t termCount, float* out, size_t frames) {
+    bool written = false;
+    const float invFrames = 1.0f / static_cast<float>(frames);
+
+    for (size_t t = 0; t < termCount; ++t) {
+        const KernelTerm& term = terms[t];
+        if (*term.silent) {
+            continue;
+        }
+
+        // Fold the constant gains; keep the ramps
+        float scale = 1.0f;
+        float rampStart[kMaxRamps];
+        float rampStep[kMaxRamps];
+        size_t ramps = 0;
+        for (size_t k = 0; k < term.gainCount; ++k) {
+            const GainRamp& gain = *term.gains[k];
+            if (gain.isConstant()) {
+                scale *= gain.end;
+            } else if (ramps < kMaxRamps) {
+                rampStart[ramps] = gain.start;
+                rampStep[ramps] = (gain.end - gain.start) * invFrames;
+                ++ramps;
+            }
+        }
+        if (scale == 0.0f) {
+            continue;
+        }
+
+        const float* in = term.samples;
+        if (ramps == 0) {
+            if (!written) {
+                if (scale == 1.0f) {
+                    std::memcpy(out, in, frames * sizeof(float));
+                } else {
+                    for (size_t i = 0; i < frames; ++i) {
+                        out[i] = in[i] * scale;
+                    }
+                }
+            } else {
+                for (size_t i = 0; i < frames; ++i) {
+                    out[i] += in[i] * scale;
+                }
+            }
+        } else {
+            for (size_t i = 0; i < frames; ++i) {
+                const float position = static_cast<float>(i + 1);
+                float g = scale;
+                for (size_t k = 0; k < ramps; ++k) {
+                    g *= rampStart[k] + rampStep[k] * position;
+                }
+                out[i] = written ? out[i] + in[i] * g : in[i] * g;
+            }
+        }
+        written = true;
+    }
+
+    if (!written) {
+        std::memset(out, 0, frames * sizeof(float));
+    }
+    return written;
+}
+
+} // namespace AudioEngine
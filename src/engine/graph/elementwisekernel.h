@@ -0,0 +1,34 @@
+#ifndef ELEMENTWISEKERNEL_H
+#define ELEMENTWISEKERNEL_H
+
+#include "audionode.h"
+#include <cstddef>
+
+namespace AudioEngine {
+
+// One input of a fused kernel: a buffer scaled by a chain of gain ramps
+struct KernelTerm {
+    const float* samples = nullptr;
+    const bool* silent = nullptr;
+    const GainRamp* const* gains = nullptr;
+    size_t gainCount = 0;
+};
+
+// The single pass behind every elementwise and sum node, fused or not
+// out = sum of terms, each term its samples times the product of its gains.
+// Constant gains collapse to one scalar per term, so a fused chain of gain,
+// pan, mute and phase invert nodes into a mix bus is one multiply-add per
+// sample per track. Ramping gains are multiplied per sample. Silent terms,
+// and terms whose constant gain is zero, are skipped without reading them.
+class ElementwiseKernel {
+public:
+    // Ramping gains a term may carry; the graph compiler keeps chains shorter
+    static constexpr size_t kMaxRamps = 16;
+
+    // Returns false, with out zeroed, when no term contributed
+    static bool run(const KernelTerm* terms, size_t termCount, float* out, size_t frames);
+};
+
+} // namespace AudioEngine
+
+#endif // ELEMENTWISEKERNEL_H
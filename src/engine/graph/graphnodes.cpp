@@ -0,0 +1,123 @@
+#include "graphnodes.h"
+#include "../common/audioerror.h"
+#include <algorithm>
+#include <cmath>
+
+namespace AudioEngine {
+
+ElementwiseNode::ElementwiseNode(int channels)
+    : AudioNode(channels, channels)
+    , m_gains(static_cast<size_t>(channels))
+{
+}
+
+void ElementwiseNode::process(const ProcessBlock& block) {
+    elementwiseGains(block.frames, m_gains.data());
+    for (int ch = 0; ch < outputCount(); ++ch) {
+        const GainRamp* gain = &m_gains[static_cast<size_t>(ch)];
+        const KernelTerm term{block.inputs[ch], &block.inputSilent[ch], &gain, 1};
+        block.outputSilent[ch] = !ElementwiseKernel::run(&term, 1, block.outputs[ch], block.frames);
+    }
+}
+
+void ElementwiseNode::wake() {
+    // Discard the ramp from the stale settings; this period starts at the targets
+    elementwiseGains(0, m_gains.data());
+}
+
+GainNode::GainNode(int channels, float gain)
+    : ElementwiseNode(channels)
+    , m_target(gain)
+    , m_current(gain)
+{
+}
+
+void GainNode::elementwiseGains(size_t, GainRamp* gains) {
+    const float target = m_target.load(std::memory_order_relaxed);
+    std::fill(gains, gains + outputCount(), GainRamp{m_current, target});
+    m_current = target;
+}
+
+PanNode::PanNode(float pan)
+    : ElementwiseNode(2)
+    , m_target(pan)
+{
+    lawGains(pan, m_currentLeft, m_currentRight);
+}
+
+void PanNode::lawGains(float pan, float& left, float& right) {
+    const float p = std::clamp(pan, -1.0f, 1.0f);
+    left = p > 0.0f ? static_cast<float>(std::cos(p * M_PI / 2.0)) : 1.0f;
+    right = p < 0.0f ? static_cast<float>(std::cos(-p * M_PI / 2.0)) : 1.0f;
+}
+
+void PanNode::elementwiseGains(size_t, GainRamp* gains) {
+    float left, right;
+    lawGains(m_target.load(std::memory_order_relaxed), left, right);
+    gains[0] = {m_currentLeft, left};
+    gains[1] = {m_currentRight, right};
+    m_currentLeft = left;
+    m_currentRight = right;
+}
+
+MuteNode::MuteNode(int channels, bool muted)
+    : ElementwiseNode(channels)
+    , m_muted(muted)
+    , m_current(muted ? 0.0f : 1.0f)
+{
+}
+
+void MuteNode::elementwiseGains(size_t, GainRamp* gains) {
+    const float target = m_muted.load(std::memory_order_relaxed) ? 0.0f : 1.0f;
+    std::fill(gains, gains + outputCount(), GainRamp{m_current, target});
+    m_current = target;
+}
+
+PhaseInvertNode::PhaseInvertNode(int channels)
+    : ElementwiseNode(channels)
+    , m_inverted(new std::atomic<bool>[static_cast<size_t>(channels)])
+    , m_current(static_cast<size_t>(channels), 1.0f)
+{
+    for (int ch = 0; ch < channels; ++ch) {
+        m_inverted[ch].store(false, std::memory_order_relaxed);
+    }
+}
+
+void PhaseInvertNode::setInverted(int channel, bool inverted) {
+    if (channel < 0 || channel >= outputCount()) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration, "Phase invert channel out of range");
+    }
+    m_inverted[channel].store(inverted, std::memory_order_relaxed);
+}
+
+bool PhaseInvertNode::isInverted(int channel) const {
+    return channel >= 0 && channel < outputCount() && m_inverted[channel].load(std::memory_order_relaxed);
+}
+
+void PhaseInvertNode::elementwiseGains(size_t, GainRamp* gains) {
+    for (int ch = 0; ch < outputCount(); ++ch) {
+        const float target = m_inverted[ch].load(std::memory_order_relaxed) ? -1.0f : 1.0f;
+        gains[ch] = {m_current[static_cast<size_t>(ch)], target};
+        m_current[static_cast<size_t>(ch)] = target;
+    }
+}
+
+MixNode::MixNode(int channels, int sources)
+    : AudioNode(channels * sources, channels)
+    , m_channels(channels)
+    , m_sources(sources)
+    , m_terms(static_cast<size_t>(sources))
+{
+}
+
+void MixNode::process(const ProcessBlock& block) {
+    for (int ch = 0; ch < m_channels; ++ch) {
+        for (int s = 0; s < m_sources; ++s) {
+            const int input = s * m_channels + ch;
+            m_terms[static_cast<size_t>(s)] = {block.inputs[input], &block.inputSilent[input], nullptr, 0};
+        }
+        block.outputSilent[ch] = !ElementwiseKernel::run(m_terms.data(), m_terms.size(), block.outputs[ch], block.frames);
+    }
+}
+
+} // namespace AudioEngine
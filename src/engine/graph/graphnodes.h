@@ -0,0 +1,139 @@
+#ifndef GRAPHNODES_H
+#define GRAPHNODES_H
+
+#include "audionode.h"
+#include "elementwisekernel.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace AudioEngine {
+
+// Base for nodes that scale each channel by a gain ramp
+// Subclasses only say which gains apply this period; the samples go
+// through ElementwiseKernel here or, fused, in the node that consumes them.
+// Silent inputs and zero gains give silent outputs without touching the samples.
+// elementwiseGains() must leave each ramp's start at its end for the next period.
+class ElementwiseNode : public AudioNode {
+public:
+    explicit ElementwiseNode(int channels);
+
+    Fusion fusion() const final { return Fusion::Elementwise; }
+
+    // ===== Audio Thread =====
+
+    void process(const ProcessBlock& block) final;
+
+    // Settings changed while asleep take effect at once: there is nothing to ramp from
+    void wake() final;
+
+private:
+    std::vector<GainRamp> m_gains;
+};
+
+// Per-channel gain; changes ramp linearly across one period
+class GainNode : public ElementwiseNode {
+public:
+    explicit GainNode(int channels, float gain = 1.0f);
+
+    // ===== Any Thread =====
+
+    void setGain(float gain) { m_target.store(gain, std::memory_order_relaxed); }
+    float gain() const { return m_target.load(std::memory_order_relaxed); }
+
+    // ===== Audio Thread =====
+
+    void elementwiseGains(size_t frames, GainRamp* gains) override;
+
+private:
+    std::atomic<float> m_target;
+    float m_current;
+};
+
+// Stereo balance: unity at centre; turning towards one side fades the
+// other with a quarter-cosine, so hard left silences the right channel
+class PanNode : public ElementwiseNode {
+public:
+    explicit PanNode(float pan = 0.0f);
+
+    // ===== Any Thread =====
+
+    // -1 (left) to +1 (right)
+    void setPan(float pan) { m_target.store(pan, std::memory_order_relaxed); }
+    float pan() const { return m_target.load(std::memory_order_relaxed); }
+
+    // ===== Audio Thread =====
+
+    void elementwiseGains(size_t frames, GainRamp* gains) override;
+
+private:
+    static void lawGains(float pan, float& left, float& right);
+
+    std::atomic<float> m_target;
+    float m_currentLeft;
+    float m_currentRight;
+};
+
+// Mute that fades over one period instead of clicking
+class MuteNode : public ElementwiseNode {
+public:
+    explicit MuteNode(int channels, bool muted = false);
+
+    // ===== Any Thread =====
+
+    void setMuted(bool muted) { m_muted.store(muted, std::memory_order_relaxed); }
+    bool isMuted() const { return m_muted.load(std::memory_order_relaxed); }
+
+    // ===== Audio Thread =====
+
+    void elementwiseGains(size_t frames, GainRamp* gains) override;
+
+private:
+    std::atomic<bool> m_muted;
+    float m_current;
+};
+
+// Per-channel polarity; a flip ramps through zero across one period
+class PhaseInvertNode : public ElementwiseNode {
+public:
+    explicit PhaseInvertNode(int channels);
+
+    // ===== Any Thread =====
+
+    void setInverted(int channel, bool inverted);
+    bool isInverted(int channel) const;
+
+    // ===== Audio Thread =====
+
+    void elementwiseGains(size_t frames, GainRamp* gains) override;
+
+private:
+    std::unique_ptr<std::atomic<bool>[]> m_inverted;
+    std::vector<float> m_current;
+};
+
+// Sums sources groups of channels into one group: input s * channels + ch
+// feeds output ch. Silent inputs are skipped, so a mix bus costs in
+// proportion to the tracks that are playing; all silent gives a silent output.
+class MixNode : public AudioNode {
+public:
+    MixNode(int channels, int sources);
+
+    int channels() const { return m_channels; }
+    int sources() const { return m_sources; }
+
+    Fusion fusion() const override { return Fusion::Sum; }
+
+    // ===== Audio Thread =====
+
+    void process(const ProcessBlock& block) override;
+
+private:
+    int m_channels;
+    int m_sources;
+    std::vector<KernelTerm> m_terms;
+};
+
+} // namespace AudioEngine
+
+#endif // GRAPHNODES_H
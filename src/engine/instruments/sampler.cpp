@@ -0,0 +1,372 @@
+#include "sampler.h"
+#include "../common/audioerror.h"
+#include "../io/wavfile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace AudioEngine {
+
+namespace {
+// Release ends once the envelope is this far down (-80 dB)
+constexpr float kSilentEnvelope = 1e-4f;
+}
+
+Sampler::Sampler(double sampleRate)
+    : Sampler(sampleRate, Options{})
+{}
+
+Sampler::Sampler(double sampleRate, const Options& options)
+    : m_sampleRate(sampleRate)
+    , m_options(options)
+{
+    if (sampleRate <= 0.0 || options.voices < 1 || options.maxBlockFrames == 0 ||
+        options.preloadMs <= 0.0 || options.attackMs <= 0.0 || options.releaseMs <= 0.0 ||
+        options.stealFadeMs <= 0.0) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration, "Invalid sampler configuration");
+    }
+
+    const size_t voices = static_cast<size_t>(options.voices);
+    m_stage.assign(voices, Idle);
+    m_note.assign(voices, -1);
+    m_sample.assign(voices, -1);
+    m_started.assign(voices, 0);
+    m_step.assign(voices, 1.0);
+    m_position.assign(voices, 0.0);
+    m_nextSource.assign(voices, 0);
+    m_staged.assign(voices, 0);
+    m_velocityGain.assign(voices, 0.0f);
+    m_envelope.assign(voices, 0.0f);
+    m_envelopeEnd.assign(voices, 0.0f);
+    m_pendingSample.assign(voices, -1);
+    m_pendingNote.assign(voices, -1);
+    m_pendingVelocity.assign(voices, 0);
+
+    // One block at the highest step, plus the interpolation neighbour
+    m_stagingFrames = static_cast<size_t>(std::ceil(options.maxBlockFrames * kMaxStep)) + 4;
+    m_stagingLeft.assign(voices * m_stagingFrames, 0.0f);
+    m_stagingRight.assign(voices * m_stagingFrames, 0.0f);
+
+    const double msToFrames = sampleRate / 1000.0;
+    m_attackStep = static_cast<float>(1.0 / (options.attackMs * msToFrames));
+    m_stealStep = static_cast<float>(1.0 / (options.stealFadeMs * msToFrames));
+    m_releaseCoeff = static_cast<float>(std::exp(std::log(kSilentEnvelope) / (options.releaseMs * msToFrames)));
+
+    m_streamer = std::make_unique<DiskStreamer>(options.voices, options.ringFrames);
+}
+
+Sampler::~Sampler() {
+    stop();
+}
+
+// ===== Control Thread =====
+
+int Sampler::addSample(const std::string& path, int rootKey, int lowKey, int highKey,
+                       int lowVelocity, int highVelocity) {
+    if (rootKey < 0 || rootKey > 127 || lowKey < 0 || highKey > 127 || lowKey > highKey ||
+        lowVelocity < 1 || highVelocity > 127 || lowVelocity > highVelocity) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration, "Invalid sample key or velocity range");
+    }
+
+    WavReader reader;
+    reader.open(path);
+
+    Sample sample;
+    sample.path = path;
+    sample.rootKey = rootKey;
+    sample.lowKey = lowKey;
+    sample.highKey = highKey;
+    sample.lowVelocity = lowVelocity;
+    sample.highVelocity = highVelocity;
+    sample.rateRatio = reader.format().sampleRate / m_sampleRate;
+    sample.frameCount = reader.frameCount();
+    sample.headFrames = static_cast<size_t>(std::min<uint64_t>(
+        sample.frameCount,
+        static_cast<uint64_t>(std::ceil(m_options.preloadMs * reader.format().sampleRate / 1000.0))));
+
+    sample.headLeft.assign(sample.headFrames, 0.0f);
+    sample.headRight.assign(sample.headFrames, 0.0f);
+    float* channels[] = {sample.headLeft.data(), sample.headRight.data()};
+    reader.read(channels, 2, sample.headFrames);
+    if (reader.format().channels == 1) {
+        sample.headRight = sample.headLeft;
+    }
+
+    m_samples.push_back(std::move(sample));
+    return static_cast<int>(m_samples.size()) - 1;
+}
+
+size_t Sampler::getPreloadedBytes() const {
+    size_t bytes = 0;
+    for (const Sample& sample : m_samples) {
+        bytes += 2 * sample.headFrames * sizeof(float);
+    }
+    return bytes;
+}
+
+void Sampler::start() {
+    m_streamer->start();
+}
+
+void Sampler::stop() {
+    m_streamer->stop();
+}
+
+// ===== Audio Thread =====
+
+int Sampler::findSample(int note, int velocity) const {
+    for (size_t i = 0; i < m_samples.size(); ++i) {
+        const Sample& s = m_samples[i];
+        if (note >= s.lowKey && note <= s.highKey && velocity >= s.lowVelocity && velocity <= s.highVelocity) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int Sampler::allocateVoice() {
+    // Idle first, then the oldest releasing, then the oldest playing. A voice
+    // already stolen is last: taking it drops a note that never sounded.
+    int oldest[4] = {-1, -1, -1, -1};
+    for (int v = 0; v < m_options.voices; ++v) {
+        const size_t i = static_cast<size_t>(v);
+        if (m_stage[i] == Idle) {
+            return v;
+        }
+        int& candidate = oldest[m_stage[i]];
+        if (candidate < 0 || m_started[i] < m_started[static_cast<size_t>(candidate)]) {
+            candidate = v;
+        }
+    }
+    for (VoiceStage stage : {Releasing, Playing, Stolen}) {
+        if (oldest[stage] >= 0) {
+            return oldest[stage];
+        }
+    }
+    return -1;
+}
+
+void Sampler::noteOn(int note, int velocity) {
+    if (velocity <= 0) {
+        noteOff(note);
+        return;
+    }
+    const int sample = findSample(note, velocity);
+    if (sample < 0) {
+        return;
+    }
+
+    const int voice = allocateVoice();
+    const size_t v = static_cast<size_t>(voice);
+    if (m_stage[v] == Idle) {
+        startVoice(voice, sample, note, velocity);
+        return;
+    }
+
+    // Steal: fade the victim out quickly, then start the note in its slot
+    if (m_stage[v] == Stolen && m_pendingSample[v] >= 0) {
+        m_droppedNotes.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_stage[v] = Stolen;
+    m_pendingSample[v] = sample;
+    m_pendingNote[v] = note;
+    m_pendingVelocity[v] = velocity;
+    m_started[v] = ++m_voiceCounter;
+    m_steals.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Sampler::noteOff(int note) {
+    for (size_t v = 0; v < m_stage.size(); ++v) {
+        if (m_stage[v] == Playing && m_note[v] == note) {
+            m_stage[v] = Releasing;
+        } else if (m_stage[v] == Stolen && m_pendingNote[v] == note) {
+            m_pendingSample[v] = -1;    // Released before it started
+        }
+    }
+}
+
+void Sampler::allNotesOff() {
+    for (size_t v = 0; v < m_stage.size(); ++v) {
+        if (m_stage[v] == Playing) {
+            m_stage[v] = Releasing;
+        } else if (m_stage[v] == Stolen) {
+            m_pendingSample[v] = -1;
+        }
+    }
+}
+
+void Sampler::startVoice(int voice, int sampleIndex, int note, int velocity) {
+    const size_t v = static_cast<size_t>(voice);
+    const Sample& sample = m_samples[static_cast<size_t>(sampleIndex)];
+
+    // The head covers playback while the stream opens behind it. Without a
+    // stream the note would cut out at the end of the head: drop it instead.
+    if (sample.frameCount > sample.headFrames && !m_streamer->open(voice, &sample.path, sample.headFrames)) {
+        m_streamFailures.fetch_add(1, std::memory_order_relaxed);
+        m_stage[v] = Idle;
+        m_note[v] = -1;
+        m_envelope[v] = 0.0f;
+        m_pendingSample[v] = -1;
+        return;
+    }
+
+    m_stage[v] = Playing;
+    m_note[v] = note;
+    m_sample[v] = sampleIndex;
+    m_started[v] = ++m_voiceCounter;
+    m_step[v] = std::min(kMaxStep, std::pow(2.0, (note - sample.rootKey) / 12.0) * sample.rateRatio);
+    m_position[v] = 0.0;
+    m_nextSource[v] = 0;
+    m_staged[v] = 0;
+    const float level = static_cast<float>(velocity) / 127.0f;
+    m_velocityGain[v] = level * level;
+    m_envelope[v] = 0.0f;
+    m_pendingSample[v] = -1;
+}
+
+void Sampler::finishVoice(int voice) {
+    const size_t v = static_cast<size_t>(voice);
+    const Sample& sample = m_samples[static_cast<size_t>(m_sample[v])];
+    if (sample.frameCount > sample.headFrames) {
+        m_streamer->close(voice);
+    }
+
+    if (m_stage[v] == Stolen && m_pendingSample[v] >= 0) {
+        startVoice(voice, m_pendingSample[v], m_pendingNote[v], m_pendingVelocity[v]);
+        return;
+    }
+    m_stage[v] = Idle;
+    m_note[v] = -1;
+    m_envelope[v] = 0.0f;
+}
+
+size_t Sampler::stage(int voice, size_t needed) {
+    const size_t v = static_cast<size_t>(voice);
+    const Sample& sample = m_samples[static_cast<size_t>(m_sample[v])];
+    float* left = m_stagingLeft.data() + v * m_stagingFrames;
+    float* right = m_stagingRight.data() + v * m_stagingFrames;
+    size_t staged = m_staged[v];
+    uint64_t source = m_nextSource[v];
+    needed = std::min(needed, m_stagingFrames);
+
+    while (staged < needed) {
+        const size_t wanted = needed - staged;
+        if (source >= sample.frameCount) {
+            // Past the end: silence, so the last frames still interpolate
+            std::fill(left + staged, left + needed, 0.0f);
+            std::fill(right + staged, right + needed, 0.0f);
+            source += wanted;
+            staged = needed;
+            break;
+        }
+
+        size_t n;
+        if (source < sample.headFrames) {
+            n = static_cast<size_t>(std::min<uint64_t>(wanted, sample.headFrames - source));
+            std::memcpy(left + staged, sample.headLeft.data() + source, n * sizeof(float));
+            std::memcpy(right + staged, sample.headRight.data() + source, n * sizeof(float));
+        } else {
+            const size_t request = static_cast<size_t>(std::min<uint64_t>(wanted, sample.frameCount - source));
+            n = m_streamer->read(voice, left + staged, right + staged, request);
+            if (n < request) {
+                m_underruns.fetch_add(1, std::memory_order_relaxed);
+                staged += n;
+                source += n;
+                break;
+            }
+        }
+        staged += n;
+        source += n;
+    }
+
+    m_staged[v] = staged;
+    m_nextSource[v] = source;
+    return staged;
+}
+
+void Sampler::updateEnvelopes(size_t frames) {
+    // Block-rate envelope targets for every voice at once; voices ramp
+    // linearly between them inside the block
+    const float n = static_cast<float>(frames);
+    const float release = std::pow(m_releaseCoeff, n);
+    const size_t count = m_stage.size();
+    for (size_t v = 0; v < count; ++v) {
+        const float e = m_envelope[v];
+        const uint8_t s = m_stage[v];
+        const float attack = std::min(1.0f, e + m_attackStep * n);
+        const float decay = e * release;
+        const float fade = std::max(0.0f, e - m_stealStep * n);
+        m_envelopeEnd[v] = s == Playing ? attack : s == Releasing ? decay : s == Stolen ? fade : 0.0f;
+    }
+}
+
+void Sampler::renderVoice(int voice, float* left, float* right, size_t frames) {
+    const size_t v = static_cast<size_t>(voice);
+    const double step = m_step[v];
+    double pos = m_position[v];
+
+    // Linear interpolation reads frame i and i + 1
+    const size_t needed = static_cast<size_t>(pos + static_cast<double>(frames - 1) * step) + 2;
+    const size_t available = stage(voice, needed);
+    const float* sourceLeft = m_stagingLeft.data() + v * m_stagingFrames;
+    const float* sourceRight = m_stagingRight.data() + v * m_stagingFrames;
+
+    float gain = m_envelope[v] * m_velocityGain[v];
+    const float gainStep = (m_envelopeEnd[v] - m_envelope[v]) * m_velocityGain[v] / static_cast<float>(frames);
+    for (size_t n = 0; n < frames; ++n) {
+        const size_t i = static_cast<size_t>(pos);
+        if (i + 1 >= available) {
+            break;  // Stream behind: hold position until it catches up
+        }
+        const float t = static_cast<float>(pos - static_cast<double>(i));
+        left[n] += (sourceLeft[i] + t * (sourceLeft[i + 1] - sourceLeft[i])) * gain;
+        right[n] += (sourceRight[i] + t * (sourceRight[i + 1] - sourceRight[i])) * gain;
+        gain += gainStep;
+        pos += step;
+    }
+
+    // Drop consumed frames from the front of the staging buffer
+    const size_t consumed = std::min(static_cast<size_t>(pos), available);
+    float* stagedLeft = m_stagingLeft.data() + v * m_stagingFrames;
+    float* stagedRight = m_stagingRight.data() + v * m_stagingFrames;
+    std::memmove(stagedLeft, stagedLeft + consumed, (available - consumed) * sizeof(float));
+    std::memmove(stagedRight, stagedRight + consumed, (available - consumed) * sizeof(float));
+    m_staged[v] = available - consumed;
+    m_position[v] = pos - static_cast<double>(consumed);
+}
+
+void Sampler::process(float* left, float* right, size_t frames) {
+    frames = std::min(frames, m_options.maxBlockFrames);
+    std::memset(left, 0, frames * sizeof(float));
+    std::memset(right, 0, frames * sizeof(float));
+    if (frames == 0) {
+        return;
+    }
+
+    updateEnvelopes(frames);
+
+    int active = 0;
+    for (int voice = 0; voice < m_options.voices; ++voice) {
+        const size_t v = static_cast<size_t>(voice);
+        if (m_stage[v] == Idle) {
+            continue;
+        }
+        renderVoice(voice, left, right, frames);
+
+        const Sample& sample = m_samples[static_cast<size_t>(m_sample[v])];
+        const double played = static_cast<double>(m_nextSource[v] - m_staged[v]) + m_position[v];
+        const bool ended = played >= static_cast<double>(sample.frameCount) ||
+                           (m_stage[v] == Releasing && m_envelopeEnd[v] < kSilentEnvelope) ||
+                           (m_stage[v] == Stolen && m_envelopeEnd[v] <= 0.0f);
+        m_envelope[v] = m_envelopeEnd[v];
+        if (ended) {
+            finishVoice(voice);
+        }
+        if (m_stage[v] != Idle) {
+            ++active;
+        }
+    }
+    m_activeVoices.store(active, std::memory_order_relaxed);
+}
+
+} // namespace AudioEngine
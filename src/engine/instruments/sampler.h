@@ -0,0 +1,149 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include "../io/diskstreamer.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace AudioEngine {
+
+// Disk-streaming sampler
+// Only the first preloadMs of every sample is read into RAM when it is
+// added, so large libraries load quickly and stay small. A voice plays the
+// preloaded head while the DiskStreamer opens the file and fills the voice's
+// ring from the end of the head; by the time the head runs out the stream
+// has caught up.
+// Voices come from a fixed pool. Their state is stored structure-of-arrays
+// so the per-block envelope and pitch updates run as plain loops across
+// voices, which the compiler vectorizes. When the pool is full the oldest
+// voice (releasing voices first) is faded out over a couple of milliseconds
+// and its slot restarts with the new note. Envelopes step at block rate and
+// ramp linearly inside the block, so an attack takes at least one block.
+class Sampler {
+public:
+    struct Options {
+        int voices = 64;
+        double preloadMs = 250.0;       // Must cover the worst disk latency
+        size_t ringFrames = 32768;      // Streaming buffer per voice
+        size_t maxBlockFrames = 2048;
+        double attackMs = 1.0;
+        double releaseMs = 200.0;
+        double stealFadeMs = 2.0;
+    };
+
+    explicit Sampler(double sampleRate);
+    Sampler(double sampleRate, const Options& options);
+    ~Sampler();
+
+    const Options& options() const { return m_options; }
+
+    // ===== Control Thread (playback stopped) =====
+
+    // Map a WAV file to a key and velocity range; reads its head only.
+    // Returns the sample index. Throws AudioException if the file is unusable.
+    int addSample(const std::string& path, int rootKey, int lowKey, int highKey,
+                  int lowVelocity = 1, int highVelocity = 127);
+
+    int sampleCount() const { return static_cast<int>(m_samples.size()); }
+    size_t getPreloadedBytes() const;
+
+    // Start and stop the streaming thread
+    void start();
+    void stop();
+
+    // ===== Audio Thread =====
+
+    void noteOn(int note, int velocity);
+    void noteOff(int note);
+    void allNotesOff();
+
+    // Mix all voices into left/right (overwrites); frames <= maxBlockFrames
+    void process(float* left, float* right, size_t frames);
+
+    int getActiveVoiceCount() const { return m_activeVoices.load(std::memory_order_relaxed); }
+    uint64_t getStealCount() const { return m_steals.load(std::memory_order_relaxed); }
+    // Pending notes replaced by another steal before their fade finished
+    uint64_t getDroppedNoteCount() const { return m_droppedNotes.load(std::memory_order_relaxed); }
+    uint64_t getUnderrunCount() const { return m_underruns.load(std::memory_order_relaxed); }
+    // Notes not played because the streaming command queue was full
+    uint64_t getStreamFailureCount() const { return m_streamFailures.load(std::memory_order_relaxed); }
+
+    // Largest playback rate step: +24 semitones at twice the engine rate
+    static constexpr double kMaxStep = 8.0;
+
+private:
+    Sampler(const Sampler&) = delete;
+    Sampler& operator=(const Sampler&) = delete;
+
+    struct Sample {
+        std::string path;
+        int rootKey = 60;
+        int lowKey = 0, highKey = 127;
+        int lowVelocity = 1, highVelocity = 127;
+        double rateRatio = 1.0;         // File rate over engine rate
+        uint64_t frameCount = 0;
+        size_t headFrames = 0;
+        std::vector<float> headLeft;
+        std::vector<float> headRight;
+    };
+
+    enum VoiceStage : uint8_t {
+        Idle,
+        Playing,
+        Releasing,
+        Stolen          // Fast fade, then starts the pending note
+    };
+
+    int findSample(int note, int velocity) const;
+    int allocateVoice();
+    void startVoice(int voice, int sample, int note, int velocity);
+    size_t stage(int voice, size_t needed);
+    void updateEnvelopes(size_t frames);
+    void renderVoice(int voice, float* left, float* right, size_t frames);
+    void finishVoice(int voice);
+
+    double m_sampleRate;
+    Options m_options;
+    std::vector<Sample> m_samples;
+    std::unique_ptr<DiskStreamer> m_streamer;
+
+    // ===== Voice state, structure-of-arrays =====
+    std::vector<uint8_t> m_stage;
+    std::vector<int> m_note;
+    std::vector<int> m_sample;
+    std::vector<uint64_t> m_started;            // Voice age for stealing
+    std::vector<double> m_step;                 // Source frames per output frame
+    std::vector<double> m_position;             // Read position within the staging buffer
+    std::vector<uint64_t> m_nextSource;         // Next source frame to stage
+    std::vector<size_t> m_staged;               // Frames in the staging buffer
+    std::vector<float> m_velocityGain;
+    std::vector<float> m_envelope;              // At the start of the block
+    std::vector<float> m_envelopeEnd;           // At the end of the block
+    std::vector<int> m_pendingSample;           // Stolen voices: note to start after the fade
+    std::vector<int> m_pendingNote;
+    std::vector<int> m_pendingVelocity;
+
+    // Per voice staging: contiguous source frames around the read position
+    size_t m_stagingFrames = 0;
+    std::vector<float> m_stagingLeft;           // [voice][m_stagingFrames]
+    std::vector<float> m_stagingRight;
+
+    float m_attackStep = 0.0f;                  // Envelope rise per frame
+    float m_releaseCoeff = 0.0f;                // Envelope decay per frame
+    float m_stealStep = 0.0f;
+    uint64_t m_voiceCounter = 0;
+
+    std::atomic<int> m_activeVoices{0};
+    std::atomic<uint64_t> m_steals{0};
+    std::atomic<uint64_t> m_droppedNotes{0};
+    std::atomic<uint64_t> m_underruns{0};
+    std::atomic<uint64_t> m_streamFailures{0};
+};
+
+} // namespace AudioEngine
+
+#endif // SAMPLER_H
@@ -0,0 +1,350 @@
+#include "synth.h"
+#include "../common/audioerror.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define CADENCE_SYNTH_SSE 1
+#endif
+
+namespace AudioEngine {
+
+namespace {
+// Release ends once the envelope is this far down (-80 dB)
+constexpr float kSilentLevel = 1e-4f;
+}
+
+Synth::Synth(double sampleRate, int voices)
+    : m_sampleRate(sampleRate)
+{
+    if (sampleRate <= 0.0 || voices < 1) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration, "Invalid synth configuration");
+    }
+
+    const size_t count = static_cast<size_t>((voices + kLanes - 1) / kLanes * kLanes);
+    for (auto& field : m_fields) {
+        field.assign(count, 0.0f);
+    }
+    m_fields[Increment].assign(count, 0.01f);
+    m_fields[InvIncrement].assign(count, 100.0f);
+    m_level.assign(count, 0.0f);
+    m_targetGain.assign(count, 0.0f);
+    m_velocity.assign(count, 0.0f);
+    m_stage.assign(count, Idle);
+    m_note.assign(count, -1);
+    m_started.assign(count, 0);
+    m_events.reserve(kMaxEvents);
+    std::fill(std::begin(m_mix), std::end(m_mix), 0.0f);
+
+    setParameters(Parameters{});
+}
+
+// ===== Audio Thread =====
+
+void Synth::setParameters(const Parameters& parameters) {
+    m_parameters = parameters;
+    const double msToFrames = m_sampleRate / 1000.0;
+    m_attackStep = static_cast<float>(1.0 / std::max(1.0, parameters.attackMs * msToFrames));
+    m_decayCoeff = static_cast<float>(std::exp(std::log(kSilentLevel) / std::max(1.0, parameters.decayMs * msToFrames)));
+    m_releaseCoeff = static_cast<float>(std::exp(std::log(kSilentLevel) / std::max(1.0, parameters.releaseMs * msToFrames)));
+}
+
+void Synth::noteOn(int note, int velocity, size_t offset) {
+    if (m_events.size() >= kMaxEvents) {
+        m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const Event event{offset, note, std::clamp(velocity, 0, 127)};
+    auto it = std::upper_bound(m_events.begin(), m_events.end(), event,
+                               [](const Event& a, const Event& b) { return a.offset < b.offset; });
+    m_events.insert(it, event);
+}
+
+void Synth::noteOff(int note, size_t offset) {
+    noteOn(note, 0, offset);
+}
+
+void Synth::allNotesOff() {
+    m_events.clear();
+    for (size_t v = 0; v < m_stage.size(); ++v) {
+        if (m_stage[v] != Idle) {
+            m_stage[v] = Release;
+        }
+    }
+}
+
+int Synth::allocateVoice() {
+    int oldest = -1;
+    int oldestReleasing = -1;
+    for (size_t v = 0; v < m_stage.size(); ++v) {
+        const int voice = static_cast<int>(v);
+        if (m_stage[v] == Idle) {
+            return voice;
+        }
+        int& best = m_stage[v] == Release ? oldestReleasing : oldest;
+        if (best < 0 || m_started[v] < m_started[static_cast<size_t>(best)]) {
+            best = voice;
+        }
+    }
+    return oldestReleasing >= 0 ? oldestReleasing : oldest;
+}
+
+void Synth::applyEvent(const Event& event) {
+    if (event.velocity == 0) {
+        for (size_t v = 0; v < m_stage.size(); ++v) {
+            if (m_note[v] == event.note && (m_stage[v] == Attack || m_stage[v] == Decay)) {
+                m_stage[v] = Release;
+            }
+        }
+        return;
+    }
+
+    const size_t v = static_cast<size_t>(allocateVoice());
+    if (m_stage[v] == Idle) {
+        // Fresh voice: deterministic start
+        m_fields[Phase][v] = 0.0f;
+        m_fields[Ic1][v] = 0.0f;
+        m_fields[Ic2][v] = 0.0f;
+    } else {
+        // Stolen: the envelope restarts from its current level, so the gain
+        // ramp stays continuous
+        m_steals.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const double hz = 440.0 * std::pow(2.0, (event.note - 69) / 12.0);
+    const float increment = static_cast<float>(std::min(0.45, hz / m_sampleRate));
+    m_fields[Increment][v] = increment;
+    m_fields[InvIncrement][v] = 1.0f / increment;
+    m_note[v] = event.note;
+    m_velocity[v] = static_cast<float>(event.velocity) / 127.0f;
+    m_stage[v] = Attack;
+    m_started[v] = ++m_voiceCounter;
+}
+
+void Synth::updateVoices(size_t frames) {
+    const float n = static_cast<float>(frames);
+    const float decay = std::pow(m_decayCoeff, n);
+    const float release = std::pow(m_releaseCoeff, n);
+    const float sustain = static_cast<float>(m_parameters.sustain);
+    const float gain = static_cast<float>(m_parameters.gain);
+    const double k = 1.0 / std::max(0.1, m_parameters.resonance);
+    const double maxCutoff = 0.45 * m_sampleRate;
+
+    for (size_t v = 0; v < m_level.size(); ++v) {
+        float level = m_level[v];
+        switch (m_stage[v]) {
+        case Attack:
+            level += m_attackStep * n;
+            if (level >= 1.0f) {
+                level = 1.0f;
+                m_stage[v] = Decay;
+            }
+            break;
+        case Decay:
+            level = sustain + (level - sustain) * decay;
+            break;
+        case Release:
+            level *= release;
+            if (level < kSilentLevel) {
+                level = 0.0f;
+                m_stage[v] = Idle;
+            }
+            break;
+        default:
+            break;
+        }
+        m_level[v] = level;
+        m_targetGain[v] = level * m_velocity[v] * gain;
+        m_fields[GainStep][v] = (m_targetGain[v] - m_fields[Gain][v]) / n;
+
+        if (m_stage[v] == Idle) {
+            continue;
+        }
+
+        // Topology-preserving state variable low-pass (Simper), cutoff swept by the envelope
+        const double cutoff = std::min(maxCutoff, m_parameters.cutoffHz * std::exp2(m_parameters.envelopeOctaves * level));
+        const double g = std::tan(M_PI * cutoff / m_sampleRate);
+        const double a1 = 1.0 / (1.0 + g * (g + k));
+        m_fields[A1][v] = static_cast<float>(a1);
+        m_fields[A2][v] = static_cast<float>(g * a1);
+        m_fields[A3][v] = static_cast<float>(g * g * a1);
+    }
+}
+
+void Synth::process(float* left, float* right, size_t frames) {
+#if defined(CADENCE_SYNTH_SSE)
+    render<true>(left, right, frames);
+#else
+    render<false>(left, right, frames);
+#endif
+}
+
+void Synth::processScalar(float* left, float* right, size_t frames) {
+    render<false>(left, right, frames);
+}
+
+template <bool Simd>
+void Synth::render(float* left, float* right, size_t frames) {
+    const size_t groups = m_level.size() / kLanes;
+    size_t next = 0;
+    size_t pos = 0;
+
+    while (pos < frames) {
+        while (next < m_events.size() && m_events[next].offset <= pos) {
+            applyEvent(m_events[next++]);
+        }
+        const size_t end = next < m_events.size() ? std::min(frames, m_events[next].offset) : frames;
+        const size_t n = std::min(kControlFrames, end - pos);
+
+        updateVoices(n);
+        std::memset(m_mix, 0, n * kLanes * sizeof(float));
+        for (size_t group = 0; group < groups; ++group) {
+            const size_t first = group * kLanes;
+            bool silent = true;
+            for (size_t v = first; v < first + kLanes; ++v) {
+                silent = silent && m_stage[v] == Idle && m_fields[Gain][v] == 0.0f && m_targetGain[v] == 0.0f;
+            }
+            if (silent) {
+                continue;
+            }
+
+            float* state[kFieldCount];
+            for (int f = 0; f < kFieldCount; ++f) {
+                state[f] = m_fields[f].data() + first;
+            }
+            if (Simd) {
+                renderGroupSimd(state, m_mix, n);
+            } else {
+                renderGroupScalar(state, m_mix, n);
+            }
+            // Land exactly on the target so released voices reach silence
+            for (size_t v = first; v < first + kLanes; ++v) {
+                m_fields[Gain][v] = m_targetGain[v];
+            }
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            const float* lanes = m_mix + i * kLanes;
+            const float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            left[pos + i] = sum;
+            right[pos + i] = sum;
+        }
+        pos += n;
+    }
+
+    // Events beyond this block carry over
+    m_events.erase(m_events.begin(), m_events.begin() + static_cast<ptrdiff_t>(next));
+    for (Event& event : m_events) {
+        event.offset -= frames;
+    }
+
+    int active = 0;
+    for (uint8_t stage : m_stage) {
+        active += stage != Idle;
+    }
+    m_activeVoices.store(active, std::memory_order_relaxed);
+}
+
+void Synth::renderGroupScalar(float* const* state, float* mix, size_t frames) {
+    for (int lane = 0; lane < kLanes; ++lane) {
+        float phase = state[Phase][lane];
+        const float dt = state[Increment][lane];
+        const float inv = state[InvIncrement][lane];
+        float gain = state[Gain][lane];
+        const float step = state[GainStep][lane];
+        float ic1 = state[Ic1][lane];
+        float ic2 = state[Ic2][lane];
+        const float a1 = state[A1][lane];
+        const float a2 = state[A2][lane];
+        const float a3 = state[A3][lane];
+
+        for (size_t i = 0; i < frames; ++i) {
+            phase += dt;
+            if (phase >= 1.0f) {
+                phase -= 1.0f;
+            }
+
+            // PolyBLEP saw: smooth the step over one sample either side of the wrap
+            float saw = 2.0f * phase - 1.0f;
+            if (phase < dt) {
+                const float x = phase * inv;
+                saw -= x + x - x * x - 1.0f;
+            } else if (phase > 1.0f - dt) {
+                const float x = (phase - 1.0f) * inv;
+                saw -= x * x + x + x + 1.0f;
+            }
+
+            const float v3 = saw - ic2;
+            const float v1 = a1 * ic1 + a2 * v3;
+            const float v2 = ic2 + a2 * ic1 + a3 * v3;
+            ic1 = 2.0f * v1 - ic1;
+            ic2 = 2.0f * v2 - ic2;
+
+            gain += step;
+            mix[i * kLanes + lane] += v2 * gain;
+        }
+
+        state[Phase][lane] = phase;
+        state[Ic1][lane] = ic1;
+        state[Ic2][lane] = ic2;
+    }
+}
+
+#if defined(CADENCE_SYNTH_SSE)
+
+void Synth::renderGroupSimd(float* const* state, float* mix, size_t frames) {
+    __m128 phase = _mm_load_ps(state[Phase]);
+    const __m128 dt = _mm_load_ps(state[Increment]);
+    const __m128 inv = _mm_load_ps(state[InvIncrement]);
+    __m128 gain = _mm_load_ps(state[Gain]);
+    const __m128 step = _mm_load_ps(state[GainStep]);
+    __m128 ic1 = _mm_load_ps(state[Ic1]);
+    __m128 ic2 = _mm_load_ps(state[Ic2]);
+    const __m128 a1 = _mm_load_ps(state[A1]);
+    const __m128 a2 = _mm_load_ps(state[A2]);
+    const __m128 a3 = _mm_load_ps(state[A3]);
+
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 edge = _mm_sub_ps(one, dt);
+
+    for (size_t i = 0; i < frames; ++i) {
+        phase = _mm_add_ps(phase, dt);
+        phase = _mm_sub_ps(phase, _mm_and_ps(_mm_cmpge_ps(phase, one), one));
+
+        // Both polyBLEP branches, selected per lane; they never overlap while dt < 0.5
+        __m128 saw = _mm_sub_ps(_mm_mul_ps(two, phase), one);
+        const __m128 x0 = _mm_mul_ps(phase, inv);
+        const __m128 after = _mm_sub_ps(_mm_sub_ps(_mm_add_ps(x0, x0), _mm_mul_ps(x0, x0)), one);
+        const __m128 x1 = _mm_mul_ps(_mm_sub_ps(phase, one), inv);
+        const __m128 before = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x1, x1), _mm_add_ps(x1, x1)), one);
+        saw = _mm_sub_ps(saw, _mm_and_ps(_mm_cmplt_ps(phase, dt), after));
+        saw = _mm_sub_ps(saw, _mm_and_ps(_mm_cmpgt_ps(phase, edge), before));
+
+        const __m128 v3 = _mm_sub_ps(saw, ic2);
+        const __m128 v1 = _mm_add_ps(_mm_mul_ps(a1, ic1), _mm_mul_ps(a2, v3));
+        const __m128 v2 = _mm_add_ps(_mm_add_ps(ic2, _mm_mul_ps(a2, ic1)), _mm_mul_ps(a3, v3));
+        ic1 = _mm_sub_ps(_mm_mul_ps(two, v1), ic1);
+        ic2 = _mm_sub_ps(_mm_mul_ps(two, v2), ic2);
+
+        gain = _mm_add_ps(gain, step);
+        float* out = mix + i * kLanes;
+        _mm_store_ps(out, _mm_add_ps(_mm_load_ps(out), _mm_mul_ps(v2, gain)));
+    }
+
+    _mm_store_ps(state[Phase], phase);
+    _mm_store_ps(state[Ic1], ic1);
+    _mm_store_ps(state[Ic2], ic2);
+}
+
+#else
+
+void Synth::renderGroupSimd(float* const* state, float* mix, size_t frames) {
+    renderGroupScalar(state, mix, frames);
+}
+
+#endif
+
+} // namespace AudioEngine
@@ -0,0 +1,117 @@
+#ifndef SYNTH_H
+#define SYNTH_H
+
+#include "../dsp/alignedbuffer.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AudioEngine {
+
+// Polyphonic subtractive synth: band-limited saw -> resonant low-pass -> amp
+// Voice state (oscillator phase, filter memory, gain ramp) is stored as
+// arrays across voices, and voices render kLanes at a time, one lane per
+// voice, so each SIMD instruction advances a whole group. Groups whose voices
+// are all silent are skipped.
+// Envelopes and filter cutoffs are modulation: they update every
+// kControlFrames frames and the gain ramps linearly in between. Note events
+// carry a frame offset into the next process() call; the block is split at
+// each event so notes start on their exact frame.
+class Synth {
+public:
+    static constexpr int kLanes = 4;
+    static constexpr size_t kControlFrames = 32;
+
+    struct Parameters {
+        double cutoffHz = 1200.0;
+        double resonance = 0.9;         // Filter Q
+        double envelopeOctaves = 3.0;   // Cutoff sweep at full envelope
+        double attackMs = 5.0;
+        double decayMs = 250.0;
+        double sustain = 0.6;
+        double releaseMs = 300.0;
+        double gain = 0.25;             // Per voice at full velocity
+    };
+
+    // voices is rounded up to a multiple of kLanes
+    Synth(double sampleRate, int voices);
+
+    int voiceCount() const { return static_cast<int>(m_level.size()); }
+
+    // ===== Audio Thread =====
+
+    void setParameters(const Parameters& parameters);
+    const Parameters& parameters() const { return m_parameters; }
+
+    // offset: frames into the next process() call; later events carry over
+    void noteOn(int note, int velocity, size_t offset = 0);
+    void noteOff(int note, size_t offset = 0);
+    void allNotesOff();
+
+    // Render into left/right (overwrites)
+    void process(float* left, float* right, size_t frames);
+
+    // Same output with a portable per-lane loop; reference for tests and benchmarks
+    void processScalar(float* left, float* right, size_t frames);
+
+    int getActiveVoiceCount() const { return m_activeVoices.load(std::memory_order_relaxed); }
+    uint64_t getStealCount() const { return m_steals.load(std::memory_order_relaxed); }
+    uint64_t getDroppedEventCount() const { return m_droppedEvents.load(std::memory_order_relaxed); }
+
+private:
+    enum Stage : uint8_t { Idle, Attack, Decay, Release };
+
+    struct Event {
+        size_t offset;
+        int note;
+        int velocity;       // 0 for note off
+    };
+
+    static constexpr size_t kMaxEvents = 256;
+
+    template <bool Simd>
+    void render(float* left, float* right, size_t frames);
+
+    void applyEvent(const Event& event);
+    int allocateVoice();
+    void updateVoices(size_t frames);
+
+    static void renderGroupScalar(float* const* state, float* mix, size_t frames);
+    static void renderGroupSimd(float* const* state, float* mix, size_t frames);
+
+    double m_sampleRate;
+    Parameters m_parameters;
+
+    // Per frame and per block constants derived from the parameters
+    float m_attackStep = 0.0f;
+    float m_decayCoeff = 0.0f;
+    float m_releaseCoeff = 0.0f;
+
+    // ===== Voice state, structure-of-arrays =====
+    // Rendered per frame, kLanes at a time
+    enum Field { Phase, Increment, InvIncrement, Gain, GainStep, Ic1, Ic2, A1, A2, A3, kFieldCount };
+    AlignedVector<float> m_fields[kFieldCount];
+
+    // Updated per control block
+    std::vector<float> m_level;         // Envelope
+    std::vector<float> m_targetGain;    // Gain at the end of the control block
+    std::vector<float> m_velocity;
+    std::vector<uint8_t> m_stage;
+    std::vector<int> m_note;
+    std::vector<uint64_t> m_started;
+    uint64_t m_voiceCounter = 0;
+
+    // Pending events, ordered by offset
+    std::vector<Event> m_events;
+
+    alignas(16) float m_mix[kControlFrames * kLanes];   // [frame][lane]
+
+    std::atomic<int> m_activeVoices{0};
+    std::atomic<uint64_t> m_steals{0};
+    std::atomic<uint64_t> m_droppedEvents{0};
+};
+
+} // namespace AudioEngine
+
+#endif // SYNTH_H
@@ -0,0 +1,172 @@
+#include "diskstreamer.h"
+#include "../common/audioerror.h"
+#include <algorithm>
+#include <chrono>
+
+namespace AudioEngine {
+
+DiskStreamer::DiskStreamer(int slots, size_t ringFrames)
+    : m_commands(static_cast<size_t>(std::max(1, slots)) * 4)
+    , m_left(kChunkFrames, 0.0f)
+    , m_right(kChunkFrames, 0.0f)
+    , m_interleaved(2 * kChunkFrames, 0.0f)
+{
+    for (int i = 0; i < slots; ++i) {
+        auto slot = std::make_unique<Slot>();
+        slot->ring = std::make_unique<SpscQueue<float>>(2 * std::max(ringFrames, kChunkFrames));
+        m_slots.push_back(std::move(slot));
+    }
+}
+
+DiskStreamer::~DiskStreamer() {
+    stop();
+}
+
+void DiskStreamer::start() {
+    if (m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = false;
+    }
+    m_thread = std::thread([this] { ioLoop(); });
+}
+
+void DiskStreamer::stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+bool DiskStreamer::open(int slot, const std::string* path, uint64_t startFrame) {
+    Slot& s = *m_slots[static_cast<size_t>(slot)];
+    if (!m_commands.push(Command{slot, s.generation + 1, path, startFrame})) {
+        return false;
+    }
+    ++s.generation;
+    m_wake.notify_one();
+    return true;
+}
+
+void DiskStreamer::close(int slot) {
+    Slot& s = *m_slots[static_cast<size_t>(slot)];
+
+    // If the queue is full the stream runs to its end instead; the new
+    // generation still hides anything it pushes
+    m_commands.push(Command{slot, s.generation + 1, nullptr, 0});
+    ++s.generation;
+}
+
+size_t DiskStreamer::read(int slot, float* left, float* right, size_t frames) {
+    Slot& s = *m_slots[static_cast<size_t>(slot)];
+    if (s.ready.load(std::memory_order_acquire) != s.generation) {
+        return 0;
+    }
+
+    // Skip whatever earlier streams left in the ring
+    float scratch[256];
+    const uint64_t start = s.startOffset.load(std::memory_order_relaxed);
+    while (s.consumed < start) {
+        const size_t skip = static_cast<size_t>(std::min<uint64_t>(128, start - s.consumed));
+        const size_t popped = s.ring->pop(scratch, 2 * skip) / 2;
+        s.consumed += popped;
+        if (popped < skip) {
+            return 0;
+        }
+    }
+
+    size_t done = 0;
+    while (done < frames) {
+        const size_t want = std::min<size_t>(128, frames - done);
+        const size_t popped = s.ring->pop(scratch, 2 * want) / 2;
+        for (size_t i = 0; i < popped; ++i) {
+            left[done + i] = scratch[2 * i];
+            right[done + i] = scratch[2 * i + 1];
+        }
+        done += popped;
+        s.consumed += popped;
+        if (popped < want) {
+            break;
+        }
+    }
+    return done;
+}
+
+void DiskStreamer::ioLoop() {
+    while (true) {
+        Command command;
+        while (m_commands.pop(command)) {
+            handle(command);
+        }
+
+        bool more = false;
+        for (auto& slot : m_slots) {
+            more = fill(*slot) || more;
+        }
+
+        // The audio thread notifies without the lock; the timeout covers a
+        // notification landing between the check and the wait
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_quit) {
+            return;
+        }
+        if (!more) {
+            m_wake.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+}
+
+void DiskStreamer::handle(const Command& command) {
+    Slot& slot = *m_slots[static_cast<size_t>(command.slot)];
+    slot.streaming = false;
+    slot.reader.close();
+
+    if (command.path) {
+        try {
+            slot.reader.open(*command.path);
+            slot.reader.seek(command.startFrame);
+            slot.streaming = true;
+        } catch (const AudioException&) {
+            m_errors.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    slot.startOffset.store(slot.produced, std::memory_order_relaxed);
+    slot.ready.store(command.generation, std::memory_order_release);
+}
+
+bool DiskStreamer::fill(Slot& slot) {
+    if (!slot.streaming) {
+        return false;
+    }
+
+    const size_t freeFrames = (slot.ring->capacity() - slot.ring->size()) / 2;
+    if (freeFrames < kChunkFrames) {
+        return false;
+    }
+
+    float* channels[] = {m_left.data(), m_right.data()};
+    const size_t n = slot.reader.read(channels, 2, kChunkFrames);
+    const bool mono = slot.reader.format().channels == 1;
+    for (size_t i = 0; i < n; ++i) {
+        m_interleaved[2 * i] = m_left[i];
+        m_interleaved[2 * i + 1] = mono ? m_left[i] : m_right[i];
+    }
+    slot.ring->push(m_interleaved.data(), 2 * n);
+    slot.produced += n;
+
+    if (n < kChunkFrames) {
+        slot.streaming = false;
+        slot.reader.close();
+    }
+    return slot.streaming;
+}
+
+} // namespace AudioEngine
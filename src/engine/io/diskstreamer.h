@@ -0,0 +1,102 @@
+#ifndef DISKSTREAMER_H
+#define DISKSTREAMER_H
+
+#include "wavfile.h"
+#include "../realtime/spscqueue.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace AudioEngine {
+
+// Background reader that streams WAV files into per-slot rings
+// The audio thread opens a stream on a slot (one slot per voice) with a
+// command through a lock-free queue; the I/O thread opens the file, seeks and
+// keeps the slot's ring topped up, and the audio thread pops stereo frames.
+// Mono files come out on both channels. Reopening a slot abandons whatever
+// the old stream left in the ring: the I/O thread publishes where the new
+// stream starts and the reader skips up to it.
+class DiskStreamer {
+public:
+    DiskStreamer(int slots, size_t ringFrames);
+    ~DiskStreamer();
+
+    int slotCount() const { return static_cast<int>(m_slots.size()); }
+
+    // ===== Control Thread =====
+
+    void start();
+    void stop();
+
+    // ===== Audio Thread =====
+
+    // Stream path (which must outlive the stream) from startFrame; false if
+    // the command queue is full
+    bool open(int slot, const std::string* path, uint64_t startFrame);
+    void close(int slot);
+
+    // Pop up to frames of the slot's current stream; fewer (possibly zero)
+    // while the I/O thread has not caught up
+    size_t read(int slot, float* left, float* right, size_t frames);
+
+    // Open failures (missing or unreadable files) seen by the I/O thread
+    uint64_t getErrorCount() const { return m_errors.load(std::memory_order_relaxed); }
+
+private:
+    DiskStreamer(const DiskStreamer&) = delete;
+    DiskStreamer& operator=(const DiskStreamer&) = delete;
+
+    struct Command {
+        int slot = 0;
+        uint32_t generation = 0;
+        const std::string* path = nullptr;  // Null closes the slot
+        uint64_t startFrame = 0;
+    };
+
+    struct Slot {
+        std::unique_ptr<SpscQueue<float>> ring;     // Interleaved stereo
+
+        // Audio thread
+        uint32_t generation = 0;
+        uint64_t consumed = 0;                      // Frames popped, all streams
+
+        // I/O thread
+        WavReader reader;
+        bool streaming = false;
+        uint64_t produced = 0;                      // Frames pushed, all streams
+
+        // Published by the I/O thread: stream `ready` starts at `startOffset`
+        std::atomic<uint64_t> startOffset{0};
+        std::atomic<uint32_t> ready{0};
+    };
+
+    void ioLoop();
+    void handle(const Command& command);
+    bool fill(Slot& slot);
+
+    static constexpr size_t kChunkFrames = 4096;
+
+    std::vector<std::unique_ptr<Slot>> m_slots;
+    SpscQueue<Command> m_commands;
+    std::atomic<uint64_t> m_errors{0};
+
+    // I/O thread scratch
+    std::vector<float> m_left;
+    std::vector<float> m_right;
+    std::vector<float> m_interleaved;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_quit = false;
+};
+
+} // namespace AudioEngine
+
+#endif // DISKSTREAMER_H
@@ -0,0 +1,30 @@
+#include "loudnessscan.h"
+#include "wavfile.h"
+#include "../dsp/loudnessmeter.h"
+#include <vector>
+
+namespace AudioEngine {
+
+LoudnessReading LoudnessScan::file(const std::string& path, size_t blockFrames) {
+    WavReader reader;
+    reader.open(path);
+    const int channels = reader.format().channels;
+
+    LoudnessMeter meter(reader.format().sampleRate, channels, blockFrames);
+    std::vector<std::vector<float>> buffers(static_cast<size_t>(channels), std::vector<float>(blockFrames));
+    std::vector<float*> pointers;
+    for (auto& buffer : buffers) {
+        pointers.push_back(buffer.data());
+    }
+
+    for (;;) {
+        const size_t frames = reader.read(pointers.data(), channels, blockFrames);
+        if (frames == 0) {
+            break;
+        }
+        meter.process(pointers.data(), frames);
+    }
+    return meter.reading();
+}
+
+} // namespace AudioEngine
@@ -0,0 +1,22 @@
+#ifndef LOUDNESSSCAN_H
+#define LOUDNESSSCAN_H
+
+#include "../common/enginesnapshot.h"
+#include <cstddef>
+#include <string>
+
+namespace AudioEngine {
+
+// Offline loudness measurement of a rendered WAV
+// Runs the same LoudnessMeter as the live master bus over the whole file in
+// large blocks, at disk/decode speed rather than real time, so a render can
+// be checked against a delivery spec without an external meter.
+class LoudnessScan {
+public:
+    // Throws AudioException if the file cannot be read
+    static LoudnessReading file(const std::string& path, size_t blockFrames = 65536);
+};
+
+} // namespace AudioEngine
+
+#endif // LOUDNESSSCAN_H
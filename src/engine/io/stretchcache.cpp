@@ -0,0 +1,168 @@
+#include "stretchcache.h"
+#include "wavfile.h"
+#include "../common/audioerror.h"
+#include "../dsp/timestretcher.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace AudioEngine {
+
+StretchCache::StretchCache(std::string directory)
+    : m_directory(std::move(directory))
+{
+    m_worker = std::thread([this] { workerLoop(); });
+}
+
+StretchCache::~StretchCache() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_one();
+    m_worker.join();
+}
+
+std::string StretchCache::cachePath(const std::string& source, double timeRatio, double pitchRatio) const {
+    // Ratios at a precision well past anything audible, so near-equal
+    // requests share a file
+    char key[64];
+    std::snprintf(key, sizeof(key), "%.6f-%.6f", timeRatio, pitchRatio);
+    const size_t hash = std::hash<std::string>{}(source + '|' + key);
+
+    char name[48];
+    std::snprintf(name, sizeof(name), "stretch-%016zx.wav", hash);
+    return m_directory + "/" + name;
+}
+
+std::string StretchCache::lookup(const std::string& source, double timeRatio, double pitchRatio) const {
+    const std::string path = cachePath(source, timeRatio, pitchRatio);
+    if (std::FILE* file = std::fopen(path.c_str(), "rb")) {
+        std::fclose(file);
+        return path;
+    }
+    return {};
+}
+
+void StretchCache::request(const std::string& source, double timeRatio, double pitchRatio) {
+    const std::string destination = cachePath(source, timeRatio, pitchRatio);
+    if (!lookup(source, timeRatio, pitchRatio).empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_queued.insert(destination).second) {
+            return;
+        }
+        m_queue.push_back(Job{source, timeRatio, pitchRatio, destination});
+    }
+    m_wake.notify_one();
+}
+
+void StretchCache::waitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_queue.empty() && !m_busy; });
+}
+
+int StretchCache::getFailedCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_failed;
+}
+
+void StretchCache::workerLoop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_quit || !m_queue.empty(); });
+            if (m_quit) {
+                return;
+            }
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_busy = true;
+        }
+
+        bool failed = false;
+        try {
+            render(job.source, job.destination, job.timeRatio, job.pitchRatio);
+        } catch (const std::exception&) {
+            // AudioException from the files, or bad_alloc from the stretcher
+            failed = true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queued.erase(job.destination);
+            m_busy = false;
+            if (failed) {
+                ++m_failed;
+            }
+        }
+        m_idle.notify_all();
+    }
+}
+
+void StretchCache::render(const std::string& source, const std::string& destination,
+                          double timeRatio, double pitchRatio) {
+    WavReader reader;
+    reader.open(source);
+
+    WavFormat format = reader.format();
+    format.format = SampleFormat::Float32;
+    const int channels = format.channels;
+
+    TimeStretcher stretcher(channels, format.sampleRate, TimeStretcher::Quality::HighQuality);
+    stretcher.setTimeRatio(timeRatio);
+    stretcher.setPitchRatio(pitchRatio);
+    const uint64_t target = static_cast<uint64_t>(
+        std::llround(static_cast<double>(reader.frameCount()) * stretcher.getTimeRatio()));
+
+    // Written under a temporary name and renamed once complete
+    const std::string partial = destination + ".part";
+    WavWriter writer;
+    writer.open(partial, format);
+
+    const size_t block = 4096;
+    std::vector<std::vector<float>> buffers(static_cast<size_t>(channels), std::vector<float>(block));
+    std::vector<float*> pointers(static_cast<size_t>(channels));
+    for (int ch = 0; ch < channels; ++ch) {
+        pointers[ch] = buffers[ch].data();
+    }
+
+    // Past the end of the source the reader zero-fills, which flushes the tail.
+    // A render that fails part way leaves nothing behind.
+    try {
+        while (writer.framesWritten() < target) {
+            const size_t wanted = static_cast<size_t>(std::min<uint64_t>(block, target - writer.framesWritten()));
+            while (stretcher.available() < wanted) {
+                const size_t need = std::min(stretcher.getSamplesRequired(), block);
+                reader.read(pointers.data(), channels, need);
+                if (stretcher.process(pointers.data(), need) != need) {
+                    throw AudioException(AudioErrorCode::PlatformSpecificError,
+                                         "Time-stretcher refused input while rendering: " + destination);
+                }
+            }
+            const size_t n = stretcher.retrieve(pointers.data(), wanted);
+            writer.write(pointers.data(), n);
+        }
+    } catch (...) {
+        writer.close();
+        std::remove(partial.c_str());
+        throw;
+    }
+    writer.close();
+
+    if (std::rename(partial.c_str(), destination.c_str()) != 0) {
+        std::remove(partial.c_str());
+        throw AudioException(AudioErrorCode::PlatformSpecificError,
+                             "Cannot move rendered clip into the cache: " + destination);
+    }
+}
+
+} // namespace AudioEngine
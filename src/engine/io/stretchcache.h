@@ -0,0 +1,77 @@
+#ifndef STRETCHCACHE_H
+#define STRETCHCACHE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace AudioEngine {
+
+// Disk cache of time-stretched clips
+// When live stretching gets too expensive (EngineSnapshot::dspLoad above
+// kPrerenderLoad), the session asks for a clip at its current ratios. A
+// background thread renders it once with the HighQuality stretcher into the
+// cache directory. Until lookup() returns the file, playback keeps stretching
+// live, then it switches to plain streaming of the rendered WAV. Files are
+// keyed on source path and ratios and written under a temporary name, so a
+// file that exists is always complete.
+class StretchCache {
+public:
+    static constexpr double kPrerenderLoad = 70.0;    // dspLoad, percent
+
+    explicit StretchCache(std::string directory);
+    ~StretchCache();
+
+    // ===== Control Thread =====
+
+    // Rendered file for these settings, or empty if not rendered (yet)
+    std::string lookup(const std::string& source, double timeRatio, double pitchRatio) const;
+
+    // Queue a render unless the file exists or is already queued
+    void request(const std::string& source, double timeRatio, double pitchRatio);
+
+    // Block until the queue is empty
+    void waitIdle();
+
+    // Renders that threw (missing or unreadable source); not retried
+    int getFailedCount() const;
+
+    // Where the render for these settings lives
+    std::string cachePath(const std::string& source, double timeRatio, double pitchRatio) const;
+
+    // Stretch a whole WAV file offline. Throws AudioException on I/O errors.
+    static void render(const std::string& source, const std::string& destination,
+                       double timeRatio, double pitchRatio);
+
+private:
+    StretchCache(const StretchCache&) = delete;
+    StretchCache& operator=(const StretchCache&) = delete;
+
+    struct Job {
+        std::string source;
+        double timeRatio = 1.0;
+        double pitchRatio = 1.0;
+        std::string destination;
+    };
+
+    void workerLoop();
+
+    std::string m_directory;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::deque<Job> m_queue;
+    std::set<std::string> m_queued;         // Destinations queued or rendering
+    bool m_busy = false;
+    bool m_quit = false;
+    int m_failed = 0;
+    std::thread m_worker;
+};
+
+} // namespace AudioEngine
+
+#endif // STRETCHCACHE_H
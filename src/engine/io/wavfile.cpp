@@ -0,0 +1,349 @@
+#include "wavfile.h"
+#include "../common/audioerror.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace AudioEngine {
+
+namespace {
+
+constexpr uint16_t kFormatPcm = 1;
+constexpr uint16_t kFormatFloat = 3;
+constexpr uint16_t kFormatExtensible = 0xFFFE;
+
+// Frames converted per chunk, bounds the raw byte buffer
+constexpr size_t kChunkFrames = 1024;
+
+uint16_t readU16(const unsigned char* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t readU32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void putU16(unsigned char* p, uint16_t v) {
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+}
+
+void putU32(unsigned char* p, uint32_t v) {
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = (v >> 16) & 0xff;
+    p[3] = (v >> 24) & 0xff;
+}
+
+int bytesPerSample(SampleFormat format) {
+    switch (format) {
+    case SampleFormat::Int16: return 2;
+    case SampleFormat::Int24: return 3;
+    case SampleFormat::Int32: return 4;
+    case SampleFormat::Float32: return 4;
+    }
+    return 4;
+}
+
+inline float decodeSample(const unsigned char* p, SampleFormat format) {
+    switch (format) {
+    case SampleFormat::Int16:
+        return static_cast<int16_t>(readU16(p)) * (1.0f / 32768.0f);
+    case SampleFormat::Int24: {
+        int32_t value = static_cast<int32_t>((p[0] << 8) | (p[1] << 16) |
+                                             (static_cast<uint32_t>(p[2]) << 24));
+        return (value >> 8) * (1.0f / 8388608.0f);
+    }
+    case SampleFormat::Int32:
+        return static_cast<int32_t>(readU32(p)) * (1.0f / 2147483648.0f);
+    case SampleFormat::Float32: {
+        float value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+    }
+    return 0.0f;
+}
+
+
+}
+
+// ===== WavReader =====
+
+WavReader::~WavReader() {
+    close();
+}
+
+void WavReader::open(const std::string& path) {
+    close();
+
+    m_file = std::fopen(path.c_str(), "rb");
+    if (!m_file) {
+        throw AudioException(AudioErrorCode::DeviceUnavailable, "Cannot open WAV file: " + path);
+    }
+
+    auto fail = [&](const std::string& reason) {
+        close();
+        throw AudioException(AudioErrorCode::InvalidConfiguration, path + ": " + reason);
+    };
+
+    unsigned char riff[12];
+    if (std::fread(riff, 1, sizeof(riff), m_file) != sizeof(riff) ||
+        std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+        fail("not a RIFF/WAVE file");
+    }
+
+    bool haveFormat = false;
+    uint16_t formatTag = 0;
+    uint16_t bitsPerSample = 0;
+
+    // Walk chunks until "data"; skip anything we don't understand
+    while (true) {
+        unsigned char header[8];
+        if (std::fread(header, 1, sizeof(header), m_file) != sizeof(header)) {
+            fail("no data chunk");
+        }
+        const uint32_t size = readU32(header + 4);
+
+        if (std::memcmp(header, "fmt ", 4) == 0) {
+            unsigned char fmt[40] = {};
+            const size_t toRead = std::min<size_t>(size, sizeof(fmt));
+            if (size < 16 || std::fread(fmt, 1, toRead, m_file) != toRead) {
+                fail("truncated fmt chunk");
+            }
+            formatTag = readU16(fmt);
+            m_format.channels = readU16(fmt + 2);
+            m_format.sampleRate = static_cast<int>(readU32(fmt + 4));
+            bitsPerSample = readU16(fmt + 14);
+
+            // Extensible: the real tag is the first two bytes of the subformat GUID
+            if (formatTag == kFormatExtensible && size >= 40) {
+                formatTag = readU16(fmt + 24);
+            }
+            std::fseek(m_file, static_cast<long>(size - toRead + (size & 1)), SEEK_CUR);
+            haveFormat = true;
+        } else if (std::memcmp(header, "data", 4) == 0) {
+            if (!haveFormat) {
+                fail("data chunk before fmt chunk");
+            }
+            m_dataOffset = static_cast<uint64_t>(std::ftell(m_file));
+            m_bytesPerSample = bitsPerSample / 8;
+            const uint64_t frameBytes = static_cast<uint64_t>(m_bytesPerSample) * m_format.channels;
+            m_frameCount = frameBytes ? size / frameBytes : 0;
+            break;
+        } else {
+            std::fseek(m_file, static_cast<long>(size + (size & 1)), SEEK_CUR);
+        }
+    }
+
+    if (formatTag == kFormatFloat && bitsPerSample == 32) {
+        m_format.format = SampleFormat::Float32;
+    } else if (formatTag == kFormatPcm && bitsPerSample == 16) {
+        m_format.format = SampleFormat::Int16;
+    } else if (formatTag == kFormatPcm && bitsPerSample == 24) {
+        m_format.format = SampleFormat::Int24;
+    } else if (formatTag == kFormatPcm && bitsPerSample == 32) {
+        m_format.format = SampleFormat::Int32;
+    } else {
+        fail("unsupported sample format");
+    }
+
+    if (m_format.channels <= 0 || m_format.sampleRate <= 0) {
+        fail("invalid channel count or sample rate");
+    }
+
+    m_position = 0;
+    m_raw.resize(kChunkFrames * m_format.channels * m_bytesPerSample);
+}
+
+void WavReader::close() {
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+    m_frameCount = 0;
+    m_position = 0;
+}
+
+void WavReader::seek(uint64_t frame) {
+    if (!m_file) {
+        return;
+    }
+    m_position = std::min(frame, m_frameCount);
+    const uint64_t offset = m_dataOffset + m_position * m_bytesPerSample * m_format.channels;
+    std::fseek(m_file, static_cast<long>(offset), SEEK_SET);
+}
+
+size_t WavReader::readRaw(size_t frames) {
+    frames = static_cast<size_t>(std::min<uint64_t>(frames, m_frameCount - m_position));
+    const size_t frameBytes = static_cast<size_t>(m_bytesPerSample) * m_format.channels;
+    const size_t got = std::fread(m_raw.data(), frameBytes, frames, m_file);
+    m_position += got;
+    return got;
+}
+
+size_t WavReader::read(float* const* channels, int channelCount, size_t frames) {
+    size_t done = 0;
+
+    while (m_file && done < frames) {
+        const size_t got = readRaw(std::min(kChunkFrames, frames - done));
+        if (got == 0) {
+            break;
+        }
+
+        for (int ch = 0; ch < channelCount; ++ch) {
+            if (!channels[ch]) continue;
+            float* dst = channels[ch] + done;
+            if (ch >= m_format.channels) {
+                std::fill(dst, dst + got, 0.0f);
+                continue;
+            }
+            const unsigned char* src = m_raw.data() + ch * m_bytesPerSample;
+            const size_t stride = static_cast<size_t>(m_bytesPerSample) * m_format.channels;
+            for (size_t i = 0; i < got; ++i, src += stride) {
+                dst[i] = decodeSample(src, m_format.format);
+            }
+        }
+        done += got;
+    }
+
+    for (int ch = 0; ch < channelCount; ++ch) {
+        if (channels[ch]) {
+            std::fill(channels[ch] + done, channels[ch] + frames, 0.0f);
+        }
+    }
+    return done;
+}
+
+size_t WavReader::readInterleaved(float* destination, size_t frames) {
+    size_t done = 0;
+
+    while (m_file && done < frames) {
+        const size_t got = readRaw(std::min(kChunkFrames, frames - done));
+        if (got == 0) {
+            break;
+        }
+
+        const size_t samples = got * m_format.channels;
+        float* dst = destination + done * m_format.channels;
+        for (size_t i = 0; i < samples; ++i) {
+            dst[i] = decodeSample(m_raw.data() + i * m_bytesPerSample, m_format.format);
+        }
+        done += got;
+    }
+    return done;
+}
+
+// ===== WavWriter =====
+
+WavWriter::~WavWriter() {
+    close();
+}
+
+void WavWriter::open(const std::string& path, const WavFormat& format) {
+    close();
+
+    if (format.channels <= 0 || format.sampleRate <= 0) {
+        throw AudioException(AudioErrorCode::InvalidConfiguration,
+                             "Invalid WAV format for " + path);
+    }
+
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) {
+        throw AudioException(AudioErrorCode::DeviceUnavailable, "Cannot create WAV file: " + path);
+    }
+
+    m_format = format;
+    m_bytesPerSample = bytesPerSample(format.format);
+    m_framesWritten = 0;
+    m_raw.resize(kChunkFrames * format.channels * m_bytesPerSample);
+    m_dither.clear();
+    for (int ch = 0; ch < format.channels; ++ch) {
+        m_dither.emplace_back(format.dither, static_cast<uint32_t>(ch + 1));
+    }
+    writeHeader();
+}
+
+void WavWriter::close() {
+    if (!m_file) {
+        return;
+    }
+
+    // Patch sizes now that the data length is known
+    std::fseek(m_file, 0, SEEK_SET);
+    writeHeader();
+    std::fclose(m_file);
+    m_file = nullptr;
+}
+
+void WavWriter::writeHeader() {
+    const bool isFloat = (m_format.format == SampleFormat::Float32);
+    const uint32_t blockAlign = static_cast<uint32_t>(m_bytesPerSample * m_format.channels);
+    const uint64_t dataBytes64 = m_framesWritten * blockAlign;
+    const uint32_t dataBytes = static_cast<uint32_t>(std::min<uint64_t>(dataBytes64, 0xFFFFFFFFu - 36));
+
+    unsigned char header[44];
+    std::memcpy(header, "RIFF", 4);
+    putU32(header + 4, 36 + dataBytes);
+    std::memcpy(header + 8, "WAVE", 4);
+    std::memcpy(header + 12, "fmt ", 4);
+    putU32(header + 16, 16);
+    putU16(header + 20, isFloat ? kFormatFloat : kFormatPcm);
+    putU16(header + 22, static_cast<uint16_t>(m_format.channels));
+    putU32(header + 24, static_cast<uint32_t>(m_format.sampleRate));
+    putU32(header + 28, static_cast<uint32_t>(m_format.sampleRate) * blockAlign);
+    putU16(header + 32, static_cast<uint16_t>(blockAlign));
+    putU16(header + 34, static_cast<uint16_t>(m_bytesPerSample * 8));
+    std::memcpy(header + 36, "data", 4);
+    putU32(header + 40, dataBytes);
+
+    std::fwrite(header, 1, sizeof(header), m_file);
+}
+
+void WavWriter::flushRaw(size_t bytes) {
+    std::fwrite(m_raw.data(), 1, bytes, m_file);
+}
+
+void WavWriter::write(const float* const* channels, size_t frames) {
+    if (!m_file) {
+        return;
+    }
+
+    const size_t stride = static_cast<size_t>(m_bytesPerSample) * m_format.channels;
+    size_t done = 0;
+    while (done < frames) {
+        const size_t count = std::min(kChunkFrames, frames - done);
+        for (int ch = 0; ch < m_format.channels; ++ch) {
+            const float* src = channels[ch] ? channels[ch] + done : nullptr;
+            m_dither[ch].convert(src, 1, count, m_format.format,
+                                 m_raw.data() + ch * m_bytesPerSample, stride);
+        }
+        flushRaw(count * stride);
+        done += count;
+    }
+    m_framesWritten += frames;
+}
+
+void WavWriter::writeInterleaved(const float* source, size_t frames) {
+    if (!m_file) {
+        return;
+    }
+
+    size_t done = 0;
+    while (done < frames) {
+        const size_t count = std::min(kChunkFrames, frames - done);
+        const size_t channels = static_cast<size_t>(m_format.channels);
+        const size_t stride = static_cast<size_t>(m_bytesPerSample) * channels;
+        const float* src = source + done * channels;
+        for (size_t ch = 0; ch < channels; ++ch) {
+            m_dither[ch].convert(src + ch, channels, count, m_format.format,
+                                 m_raw.data() + ch * m_bytesPerSample, stride);
+        }
+        flushRaw(count * stride);
+        done += count;
+    }
+    m_framesWritten += frames;
+}
+
+} // namespace AudioEngine
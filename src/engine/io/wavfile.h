@@ -0,0 +1,102 @@
+#ifndef WAVFILE_H
+#define WAVFILE_H
+
+#include "../common/audioconfig.h"
+#include "../dsp/dither.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace AudioEngine {
+
+// Layout of a WAV file's sample data
+struct WavFormat {
+    int sampleRate = 48000;
+    int channels = 2;
+    SampleFormat format = SampleFormat::Float32;
+    DitherMode dither = DitherMode::None;       // Writing Int16/Int24; FileBackend uses StreamConfig::dither
+};
+
+// Streaming WAV reader
+// Handles PCM 16/24/32-bit, IEEE float and WAVE_FORMAT_EXTENSIBLE wrappers of
+// those. Samples come back as float in [-1, 1). Little-endian hosts only.
+class WavReader {
+public:
+    WavReader() = default;
+    ~WavReader();
+
+    // Throws AudioException if the file is missing or not a supported WAV
+    void open(const std::string& path);
+    void close();
+    bool isOpen() const { return m_file != nullptr; }
+
+    const WavFormat& format() const { return m_format; }
+    uint64_t frameCount() const { return m_frameCount; }
+    uint64_t position() const { return m_position; }
+    void seek(uint64_t frame);
+
+    // Planar read. Destination channels beyond the file's are zeroed, file
+    // channels beyond channelCount are skipped. Returns frames read (short
+    // at end of file; the remainder of each channel is zeroed).
+    size_t read(float* const* channels, int channelCount, size_t frames);
+
+    // Interleaved read in the file's own channel count
+    size_t readInterleaved(float* destination, size_t frames);
+
+private:
+    WavReader(const WavReader&) = delete;
+    WavReader& operator=(const WavReader&) = delete;
+
+    size_t readRaw(size_t frames);
+
+    std::FILE* m_file = nullptr;
+    WavFormat m_format;
+    uint64_t m_dataOffset = 0;
+    uint64_t m_frameCount = 0;
+    uint64_t m_position = 0;
+    int m_bytesPerSample = 4;
+    std::vector<unsigned char> m_raw;
+};
+
+// Streaming WAV writer
+// Header sizes are patched on close(), so an interrupted file still has a
+// valid header for everything flushed before the last close. Int16/Int24
+// samples are dithered as WavFormat::dither selects.
+class WavWriter {
+public:
+    WavWriter() = default;
+    ~WavWriter();
+
+    // Throws AudioException if the file cannot be created
+    void open(const std::string& path, const WavFormat& format);
+    void close();
+    bool isOpen() const { return m_file != nullptr; }
+
+    const WavFormat& format() const { return m_format; }
+    uint64_t framesWritten() const { return m_framesWritten; }
+
+    // Planar write of format().channels channels; null channels write silence
+    void write(const float* const* channels, size_t frames);
+
+    // Interleaved write in the file's channel count
+    void writeInterleaved(const float* source, size_t frames);
+
+private:
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+
+    void writeHeader();
+    void flushRaw(size_t bytes);
+
+    std::FILE* m_file = nullptr;
+    WavFormat m_format;
+    uint64_t m_framesWritten = 0;
+    int m_bytesPerSample = 4;
+    std::vector<unsigned char> m_raw;
+    std::vector<DitherConverter> m_dither;      // Per channel
+};
+
+} // namespace AudioEngine
+
+#endif // WAVFILE_H
@@ -0,0 +1,133 @@
+#include "deferredreclaimer.h"
+
+namespace AudioEngine {
+
+DeferredReclaimer::DeferredReclaimer(size_t audioQueueCapacity)
+    : m_audioRetired(audioQueueCapacity)
+{
+    m_pending.reserve(audioQueueCapacity);
+}
+
+DeferredReclaimer::~DeferredReclaimer() {
+    stopHousekeeping();
+
+    // The audio thread must be stopped by now, so everything is safe
+    Retired item;
+    while (m_audioRetired.pop(item)) {
+        item.deleter(item.object);
+    }
+    for (const Retired& pending : m_pending) {
+        pending.deleter(pending.object);
+    }
+}
+
+bool DeferredReclaimer::retireFromAudioThread(void* object, Deleter deleter) {
+    if (!object) {
+        return true;
+    }
+
+    Retired item;
+    item.object = object;
+    item.deleter = deleter;
+    item.epoch = m_epoch.load(std::memory_order_acquire);
+    return m_audioRetired.push(item);
+}
+
+void DeferredReclaimer::retire(void* object, Deleter deleter) {
+    if (!object) {
+        return;
+    }
+
+    // The object is already unlinked; whatever epoch we see now is one the
+    // audio thread can only have entered with the old pointer if it is odd.
+    // The fence keeps the caller's unlink store ahead of the epoch load
+    // (pairs with the fence in enterCallback()).
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    Retired item;
+    item.object = object;
+    item.deleter = deleter;
+    item.epoch = m_epoch.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_pending.push_back(item);
+}
+
+bool DeferredReclaimer::isSafeToFree(const Retired& item, uint64_t epochNow) const {
+    // Even epoch: the audio thread was outside a callback at retirement.
+    // Odd epoch: wait until that callback has exited.
+    return (item.epoch % 2 == 0) || epochNow > item.epoch;
+}
+
+size_t DeferredReclaimer::collect() {
+    std::vector<Retired> ready;
+
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+
+        Retired item;
+        while (m_audioRetired.pop(item)) {
+            m_pending.push_back(item);
+        }
+
+        const uint64_t epochNow = m_epoch.load(std::memory_order_seq_cst);
+        auto it = m_pending.begin();
+        while (it != m_pending.end()) {
+            if (isSafeToFree(*it, epochNow)) {
+                ready.push_back(*it);
+                it = m_pending.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Run destructors outside the lock
+    for (const Retired& item : ready) {
+        item.deleter(item.object);
+    }
+
+    return ready.size();
+}
+
+void DeferredReclaimer::startHousekeeping(std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(m_housekeeperMutex);
+    if (m_housekeeperRunning) {
+        return;
+    }
+
+    m_housekeeperRunning = true;
+    m_housekeeper = std::thread(&DeferredReclaimer::housekeepingLoop, this, interval);
+}
+
+void DeferredReclaimer::stopHousekeeping() {
+    {
+        std::lock_guard<std::mutex> lock(m_housekeeperMutex);
+        if (!m_housekeeperRunning) {
+            return;
+        }
+        m_housekeeperRunning = false;
+    }
+
+    m_housekeeperWake.notify_all();
+    if (m_housekeeper.joinable()) {
+        m_housekeeper.join();
+    }
+}
+
+size_t DeferredReclaimer::pendingCount() const {
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    return m_pending.size() + m_audioRetired.size();
+}
+
+void DeferredReclaimer::housekeepingLoop(std::chrono::milliseconds interval) {
+    std::unique_lock<std::mutex> lock(m_housekeeperMutex);
+    while (m_housekeeperRunning) {
+        m_housekeeperWake.wait_for(lock, interval);
+
+        lock.unlock();
+        collect();
+        lock.lock();
+    }
+}
+
+} // namespace AudioEngine
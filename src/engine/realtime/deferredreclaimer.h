@@ -0,0 +1,123 @@
+#ifndef DEFERREDRECLAIMER_H
+#define DEFERREDRECLAIMER_H
+
+#include "spscqueue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace AudioEngine {
+
+// Epoch-based deferred reclamation for objects shared with the audio thread
+//
+// The audio thread brackets every callback with enterCallback()/exitCallback(),
+// which bumps an epoch counter (odd = inside a callback). Objects unlinked from
+// live structures are retired instead of deleted; a housekeeping thread frees
+// them once the audio thread has passed a quiescent point after the retirement.
+// The audio thread itself never runs a destructor.
+//
+// Ordering contract: unlinking is a store to the shared pointer followed by
+// retire(), which reads the epoch; entering a callback writes the epoch and
+// then reads the pointer. Each side is a store followed by a load of a
+// different variable, so both sides put a seq_cst fence in between: either
+// retire() sees the odd epoch, or the callback sees the new pointer. Callers
+// only need to unlink (with any atomic store) before calling retire().
+class DeferredReclaimer {
+public:
+    using Deleter = void (*)(void*);
+
+    explicit DeferredReclaimer(size_t audioQueueCapacity = 4096);
+    ~DeferredReclaimer();
+
+    // ===== Audio Thread =====
+
+    void enterCallback() {
+        m_epoch.fetch_add(1, std::memory_order_acq_rel);
+        std::atomic_thread_fence(std::memory_order_seq_cst);    // Pairs with retire()
+    }
+    void exitCallback() { m_epoch.fetch_add(1, std::memory_order_acq_rel); }
+
+    // RAII bracket for one callback
+    class CallbackScope {
+    public:
+        explicit CallbackScope(DeferredReclaimer& reclaimer) : m_reclaimer(reclaimer) {
+            m_reclaimer.enterCallback();
+        }
+        ~CallbackScope() { m_reclaimer.exitCallback(); }
+
+    private:
+        DeferredReclaimer& m_reclaimer;
+    };
+
+    // Retire an object the audio thread has just unlinked. Lock-free and
+    // allocation-free; returns false if the queue is full, in which case the
+    // caller still owns the object and should retry next period.
+    template <typename T>
+    bool retireFromAudioThread(T* object) {
+        return retireFromAudioThread(object, &deleteObject<T>);
+    }
+    bool retireFromAudioThread(void* object, Deleter deleter);
+
+    // ===== Control Threads =====
+
+    // Retire an object the audio thread may still be reading
+    template <typename T>
+    void retire(T* object) {
+        retire(object, &deleteObject<T>);
+    }
+    template <typename T>
+    void retire(std::unique_ptr<T> object) {
+        retire(object.release(), &deleteObject<T>);
+    }
+    void retire(void* object, Deleter deleter);
+
+    // Free everything that is safe to free; returns the number reclaimed
+    size_t collect();
+
+    // Background thread calling collect() periodically
+    void startHousekeeping(std::chrono::milliseconds interval = std::chrono::milliseconds(20));
+    void stopHousekeeping();
+
+    // Objects retired but not yet freed
+    size_t pendingCount() const;
+
+    uint64_t currentEpoch() const { return m_epoch.load(std::memory_order_acquire); }
+
+private:
+    DeferredReclaimer(const DeferredReclaimer&) = delete;
+    DeferredReclaimer& operator=(const DeferredReclaimer&) = delete;
+
+    struct Retired {
+        void* object = nullptr;
+        Deleter deleter = nullptr;
+        uint64_t epoch = 0;   // Epoch observed when the object was retired
+    };
+
+    template <typename T>
+    static void deleteObject(void* object) {
+        delete static_cast<T*>(object);
+    }
+
+    bool isSafeToFree(const Retired& item, uint64_t epochNow) const;
+    void housekeepingLoop(std::chrono::milliseconds interval);
+
+    std::atomic<uint64_t> m_epoch{0};
+    SpscQueue<Retired> m_audioRetired;
+
+    mutable std::mutex m_pendingMutex;
+    std::vector<Retired> m_pending;
+
+    std::thread m_housekeeper;
+    std::mutex m_housekeeperMutex;
+    std::condition_variable m_housekeeperWake;
+    bool m_housekeeperRunning = false;
+};
+
+} // namespace AudioEngine
+
+#endif // DEFERREDRECLAIMER_H
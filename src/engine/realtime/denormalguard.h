@@ -0,0 +1,78 @@
+#ifndef DENORMALGUARD_H
+#define DENORMALGUARD_H
+
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define CADENCE_DENORMALS_SSE 1
+#elif defined(__aarch64__) || defined(__arm__)
+#define CADENCE_DENORMALS_ARM 1
+#endif
+
+namespace AudioEngine {
+
+// Flushes denormals to zero for the lifetime of the guard and restores the
+// previous floating-point mode on exit. Engine threads (audio callback and
+// workers) hold one for their whole processing scope, so decaying filter and
+// reverb tails never hit the slow denormal path regardless of the callback.
+class ScopedDenormalGuard {
+public:
+    ScopedDenormalGuard() : m_previous(readMode()) {
+        writeMode(m_previous | flushMask());
+    }
+
+    ~ScopedDenormalGuard() {
+        writeMode(m_previous);
+    }
+
+    // True when the calling thread currently flushes denormals
+    static bool isActive() {
+        return flushMask() != 0 && (readMode() & flushMask()) == flushMask();
+    }
+
+private:
+    ScopedDenormalGuard(const ScopedDenormalGuard&) = delete;
+    ScopedDenormalGuard& operator=(const ScopedDenormalGuard&) = delete;
+
+#if defined(CADENCE_DENORMALS_SSE)
+    // MXCSR: FTZ (bit 15) and DAZ (bit 6)
+    static uintptr_t flushMask() { return 0x8040; }
+    static uintptr_t readMode() { return _mm_getcsr(); }
+    static void writeMode(uintptr_t mode) { _mm_setcsr(static_cast<unsigned int>(mode)); }
+#elif defined(CADENCE_DENORMALS_ARM) && defined(__aarch64__)
+    // FPCR: FZ (bit 24)
+    static uintptr_t flushMask() { return uintptr_t(1) << 24; }
+    static uintptr_t readMode() {
+        uint64_t fpcr;
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+        return static_cast<uintptr_t>(fpcr);
+    }
+    static void writeMode(uintptr_t mode) {
+        uint64_t fpcr = mode;
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+    }
+#elif defined(CADENCE_DENORMALS_ARM)
+    // FPSCR: FZ (bit 24)
+    static uintptr_t flushMask() { return uintptr_t(1) << 24; }
+    static uintptr_t readMode() {
+        uint32_t fpscr;
+        __asm__ __volatile__("vmrs %0, fpscr" : "=r"(fpscr));
+        return fpscr;
+    }
+    static void writeMode(uintptr_t mode) {
+        uint32_t fpscr = static_cast<uint32_t>(mode);
+        __asm__ __volatile__("vmsr fpscr, %0" : : "r"(fpscr));
+    }
+#else
+    static uintptr_t flushMask() { return 0; }
+    static uintptr_t readMode() { return 0; }
+    static void writeMode(uintptr_t) {}
+#endif
+
+    uintptr_t m_previous;
+};
+
+} // namespace AudioEngine
+
+#endif // DENORMALGUARD_H
@@ -0,0 +1,155 @@
+#include "realtimethread.h"
+#include <algorithm>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <alloca.h>
+#endif
+
+namespace AudioEngine {
+
+bool RealtimeThread::lockProcessMemory() {
+#if defined(__unix__) || defined(__APPLE__)
+    return mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+#else
+    return false;
+#endif
+}
+
+void RealtimeThread::prefaultStack(size_t bytes) {
+#if defined(__unix__) || defined(__APPLE__)
+    // alloca keeps this allocation-free; volatile stops the writes being elided
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    volatile unsigned char* stack = static_cast<volatile unsigned char*>(alloca(bytes));
+    for (size_t i = 0; i < bytes; i += pageSize) {
+        stack[i] = 0;
+    }
+#else
+    (void)bytes;
+#endif
+}
+
+bool RealtimeThread::pinCurrentThread(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return false;
+    }
+
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+bool RealtimeThread::promoteCurrentThread(int priority) {
+#if defined(__unix__) || defined(__APPLE__)
+    sched_param param{};
+    param.sched_priority = std::clamp(priority,
+                                      sched_get_priority_min(SCHED_FIFO),
+                                      sched_get_priority_max(SCHED_FIFO));
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#else
+    (void)priority;
+    return false;
+#endif
+}
+
+RealtimeStatus RealtimeThread::queryCurrentThread() {
+    RealtimeStatus status;
+
+#if defined(__unix__) || defined(__APPLE__)
+    int policy = 0;
+    sched_param param{};
+    if (pthread_getschedparam(pthread_self(), &policy, &param) == 0) {
+        status.schedulingPolicy = policy;
+        status.priority = param.sched_priority;
+        status.isRealtime = (policy == SCHED_FIFO || policy == SCHED_RR);
+    }
+#endif
+
+#if defined(__linux__)
+    rlimit limit{};
+    if (getrlimit(RLIMIT_RTPRIO, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+        status.maxPermittedPriority = static_cast<int>(limit.rlim_cur);
+    }
+#endif
+
+    return status;
+}
+
+RealtimeStatus RealtimeThread::setupAudioThread(const StreamConfig& config) {
+    if (config.lockMemory) {
+        prefaultStack();
+    }
+    bool pinned = pinCurrentThread(config.audioThreadCpus);
+
+    // RtAudio only logs when its own promotion fails, so check what we got
+    RealtimeStatus status = queryCurrentThread();
+    if (!status.isRealtime && config.realtimePriority > 0) {
+        promoteCurrentThread(config.realtimePriority);
+        status = queryCurrentThread();
+    }
+
+    status.configured = true;
+    status.stackPrefaulted = config.lockMemory;
+    status.affinityApplied = pinned;
+    return status;
+}
+
+RealtimeStatus RealtimeThread::setupWorkerThread(const StreamConfig& config) {
+    if (config.lockMemory) {
+        prefaultStack();
+    }
+    bool pinned = pinCurrentThread(config.workerThreadCpus);
+
+    if (config.realtimePriority > 0) {
+        promoteCurrentThread(std::max(1, config.realtimePriority - 10));
+    }
+
+    RealtimeStatus status = queryCurrentThread();
+    status.configured = true;
+    status.stackPrefaulted = config.lockMemory;
+    status.affinityApplied = pinned;
+    return status;
+}
+
+std::string RealtimeThread::describe(const RealtimeStatus& status, int requestedPriority) {
+    std::stringstream ss;
+
+    if (!status.configured) {
+        ss << "Audio thread did not report its scheduling state";
+        return ss.str();
+    }
+
+    if (status.isRealtime) {
+        ss << "Audio thread running real-time at priority " << status.priority;
+    } else {
+        ss << "Audio thread running under SCHED_OTHER (requested SCHED_FIFO priority "
+           << requestedPriority;
+        if (status.maxPermittedPriority >= 0) {
+            ss << ", RLIMIT_RTPRIO is " << status.maxPermittedPriority;
+        }
+        ss << "). Grant real-time scheduling via rtkit or an rtprio entry in "
+           << "/etc/security/limits.d";
+    }
+
+    if (!status.memoryLocked) {
+        ss << "; memory not locked (check RLIMIT_MEMLOCK)";
+    }
+
+    return ss.str();
+}
+
+} // namespace AudioEngine
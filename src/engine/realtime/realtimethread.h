@@ -0,0 +1,50 @@
+#ifndef REALTIMETHREAD_H
+#define REALTIMETHREAD_H
+
+#include "../common/audioconfig.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace AudioEngine {
+
+// Real-time thread setup helpers
+// Process-wide calls (lockProcessMemory) belong on a control thread before the
+// stream opens; the per-thread calls run on the thread being configured and do
+// not allocate, so they are safe from inside the first audio callback.
+class RealtimeThread {
+public:
+    static constexpr size_t kDefaultStackPrefaultBytes = 256 * 1024;
+
+    // Lock current and future pages into RAM (mlockall)
+    static bool lockProcessMemory();
+
+    // Touch the top of the calling thread's stack so it never page-faults later
+    static void prefaultStack(size_t bytes = kDefaultStackPrefaultBytes);
+
+    // Pin the calling thread to the given cores (empty = leave unchanged)
+    static bool pinCurrentThread(const std::vector<int>& cpus);
+
+    // Request SCHED_FIFO at the given priority for the calling thread
+    static bool promoteCurrentThread(int priority);
+
+    // Read back the policy and priority actually in effect for the calling thread
+    static RealtimeStatus queryCurrentThread();
+
+    // Full setup for the audio callback thread. Verifies the policy granted
+    // by the backend (RtAudio, rtkit or RLIMIT_RTPRIO) and promotes the thread
+    // itself when it was silently left on SCHED_OTHER.
+    static RealtimeStatus setupAudioThread(const StreamConfig& config);
+
+    // Setup for engine worker threads: pinned to workerThreadCpus, running
+    // just below the audio thread so they never preempt it. Workers also hold
+    // a ScopedDenormalGuard for the body of their loop.
+    static RealtimeStatus setupWorkerThread(const StreamConfig& config);
+
+    // Human-readable explanation of a status, used for error reporting
+    static std::string describe(const RealtimeStatus& status, int requestedPriority);
+};
+
+} // namespace AudioEngine
+
+#endif // REALTIMETHREAD_H
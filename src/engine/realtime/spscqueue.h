@@ -0,0 +1,98 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace AudioEngine {
+
+// Bounded lock-free single-producer/single-consumer queue
+// Storage is allocated once in the constructor; push/pop never allocate or
+// block, so either end may be the audio thread.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity)
+        : m_buffer(roundUpToPowerOfTwo(capacity + 1))
+        , m_mask(m_buffer.size() - 1)
+    {}
+
+    // Producer side
+    bool push(const T& item) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t next = (head + 1) & m_mask;
+        if (next == m_tail.load(std::memory_order_acquire)) {
+            return false; // Full
+        }
+        m_buffer[head] = item;
+        m_head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Push as many of count items as fit; returns the number pushed
+    size_t push(const T* items, size_t count) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t space = (tail - head - 1) & m_mask;
+        const size_t n = count < space ? count : space;
+        for (size_t i = 0; i < n; ++i) {
+            m_buffer[(head + i) & m_mask] = items[i];
+        }
+        m_head.store((head + n) & m_mask, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side
+    bool pop(T& item) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return false; // Empty
+        }
+        item = m_buffer[tail];
+        m_tail.store((tail + 1) & m_mask, std::memory_order_release);
+        return true;
+    }
+
+    // Pop up to count items; returns the number popped
+    size_t pop(T* items, size_t count) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        const size_t available = (head - tail) & m_mask;
+        const size_t n = count < available ? count : available;
+        for (size_t i = 0; i < n; ++i) {
+            items[i] = m_buffer[(tail + i) & m_mask];
+        }
+        m_tail.store((tail + n) & m_mask, std::memory_order_release);
+        return n;
+    }
+
+    // Approximate when called concurrently with the other side
+    size_t size() const {
+        return (m_head.load(std::memory_order_acquire) -
+                m_tail.load(std::memory_order_acquire)) & m_mask;
+    }
+
+    size_t capacity() const { return m_mask; }
+    bool empty() const { return size() == 0; }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    std::vector<T> m_buffer;
+    size_t m_mask;
+
+    // Separate cache lines so producer and consumer don't false-share
+    alignas(64) std::atomic<size_t> m_head{0};  // Next slot to write
+    alignas(64) std::atomic<size_t> m_tail{0};  // Next slot to read
+};
+
+} // namespace AudioEngine
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,67 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace AudioEngine {
+
+// Lock-free single-writer/single-reader triple buffer
+// The writer fills writeBuffer() and publishes it whole; the reader always sees
+// the most recent complete value and never a torn one. Neither side blocks or
+// waits, and a slow reader simply skips intermediate values.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+
+    // ===== Writer =====
+
+    T& writeBuffer() { return m_buffers[m_writeIndex]; }
+
+    // Make the write buffer visible to the reader and take a fresh one
+    void publish() {
+        const uint8_t previous = m_middle.exchange(
+            static_cast<uint8_t>(m_writeIndex | kDirtyBit), std::memory_order_acq_rel);
+        m_writeIndex = previous & kIndexMask;
+    }
+
+    // ===== Reader =====
+
+    // Pick up the latest published value; returns false if nothing new
+    bool update() {
+        if ((m_middle.load(std::memory_order_relaxed) & kDirtyBit) == 0) {
+            return false;
+        }
+        const uint8_t previous = m_middle.exchange(m_readIndex, std::memory_order_acq_rel);
+        m_readIndex = previous & kIndexMask;
+        return true;
+    }
+
+    const T& readBuffer() const { return m_buffers[m_readIndex]; }
+
+    const T& read() {
+        update();
+        return readBuffer();
+    }
+
+private:
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kDirtyBit = 0x4;
+
+    T m_buffers[3] {};
+
+    // Index of the buffer in the middle, plus a flag for "newer than reader's"
+    alignas(64) std::atomic<uint8_t> m_middle{2};
+
+    // Owned by one side each
+    alignas(64) uint8_t m_writeIndex = 0;
+    alignas(64) uint8_t m_readIndex = 1;
+};
+
+} // namespace AudioEngine
+
+#endif // TRIPLEBUFFER_H
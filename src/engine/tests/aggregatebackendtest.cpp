@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../backends/aggregate/aggregatebackend.h"
+#include "../backends/file/filebackend.h"
+#include "../io/wavfile.h"
+#include "testsupport.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace AudioEngine;
+
+namespace {
+
+// Mono 441 Hz sine recorded at 44.1 kHz: 100 frames per cycle at its own rate
+std::string writeInput(size_t frames) {
+    const std::string path = TestSupport::tempPath("aggregate_input");
+    std::vector<float> samples(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        samples[i] = 0.5f * static_cast<float>(std::sin(2.0 * M_PI * static_cast<double>(i) / 100.0));
+    }
+    WavWriter writer;
+    writer.open(path, WavFormat{44100, 1, SampleFormat::Float32});
+    const float* channels[] = {samples.data()};
+    writer.write(channels, frames);
+    writer.close();
+    return path;
+}
+
+}
+
+TEST_CASE("Aggregate runs on the output master and rate-matches the follower's input", "[Aggregate]") {
+    const std::string input = writeInput(44100);
+
+    // Both sides paced by wall time like hardware; the follower adopts its file's 44.1 kHz
+    auto master = std::make_unique<FileBackend>();
+    auto follower = std::make_unique<FileBackend>();
+    follower->setLoopInput(true);
+    AggregateBackend aggregate(std::move(master), std::move(follower));
+
+    StreamConfig config;
+    config.inputDeviceName = input;
+    config.sampleRate = 48000;
+    config.bufferSize = 256;
+    config.inputChannels = 1;
+    config.outputChannels = 2;
+    config.allowSampleRateChange = true;
+    config.realtimePriority = 0;
+    config.lockMemory = false;
+    aggregate.initialize(config);
+
+    // Audio thread writes, test thread reads after stop()
+    std::vector<float> captured(48000, 0.0f);
+    std::vector<double> times(400, -1.0);
+    std::atomic<size_t> capturedFrames{0};
+    std::atomic<int> callbacks{0};
+    std::atomic<int> wrongPeriods{0};
+    aggregate.startPlanar([&](const float* const* inputs, float* const* outputs, size_t frames, double streamTime) {
+        if (frames != 256) {
+            wrongPeriods++;
+        }
+        const int call = callbacks++;
+        if (call < static_cast<int>(times.size())) {
+            times[static_cast<size_t>(call)] = streamTime;
+        }
+        const size_t at = capturedFrames.load();
+        for (size_t i = 0; i < frames && at + i < captured.size(); ++i) {
+            captured[at + i] = inputs[0][i];
+        }
+        capturedFrames = std::min(captured.size(), at + frames);
+        for (int ch = 0; ch < 2; ++ch) {
+            std::fill(outputs[ch], outputs[ch] + frames, 0.0f);
+        }
+    });
+    REQUIRE(aggregate.isRunning());
+    REQUIRE(aggregate.getInputBackend().getActualSampleRate() == 44100);
+    REQUIRE(aggregate.getActualSampleRate() == 48000);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (capturedFrames.load() < captured.size() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    aggregate.stop();
+    REQUIRE_FALSE(aggregate.isRunning());
+    REQUIRE(capturedFrames.load() == captured.size());
+
+    // The user callback is the master's: its period and its clock, 256 frames at 48 kHz
+    REQUIRE(wrongPeriods.load() == 0);
+    for (size_t i = 1; i < times.size() && times[i] >= 0.0; ++i) {
+        REQUIRE(std::abs(times[i] - times[i - 1] - 256.0 / 48000.0) < 1e-9);
+    }
+
+    // Once primed, the input arrives at the master's rate: 441 Hz is 108.8
+    // frames per cycle at 48 kHz (unconverted it would be 100, i.e. 480 Hz)
+    int crossings = 0;
+    size_t first = 0, last = 0;
+    for (size_t i = captured.size() / 2; i < captured.size(); ++i) {
+        if (captured[i - 1] < 0.0f && captured[i] >= 0.0f) {
+            first = crossings == 0 ? i : first;
+            last = i;
+            ++crossings;
+        }
+    }
+    REQUIRE(crossings > 100);
+    const double framesPerCycle = static_cast<double>(last - first) / (crossings - 1);
+    INFO("frames per cycle " << framesPerCycle);
+    REQUIRE(std::abs(framesPerCycle - 48000.0 / 441.0) < 0.5);
+
+    std::remove(input.c_str());
+}
+
+TEST_CASE("The factory aggregates when inputs come from another backend", "[Aggregate]") {
+    StreamConfig config;
+    config.preferredBackend = BackendType::File;
+
+    // Same backend on both sides: nothing to aggregate
+    config.inputBackend = BackendType::File;
+    auto single = AudioBackendFactory::createBackend(config);
+    REQUIRE(dynamic_cast<FileBackend*>(single.get()) != nullptr);
+
+#if defined(__linux__)
+    config.inputBackend = BackendType::ALSA;
+    auto backend = AudioBackendFactory::createBackend(config);
+    auto* aggregate = dynamic_cast<AggregateBackend*>(backend.get());
+    REQUIRE(aggregate != nullptr);
+    REQUIRE(dynamic_cast<FileBackend*>(&aggregate->getOutputBackend()) != nullptr);
+#endif
+}
@@ -4,49 +4,61 @@
 #include "../common/audiobackend.h"
 #include "../common/audiodevice.h"
 #include "../common/audioerror.h"
+#include "../instruments/synth.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <thread>
 #include <atomic>
+#include <memory>
+#include <vector>
 using namespace AudioEngine;
-// Test callback that generates a sine wave
-class TestSineCallback {
+// Test callback that plays a held chord on the built-in synth: a real DSP
+// load on the audio thread rather than a lone oscillator
+class TestSynthCallback {
 public:
-    TestSineCallback(double frequency = 440.0, double amplitude = 0.5)
-        : m_frequency(frequency), m_amplitude(amplitude), m_phase(0.0) {}
+    TestSynthCallback(int voices = 16)
+        : m_voices(voices), m_synth(std::make_unique<Synth>(48000.0, voices)) {
+        setSampleRate(48000.0);
+    }
 
     void operator()(const float* input, float* output, size_t frames, double streamTime) {
-        double phaseIncrement = 2.0 * M_PI * m_frequency / m_sampleRate;
-
-        for (size_t i = 0; i < frames; ++i) {
-            float sample = static_cast<float>(m_amplitude * sin(m_phase));
-
-            // Fill all channels with same sine wave
-            for (int ch = 0; ch < m_channels; ++ch) {
-                output[i * m_channels + ch] = sample;
-            }
-
-            m_phase += phaseIncrement;
-            if (m_phase >= 2.0 * M_PI) {
-                m_phase -= 2.0 * M_PI;
+        // Render in scratch-sized chunks and interleave the stereo pair
+        // into every channel pair
+        for (size_t done = 0; done < frames;) {
+            const size_t n = std::min(kScratchFrames, frames - done);
+            m_synth->process(m_left.data(), m_right.data(), n);
+            for (size_t i = 0; i < n; ++i) {
+                float* frame = output + (done + i) * m_channels;
+                for (int ch = 0; ch < m_channels; ++ch) {
+                    frame[ch] = (ch % 2 == 0) ? m_left[i] : m_right[i];
+                }
             }
+            done += n;
         }
 
         m_callbackCount++;
         m_totalFrames += frames;
     }
 
-    void setSampleRate(double sampleRate) { m_sampleRate = sampleRate; }
+    void setSampleRate(double sampleRate) {
+        m_synth = std::make_unique<Synth>(sampleRate, m_voices);
+        for (int i = 0; i < m_voices; ++i) {
+            m_synth->noteOn(36 + (i * 7) % 48, 100);
+        }
+    }
     void setChannels(int channels) { m_channels = channels; }
 
     int getCallbackCount() const { return m_callbackCount; }
     size_t getTotalFrames() const { return m_totalFrames; }
 
 private:
-    double m_frequency;
-    double m_amplitude;
-    double m_phase;
-    double m_sampleRate = 48000.0;
+    static constexpr size_t kScratchFrames = 1024;
+
+    int m_voices;
+    std::unique_ptr<Synth> m_synth;
+    std::vector<float> m_left = std::vector<float>(kScratchFrames);
+    std::vector<float> m_right = std::vector<float>(kScratchFrames);
     int m_channels = 2;
     std::atomic<int> m_callbackCount{0};
     std::atomic<size_t> m_totalFrames{0};
@@ -110,13 +122,13 @@ TEST_CASE("AudioBackend basic operations", "[AudioBackend]") {
     SECTION("Start and stop stream") {
         backend->initialize(config);
 
-        TestSineCallback sineCallback;
-        sineCallback.setSampleRate(config.sampleRate);
-        sineCallback.setChannels(config.outputChannels);
+        TestSynthCallback synthCallback;
+        synthCallback.setSampleRate(config.sampleRate);
+        synthCallback.setChannels(config.outputChannels);
 
         // Start the stream
         backend->start([&](const float* input, float* output, size_t frames, double time) {
-            sineCallback(input, output, frames, time);
+            synthCallback(input, output, frames, time);
         });
 
         REQUIRE(backend->isRunning() == true);
@@ -128,7 +140,7 @@ TEST_CASE("AudioBackend basic operations", "[AudioBackend]") {
         backend->stop();
 
         REQUIRE(backend->isRunning() == false);
-        REQUIRE(sineCallback.getCallbackCount() > 0);
+        REQUIRE(synthCallback.getCallbackCount() > 0);
     }
 
     SECTION("Pause and resume") {
@@ -0,0 +1,206 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../backends/buffercontroller.h"
+#include "../backends/periodtuner.h"
+#include "../backends/file/filebackend.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace AudioEngine;
+
+namespace {
+
+DeviceCapabilities probedSizes(std::vector<int> sizes) {
+    DeviceCapabilities caps{};
+    caps.supportedBufferSizes = std::move(sizes);
+    return caps;
+}
+
+// Feeds the controller one snapshot every 100 ms
+struct Feed {
+    explicit Feed(BufferController& c) : controller(c) {}
+
+    BufferController& controller;
+    EngineSnapshot snapshot;
+    double time = 0.0;
+
+    int run(double seconds, double load, int xrunEvery = 0) {
+        int size = controller.getCurrentSize();
+        for (int tick = 0; time < seconds; ++tick) {
+            time += 0.1;
+            snapshot.sequence += 100;
+            snapshot.dspLoad = load;
+            if (xrunEvery > 0 && tick % xrunEvery == 0) {
+                ++snapshot.xruns;
+            }
+            size = controller.evaluate(snapshot, time);
+            if (size != controller.getCurrentSize()) {
+                // Applying a new size restarts the stream
+                controller.setCurrentSize(size, time);
+                snapshot = EngineSnapshot{};
+            }
+        }
+        return size;
+    }
+};
+
+}
+
+TEST_CASE("BufferController resolves strategies", "[BufferController]") {
+    const DeviceCapabilities caps = probedSizes({512, 64, 128, 256, 8, 1024});
+
+    StreamConfig requested;
+    requested.bufferSize = 256;
+    requested.periodCount = 2;
+
+    REQUIRE(BufferController::candidateSizes(caps) == std::vector<int>{64, 128, 256, 512, 1024});
+
+    requested.bufferStrategy = BufferStrategy::Fixed;
+    REQUIRE(BufferController::resolve(requested, caps).bufferSize == 256);
+
+    requested.bufferStrategy = BufferStrategy::LowLatency;
+    StreamConfig resolved = BufferController::resolve(requested, caps);
+    REQUIRE(resolved.bufferSize == 64);
+    REQUIRE(resolved.periodCount == 2);
+
+    requested.bufferStrategy = BufferStrategy::Adaptive;
+    resolved = BufferController::resolve(requested, caps);
+    REQUIRE(resolved.bufferSize == 64);
+    REQUIRE(resolved.allowBufferSizeChange);
+
+    requested.bufferStrategy = BufferStrategy::Stable;
+    resolved = BufferController::resolve(requested, caps);
+    REQUIRE(resolved.bufferSize == 512);
+    REQUIRE(resolved.periodCount == 3);
+    REQUIRE(resolved.isValid());
+
+    // Nothing probed: powers of two
+    REQUIRE(BufferController::candidateSizes(DeviceCapabilities{}).front() == 16);
+}
+
+TEST_CASE("BufferController adapts to xruns and load", "[BufferController]") {
+    BufferController controller;
+    controller.configure(BufferStrategy::Adaptive, {64, 128, 256, 512}, 64, 0.0);
+    Feed feed{controller};
+
+    SECTION("Steps up on xruns until they stop") {
+        REQUIRE(feed.run(5.0, 20.0, 5) > 64);
+        REQUIRE(controller.getCurrentSize() > 64);
+    }
+
+    SECTION("Steps up on sustained load") {
+        feed.run(10.0, 90.0);
+        REQUIRE(controller.getCurrentSize() == 512);
+    }
+
+    SECTION("Ignores xruns while a new period settles") {
+        feed.snapshot.xruns = 3;
+        feed.run(1.0, 20.0);
+        REQUIRE(controller.getCurrentSize() == 64);
+    }
+
+    SECTION("Steps down after a stable stretch, backing off when that fails") {
+        controller.configure(BufferStrategy::Adaptive, {64, 128, 256, 512}, 256, 0.0);
+        const double stable = controller.getThresholds().stableSecondsToStepDown;
+
+        feed.run(stable + 5.0, 20.0);
+        REQUIRE(controller.getCurrentSize() == 128);
+
+        // The smaller period xruns: back up, and wait longer next time
+        feed.run(feed.time + 1.5, 20.0, 10);
+        REQUIRE(controller.getCurrentSize() == 256);
+        REQUIRE(controller.getStableSecondsRequired() == 2.0 * stable);
+    }
+}
+
+TEST_CASE("BufferController resizes a running stream under load", "[BufferController]") {
+    FileBackend backend;
+    StreamConfig requested;
+    requested.sampleRate = 48000;
+    requested.bufferSize = 256;
+    requested.inputChannels = 0;
+    requested.outputChannels = 2;
+    requested.realtimePriority = 0;
+    requested.lockMemory = false;
+    requested.bufferStrategy = BufferStrategy::Adaptive;
+
+    BufferController controller;
+    BufferController::Thresholds thresholds;
+    thresholds.settleSeconds = 0.05;
+    thresholds.loadTimeConstant = 0.05;
+    controller.setThresholds(thresholds);
+    controller.initialize(backend, requested);
+    const int initial = controller.getCurrentSize();
+    REQUIRE(backend.getActualBufferSize() == initial);
+
+    // Spend ~90% of every period, whatever its size
+    backend.startPlanar([](const float* const*, float* const* outputs, size_t frames, double) {
+        const auto busy = std::chrono::duration<double>(0.9 * frames / 48000.0);
+        const auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < busy) {
+        }
+        for (int ch = 0; ch < 2; ++ch) {
+            std::fill(outputs[ch], outputs[ch] + frames, 0.0f);
+        }
+    });
+
+    int changes = 0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (controller.getCurrentSize() < 4 * initial && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        if (controller.poll(backend)) {
+            ++changes;
+            REQUIRE(backend.isRunning());
+        }
+    }
+    backend.stop();
+
+    REQUIRE(changes >= 2);
+    REQUIRE(controller.getCurrentSize() >= 4 * initial);
+    REQUIRE(backend.getActualBufferSize() == controller.getCurrentSize());
+}
+
+TEST_CASE("BufferController leaves other strategies alone", "[BufferController]") {
+    BufferController controller;
+    controller.configure(BufferStrategy::Stable, {64, 128, 256}, 128, 0.0);
+    Feed feed{controller};
+
+    REQUIRE(feed.run(60.0, 95.0, 3) == 128);
+}
+
+TEST_CASE("PeriodTuner picks the lowest latency layout without xruns", "[PeriodTuner]") {
+    FileBackend backend;
+    backend.setClock(FileClock::RealTime);
+
+    // Wake-ups 8 ms late: more than one 256-frame period, well under two
+    JitterProfile jitter;
+    jitter.spikeProbability = 0.2;
+    jitter.spikeMs = 8.0;
+    backend.setJitterProfile(jitter);
+
+    StreamConfig base;
+    base.inputChannels = 0;
+    base.outputChannels = 2;
+
+    PeriodTuner::Options options;
+    options.bufferSizes = {256, 512};
+    options.periodCounts = {2, 3, 4};
+    options.warmupSeconds = 0.05;
+    options.stressSeconds = 0.5;
+    options.stressLoad = 10.0;
+
+    const auto layouts = PeriodTuner::candidates(base, options.bufferSizes, options);
+    REQUIRE(layouts.size() == 6);
+    REQUIRE(layouts[0].bufferSize == 256);
+    REQUIRE(layouts[0].periodCount == 2);
+    REQUIRE(layouts[1].periodCount == 3);  // 3 x 256 beats 2 x 512
+
+    PeriodTuner::Result result = PeriodTuner::tune(backend, base, options);
+    REQUIRE_FALSE(backend.isRunning());
+    REQUIRE(result.found);
+    REQUIRE(result.trials.front().started);
+    REQUIRE(result.trials.front().xruns > 0);
+    REQUIRE(result.config.bufferSize * result.config.periodCount > 256 * 2);
+    REQUIRE(result.config.isValid());
+}
@@ -0,0 +1,119 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../realtime/deferredreclaimer.h"
+#include <atomic>
+#include <thread>
+
+using namespace AudioEngine;
+
+namespace {
+
+std::atomic<int> g_liveNodes{0};
+
+// Stand-in for a graph node whose destructor must not run on the audio thread
+struct TestNode {
+    TestNode() { g_liveNodes++; }
+    ~TestNode() { g_liveNodes--; }
+    float gain = 1.0f;
+};
+
+}
+
+TEST_CASE("DeferredReclaimer waits for the audio thread", "[Reclaimer]") {
+    g_liveNodes = 0;
+    DeferredReclaimer reclaimer(16);
+
+    SECTION("Audio thread retirement is freed after the callback exits") {
+        reclaimer.enterCallback();
+        REQUIRE(reclaimer.retireFromAudioThread(new TestNode));
+
+        REQUIRE(reclaimer.collect() == 0);
+        REQUIRE(g_liveNodes == 1);
+
+        reclaimer.exitCallback();
+        REQUIRE(reclaimer.collect() == 1);
+        REQUIRE(g_liveNodes == 0);
+    }
+
+    SECTION("Control thread retirement during a callback") {
+        reclaimer.enterCallback();
+        reclaimer.retire(std::make_unique<TestNode>());
+
+        REQUIRE(reclaimer.collect() == 0);
+        REQUIRE(reclaimer.pendingCount() == 1);
+
+        reclaimer.exitCallback();
+        REQUIRE(reclaimer.collect() == 1);
+        REQUIRE(g_liveNodes == 0);
+    }
+
+    SECTION("Control thread retirement while idle is freed immediately") {
+        reclaimer.retire(new TestNode);
+        REQUIRE(reclaimer.collect() == 1);
+        REQUIRE(g_liveNodes == 0);
+    }
+
+    SECTION("Full audio queue hands ownership back") {
+        reclaimer.enterCallback();
+        TestNode* overflow = nullptr;
+        for (int i = 0; i < 64 && !overflow; ++i) {
+            auto* node = new TestNode;
+            if (!reclaimer.retireFromAudioThread(node)) {
+                overflow = node;
+            }
+        }
+        reclaimer.exitCallback();
+
+        REQUIRE(overflow != nullptr);
+        delete overflow;
+        reclaimer.collect();
+        REQUIRE(g_liveNodes == 0);
+    }
+}
+
+TEST_CASE("DeferredReclaimer under live edits", "[Reclaimer]") {
+    g_liveNodes = 0;
+
+    {
+        DeferredReclaimer reclaimer;
+        std::atomic<TestNode*> current{new TestNode};
+        std::atomic<bool> running{true};
+        std::atomic<int> callbacks{0};
+
+        reclaimer.startHousekeeping(std::chrono::milliseconds(1));
+
+        // Simulated audio thread reading the live node every period
+        std::thread audio([&] {
+            while (running) {
+                DeferredReclaimer::CallbackScope scope(reclaimer);
+                TestNode* node = current.load(std::memory_order_acquire);
+                volatile float gain = node->gain;
+                (void)gain;
+                callbacks++;
+            }
+        });
+
+        while (callbacks == 0) {
+            std::this_thread::yield();
+        }
+
+        // Editor swapping nodes while playing
+        for (int i = 0; i < 2000; ++i) {
+            TestNode* old = current.exchange(new TestNode, std::memory_order_acq_rel);
+            reclaimer.retire(old);
+            if (i % 100 == 0) {
+                std::this_thread::yield();
+            }
+        }
+
+        running = false;
+        audio.join();
+        reclaimer.stopHousekeeping();
+        reclaimer.collect();
+
+        REQUIRE(callbacks > 0);
+        REQUIRE(g_liveNodes == 1);
+        delete current.load();
+    }
+
+    REQUIRE(g_liveNodes == 0);
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../realtime/denormalguard.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace AudioEngine;
+
+// Feedback-heavy one-pole lowpass, the shape of a decaying filter/reverb tail
+static float processDecayingTail(std::vector<float>& buffer, float state) {
+    const float feedback = 0.999f;
+    for (float& sample : buffer) {
+        state = sample + feedback * state;
+        sample = state;
+    }
+    return state;
+}
+
+// Time one block per decade of decay, from audible signal down into denormals
+static std::vector<double> timeDecay(int blocks) {
+    std::vector<float> buffer(4096, 0.0f);
+    std::vector<double> blockTimes;
+    float state = 1.0f;
+
+    for (int block = 0; block < blocks; ++block) {
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        auto start = std::chrono::steady_clock::now();
+        state = processDecayingTail(buffer, state);
+        auto end = std::chrono::steady_clock::now();
+        blockTimes.push_back(std::chrono::duration<double>(end - start).count());
+
+        // Jump the tail down a few decades between blocks
+        state *= 1.0e-4f;
+    }
+
+    return blockTimes;
+}
+
+TEST_CASE("ScopedDenormalGuard flushes and restores", "[Denormal]") {
+    volatile float tiny = 1.0e-39f;  // Already denormal
+
+    REQUIRE_FALSE(ScopedDenormalGuard::isActive());
+
+    {
+        ScopedDenormalGuard guard;
+        if (ScopedDenormalGuard::isActive()) {
+            volatile float result = tiny * 0.5f;
+            REQUIRE(result == 0.0f);
+        }
+    }
+
+    REQUIRE_FALSE(ScopedDenormalGuard::isActive());
+    volatile float result = tiny * 0.5f;
+    REQUIRE(result != 0.0f);
+}
+
+TEST_CASE("Decaying IIR tail flushes to zero under the guard", "[Denormal]") {
+    // A tail well below audible, left to ring down past FLT_MIN
+    auto ringDown = [] {
+        std::vector<float> buffer(20000, 0.0f);
+        processDecayingTail(buffer, 1.0e-30f);
+        return buffer;
+    };
+
+    const std::vector<float> unguarded = ringDown();
+    const bool reachedDenormals = std::any_of(unguarded.begin(), unguarded.end(),
+                                              [](float x) { return std::fpclassify(x) == FP_SUBNORMAL; });
+    REQUIRE(reachedDenormals);
+
+    ScopedDenormalGuard guard;
+#if defined(CADENCE_DENORMALS_SSE) || defined(CADENCE_DENORMALS_ARM)
+    REQUIRE(ScopedDenormalGuard::isActive());
+#endif
+    if (ScopedDenormalGuard::isActive()) {
+        const std::vector<float> guarded = ringDown();
+        REQUIRE(std::none_of(guarded.begin(), guarded.end(),
+                             [](float x) { return std::fpclassify(x) == FP_SUBNORMAL; }));
+        REQUIRE(guarded.back() == 0.0f);
+    }
+}
+
+TEST_CASE("Decaying IIR tail does not spike processing time", "[Denormal][.benchmark]") {
+    // Best of several runs per block filters out scheduling noise
+    auto bestBlockTimes = [] {
+        auto blockTimes = timeDecay(16);
+        for (int run = 0; run < 8; ++run) {
+            auto times = timeDecay(16);
+            for (size_t i = 0; i < times.size(); ++i) {
+                blockTimes[i] = std::min(blockTimes[i], times[i]);
+            }
+        }
+        return blockTimes;
+    };
+    auto spike = [](const std::vector<double>& times) {
+        return *std::max_element(times.begin(), times.end()) / *std::min_element(times.begin(), times.end());
+    };
+
+    const double unguarded = spike(bestBlockTimes());
+    ScopedDenormalGuard guard;
+    REQUIRE(ScopedDenormalGuard::isActive());
+    const double guarded = spike(bestBlockTimes());
+
+    // Denormal processing is typically 10-100x slower
+    INFO("slowest block / fastest block: unguarded " << unguarded << "x, guarded " << guarded << "x");
+    REQUIRE(guarded < 8.0);
+}
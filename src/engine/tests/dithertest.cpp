@@ -0,0 +1,190 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../dsp/dither.h"
+#include "../dsp/fft.h"
+#include "testsupport.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace AudioEngine;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+constexpr double kRate = 48000.0;
+
+std::vector<int16_t> toInt16(DitherConverter& converter, const std::vector<float>& input) {
+    std::vector<int16_t> out(input.size());
+    converter.convert(input.data(), 1, input.size(), SampleFormat::Int16, out.data(), sizeof(int16_t));
+    return out;
+}
+
+// Mean and variance of the quantization error, in LSB
+void errorMoments(const std::vector<float>& input, const std::vector<int16_t>& out, double& mean, double& variance) {
+    double sum = 0.0, sumSq = 0.0;
+    for (size_t i = 0; i < input.size(); ++i) {
+        const double e = out[i] - input[i] * 32767.0;
+        sum += e;
+        sumSq += e * e;
+    }
+    mean = sum / static_cast<double>(input.size());
+    variance = sumSq / static_cast<double>(input.size()) - mean * mean;
+}
+
+// Averaged error power per band, from 4096-point periodograms
+double errorBandPower(const std::vector<float>& input, const std::vector<int16_t>& out, double lowHz, double highHz) {
+    const size_t n = 4096;
+    auto fft = Fft::get(n);
+    std::vector<float> frame(n), re(n / 2 + 1), im(n / 2 + 1);
+    double sum = 0.0;
+    for (size_t start = 0; start + n <= input.size(); start += n) {
+        for (size_t i = 0; i < n; ++i) {
+            const float e = out[start + i] - input[start + i] * 32767.0f;
+            frame[i] = e * static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * i / n));
+        }
+        fft->forwardReal(frame.data(), re.data(), im.data());
+        for (size_t k = static_cast<size_t>(lowHz * n / kRate); k < static_cast<size_t>(highHz * n / kRate); ++k) {
+            sum += static_cast<double>(re[k]) * re[k] + static_cast<double>(im[k]) * im[k];
+        }
+    }
+    return sum;
+}
+
+}
+
+TEST_CASE("Undithered conversion matches plain rounding", "[Dither]") {
+    std::vector<float> input(1001);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = 1.2f * std::sin(0.37f * static_cast<float>(i));
+    }
+
+    DitherConverter converter(DitherMode::None);
+    const std::vector<int16_t> out16 = toInt16(converter, input);
+
+    std::vector<unsigned char> out24(3 * input.size());
+    converter.convert(input.data(), 1, input.size(), SampleFormat::Int24, out24.data(), 3);
+
+    for (size_t i = 0; i < input.size(); ++i) {
+        const float clamped = std::clamp(input[i], -1.0f, 1.0f);
+        REQUIRE(out16[i] == static_cast<int16_t>(std::lrint(clamped * 32767.0f)));
+
+        const int32_t expected = static_cast<int32_t>(std::lrint(clamped * 8388607.0f));
+        const int32_t actual = static_cast<int32_t>((out24[3 * i] << 8) | (out24[3 * i + 1] << 16) |
+                                                    (static_cast<uint32_t>(out24[3 * i + 2]) << 24)) >> 8;
+        REQUIRE(actual == expected);
+    }
+}
+
+TEST_CASE("TPDF dither makes the error independent of the signal", "[Dither]") {
+    const size_t frames = 200000;
+    DitherConverter converter(DitherMode::Triangular, 5);
+
+    // DC on a code and halfway between codes: rounding alone gives errors of
+    // 0 and 0.5 LSB; with TPDF both have zero mean and 1/4 LSB^2 variance
+    for (double lsb : {0.0, 0.5, 0.25}) {
+        INFO("input " << lsb << " LSB");
+        const std::vector<float> input(frames, static_cast<float>(lsb / 32767.0));
+        double mean = 0.0, variance = 0.0;
+        errorMoments(input, toInt16(converter, input), mean, variance);
+        REQUIRE_THAT(mean, WithinAbs(0.0, 0.01));
+        REQUIRE_THAT(variance, WithinAbs(0.25, 0.01));
+    }
+
+    // A sine of 0.4 LSB vanishes without dither but survives with it
+    std::vector<float> quiet(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        quiet[i] = static_cast<float>(0.4 / 32767.0 * std::sin(2.0 * M_PI * 1000.0 * i / kRate));
+    }
+    DitherConverter plain(DitherMode::None);
+    const std::vector<int16_t> truncated = toInt16(plain, quiet);
+    REQUIRE(std::all_of(truncated.begin(), truncated.end(), [](int16_t x) { return x == 0; }));
+
+    const std::vector<int16_t> dithered = toInt16(converter, quiet);
+    double correlation = 0.0;
+    for (size_t i = 0; i < frames; ++i) {
+        correlation += dithered[i] * std::sin(2.0 * M_PI * 1000.0 * i / kRate);
+    }
+    REQUIRE_THAT(2.0 * correlation / frames, WithinAbs(0.4, 0.03));
+}
+
+TEST_CASE("Shaped dither moves noise out of the midrange", "[Dither]") {
+    const size_t frames = 1 << 17;
+    std::vector<float> input(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        input[i] = static_cast<float>(0.25 * std::sin(2.0 * M_PI * 441.0 * i / kRate));
+    }
+
+    DitherConverter flat(DitherMode::Triangular, 3);
+    DitherConverter shaped(DitherMode::Shaped, 3);
+    const std::vector<int16_t> flatOut = toInt16(flat, input);
+    const std::vector<int16_t> shapedOut = toInt16(shaped, input);
+
+    const double flatMid = errorBandPower(input, flatOut, 1000.0, 6000.0);
+    const double shapedMid = errorBandPower(input, shapedOut, 1000.0, 6000.0);
+    const double flatHigh = errorBandPower(input, flatOut, 16000.0, 22000.0);
+    const double shapedHigh = errorBandPower(input, shapedOut, 16000.0, 22000.0);
+    INFO("midrange " << 10.0 * std::log10(shapedMid / flatMid) << " dB, top "
+         << 10.0 * std::log10(shapedHigh / flatHigh) << " dB");
+    REQUIRE(shapedMid < flatMid * 0.5);
+    REQUIRE(shapedHigh > flatHigh);
+}
+
+TEST_CASE("Strided and contiguous conversion agree", "[Dither]") {
+    std::vector<float> input(2 * 777);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = 0.5f * std::sin(0.01f * static_cast<float>(i));
+    }
+
+    // Left channel of an interleaved pair, against the same samples planar
+    for (auto mode : {DitherMode::None, DitherMode::Triangular, DitherMode::Shaped}) {
+        DitherConverter a(mode, 9), b(mode, 9);
+        std::vector<int16_t> interleaved(2 * 777, 0);
+        a.convert(input.data(), 2, 777, SampleFormat::Int16, interleaved.data(), 2 * sizeof(int16_t));
+
+        std::vector<float> planar(777);
+        for (size_t i = 0; i < planar.size(); ++i) {
+            planar[i] = input[2 * i];
+        }
+        std::vector<int16_t> contiguous(777);
+        b.convert(planar.data(), 1, 777, SampleFormat::Int16, contiguous.data(), sizeof(int16_t));
+
+        for (size_t i = 0; i < 777; ++i) {
+            REQUIRE(interleaved[2 * i] == contiguous[i]);
+            REQUIRE(interleaved[2 * i + 1] == 0);
+        }
+    }
+
+    // Null source writes silence; float passes through
+    DitherConverter none(DitherMode::None);
+    std::vector<int16_t> silent(100, 7);
+    none.convert(nullptr, 1, 100, SampleFormat::Int16, silent.data(), sizeof(int16_t));
+    REQUIRE(std::all_of(silent.begin(), silent.end(), [](int16_t x) { return x == 0; }));
+    std::vector<float> copy(100);
+    none.convert(input.data(), 1, 100, SampleFormat::Float32, copy.data(), sizeof(float));
+    REQUIRE(std::equal(copy.begin(), copy.end(), input.begin()));
+}
+
+TEST_CASE("Dithered conversion costs less than plain per-sample rounding", "[Dither][.benchmark]") {
+    const size_t frames = 512;
+    std::vector<float> input(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        input[i] = 0.5f * std::sin(0.01f * static_cast<float>(i));
+    }
+    std::vector<int16_t> out(frames);
+
+    // The conversion the output path used before, without any dither
+    const double plain = TestSupport::bestOf(200, [&] {
+        for (size_t i = 0; i < frames; ++i) {
+            const float clamped = std::clamp(input[i], -1.0f, 1.0f);
+            out[i] = static_cast<int16_t>(std::lrint(clamped * 32767.0f));
+        }
+    });
+    DitherConverter converter(DitherMode::Triangular);
+    const double fused = TestSupport::bestOf(200, [&] {
+        converter.convert(input.data(), 1, frames, SampleFormat::Int16, out.data(), sizeof(int16_t));
+    });
+    INFO("plain " << plain * 1e6 << " us, fused TPDF " << fused * 1e6 << " us");
+    REQUIRE(fused < plain);
+}
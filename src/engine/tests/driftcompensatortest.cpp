@@ -0,0 +1,128 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../dsp/driftcompensator.h"
+#include <cmath>
+#include <vector>
+
+using namespace AudioEngine;
+
+namespace {
+
+struct DriftResult {
+    int underruns = 0;
+    int overruns = 0;
+    double driftPpm = 0.0;
+    double fillError = 0.0;     // Smoothed fill relative to target
+    double maxStep = 0.0;       // Largest sample-to-sample jump after settling
+    double rms = 0.0;           // Output level after settling
+};
+
+// Two devices on simulated clocks: the producer runs fast by driftPpm and
+// feeds a 1 kHz sine; the consumer pulls at its nominal rate
+DriftResult simulate(int inputRate, int outputRate, int inputPeriod, int outputPeriod,
+                     double driftPpm, double seconds) {
+    DriftCompensator compensator;
+    compensator.configure(1, inputRate, outputRate, inputPeriod, outputPeriod);
+
+    const double producerRate = inputRate * (1.0 + driftPpm * 1e-6);
+    const double frequency = 1000.0;
+    const double settle = seconds * 0.5;
+
+    std::vector<float> in(inputPeriod);
+    std::vector<float> out(outputPeriod);
+    float* outPtr = out.data();
+    const float* inPtr = in.data();
+
+    double producerTime = 0.0;
+    double consumerTime = 0.0;
+    uint64_t produced = 0;
+    int underrunsAtSettle = 0;
+    int overrunsAtSettle = 0;
+    bool settled = false;
+
+    DriftResult result;
+    double sumSquares = 0.0;
+    size_t counted = 0;
+    float previous = 0.0f;
+
+    while (consumerTime < seconds) {
+        if (producerTime <= consumerTime) {
+            // Sine in the producer's own sample clock
+            for (int i = 0; i < inputPeriod; ++i, ++produced) {
+                in[i] = static_cast<float>(
+                    0.5 * std::sin(2.0 * M_PI * frequency * produced / inputRate));
+            }
+            compensator.push(&inPtr, inputPeriod, producerTime);
+            producerTime += inputPeriod / producerRate;
+        } else {
+            bool ok = compensator.pull(&outPtr, outputPeriod, consumerTime);
+            consumerTime += outputPeriod / static_cast<double>(outputRate);
+
+            if (!settled && consumerTime >= settle) {
+                settled = true;
+                underrunsAtSettle = compensator.getUnderrunCount();
+                overrunsAtSettle = compensator.getOverrunCount();
+                previous = out[outputPeriod - 1];
+                continue;
+            }
+            if (settled && ok) {
+                for (float sample : out) {
+                    result.maxStep = std::max(result.maxStep,
+                                              static_cast<double>(std::fabs(sample - previous)));
+                    previous = sample;
+                    sumSquares += sample * sample;
+                    ++counted;
+                }
+            }
+        }
+    }
+
+    result.underruns = compensator.getUnderrunCount() - underrunsAtSettle;
+    result.overruns = compensator.getOverrunCount() - overrunsAtSettle;
+    result.driftPpm = compensator.getDriftPpm();
+    result.fillError = (compensator.getFillFrames() - compensator.getTargetLatencyFrames()) /
+                       compensator.getTargetLatencyFrames();
+    result.rms = counted ? std::sqrt(sumSquares / counted) : 0.0;
+    return result;
+}
+
+}
+
+TEST_CASE("DriftCompensator tracks clock drift between devices", "[DriftCompensator]") {
+    for (double drift : {-300.0, 0.0, 150.0, 1000.0}) {
+        DriftResult result = simulate(48000, 48000, 256, 192, drift, 60.0);
+
+        INFO("drift " << drift << " ppm, estimated " << result.driftPpm);
+        REQUIRE(result.underruns == 0);
+        REQUIRE(result.overruns == 0);
+        REQUIRE(std::fabs(result.driftPpm - drift) < 5.0);
+
+        // Added latency holds at its target
+        REQUIRE(std::fabs(result.fillError) < 0.01);
+
+        // Continuous sine: no dropouts or discontinuities
+        REQUIRE(std::fabs(result.rms - 0.5 / std::sqrt(2.0)) < 0.01);
+        REQUIRE(result.maxStep < 0.5 * 2.0 * M_PI * 1000.0 / 48000.0 * 1.1);
+    }
+}
+
+TEST_CASE("DriftCompensator converts between nominal rates", "[DriftCompensator]") {
+    DriftResult result = simulate(44100, 48000, 441, 512, 50.0, 60.0);
+
+    REQUIRE(result.underruns == 0);
+    REQUIRE(result.overruns == 0);
+    REQUIRE(std::fabs(result.driftPpm - 50.0) < 5.0);
+    REQUIRE(std::fabs(result.rms - 0.5 / std::sqrt(2.0)) < 0.01);
+}
+
+TEST_CASE("DriftCompensator outputs silence until primed", "[DriftCompensator]") {
+    DriftCompensator compensator;
+    compensator.configure(2, 48000, 48000, 64, 64);
+
+    std::vector<float> left(64, 1.0f);
+    std::vector<float> right(64, 1.0f);
+    float* out[] = {left.data(), right.data()};
+    REQUIRE_FALSE(compensator.pull(out, 64, 0.0));
+    REQUIRE(left[0] == 0.0f);
+    REQUIRE(right[63] == 0.0f);
+    REQUIRE(compensator.getUnderrunCount() == 0);
+}
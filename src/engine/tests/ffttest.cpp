@@ -0,0 +1,155 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../dsp/fft.h"
+#include "testsupport.h"
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+using namespace AudioEngine;
+
+namespace {
+
+std::vector<std::complex<double>> naiveDft(const std::vector<float>& re, const std::vector<float>& im) {
+    const size_t n = re.size();
+    std::vector<std::complex<double>> out(n);
+    for (size_t k = 0; k < n; ++k) {
+        std::complex<double> sum = 0.0;
+        for (size_t t = 0; t < n; ++t) {
+            const double angle = -2.0 * M_PI * static_cast<double>((k * t) % n) / static_cast<double>(n);
+            sum += std::complex<double>(re[t], im[t]) * std::polar(1.0, angle);
+        }
+        out[k] = sum;
+    }
+    return out;
+}
+
+std::vector<float> noise(size_t n, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> v(n);
+    for (float& x : v) {
+        x = dist(rng);
+    }
+    return v;
+}
+
+// Textbook in-place radix-2 on interleaved std::complex, the baseline
+void referenceFft(std::vector<std::complex<float>>& data) {
+    const size_t n = data.size();
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j |= bit;
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+    for (size_t len = 2; len <= n; len <<= 1) {
+        const float angle = static_cast<float>(-2.0 * M_PI / static_cast<double>(len));
+        const std::complex<float> step(std::cos(angle), std::sin(angle));
+        for (size_t start = 0; start < n; start += len) {
+            std::complex<float> w(1.0f, 0.0f);
+            for (size_t k = 0; k < len / 2; ++k) {
+                const std::complex<float> t = w * data[start + k + len / 2];
+                data[start + k + len / 2] = data[start + k] - t;
+                data[start + k] += t;
+                w *= step;
+            }
+        }
+    }
+}
+
+}
+
+TEST_CASE("Complex FFT matches the DFT and round-trips", "[FFT]") {
+    for (size_t n = 1; n <= 4096; n *= 2) {
+        INFO("size " << n);
+        const Fft fft(n);
+        std::vector<float> re = noise(n, 1);
+        std::vector<float> im = noise(n, 2);
+        const auto expected = naiveDft(re, im);
+
+        std::vector<float> outRe = re, outIm = im;
+        fft.forward(outRe.data(), outIm.data());
+        const double tolerance = 1e-5 * n + 1e-5;
+        for (size_t k = 0; k < n; ++k) {
+            REQUIRE(std::abs(outRe[k] - expected[k].real()) < tolerance);
+            REQUIRE(std::abs(outIm[k] - expected[k].imag()) < tolerance);
+        }
+
+        fft.inverse(outRe.data(), outIm.data());
+        for (size_t t = 0; t < n; ++t) {
+            REQUIRE(std::abs(outRe[t] / n - re[t]) < 1e-5);
+            REQUIRE(std::abs(outIm[t] / n - im[t]) < 1e-5);
+        }
+    }
+}
+
+TEST_CASE("Real FFT matches the DFT and round-trips", "[FFT]") {
+    for (size_t n = 2; n <= 4096; n *= 2) {
+        INFO("size " << n);
+        const Fft fft(n);
+        const std::vector<float> input = noise(n, 3);
+        const auto expected = naiveDft(input, std::vector<float>(n, 0.0f));
+
+        std::vector<float> re(n / 2 + 1), im(n / 2 + 1);
+        fft.forwardReal(input.data(), re.data(), im.data());
+        const double tolerance = 1e-5 * n + 1e-5;
+        for (size_t k = 0; k <= n / 2; ++k) {
+            REQUIRE(std::abs(re[k] - expected[k].real()) < tolerance);
+            REQUIRE(std::abs(im[k] - expected[k].imag()) < tolerance);
+        }
+        REQUIRE(im[0] == 0.0f);
+        REQUIRE(im[n / 2] == 0.0f);
+
+        std::vector<float> output(n);
+        fft.inverseReal(re.data(), im.data(), output.data());
+        for (size_t t = 0; t < n; ++t) {
+            REQUIRE(std::abs(output[t] / n - input[t]) < 1e-5);
+        }
+    }
+}
+
+TEST_CASE("FFT plans are cached per size", "[FFT]") {
+    const auto a = Fft::get(1024);
+    REQUIRE(a == Fft::get(1024));
+    REQUIRE(a != Fft::get(2048));
+    REQUIRE(a->size() == 1024);
+    REQUIRE_THROWS(Fft(1000));
+}
+
+TEST_CASE("FFT outpaces a textbook radix-2 transform", "[FFT][.benchmark]") {
+    const size_t n = 4096;
+    const auto fft = Fft::get(n);
+    const std::vector<float> sourceRe = noise(n, 4);
+    const std::vector<float> sourceIm = noise(n, 5);
+
+    AlignedVector<float> re(sourceRe.begin(), sourceRe.end());
+    AlignedVector<float> im(sourceIm.begin(), sourceIm.end());
+    std::vector<std::complex<float>> reference(n);
+
+    const double planned = TestSupport::bestOf(100, [&] {
+        fft->forward(re.data(), im.data());
+        fft->inverse(re.data(), im.data());
+        for (size_t i = 0; i < n; ++i) {
+            re[i] *= 1.0f / n;
+            im[i] *= 1.0f / n;
+        }
+    });
+    const double textbook = TestSupport::bestOf(100, [&] {
+        referenceFft(reference);
+        referenceFft(reference);
+    }, [&] {
+        for (size_t i = 0; i < n; ++i) {
+            reference[i] = {sourceRe[i], sourceIm[i]};
+        }
+    });
+
+    INFO("planned " << planned * 1e6 << " us, textbook " << textbook * 1e6 << " us per pair");
+    REQUIRE(std::abs(re[17] - sourceRe[17]) < 1e-3);
+    REQUIRE(std::isfinite(reference[17].real()));
+    REQUIRE(planned < textbook);
+}
@@ -0,0 +1,246 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../backends/file/filebackend.h"
+#include "../io/wavfile.h"
+#include "testsupport.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+using namespace AudioEngine;
+using TestSupport::tempPath;
+
+namespace {
+
+// Stereo ramp: left rises, right falls
+void writeRamp(const std::string& path, int rate, size_t frames) {
+    std::vector<float> left(frames);
+    std::vector<float> right(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        left[i] = static_cast<float>(i % 1000) / 1000.0f - 0.5f;
+        right[i] = -left[i];
+    }
+    const float* channels[] = {left.data(), right.data()};
+
+    WavWriter writer;
+    writer.open(path, {rate, 2, SampleFormat::Float32});
+    writer.write(channels, frames);
+    writer.close();
+}
+
+std::vector<char> fileBytes(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+StreamConfig fileConfig(const std::string& input, const std::string& output) {
+    StreamConfig config;
+    config.inputDeviceName = input;
+    config.outputDeviceName = output;
+    config.sampleRate = 48000;
+    config.bufferSize = 256;
+    config.inputChannels = 2;
+    config.outputChannels = 2;
+    config.realtimePriority = 0;
+    config.lockMemory = false;
+    return config;
+}
+
+// Half-gain passthrough of a free-running render
+void render(const std::string& input, const std::string& output, uint64_t frames) {
+    FileBackend backend;
+    backend.initialize(fileConfig(input, output));
+    backend.setClock(FileClock::FreeRunning);
+    backend.setRenderLength(frames);
+    backend.startPlanar([](const float* const* inputs, float* const* outputs, size_t n, double) {
+        for (int ch = 0; ch < 2; ++ch) {
+            for (size_t i = 0; i < n; ++i) {
+                outputs[ch][i] = inputs[ch][i] * 0.5f;
+            }
+        }
+    });
+    REQUIRE(backend.waitUntilFinished(5000));
+    backend.stop();
+}
+
+}
+
+TEST_CASE("WAV files round trip every sample format", "[WavFile]") {
+    const std::string path = tempPath("roundtrip");
+    std::vector<float> source(999);
+    for (size_t i = 0; i < source.size(); ++i) {
+        source[i] = static_cast<float>(i) / source.size() * 1.8f - 0.9f;
+    }
+
+    for (auto format : {SampleFormat::Int16, SampleFormat::Int24,
+                        SampleFormat::Int32, SampleFormat::Float32}) {
+        WavWriter writer;
+        writer.open(path, {44100, 1, format});
+        writer.writeInterleaved(source.data(), source.size());
+        writer.close();
+
+        WavReader reader;
+        reader.open(path);
+        REQUIRE(reader.format().sampleRate == 44100);
+        REQUIRE(reader.format().channels == 1);
+        REQUIRE(reader.format().format == format);
+        REQUIRE(reader.frameCount() == source.size());
+
+        std::vector<float> decoded(source.size());
+        REQUIRE(reader.readInterleaved(decoded.data(), decoded.size()) == source.size());
+
+        const float tolerance = (format == SampleFormat::Int16) ? 1.0f / 16384 : 1.0f / 1e6f;
+        for (size_t i = 0; i < source.size(); ++i) {
+            REQUIRE(std::abs(decoded[i] - source[i]) <= tolerance);
+        }
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Free-running file render is bit-reproducible", "[FileBackend]") {
+    const std::string input = tempPath("input");
+    const std::string first = tempPath("render1");
+    const std::string second = tempPath("render2");
+    writeRamp(input, 48000, 10000);
+
+    // Render length is not a multiple of the period
+    render(input, first, 12345);
+    render(input, second, 12345);
+
+    WavReader reader;
+    reader.open(first);
+    REQUIRE(reader.frameCount() == 12345);
+    REQUIRE(fileBytes(first) == fileBytes(second));
+
+    // Output is the input at half gain, then silence past the input's end
+    std::vector<float> left(12345);
+    std::vector<float> right(12345);
+    float* channels[] = {left.data(), right.data()};
+    reader.read(channels, 2, left.size());
+    REQUIRE(left[10] == (10.0f / 1000.0f - 0.5f) * 0.5f);
+    REQUIRE(right[10] == -left[10]);
+    REQUIRE(left[12000] == 0.0f);
+
+    std::remove(input.c_str());
+    std::remove(first.c_str());
+    std::remove(second.c_str());
+}
+
+TEST_CASE("Real-time file clock paces periods and supports pause", "[FileBackend]") {
+    const std::string input = tempPath("rt_input");
+    writeRamp(input, 48000, 4800);
+
+    FileBackend backend;
+    StreamConfig config = fileConfig(input, "");
+    config.bufferSize = 480;  // 10 ms
+    backend.initialize(config);
+    backend.setClock(FileClock::RealTime);
+    backend.setLoopInput(true);
+
+    std::atomic<int> callbacks{0};
+    backend.start([&](const float*, float* output, size_t frames, double) {
+        std::fill(output, output + frames * 2, 0.0f);
+        callbacks++;
+    });
+    REQUIRE(backend.isRunning());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    // ~20 periods; allow generous scheduling slack on loaded build machines
+    REQUIRE(callbacks.load() >= 5);
+    REQUIRE(callbacks.load() <= 30);
+
+    backend.pause();
+    REQUIRE(backend.isPaused());
+    const int paused = callbacks.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE(callbacks.load() == paused);
+
+    backend.resume();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE(callbacks.load() > paused);
+
+    backend.stop();
+    REQUIRE_FALSE(backend.isRunning());
+    std::remove(input.c_str());
+}
+
+TEST_CASE("Jitter spikes longer than a period count as xruns", "[FileBackend]") {
+    FileBackend backend;
+    StreamConfig config = fileConfig("", "");
+    config.inputDeviceName.reset();
+    config.outputDeviceName.reset();
+    config.inputChannels = 0;
+    config.bufferSize = 64;
+    backend.initialize(config);
+
+    JitterProfile jitter;
+    jitter.spikeProbability = 1.0;
+    jitter.spikeMs = 5.0;  // > 64 / 48000 s
+    backend.setJitterProfile(jitter);
+    backend.setRenderLength(64 * 10);
+
+    backend.start([](const float*, float*, size_t, double) {});
+    REQUIRE(backend.waitUntilFinished(5000));
+    backend.stop();
+
+    REQUIRE(backend.getXrunCount() >= 5);
+}
+
+TEST_CASE("A finished render stops the stream and can be restarted", "[FileBackend]") {
+    const std::string input = tempPath("finish_input");
+    const std::string output = tempPath("finish_output");
+    writeRamp(input, 48000, 1000);
+
+    FileBackend backend;
+    StreamConfig config = fileConfig(input, output);
+    config.inputChannels = 300;         // More than a planar callback carries
+    backend.initialize(config);
+    backend.setClock(FileClock::FreeRunning);
+    backend.setRenderLength(2000);
+
+    for (int run = 0; run < 2; ++run) {
+        std::atomic<int> callbacks{0};
+        backend.startPlanar([&](const float* const* inputs, float* const*, size_t n, double) {
+            // Channels past the file's two are silent, up to the planar limit
+            REQUIRE(inputs[kMaxPlanarChannels - 1][n - 1] == 0.0f);
+            callbacks++;
+        });
+        REQUIRE(backend.waitUntilFinished(5000));
+        REQUIRE_FALSE(backend.isRunning());
+        REQUIRE(callbacks.load() == 8);
+
+        // The output file is complete once the render reports finished
+        WavReader reader;
+        reader.open(output);
+        REQUIRE(reader.frameCount() == 2000);
+    }
+    backend.stop();
+
+    std::remove(input.c_str());
+    std::remove(output.c_str());
+}
+
+TEST_CASE("A backend destroyed after its render finished reaps the thread", "[FileBackend]") {
+    const std::string input = tempPath("reap_input");
+    const std::string output = tempPath("reap_output");
+    writeRamp(input, 48000, 1000);
+
+    {
+        FileBackend backend;
+        backend.initialize(fileConfig(input, output));
+        backend.setClock(FileClock::FreeRunning);
+        backend.setRenderLength(1000);
+
+        backend.start([](const float*, float*, size_t, double) {});
+        REQUIRE(backend.waitUntilFinished(5000));
+        REQUIRE_FALSE(backend.isRunning());
+        // No stop(): the destructor must join the finished clock thread
+    }
+
+    std::remove(input.c_str());
+    std::remove(output.c_str());
+}
@@ -0,0 +1,477 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../graph/audiograph.h"
+#include "../graph/graphnodes.h"
+#include "../dsp/biquadbank.h"
+#include "../realtime/denormalguard.h"
+#include "../common/audioerror.h"
+#include "testsupport.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace AudioEngine;
+
+namespace {
+
+constexpr double kRate = 48000.0;
+constexpr size_t kPeriod = 512;
+
+// Sine on every output while playing, flagged silence otherwise. Looped
+// repeats one period of it, costing a copy rather than a sin() per sample.
+class ClipSource : public AudioNode {
+public:
+    explicit ClipSource(int channels, bool looped = false) : AudioNode(0, channels) {
+        if (looped) {
+            m_loop.resize(kPeriod);
+            for (size_t i = 0; i < kPeriod; ++i) {
+                m_loop[i] = 0.5f * static_cast<float>(std::sin(0.05 * static_cast<double>(i)));
+            }
+        }
+    }
+
+    bool playing = true;
+
+    void process(const ProcessBlock& block) override {
+        for (int ch = 0; ch < outputCount(); ++ch) {
+            if (!playing) {
+                std::memset(block.outputs[ch], 0, block.frames * sizeof(float));
+                block.outputSilent[ch] = true;
+                continue;
+            }
+            if (!m_loop.empty()) {
+                std::memcpy(block.outputs[ch], m_loop.data(), std::min(block.frames, kPeriod) * sizeof(float));
+                continue;
+            }
+            for (size_t i = 0; i < block.frames; ++i) {
+                block.outputs[ch][i] = 0.5f * static_cast<float>(std::sin(0.05 * static_cast<double>(m_frame + i)));
+            }
+        }
+        m_frame += block.frames;
+    }
+
+private:
+    uint64_t m_frame = 0;
+    std::vector<float> m_loop;
+};
+
+// Pass-through that counts its calls, with a configurable tail
+class CountingEffect : public AudioNode {
+public:
+    explicit CountingEffect(size_t tail) : AudioNode(1, 1), m_tail(tail) {}
+
+    int processCalls = 0;
+    int wakeCalls = 0;
+
+    void process(const ProcessBlock& block) override {
+        ++processCalls;
+        std::memcpy(block.outputs[0], block.inputs[0], block.frames * sizeof(float));
+    }
+    size_t tailFrames() const override { return m_tail; }
+    void wake() override { ++wakeCalls; }
+
+private:
+    size_t m_tail;
+};
+
+// A track's insert chain stand-in: a stereo 8-band EQ with a ring-out tail
+class EqEffect : public AudioNode {
+public:
+    EqEffect() : AudioNode(2, 2), m_bank(2, 8, 0) {
+        for (int ch = 0; ch < 2; ++ch) {
+            for (int stage = 0; stage < 8; ++stage) {
+                m_bank.setCoefficientsImmediate(ch, stage,
+                    BiquadCoefficients::peaking(kRate, 100.0 * (stage + 1), 1.0, 3.0));
+            }
+        }
+    }
+
+    void process(const ProcessBlock& block) override {
+        for (int ch = 0; ch < 2; ++ch) {
+            std::memcpy(block.outputs[ch], block.inputs[ch], block.frames * sizeof(float));
+        }
+        m_bank.process(block.outputs, block.frames);
+    }
+    size_t tailFrames() const override { return 4800; }
+    void wake() override { m_bank.reset(); }
+
+private:
+    BiquadBank m_bank;
+};
+
+bool isSilent(const std::vector<float>& buffer) {
+    return std::all_of(buffer.begin(), buffer.end(), [](float x) { return x == 0.0f; });
+}
+
+}
+
+TEST_CASE("Graph runs nodes after their inputs", "[AudioGraph]") {
+    AudioGraph graph;
+    // Consumer added first: the schedule, not insertion order, decides
+    auto gainNode = std::make_unique<GainNode>(1, 0.5f);
+    const AudioGraph::NodeId gain = graph.addNode(std::move(gainNode));
+    const AudioGraph::NodeId source = graph.addNode(std::make_unique<ClipSource>(1));
+    graph.connect(source, 0, gain, 0);
+    graph.connectToOutput(gain, 0, 0);
+    graph.compile(kRate, kPeriod, 2);
+
+    std::vector<float> left(1000, 1.0f), right(1000, 1.0f);
+    float* outputs[] = {left.data(), right.data()};
+    graph.process(outputs, left.size());
+    for (size_t i = 0; i < left.size(); ++i) {
+        REQUIRE(left[i] == 0.5f * static_cast<float>(std::sin(0.05 * static_cast<double>(i))) * 0.5f);
+    }
+    REQUIRE(isSilent(right));
+
+    REQUIRE_THROWS_AS(graph.connect(source, 1, gain, 0), AudioException);
+    REQUIRE_THROWS_AS(graph.connect(source, 0, 7, 0), AudioException);
+
+    // Feedback without a delay node cannot be scheduled
+    AudioGraph cyclic;
+    const AudioGraph::NodeId a = cyclic.addNode(std::make_unique<GainNode>(1));
+    const AudioGraph::NodeId b = cyclic.addNode(std::make_unique<GainNode>(1));
+    cyclic.connect(a, 0, b, 0);
+    cyclic.connect(b, 0, a, 0);
+    REQUIRE_THROWS_AS(cyclic.compile(kRate, kPeriod, 1), AudioException);
+}
+
+TEST_CASE("Silent branches sleep after their tail and wake at once", "[AudioGraph]") {
+    AudioGraph graph;
+    auto sourceNode = std::make_unique<ClipSource>(1);
+    auto effectNode = std::make_unique<CountingEffect>(1000);
+    ClipSource& clip = *sourceNode;
+    CountingEffect& effect = *effectNode;
+    const AudioGraph::NodeId source = graph.addNode(std::move(sourceNode));
+    const AudioGraph::NodeId fx = graph.addNode(std::move(effectNode));
+    graph.connect(source, 0, fx, 0);
+    graph.connectToOutput(fx, 0, 0);
+    graph.compile(kRate, kPeriod, 1);
+
+    std::vector<float> out(kPeriod);
+    float* outputs[] = {out.data()};
+    auto period = [&](bool playing) {
+        clip.playing = playing;
+        graph.process(outputs, kPeriod);
+    };
+
+    period(true);
+    period(true);
+    REQUIRE(effect.processCalls == 2);
+
+    // 1000 frames of tail: runs two silent periods, then sleeps
+    period(false);
+    period(false);
+    REQUIRE(effect.processCalls == 4);
+    REQUIRE(graph.getSleepingNodeCount() == 0);
+    period(false);
+    period(false);
+    period(false);
+    REQUIRE(effect.processCalls == 4);
+    REQUIRE(graph.getSleepingNodeCount() == 1);
+    REQUIRE(isSilent(out));
+
+    // Signal returns: processed in that same period
+    period(true);
+    REQUIRE(effect.processCalls == 5);
+    REQUIRE(effect.wakeCalls == 1);
+    REQUIRE_FALSE(isSilent(out));
+    REQUIRE(graph.getSleepingNodeCount() == 0);
+
+    // Without sleeping every node runs every period
+    graph.setSleepEnabled(false);
+    for (int i = 0; i < 5; ++i) {
+        period(false);
+    }
+    REQUIRE(effect.processCalls == 10);
+}
+
+TEST_CASE("A fader moved while asleep wakes at its new gain", "[AudioGraph]") {
+    AudioGraph graph;
+    graph.setFusionEnabled(false);      // The fader runs as its own node
+    auto sourceNode = std::make_unique<ClipSource>(1);
+    auto faderNode = std::make_unique<GainNode>(1, 1.0f);
+    ClipSource& clip = *sourceNode;
+    GainNode& fader = *faderNode;
+    const AudioGraph::NodeId source = graph.addNode(std::move(sourceNode));
+    const AudioGraph::NodeId gain = graph.addNode(std::move(faderNode));
+    graph.connect(source, 0, gain, 0);
+    graph.connectToOutput(gain, 0, 0);
+    graph.compile(kRate, kPeriod, 1);
+
+    std::vector<float> out(kPeriod);
+    float* outputs[] = {out.data()};
+    clip.playing = false;
+    graph.process(outputs, kPeriod);
+    REQUIRE(graph.getSleepingNodeCount() == 1);
+
+    // No ramp down from the old gain: the fader was silent all along
+    fader.setGain(0.0f);
+    clip.playing = true;
+    graph.process(outputs, kPeriod);
+    REQUIRE(isSilent(out));
+}
+
+TEST_CASE("Silence propagates through a mix bus", "[AudioGraph]") {
+    AudioGraph graph;
+    graph.setFusionEnabled(false);      // Counts sleeping faders one by one
+    std::vector<ClipSource*> clips;
+    const AudioGraph::NodeId mix = graph.addNode(std::make_unique<MixNode>(2, 3));
+    for (int track = 0; track < 3; ++track) {
+        auto clip = std::make_unique<ClipSource>(2);
+        clips.push_back(clip.get());
+        const AudioGraph::NodeId source = graph.addNode(std::move(clip));
+        const AudioGraph::NodeId fader = graph.addNode(std::make_unique<GainNode>(2, 0.25f * (track + 1)));
+        for (int ch = 0; ch < 2; ++ch) {
+            graph.connect(source, ch, fader, ch);
+            graph.connect(fader, ch, mix, track * 2 + ch);
+        }
+    }
+    graph.connectToOutput(mix, 0, 0);
+    graph.connectToOutput(mix, 1, 1);
+    graph.compile(kRate, kPeriod, 2);
+
+    std::vector<float> left(kPeriod), right(kPeriod);
+    float* outputs[] = {left.data(), right.data()};
+
+    // Only the third track plays: the mix is that track at its fader gain
+    clips[0]->playing = false;
+    clips[1]->playing = false;
+    graph.process(outputs, kPeriod);
+    for (size_t i = 0; i < kPeriod; ++i) {
+        REQUIRE(left[i] == 0.5f * static_cast<float>(std::sin(0.05 * static_cast<double>(i))) * 0.75f);
+    }
+    REQUIRE(graph.getSleepingNodeCount() == 2);
+
+    // Nothing plays: every fader and the mix sleep
+    clips[2]->playing = false;
+    graph.process(outputs, kPeriod);
+    REQUIRE(graph.getSleepingNodeCount() == 4);
+    REQUIRE(isSilent(left));
+    REQUIRE(isSilent(right));
+
+    clips[0]->playing = true;
+    graph.process(outputs, kPeriod);
+    REQUIRE(graph.getSleepingNodeCount() == 2);
+    REQUIRE_FALSE(isSilent(left));
+}
+
+namespace {
+
+// 32 stereo tracks of source -> EQ -> fader into one mix; 4 of them play
+void buildSparseArrangement(AudioGraph& graph) {
+    graph.setFusionEnabled(false);
+    const int tracks = 32;
+    const AudioGraph::NodeId mix = graph.addNode(std::make_unique<MixNode>(2, tracks));
+    for (int track = 0; track < tracks; ++track) {
+        auto clip = std::make_unique<ClipSource>(2);
+        clip->playing = track % 8 == 0;
+        const AudioGraph::NodeId source = graph.addNode(std::move(clip));
+        const AudioGraph::NodeId eq = graph.addNode(std::make_unique<EqEffect>());
+        const AudioGraph::NodeId fader = graph.addNode(std::make_unique<GainNode>(2, 0.5f));
+        for (int ch = 0; ch < 2; ++ch) {
+            graph.connect(source, ch, eq, ch);
+            graph.connect(eq, ch, fader, ch);
+            graph.connect(fader, ch, mix, track * 2 + ch);
+        }
+    }
+    graph.connectToOutput(mix, 0, 0);
+    graph.connectToOutput(mix, 1, 1);
+    graph.compile(kRate, kPeriod, 2);
+}
+
+}
+
+TEST_CASE("Idle tracks of a sparse arrangement fall asleep", "[AudioGraph]") {
+    ScopedDenormalGuard denormals;
+    AudioGraph graph;
+    buildSparseArrangement(graph);
+
+    std::vector<float> left(kPeriod), right(kPeriod);
+    float* outputs[] = {left.data(), right.data()};
+    graph.setSleepEnabled(true);
+    for (int i = 0; i < 20; ++i) {
+        graph.process(outputs, kPeriod);      // Past every tail
+    }
+    // EQ and fader of each of the 28 silent tracks
+    REQUIRE(graph.getSleepingNodeCount() == 2 * 28);
+    REQUIRE_FALSE(isSilent(left));
+}
+
+TEST_CASE("Sleeping idle tracks cuts the cost of a sparse arrangement", "[AudioGraph][.benchmark]") {
+    // FTZ/DAZ as on the audio thread, so idle EQs ringing down cost what they would live
+    ScopedDenormalGuard denormals;
+    AudioGraph graph;
+    buildSparseArrangement(graph);
+
+    std::vector<float> left(kPeriod), right(kPeriod);
+    float* outputs[] = {left.data(), right.data()};
+    auto timed = [&](bool sleep) {
+        graph.setSleepEnabled(sleep);
+        for (int i = 0; i < 20; ++i) {
+            graph.process(outputs, kPeriod);      // Past every tail
+        }
+        return TestSupport::bestOf(100, [&] { graph.process(outputs, kPeriod); });
+    };
+
+    const double awake = timed(false);
+    const double sleeping = timed(true);
+    INFO("every node " << awake * 1e6 << " us, idle tracks asleep " << sleeping * 1e6 << " us per period");
+    REQUIRE(sleeping < awake * 0.5);
+}
+
+namespace {
+
+// Mixer strip per track: source -> gain -> pan -> mute -> invert -> mix -> master
+struct Mixer {
+    AudioGraph graph;
+    std::vector<ClipSource*> clips;
+    std::vector<GainNode*> faders;
+    std::vector<PanNode*> pans;
+    std::vector<MuteNode*> mutes;
+    std::vector<PhaseInvertNode*> inverts;
+    GainNode* master = nullptr;
+
+    Mixer(int tracks, bool fusion, bool looped = false) {
+        graph.setFusionEnabled(fusion);
+        const AudioGraph::NodeId mix = graph.addNode(std::make_unique<MixNode>(2, tracks));
+        for (int track = 0; track < tracks; ++track) {
+            const AudioGraph::NodeId chain[] = {
+                add(clips, std::make_unique<ClipSource>(2, looped)),
+                add(faders, std::make_unique<GainNode>(2, 0.5f + 0.1f * static_cast<float>(track))),
+                add(pans, std::make_unique<PanNode>(0.3f * static_cast<float>(track % 5 - 2))),
+                add(mutes, std::make_unique<MuteNode>(2)),
+                add(inverts, std::make_unique<PhaseInvertNode>(2))};
+            for (int ch = 0; ch < 2; ++ch) {
+                for (size_t i = 1; i < 5; ++i) {
+                    graph.connect(chain[i - 1], ch, chain[i], ch);
+                }
+                graph.connect(chain[4], ch, mix, track * 2 + ch);
+            }
+        }
+        std::vector<GainNode*> masters;
+        const AudioGraph::NodeId out = add(masters, std::make_unique<GainNode>(2, 0.8f));
+        master = masters.front();
+        for (int ch = 0; ch < 2; ++ch) {
+            graph.connect(mix, ch, out, ch);
+            graph.connectToOutput(out, ch, ch);
+        }
+        graph.compile(kRate, kPeriod, 2);
+    }
+
+    template <typename T>
+    AudioGraph::NodeId add(std::vector<T*>& list, std::unique_ptr<T> node) {
+        list.push_back(node.get());
+        return graph.addNode(std::move(node));
+    }
+};
+
+}
+
+TEST_CASE("Fused mixer strips match the unfused graph", "[AudioGraph]") {
+    Mixer fused(6, true), plain(6, false);
+    // Sources, one kernel for strips + mix + master, against every node on its own
+    REQUIRE(fused.graph.getScheduledStepCount() == 6 + 1);
+    REQUIRE(plain.graph.getScheduledStepCount() == 6 * 5 + 2);
+
+    std::vector<float> a(2 * kPeriod), b(2 * kPeriod), c(2 * kPeriod), d(2 * kPeriod);
+    float* fusedOut[] = {a.data(), b.data()};
+    float* plainOut[] = {c.data(), d.data()};
+    for (int period = 0; period < 12; ++period) {
+        // Moves between periods, so the kernels see ramps as well as constants
+        for (Mixer* mixer : {&fused, &plain}) {
+            mixer->faders[1]->setGain(period % 2 ? 0.25f : 1.0f);
+            mixer->pans[2]->setPan(period % 3 ? -1.0f : 0.5f);
+            mixer->mutes[3]->setMuted(period >= 4 && period < 8);
+            mixer->inverts[4]->setInverted(1, period % 4 == 1);
+            mixer->clips[5]->playing = period < 6;
+            mixer->master->setGain(period == 10 ? 0.5f : 0.8f);
+        }
+        fused.graph.process(fusedOut, 700);
+        plain.graph.process(plainOut, 700);
+        for (size_t i = 0; i < 700; ++i) {
+            REQUIRE(std::abs(a[i] - c[i]) < 1e-5f);
+            REQUIRE(std::abs(b[i] - d[i]) < 1e-5f);
+        }
+    }
+    REQUIRE_FALSE(isSilent(a));
+}
+
+TEST_CASE("Fusion stops where a buffer is shared or routed out", "[AudioGraph]") {
+    AudioGraph graph;
+    const AudioGraph::NodeId source = graph.addNode(std::make_unique<ClipSource>(1));
+    const AudioGraph::NodeId shared = graph.addNode(std::make_unique<GainNode>(1, 0.5f));
+    const AudioGraph::NodeId a = graph.addNode(std::make_unique<GainNode>(1, 2.0f));
+    const AudioGraph::NodeId b = graph.addNode(std::make_unique<PhaseInvertNode>(1));
+    const AudioGraph::NodeId mix = graph.addNode(std::make_unique<MixNode>(1, 2));
+    static_cast<PhaseInvertNode&>(graph.node(b)).setInverted(0, true);
+    graph.connect(source, 0, shared, 0);
+    graph.connect(shared, 0, a, 0);         // Fan-out: shared keeps its buffer
+    graph.connect(shared, 0, b, 0);
+    graph.connect(a, 0, mix, 0);
+    graph.connect(b, 0, mix, 1);
+    graph.connectToOutput(mix, 0, 0);
+    graph.connectToOutput(a, 0, 1);         // Tapped: a keeps its buffer too
+    graph.compile(kRate, kPeriod, 2);
+    // source, shared, a, and b folded into the mix
+    REQUIRE(graph.getScheduledStepCount() == 4);
+
+    std::vector<float> mixed(kPeriod), tapped(kPeriod);
+    float* outputs[] = {mixed.data(), tapped.data()};
+    graph.process(outputs, kPeriod);        // The flip ramps in
+    graph.process(outputs, kPeriod);
+    for (size_t i = 0; i < kPeriod; ++i) {
+        const float x = 0.5f * static_cast<float>(std::sin(0.05 * static_cast<double>(kPeriod + i))) * 0.5f;
+        REQUIRE(tapped[i] == x * 2.0f);
+        REQUIRE(std::abs(mixed[i] - (x * 2.0f - x)) < 1e-6f);
+    }
+}
+
+TEST_CASE("Muted tracks in a fused mix are skipped", "[AudioGraph]") {
+    Mixer mixer(4, true);
+    for (MuteNode* mute : mixer.mutes) {
+        mute->setMuted(true);
+    }
+    std::vector<float> left(kPeriod), right(kPeriod);
+    float* outputs[] = {left.data(), right.data()};
+    mixer.graph.process(outputs, kPeriod);      // Fades out
+    REQUIRE_FALSE(isSilent(left));
+    mixer.graph.process(outputs, kPeriod);
+    REQUIRE(isSilent(left));
+    REQUIRE(isSilent(right));
+}
+
+TEST_CASE("A track muted or faded out while asleep stays silent on wake", "[AudioGraph]") {
+    for (bool fusion : {false, true}) {
+        INFO("fusion " << fusion);
+        Mixer mixer(2, fusion);
+        std::vector<float> left(kPeriod), right(kPeriod);
+        float* outputs[] = {left.data(), right.data()};
+        for (ClipSource* clip : mixer.clips) {
+            clip->playing = false;
+        }
+        mixer.graph.process(outputs, kPeriod);
+        REQUIRE(mixer.graph.getSleepingNodeCount() > 0);
+
+        // No fade from the settings the strips had when they fell asleep
+        mixer.mutes[0]->setMuted(true);
+        mixer.faders[1]->setGain(0.0f);
+        for (ClipSource* clip : mixer.clips) {
+            clip->playing = true;
+        }
+        mixer.graph.process(outputs, kPeriod);
+        REQUIRE(isSilent(left));
+        REQUIRE(isSilent(right));
+    }
+}
+
+TEST_CASE("Fusing mixer strips beats running each node", "[AudioGraph][.benchmark]") {
+    // 64 stereo tracks, all playing: the cost is the passes over the buffers
+    const int tracks = 64;
+    Mixer fused(tracks, true, true), plain(tracks, false, true);
+    std::vector<float> left(kPeriod), right(kPeriod);
+    float* outputs[] = {left.data(), right.data()};
+    const double unfused = TestSupport::bestOf(200, [&] { plain.graph.process(outputs, kPeriod); });
+    const double fusedTime = TestSupport::bestOf(200, [&] { fused.graph.process(outputs, kPeriod); });
+    INFO("node by node " << unfused * 1e6 << " us, fused " << fusedTime * 1e6 << " us per period");
+    REQUIRE(fusedTime < unfused * 0.6);
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../backends/jack/jackportadapter.h"
+#include <stdexcept>
+#include <vector>
+
+using namespace AudioEngine;
+
+namespace {
+
+// One cycle's port buffers, as jack_port_get_buffer() would hand them out
+struct Ports {
+    std::vector<std::vector<float>> in, out;
+    std::vector<const float*> inputs;
+    std::vector<float*> outputs;
+
+    Ports(int inputCount, int outputCount, size_t frames)
+        : in(static_cast<size_t>(inputCount), std::vector<float>(frames))
+        , out(static_cast<size_t>(outputCount), std::vector<float>(frames, -1.0f))
+    {
+        for (size_t ch = 0; ch < in.size(); ++ch) {
+            for (size_t i = 0; i < frames; ++i) {
+                in[ch][i] = static_cast<float>(ch * 1000 + i);
+            }
+            inputs.push_back(in[ch].data());
+        }
+        for (auto& buffer : out) {
+            outputs.push_back(buffer.data());
+        }
+    }
+};
+
+}
+
+TEST_CASE("JACK planar callback gets the port buffers themselves", "[JACK]") {
+    JackPortAdapter adapter;
+    adapter.configure(2, 3);
+    Ports ports(2, 3, 64);
+
+    adapter.setPlanarCallback([&](const float* const* inputs, float* const* outputs,
+                                  size_t frames, double streamTime) {
+        REQUIRE(frames == 64);
+        REQUIRE(streamTime == 1.5);
+        for (int ch = 0; ch < 2; ++ch) {
+            REQUIRE(inputs[ch] == ports.inputs[static_cast<size_t>(ch)]);
+        }
+        for (int ch = 0; ch < 3; ++ch) {
+            REQUIRE(outputs[ch] == ports.outputs[static_cast<size_t>(ch)]);
+            outputs[ch][0] = static_cast<float>(ch);
+        }
+    });
+    REQUIRE(adapter.isPlanar());
+    adapter.process(ports.inputs.data(), ports.outputs.data(), 64, 1.5);
+    REQUIRE(ports.out[2][0] == 2.0f);
+}
+
+TEST_CASE("JACK contiguous callback sees channel-major scratch at any period", "[JACK]") {
+    JackPortAdapter adapter;
+    adapter.configure(2, 2);
+
+    adapter.setCallback([](const float* input, float* output, size_t frames, double) {
+        // Output channel ch = input channel 1 - ch, plus one
+        for (size_t ch = 0; ch < 2; ++ch) {
+            for (size_t i = 0; i < frames; ++i) {
+                output[ch * frames + i] = input[(1 - ch) * frames + i] + 1.0f;
+            }
+        }
+    });
+    REQUIRE_FALSE(adapter.isPlanar());
+
+    // The server may change the period between cycles, up to its maximum
+    for (size_t frames : {size_t{32}, size_t{1024}, size_t{7}, JackPortAdapter::kMaxPeriodFrames}) {
+        Ports ports(2, 2, frames);
+        adapter.process(ports.inputs.data(), ports.outputs.data(), frames, 0.0);
+        for (size_t i = 0; i < frames; ++i) {
+            REQUIRE(ports.out[0][i] == ports.in[1][i] + 1.0f);
+            REQUIRE(ports.out[1][i] == ports.in[0][i] + 1.0f);
+        }
+    }
+}
+
+TEST_CASE("JACK adapter outputs silence without a usable callback", "[JACK]") {
+    JackPortAdapter adapter;
+    adapter.configure(1, 2);
+
+    Ports idle(1, 2, 16);
+    adapter.process(idle.inputs.data(), idle.outputs.data(), 16, 0.0);
+    REQUIRE(idle.out[0] == std::vector<float>(16, 0.0f));
+    REQUIRE(idle.out[1] == std::vector<float>(16, 0.0f));
+
+    // Larger than any JACK period: nothing to stage it in
+    int calls = 0;
+    adapter.setCallback([&](const float*, float*, size_t, double) { ++calls; });
+    Ports huge(1, 2, JackPortAdapter::kMaxPeriodFrames + 1);
+    adapter.process(huge.inputs.data(), huge.outputs.data(), huge.out[0].size(), 0.0);
+    REQUIRE(calls == 0);
+    REQUIRE(huge.out[1][0] == 0.0f);
+
+    // Callback errors reach the backend, which silences the cycle
+    adapter.setPlanarCallback([](const float* const*, float* const*, size_t, double) {
+        throw std::runtime_error("plugin crashed");
+    });
+    Ports failing(1, 2, 16);
+    REQUIRE_THROWS_AS(adapter.process(failing.inputs.data(), failing.outputs.data(), 16, 0.0),
+                      std::runtime_error);
+    adapter.silence(failing.outputs.data(), 16);
+    REQUIRE(failing.out[0] == std::vector<float>(16, 0.0f));
+}
@@ -0,0 +1,177 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../dsp/limiter.h"
+#include "../dsp/signalgenerator.h"
+#include "../common/audioerror.h"
+#include "testsupport.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace AudioEngine;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+constexpr double kRate = 48000.0;
+
+// Run stereo buffers through the limiter in uneven blocks
+void run(Limiter& limiter, std::vector<float>& left, std::vector<float>& right, bool simd = true) {
+    const size_t blocks[] = {512, 1, 33, 256, 1000, 7};
+    size_t pos = 0;
+    for (size_t i = 0; pos < left.size(); ++i) {
+        const size_t n = std::min(blocks[i % 6], left.size() - pos);
+        float* channels[] = {left.data() + pos, right.data() + pos};
+        if (simd) {
+            limiter.process(channels, n);
+        } else {
+            limiter.processScalar(channels, n);
+        }
+        pos += n;
+    }
+}
+
+// Loud noise with bursts well over full scale
+void loudProgram(std::vector<float>& left, std::vector<float>& right, size_t frames) {
+    NoiseGenerator noise(5);
+    left.resize(frames);
+    right.resize(frames);
+    noise.white(left.data(), frames, 0.8f);
+    noise.white(right.data(), frames, 0.8f);
+    for (size_t i = 0; i < frames; ++i) {
+        const float burst = (i / 4800) % 3 == 1 ? 6.0f : 1.0f;
+        left[i] *= burst;
+        right[i] *= (i % 9000 < 50) ? 10.0f : burst;
+    }
+}
+
+}
+
+TEST_CASE("Limiter passes quiet audio through, delayed by its latency", "[Limiter]") {
+    Limiter limiter(kRate, 2);
+    REQUIRE(limiter.latency() == 240);
+
+    std::vector<float> left(20000), right(20000);
+    for (size_t i = 0; i < left.size(); ++i) {
+        left[i] = 0.5f * static_cast<float>(std::sin(0.01 * i));
+        right[i] = -0.25f * static_cast<float>(std::sin(0.003 * i));
+    }
+    const std::vector<float> originalLeft = left, originalRight = right;
+    run(limiter, left, right);
+
+    for (size_t i = 0; i < left.size(); ++i) {
+        const float expectedLeft = i < 240 ? 0.0f : originalLeft[i - 240];
+        const float expectedRight = i < 240 ? 0.0f : originalRight[i - 240];
+        REQUIRE(left[i] == expectedLeft);
+        REQUIRE(right[i] == expectedRight);
+    }
+    REQUIRE(limiter.gainReductionDb() == 0.0f);
+
+    Limiter immediate(kRate, 1, {0.0, 50.0, -1.0});
+    REQUIRE(immediate.latency() == 0);
+    REQUIRE_THROWS_AS(Limiter(kRate, 0), AudioException);
+}
+
+TEST_CASE("Limiter output never exceeds the ceiling", "[Limiter]") {
+    for (double lookaheadMs : {0.0, 1.0, 5.0, 10.0}) {
+        INFO("lookahead " << lookaheadMs << " ms");
+        std::vector<float> left, right;
+        loudProgram(left, right, 96000);
+
+        Limiter limiter(kRate, 2, {lookaheadMs, 50.0, -1.0});
+        run(limiter, left, right);
+
+        const float ceiling = static_cast<float>(std::pow(10.0, -1.0 / 20.0));
+        float peak = 0.0f;
+        for (size_t i = 0; i < left.size(); ++i) {
+            peak = std::max({peak, std::abs(left[i]), std::abs(right[i])});
+        }
+        REQUIRE(peak <= ceiling * 1.000001f);
+        REQUIRE(peak > ceiling * 0.95f);
+    }
+}
+
+TEST_CASE("Limiter ramps the gain down ahead of a peak and releases after it", "[Limiter]") {
+    // Quiet tone, then a step to four times full scale, then quiet again
+    std::vector<float> left(48000), right(48000);
+    for (size_t i = 0; i < left.size(); ++i) {
+        const float level = (i >= 10000 && i < 14800) ? 4.0f : 0.25f;
+        left[i] = right[i] = level * static_cast<float>(std::sin(2.0 * M_PI * 441.0 * i / kRate));
+    }
+    std::vector<float> gain(left.size(), 0.0f);
+    const std::vector<float> original = left;
+
+    Limiter limiter(kRate, 2, {5.0, 100.0, 0.0});
+    run(limiter, left, right);
+    const size_t latency = static_cast<size_t>(limiter.latency());
+
+    // Recover the applied gain where the delayed input is large enough to divide by
+    double steepest = 0.0;
+    float previous = 1.0f;
+    for (size_t i = latency; i < left.size(); ++i) {
+        if (std::abs(original[i - latency]) > 0.1f) {
+            const float g = left[i] / original[i - latency];
+            steepest = std::max(steepest, static_cast<double>(previous - g));
+            previous = g;
+            gain[i - latency] = g;
+        }
+    }
+
+    // First recovered gain at or after a frame
+    auto gainAt = [&](size_t frame) {
+        while (gain[frame] == 0.0f) {
+            ++frame;
+        }
+        return gain[frame];
+    };
+
+    // Gain is already down before the step arrives, and about 1/4 during it
+    REQUIRE(gainAt(9920) < 0.75f);
+    REQUIRE_THAT(gainAt(12000), WithinAbs(0.25, 0.01));
+    // Ramped across the lookahead rather than stepped
+    REQUIRE(steepest < 0.1);
+    // Released back toward unity well after the burst
+    REQUIRE(gainAt(40000) > 0.99f);
+    REQUIRE(limiter.gainReductionDb() > -0.05f);
+}
+
+TEST_CASE("Limiter SIMD and scalar paths agree", "[Limiter]") {
+    std::vector<float> a, b, c, d;
+    loudProgram(a, b, 30000);
+    c = a;
+    d = b;
+
+    Limiter simd(kRate, 2), scalar(kRate, 2);
+    run(simd, a, b, true);
+    run(scalar, c, d, false);
+    REQUIRE(a == c);
+    REQUIRE(b == d);
+}
+
+TEST_CASE("Limiter costs less than a naive lookahead window scan", "[Limiter][.benchmark]") {
+    const size_t frames = 512;
+    std::vector<float> left, right;
+    loudProgram(left, right, frames);
+
+    // Only the window maximum, by rescanning 5 ms of peaks per frame
+    const size_t window = 241;
+    std::vector<float> peaks(frames + window, 0.0f), maxima(frames);
+    const double naive = TestSupport::bestOf(200, [&] {
+        for (size_t i = 0; i < frames; ++i) {
+            peaks[window + i - 1] = std::max(std::abs(left[i]), std::abs(right[i]));
+            float m = 0.0f;
+            for (size_t k = 0; k < window; ++k) {
+                m = std::max(m, peaks[i + k]);
+            }
+            maxima[i] = m;
+        }
+        std::copy(peaks.end() - static_cast<ptrdiff_t>(window), peaks.end(), peaks.begin());
+    });
+
+    Limiter limiter(kRate, 2);
+    std::vector<float> a = left, b = right;
+    float* channels[] = {a.data(), b.data()};
+    const double full = TestSupport::bestOf(200, [&] { limiter.process(channels, frames); });
+    INFO("naive window scan " << naive * 1e6 << " us, whole limiter " << full * 1e6 << " us per period");
+    REQUIRE(full < naive);
+}
@@ -0,0 +1,86 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../dsp/meterbank.h"
+#include "testsupport.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace AudioEngine;
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE("MeterBank readings", "[Metering]") {
+    const size_t frames = 480;
+    std::vector<float> sine(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        sine[i] = 0.5f * static_cast<float>(std::sin(2.0 * M_PI * 1000.0 * i / 48000.0));
+    }
+
+    SECTION("Peak and RMS of a sine") {
+        MeterBank meters(1, frames);
+        meters.process(0, sine.data(), frames);
+        meters.endPeriod(frames);
+
+        EngineSnapshot snapshot;
+        meters.writeTo(snapshot);
+        REQUIRE(snapshot.meterCount == 1);
+        REQUIRE_THAT(snapshot.meters[0].peak, WithinAbs(0.5, 1e-3));
+        REQUIRE_THAT(snapshot.meters[0].rms, WithinAbs(0.5 / std::sqrt(2.0), 1e-3));
+        REQUIRE(snapshot.meters[0].clipCount == 0);
+    }
+
+    SECTION("Readings are only delivered per window") {
+        MeterBank meters(1, frames * 4);
+        EngineSnapshot snapshot;
+
+        for (int period = 0; period < 3; ++period) {
+            meters.process(0, sine.data(), frames);
+            meters.endPeriod(frames);
+        }
+        meters.writeTo(snapshot);
+        REQUIRE(snapshot.meters[0].peak == 0.0f);
+
+        meters.process(0, sine.data(), frames);
+        meters.endPeriod(frames);
+        meters.writeTo(snapshot);
+        REQUIRE_THAT(snapshot.meters[0].peak, WithinAbs(0.5, 1e-3));
+    }
+
+    SECTION("Clip count increments per clipped window") {
+        MeterBank meters(2, frames);
+        std::vector<float> hot(frames, 0.1f);
+        hot[frames - 1] = -1.0f;
+
+        for (int period = 0; period < 3; ++period) {
+            meters.process(0, hot.data(), frames);
+            meters.process(1, sine.data(), frames);
+            meters.endPeriod(frames);
+        }
+
+        EngineSnapshot snapshot;
+        meters.writeTo(snapshot);
+        REQUIRE(snapshot.meters[0].clipCount == 3);
+        REQUIRE(snapshot.meters[1].clipCount == 0);
+    }
+}
+
+TEST_CASE("Metering 128 channels costs under 1% DSP load", "[Metering][.benchmark]") {
+    const int channels = 128;
+    const size_t frames = 512;
+    const double periodSeconds = frames / 48000.0;
+
+    std::vector<float> buffer(channels * frames);
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        buffer[i] = static_cast<float>(std::sin(i * 0.01));
+    }
+
+    MeterBank meters(channels, 800);
+    const double best = TestSupport::bestOf(50, [&] {
+        for (int ch = 0; ch < channels; ++ch) {
+            meters.process(ch, buffer.data() + ch * frames, frames);
+        }
+        meters.endPeriod(frames);
+    });
+
+    REQUIRE(best < periodSeconds * 0.01);
+}
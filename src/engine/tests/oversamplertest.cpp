@@ -0,0 +1,102 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../dsp/oversampler.h"
+#include "testsupport.h"
+#include <cmath>
+#include <vector>
+
+using namespace AudioEngine;
+
+namespace {
+
+// Amplitude of one frequency (cycles per sample) in a block
+double toneAmplitude(const float* samples, size_t count, double frequency) {
+    double re = 0.0, im = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        const double window = 0.5 - 0.5 * std::cos(2.0 * M_PI * i / count);
+        re += samples[i] * window * std::cos(2.0 * M_PI * frequency * i);
+        im -= samples[i] * window * std::sin(2.0 * M_PI * frequency * i);
+    }
+    return 2.0 * std::sqrt(re * re + im * im) / (0.5 * count);
+}
+
+}
+
+TEST_CASE("Oversampler round trip is a whole-frame delay", "[Oversampler]") {
+    for (int factor : {1, 2, 4, 8}) {
+        for (auto quality : {Oversampler::Quality::Low, Oversampler::Quality::Medium, Oversampler::Quality::High}) {
+            INFO("factor " << factor << ", quality " << static_cast<int>(quality));
+            Oversampler oversampler(1, factor, quality, 256);
+            const int latency = oversampler.latency();
+            REQUIRE(latency >= 0);
+            REQUIRE(latency < 256);
+
+            // A 1 kHz sine comes back unchanged apart from the delay
+            std::vector<float> input(1024), output(1024);
+            for (size_t i = 0; i < input.size(); ++i) {
+                input[i] = 0.5f * static_cast<float>(std::sin(2.0 * M_PI * 1000.0 * i / 48000.0));
+            }
+            for (size_t done = 0; done < input.size(); done += 256) {
+                const float* in[] = {input.data() + done};
+                float* out[] = {output.data() + done};
+                oversampler.upsample(in, 256);
+                oversampler.downsample(out, 256);
+            }
+            for (size_t i = 300; i < output.size(); ++i) {
+                REQUIRE(std::abs(output[i] - input[i - static_cast<size_t>(latency)]) < 2e-3f);
+            }
+        }
+    }
+}
+
+TEST_CASE("Oversampler rejects images across its passband", "[Oversampler]") {
+    // A tone at each quality's passband edge; the 2x image mirrors around 24 kHz
+    struct Case {
+        Oversampler::Quality quality;
+        double hz;
+        double limitDb;
+    };
+    const Case cases[] = {
+        {Oversampler::Quality::Low, 11500.0, -45.0},
+        {Oversampler::Quality::Medium, 16500.0, -65.0},
+        {Oversampler::Quality::High, 20000.0, -85.0},
+    };
+
+    const size_t frames = 4096;
+    for (const Case& c : cases) {
+        INFO("quality " << static_cast<int>(c.quality));
+        std::vector<float> input(frames);
+        for (size_t i = 0; i < frames; ++i) {
+            input[i] = static_cast<float>(std::sin(2.0 * M_PI * c.hz * i / 48000.0));
+        }
+
+        Oversampler oversampler(1, 2, c.quality, frames);
+        const float* in[] = {input.data()};
+        const float* up = oversampler.upsample(in, frames)[0];
+
+        const double wanted = toneAmplitude(up + 256, 2 * frames - 256, c.hz / 96000.0);
+        const double image = toneAmplitude(up + 256, 2 * frames - 256, (48000.0 - c.hz) / 96000.0);
+        REQUIRE(std::abs(wanted - 1.0) < 0.01);
+        REQUIRE(20.0 * std::log10(image) < c.limitDb);
+    }
+}
+
+TEST_CASE("Oversampler 4x stereo fits in a small slice of the period", "[Oversampler][.benchmark]") {
+    const size_t frames = 512;
+    Oversampler oversampler(2, 4, Oversampler::Quality::High, frames);
+    std::vector<float> left(frames, 0.25f), right(frames, -0.25f);
+    const float* in[] = {left.data(), right.data()};
+    float* out[] = {left.data(), right.data()};
+
+    const double perPeriod = 1e6 * TestSupport::bestOf(200, [&] {
+        float* const* up = oversampler.upsample(in, frames);
+        for (size_t i = 0; i < 4 * frames; ++i) {
+            up[0][i] = std::tanh(up[0][i]);
+            up[1][i] = std::tanh(up[1][i]);
+        }
+        oversampler.downsample(out, frames);
+    });
+
+    // 512 frames at 48 kHz is 10.7 ms
+    INFO(perPeriod << " us per period");
+    REQUIRE(perPeriod < 1000.0);
+}
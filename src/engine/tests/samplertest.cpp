@@ -0,0 +1,234 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../instruments/sampler.h"
+#include "../io/diskstreamer.h"
+#include "../io/wavfile.h"
+#include "../common/audioerror.h"
+#include "testsupport.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace AudioEngine;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+constexpr double kRate = 48000.0;
+
+// Mono 220 Hz sine test sample: every frame's value follows from its index
+float sampleValue(size_t frame) {
+    return 0.5f * static_cast<float>(std::sin(2.0 * M_PI * 220.0 * static_cast<double>(frame) / kRate));
+}
+
+std::string writeSample(const std::string& name, size_t frames) {
+    const std::string path = TestSupport::tempPath(name);
+    std::vector<float> samples(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        samples[i] = sampleValue(i);
+    }
+    WavWriter writer;
+    writer.open(path, WavFormat{static_cast<int>(kRate), 1, SampleFormat::Float32});
+    const float* channels[] = {samples.data()};
+    writer.write(channels, frames);
+    writer.close();
+    return path;
+}
+
+// Run process() in blocks, paced roughly like a real-time callback so the
+// streaming thread gets the time the preloaded head is meant to cover
+std::vector<float> render(Sampler& sampler, size_t frames, size_t block, std::vector<float>* right = nullptr) {
+    std::vector<float> out;
+    std::vector<float> l(block), r(block);
+    while (out.size() < frames) {
+        sampler.process(l.data(), r.data(), block);
+        out.insert(out.end(), l.begin(), l.end());
+        if (right) {
+            right->insert(right->end(), r.begin(), r.end());
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int>(1e6 * block / kRate)));
+    }
+    out.resize(frames);
+    return out;
+}
+
+}
+
+TEST_CASE("Sampler preloads only sample heads", "[Sampler]") {
+    const std::string path = writeSample("sampler_head", 48000);
+    Sampler::Options options;
+    options.preloadMs = 100.0;
+    Sampler sampler(kRate, options);
+
+    sampler.addSample(path, 60, 0, 127);
+    sampler.addSample(path, 72, 0, 127);
+    REQUIRE(sampler.sampleCount() == 2);
+    REQUIRE(sampler.getPreloadedBytes() == 2 * 2 * 4800 * sizeof(float));
+
+    REQUIRE_THROWS_AS(sampler.addSample(path, 60, 80, 70), AudioException);
+    REQUIRE_THROWS_AS(sampler.addSample(TestSupport::tempPath("missing_sample"), 60, 0, 127), AudioException);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Sampler streams seamlessly past the preloaded head", "[Sampler]") {
+    const size_t frames = 24000;
+    const std::string path = writeSample("sampler_stream", frames);
+    Sampler::Options options;
+    options.voices = 4;
+    options.preloadMs = 10.0;       // 480 frames in RAM, the rest streamed
+    options.attackMs = 0.1;
+    Sampler sampler(kRate, options);
+    sampler.addSample(path, 60, 0, 127);
+    sampler.start();
+
+    sampler.noteOn(60, 127);
+    std::vector<float> right;
+    const std::vector<float> left = render(sampler, frames, 256, &right);
+    sampler.stop();
+
+    REQUIRE(sampler.getUnderrunCount() == 0);
+
+    // Past the first block (envelopes ramp at block rate), the output is the
+    // file at unity pitch, across the head/stream boundary and on both channels
+    for (size_t i = 256; i < frames; ++i) {
+        INFO("frame " << i);
+        REQUIRE_THAT(left[i], WithinAbs(sampleValue(i), 1e-5));
+        REQUIRE_THAT(right[i], WithinAbs(sampleValue(i), 1e-5));
+    }
+
+    // The voice ends with the sample
+    std::vector<float> l(256), r(256);
+    sampler.process(l.data(), r.data(), l.size());
+    REQUIRE(sampler.getActiveVoiceCount() == 0);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Sampler transposes relative to the root key", "[Sampler]") {
+    const std::string path = writeSample("sampler_pitch", 4800);
+    Sampler::Options options;
+    options.preloadMs = 200.0;      // Whole sample in the head
+    options.attackMs = 0.1;
+    Sampler sampler(kRate, options);
+    sampler.addSample(path, 60, 0, 127);
+
+    sampler.noteOn(72, 127);
+    const std::vector<float> out = render(sampler, 2000, 128);
+
+    // An octave up reads the source at twice the rate
+    for (size_t i = 128; i < 2000; ++i) {
+        INFO("frame " << i);
+        REQUIRE_THAT(out[i], WithinAbs(sampleValue(2 * i), 1e-5));
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Sampler steals the oldest voice when the pool is full", "[Sampler]") {
+    const std::string path = writeSample("sampler_steal", 48000);
+    Sampler::Options options;
+    options.voices = 2;
+    options.preloadMs = 1000.0;
+    Sampler sampler(kRate, options);
+    sampler.addSample(path, 60, 0, 127);
+
+    std::vector<float> l(256), r(256);
+    sampler.noteOn(60, 100);
+    sampler.process(l.data(), r.data(), l.size());
+    sampler.noteOn(64, 100);
+    sampler.process(l.data(), r.data(), l.size());
+    REQUIRE(sampler.getActiveVoiceCount() == 2);
+    REQUIRE(sampler.getStealCount() == 0);
+
+    sampler.noteOn(67, 100);
+    REQUIRE(sampler.getStealCount() == 1);
+    for (int i = 0; i < 4; ++i) {
+        sampler.process(l.data(), r.data(), l.size());
+    }
+    REQUIRE(sampler.getActiveVoiceCount() == 2);
+    REQUIRE(sampler.getDroppedNoteCount() == 0);
+
+    // A voice mid-fade is stolen only once no other is left, and taking it
+    // drops the note that was waiting for it
+    sampler.noteOn(71, 100);
+    sampler.noteOn(72, 100);
+    REQUIRE(sampler.getStealCount() == 3);
+    REQUIRE(sampler.getDroppedNoteCount() == 0);
+    sampler.noteOn(74, 100);
+    REQUIRE(sampler.getStealCount() == 4);
+    REQUIRE(sampler.getDroppedNoteCount() == 1);
+    for (int i = 0; i < 4; ++i) {
+        sampler.process(l.data(), r.data(), l.size());
+    }
+    REQUIRE(sampler.getActiveVoiceCount() == 2);
+
+    // Released voices fade out and return to the pool
+    sampler.allNotesOff();
+    for (int i = 0; i < 200; ++i) {
+        sampler.process(l.data(), r.data(), l.size());
+    }
+    REQUIRE(sampler.getActiveVoiceCount() == 0);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Sampler drops a note it cannot stream and counts it", "[Sampler]") {
+    const std::string path = writeSample("sampler_queue_full", 48000);
+    Sampler::Options options;
+    options.voices = 1;
+    options.preloadMs = 10.0;
+    Sampler sampler(kRate, options);
+    sampler.addSample(path, 60, 0, 127);
+
+    // Not started: nothing drains the streaming queue, so each steal's
+    // close and open fill it until an open is refused
+    std::vector<float> l(256), r(256);
+    sampler.noteOn(60, 100);
+    for (int note = 61; note < 70 && sampler.getStreamFailureCount() == 0; ++note) {
+        sampler.noteOn(note, 100);
+        for (int i = 0; i < 4; ++i) {
+            sampler.process(l.data(), r.data(), l.size());
+        }
+    }
+    REQUIRE(sampler.getStreamFailureCount() == 1);
+    REQUIRE(sampler.getActiveVoiceCount() == 0);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("DiskStreamer abandons the old stream when a slot reopens", "[Sampler]") {
+    const std::string path = writeSample("streamer_reopen", 20000);
+    DiskStreamer streamer(1, 8192);
+    streamer.start();
+
+    auto readAll = [&](float* l, float* r, size_t frames) {
+        size_t done = 0;
+        for (int attempt = 0; attempt < 2000 && done < frames; ++attempt) {
+            done += streamer.read(0, l + done, r + done, frames - done);
+            if (done < frames) {
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+        }
+        return done;
+    };
+
+    std::vector<float> l(64), r(64);
+    REQUIRE(streamer.open(0, &path, 1000));
+    REQUIRE(readAll(l.data(), r.data(), 64) == 64);
+    REQUIRE_THAT(l[0], WithinAbs(sampleValue(1000), 1e-6));
+
+    REQUIRE(streamer.open(0, &path, 5000));
+    REQUIRE(readAll(l.data(), r.data(), 64) == 64);
+    for (size_t i = 0; i < 64; ++i) {
+        REQUIRE_THAT(l[i], WithinAbs(sampleValue(5000 + i), 1e-6));
+        REQUIRE_THAT(r[i], WithinAbs(sampleValue(5000 + i), 1e-6));
+    }
+
+    const std::string missing = TestSupport::tempPath("missing_stream");
+    REQUIRE(streamer.open(0, &missing, 0));
+    for (int attempt = 0; attempt < 2000 && streamer.getErrorCount() == 0; ++attempt) {
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    REQUIRE(streamer.getErrorCount() == 1);
+    streamer.stop();
+    std::remove(path.c_str());
+}
@@ -0,0 +1,262 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../dsp/signalgenerator.h"
+#include "../dsp/fft.h"
+#include "../common/audioerror.h"
+#include "testsupport.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace AudioEngine;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+constexpr double kRate = 48000.0;
+
+double rms(const std::vector<float>& samples) {
+    double sum = 0.0;
+    for (float x : samples) {
+        sum += static_cast<double>(x) * x;
+    }
+    return std::sqrt(sum / static_cast<double>(samples.size()));
+}
+
+// Hann-windowed power spectrum averaged over consecutive 4096-sample frames
+std::vector<double> powerSpectrum(const std::vector<float>& samples) {
+    const size_t n = 4096;
+    auto fft = Fft::get(n);
+    std::vector<float> frame(n), re(n / 2 + 1), im(n / 2 + 1);
+    std::vector<double> power(n / 2 + 1, 0.0);
+    for (size_t start = 0; start + n <= samples.size(); start += n) {
+        for (size_t i = 0; i < n; ++i) {
+            frame[i] = samples[start + i] * static_cast<float>(0.5 - 0.5 * std::cos(2.0 * M_PI * i / n));
+        }
+        fft->forwardReal(frame.data(), re.data(), im.data());
+        for (size_t k = 0; k < power.size(); ++k) {
+            power[k] += static_cast<double>(re[k]) * re[k] + static_cast<double>(im[k]) * im[k];
+        }
+    }
+    return power;
+}
+
+double bandPower(const std::vector<double>& power, double lowHz, double highHz) {
+    const double binHz = kRate / 4096.0;
+    double sum = 0.0;
+    for (size_t k = static_cast<size_t>(lowHz / binHz); k < static_cast<size_t>(highHz / binHz); ++k) {
+        sum += power[k];
+    }
+    return sum;
+}
+
+// Share of the power more than a few bins away from any harmonic of hz
+double inharmonicShare(const std::vector<float>& samples, double hz) {
+    const std::vector<double> power = powerSpectrum(samples);
+    const double binHz = kRate / 4096.0;
+    double total = 0.0, stray = 0.0;
+    for (size_t k = 1; k < power.size(); ++k) {
+        const double f = k * binHz;
+        const double nearest = std::round(f / hz) * hz;
+        total += power[k];
+        if (std::abs(f - nearest) > 4.0 * binHz) {
+            stray += power[k];
+        }
+    }
+    return stray / total;
+}
+
+}
+
+TEST_CASE("SineOscillator tracks the exact sine across blocks", "[SignalGenerator]") {
+    SineOscillator sine(kRate, 997.0);
+    std::vector<float> out(100000);
+    size_t pos = 0;
+    for (size_t block : {1, 3, 4, 7, 64, 1023, 1024, 1025, 4096}) {
+        for (int repeat = 0; repeat < 8 && pos < out.size(); ++repeat) {
+            const size_t n = std::min(block, out.size() - pos);
+            sine.generate(out.data() + pos, n, 0.5f);
+            pos += n;
+        }
+    }
+    sine.generate(out.data() + pos, out.size() - pos, 0.5f);
+
+    double worst = 0.0;
+    for (size_t i = 0; i < out.size(); ++i) {
+        const double exact = 0.5 * std::sin(2.0 * M_PI * 997.0 * static_cast<double>(i) / kRate);
+        worst = std::max(worst, std::abs(out[i] - exact));
+    }
+    REQUIRE(worst < 2e-5);
+}
+
+TEST_CASE("BlepOscillator aliases far less than a naive waveform", "[SignalGenerator]") {
+    const double hz = 4567.0;
+    const size_t frames = 65536;
+
+    std::vector<float> naive(frames);
+    double phase = 0.0;
+    for (size_t i = 0; i < frames; ++i) {
+        phase += hz / kRate;
+        phase -= std::floor(phase);
+        naive[i] = static_cast<float>(2.0 * phase - 1.0);
+    }
+
+    BlepOscillator saw(BlepOscillator::Shape::Saw, kRate, hz);
+    std::vector<float> blep(frames);
+    for (size_t pos = 0; pos < frames; pos += 509) {
+        saw.generate(blep.data() + pos, std::min<size_t>(509, frames - pos));
+    }
+
+    const double naiveStray = inharmonicShare(naive, hz);
+    const double blepStray = inharmonicShare(blep, hz);
+    INFO("naive " << 10.0 * std::log10(naiveStray) << " dB, polyBLEP " << 10.0 * std::log10(blepStray) << " dB");
+    REQUIRE(blepStray < naiveStray * 0.1);
+
+    BlepOscillator square(BlepOscillator::Shape::Square, kRate, hz);
+    std::vector<float> squareOut(frames);
+    square.generate(squareOut.data(), frames);
+    REQUIRE(inharmonicShare(squareOut, hz) < naiveStray * 0.1);
+    REQUIRE_THAT(rms(squareOut), WithinAbs(1.0, 0.1));
+}
+
+TEST_CASE("NoiseGenerator white is flat and pink falls 3 dB per octave", "[SignalGenerator]") {
+    NoiseGenerator noise(7);
+    std::vector<float> white(1 << 20);
+    noise.white(white.data(), white.size());
+    REQUIRE(std::all_of(white.begin(), white.end(), [](float x) { return x >= -1.0f && x <= 1.0f; }));
+    REQUIRE_THAT(rms(white), WithinAbs(1.0 / std::sqrt(3.0), 0.005));
+
+    const std::vector<double> whitePower = powerSpectrum(white);
+    const double whiteRatio = bandPower(whitePower, 6400.0, 12800.0) / bandPower(whitePower, 400.0, 800.0);
+    REQUIRE_THAT(whiteRatio, WithinAbs(16.0, 1.5));
+
+    std::vector<float> pink(1 << 20);
+    noise.pink(pink.data(), pink.size());
+    REQUIRE_THAT(rms(pink), WithinAbs(rms(white), 0.1));
+    const std::vector<double> pinkPower = powerSpectrum(pink);
+    const double pinkRatio = bandPower(pinkPower, 6400.0, 12800.0) / bandPower(pinkPower, 400.0, 800.0);
+    REQUIRE_THAT(10.0 * std::log10(pinkRatio), WithinAbs(0.0, 1.0));
+
+    // Same seed, same sequence, at any block size
+    NoiseGenerator a(3), b(3);
+    std::vector<float> x(1000), y(1000);
+    a.white(x.data(), x.size());
+    b.white(y.data(), 500);
+    b.white(y.data() + 500, 500);
+    REQUIRE(x == y);
+}
+
+TEST_CASE("LogSweep rises from the start to the end frequency", "[SignalGenerator]") {
+    LogSweep sweep(kRate, 100.0, 10000.0, 2.0);
+    REQUIRE(sweep.length() == 96000);
+    std::vector<float> out(sweep.length() + 100);
+    sweep.generate(out.data(), out.size());
+
+    auto frequencyAround = [&](size_t center) {
+        const size_t span = 2400;
+        size_t first = 0, last = 0;
+        int crossings = 0;
+        for (size_t i = center - span / 2 + 1; i < center + span / 2; ++i) {
+            if (out[i - 1] < 0.0f && out[i] >= 0.0f) {
+                first = crossings == 0 ? i : first;
+                last = i;
+                ++crossings;
+            }
+        }
+        return (crossings - 1) * kRate / static_cast<double>(last - first);
+    };
+    // Halfway through a log sweep is the geometric mean
+    REQUIRE_THAT(frequencyAround(48000), WithinAbs(1000.0, 20.0));
+    REQUIRE_THAT(frequencyAround(96000 - 1200), WithinAbs(10000.0 * std::pow(100.0, -0.0125), 200.0));
+    REQUIRE(std::all_of(out.begin() + 96000, out.end(), [](float x) { return x == 0.0f; }));
+
+    REQUIRE_THROWS_AS(LogSweep(kRate, 1000.0, 100.0, 1.0), AudioException);
+}
+
+TEST_CASE("Mls is a maximum length sequence", "[SignalGenerator]") {
+    for (int order = 2; order <= 20; ++order) {
+        INFO("order " << order);
+        Mls mls(order);
+        const size_t length = mls.length();
+        std::vector<float> out(2 * length);
+        mls.generate(out.data(), out.size());
+
+        // Balanced, and periodic with exactly length()
+        const auto ones = std::count(out.begin(), out.begin() + static_cast<ptrdiff_t>(length), 1.0f);
+        REQUIRE(static_cast<size_t>(ones) == (length + 1) / 2);
+        REQUIRE(std::equal(out.begin(), out.begin() + static_cast<ptrdiff_t>(length),
+                           out.begin() + static_cast<ptrdiff_t>(length)));
+    }
+    REQUIRE_THROWS_AS(Mls(1), AudioException);
+    REQUIRE_THROWS_AS(Mls(25), AudioException);
+
+    // Circular autocorrelation is -1 off the peak
+    Mls mls(10);
+    std::vector<float> seq(mls.length());
+    mls.generate(seq.data(), seq.size());
+    for (size_t lag : {1, 2, 100, 511, 1022}) {
+        double sum = 0.0;
+        for (size_t i = 0; i < seq.size(); ++i) {
+            sum += seq[i] * seq[(i + lag) % seq.size()];
+        }
+        REQUIRE(sum == -1.0);
+    }
+}
+
+TEST_CASE("Mls finds a delay through noise", "[SignalGenerator]") {
+    Mls mls(12);
+    std::vector<float> reference(mls.length());
+    mls.generate(reference.data(), reference.size(), 0.5f);
+
+    const size_t delay = 1234;
+    std::vector<float> recorded(reference.size() + 3000);
+    NoiseGenerator noise(11);
+    noise.white(recorded.data(), recorded.size(), 0.5f);
+    for (size_t i = 0; i < reference.size(); ++i) {
+        recorded[delay + i] += 0.3f * reference[i];
+    }
+
+    REQUIRE(Mls::findDelay(reference.data(), reference.size(), recorded.data(), recorded.size()) == 1234);
+    REQUIRE(Mls::findDelay(reference.data(), reference.size(), recorded.data(), 100) == -1);
+}
+
+TEST_CASE("ToneGenerator writes the same signal to every channel", "[SignalGenerator]") {
+    ToneGenerator tone(kRate);
+    tone.setFrequency(1000.0);
+    tone.setGain(0.25f);
+    std::vector<float> interleaved(3 * 700);
+    tone.generateInterleaved(interleaved.data(), 3, 700);
+    for (size_t i = 0; i < 700; ++i) {
+        REQUIRE(interleaved[3 * i] == interleaved[3 * i + 1]);
+        REQUIRE(interleaved[3 * i] == interleaved[3 * i + 2]);
+        REQUIRE_THAT(interleaved[3 * i], WithinAbs(0.25 * std::sin(2.0 * M_PI * 1000.0 * i / kRate), 1e-5));
+    }
+
+    for (auto waveform : {ToneGenerator::Waveform::Saw, ToneGenerator::Waveform::Square,
+                          ToneGenerator::Waveform::WhiteNoise, ToneGenerator::Waveform::PinkNoise}) {
+        tone.setWaveform(waveform);
+        std::vector<float> left(512), right(512);
+        float* channels[] = {left.data(), right.data()};
+        tone.generate(channels, 2, 512);
+        REQUIRE(left == right);
+        REQUIRE(rms(left) > 0.01);
+        REQUIRE(rms(left) < 0.5);
+    }
+}
+
+TEST_CASE("SineOscillator outpaces per-sample sin()", "[SignalGenerator][.benchmark]") {
+    const size_t frames = 512;
+    std::vector<float> out(frames);
+
+    double phase = 0.0;
+    const double libm = TestSupport::bestOf(50, [&] {
+        for (size_t i = 0; i < frames; ++i) {
+            out[i] = static_cast<float>(0.5 * std::sin(phase));
+            phase += 2.0 * M_PI * 440.0 / kRate;
+        }
+    });
+    SineOscillator sine(kRate, 440.0);
+    const double recursive = TestSupport::bestOf(50, [&] { sine.generate(out.data(), frames, 0.5f); });
+    INFO("sin() " << libm * 1e6 << " us, recursive " << recursive * 1e6 << " us per period");
+    REQUIRE(recursive < libm);
+}
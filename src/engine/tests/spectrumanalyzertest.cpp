@@ -0,0 +1,98 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../dsp/spectrumanalyzer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace AudioEngine;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+std::vector<float> sine(double hz, float amplitude, size_t frames, double sampleRate) {
+    std::vector<float> samples(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        samples[i] = amplitude * static_cast<float>(std::sin(2.0 * M_PI * hz * i / sampleRate));
+    }
+    return samples;
+}
+
+int loudestBand(const std::vector<float>& bandsDb) {
+    return static_cast<int>(std::max_element(bandsDb.begin(), bandsDb.end()) - bandsDb.begin());
+}
+
+}
+
+TEST_CASE("SpectrumAnalyzer bins a tone into its log band", "[Spectrum]") {
+    const double rate = 48000.0;
+    SpectrumAnalyzer analyzer(rate);
+    std::vector<float> bands(static_cast<size_t>(analyzer.bandCount()));
+
+    for (double hz : {100.0, 1000.0, 10000.0}) {
+        INFO(hz << " Hz");
+        const std::vector<float> tone = sine(hz, 0.5f, analyzer.options().fftSize, rate);
+        analyzer.analyze(tone.data(), bands.data());
+
+        // At 100 Hz a band is narrower than the window's main lobe
+        const int band = loudestBand(bands);
+        const double toleranceOctaves = hz < 200.0 ? 0.25 : 0.1;
+        REQUIRE(std::abs(std::log2(analyzer.bandCenterHz(band) / hz)) < toleranceOctaves);
+        REQUIRE_THAT(bands[static_cast<size_t>(band)], WithinAbs(20.0 * std::log10(0.5), 1.5));
+    }
+
+    // Silence sits at the floor
+    std::vector<float> silence(analyzer.options().fftSize, 0.0f);
+    analyzer.analyze(silence.data(), bands.data());
+    REQUIRE(*std::max_element(bands.begin(), bands.end()) == SpectrumAnalyzer::kFloorDb);
+}
+
+TEST_CASE("SpectrumAnalyzer analyzes on its own thread and publishes bands", "[Spectrum]") {
+    const double rate = 48000.0;
+    SpectrumAnalyzer::Options options;
+    options.updateHz = 100.0;
+    SpectrumAnalyzer analyzer(rate, options);
+    analyzer.start();
+
+    // Interleaved stereo from a fake callback, 256 frames at a time
+    const size_t period = 256;
+    const std::vector<float> tone = sine(2000.0, 0.25f, period * 64, rate);
+    std::vector<float> stereo(period * 2);
+    uint64_t lastSequence = 0;
+    for (size_t p = 0; p < 64; ++p) {
+        for (size_t i = 0; i < period; ++i) {
+            stereo[2 * i] = stereo[2 * i + 1] = tone[p * period + i];
+        }
+        analyzer.pushInterleaved(stereo.data(), period, 2);
+        std::this_thread::sleep_for(std::chrono::microseconds(period * 1000000 / 48000));
+        if (analyzer.update()) {
+            REQUIRE(analyzer.frame().sequence > lastSequence);
+            lastSequence = analyzer.frame().sequence;
+        }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    analyzer.update();
+    analyzer.stop();
+
+    REQUIRE(analyzer.frame().sequence > 0);
+    REQUIRE(analyzer.getDroppedFrames() == 0);
+    const std::vector<float>& bands = analyzer.frame().bandsDb;
+    REQUIRE(bands.size() == static_cast<size_t>(analyzer.bandCount()));
+    REQUIRE(std::abs(std::log2(analyzer.bandCenterHz(loudestBand(bands)) / 2000.0)) < 0.1);
+}
+
+TEST_CASE("SpectrumAnalyzer drops audio instead of blocking when the ring is full", "[Spectrum]") {
+    SpectrumAnalyzer::Options options;
+    options.ringFrames = 1024;
+    SpectrumAnalyzer analyzer(48000.0, options);  // Not started: nothing drains
+
+    std::vector<float> block(512, 0.0f);
+    for (int i = 0; i < 8; ++i) {
+        analyzer.push(block.data(), block.size());
+    }
+    REQUIRE(analyzer.getDroppedFrames() > 0);
+    REQUIRE(analyzer.getDroppedFrames() < 8 * block.size());
+    REQUIRE_FALSE(analyzer.update());
+}
@@ -0,0 +1,188 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include "../instruments/synth.h"
+#include "../common/audioerror.h"
+#include "../backends/file/filebackend.h"
+#include "../io/wavfile.h"
+#include "testsupport.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace AudioEngine;
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+constexpr double kRate = 48000.0;
+
+std::vector<float> render(Synth& synth, size_t frames, size_t block, bool simd = true) {
+    std::vector<float> out(frames), right(block);
+    for (size_t pos = 0; pos < frames; pos += block) {
+        const size_t n = std::min(block, frames - pos);
+        if (simd) {
+            synth.process(out.data() + pos, right.data(), n);
+        } else {
+            synth.processScalar(out.data() + pos, right.data(), n);
+        }
+    }
+    return out;
+}
+
+}
+
+TEST_CASE("Synth starts notes on their exact frame", "[Synth]") {
+    Synth synth(kRate, 8);
+    synth.noteOn(60, 100, 100);
+    std::vector<float> left(256), right(256);
+    synth.process(left.data(), right.data(), left.size());
+
+    for (size_t i = 0; i < 100; ++i) {
+        REQUIRE(left[i] == 0.0f);
+    }
+    REQUIRE(left[100] != 0.0f);
+    REQUIRE(left == right);
+
+    // An offset past the block lands in the next one
+    Synth late(kRate, 8);
+    late.noteOn(60, 100, 300);
+    late.process(left.data(), right.data(), left.size());
+    REQUIRE(std::all_of(left.begin(), left.end(), [](float x) { return x == 0.0f; }));
+    late.process(left.data(), right.data(), left.size());
+    REQUIRE(left[43] == 0.0f);
+    REQUIRE(left[44] != 0.0f);
+}
+
+TEST_CASE("Synth plays the note's pitch", "[Synth]") {
+    Synth synth(kRate, 4);
+    Synth::Parameters parameters;
+    parameters.cutoffHz = 400.0;
+    parameters.envelopeOctaves = 0.0;    // Keep mostly the fundamental
+    synth.setParameters(parameters);
+    synth.noteOn(57, 127);               // A3, 220 Hz
+
+    const std::vector<float> out = render(synth, 48000, 512);
+    size_t first = 0, last = 0;
+    int crossings = 0;
+    for (size_t i = 4801; i < out.size(); ++i) {
+        if (out[i - 1] < 0.0f && out[i] >= 0.0f) {
+            first = crossings == 0 ? i : first;
+            last = i;
+            ++crossings;
+        }
+    }
+    const double hz = (crossings - 1) * kRate / static_cast<double>(last - first);
+    REQUIRE_THAT(hz, WithinAbs(220.0, 0.5));
+}
+
+TEST_CASE("Synth SIMD and scalar paths agree", "[Synth]") {
+    auto play = [](bool simd) {
+        Synth synth(kRate, 16);
+        for (int i = 0; i < 10; ++i) {
+            synth.noteOn(48 + 3 * i, 40 + 8 * i, static_cast<size_t>(37 * i));
+        }
+        synth.noteOff(51, 700);
+        return render(synth, 4096, 300, simd);
+    };
+    const std::vector<float> simd = play(true);
+    const std::vector<float> scalar = play(false);
+    for (size_t i = 0; i < simd.size(); ++i) {
+        INFO("frame " << i);
+        REQUIRE_THAT(simd[i], WithinAbs(scalar[i], 1e-4));
+    }
+}
+
+TEST_CASE("Synth voices release, then steal when the pool is full", "[Synth]") {
+    Synth synth(kRate, 3);
+    REQUIRE(synth.voiceCount() == 4);
+    REQUIRE_THROWS_AS(Synth(kRate, 0), AudioException);
+
+    std::vector<float> left(512), right(512);
+    for (int note = 60; note < 64; ++note) {
+        synth.noteOn(note, 100);
+    }
+    synth.process(left.data(), right.data(), left.size());
+    REQUIRE(synth.getActiveVoiceCount() == 4);
+    REQUIRE(synth.getStealCount() == 0);
+
+    synth.noteOn(70, 100);
+    synth.process(left.data(), right.data(), left.size());
+    REQUIRE(synth.getStealCount() == 1);
+    REQUIRE(synth.getActiveVoiceCount() == 4);
+
+    synth.allNotesOff();
+    for (int i = 0; i < 60; ++i) {
+        synth.process(left.data(), right.data(), left.size());
+    }
+    REQUIRE(synth.getActiveVoiceCount() == 0);
+    synth.process(left.data(), right.data(), left.size());
+    REQUIRE(std::all_of(left.begin(), left.end(), [](float x) { return x == 0.0f; }));
+}
+
+TEST_CASE("Synth drives a file backend render", "[Synth]") {
+    const std::string path = TestSupport::tempPath("synth_render");
+    StreamConfig config;
+    config.outputDeviceName = path;
+    config.sampleRate = 48000;
+    config.bufferSize = 512;
+    config.inputChannels = 0;
+    config.outputChannels = 2;
+    config.realtimePriority = 0;
+    config.lockMemory = false;
+
+    // 64 voices held through a one second render, as the backend benchmark workload
+    Synth synth(kRate, 64);
+    for (int i = 0; i < 64; ++i) {
+        synth.noteOn(36 + i, 100);
+    }
+    FileBackend backend;
+    backend.initialize(config);
+    backend.setClock(FileClock::FreeRunning);
+    backend.setRenderLength(48000);
+    backend.startPlanar([&](const float* const*, float* const* outputs, size_t frames, double) {
+        synth.process(outputs[0], outputs[1], frames);
+    });
+    REQUIRE(backend.waitUntilFinished(10000));
+    backend.stop();
+    const EngineSnapshot& snapshot = backend.readSnapshot();
+    INFO("peak DSP load " << snapshot.peakDspLoad << "%");
+    REQUIRE(snapshot.framePosition >= 48000);
+
+    WavReader reader;
+    reader.open(path);
+    REQUIRE(reader.frameCount() == 48000);
+    std::vector<float> left(48000), right(48000);
+    float* channels[] = {left.data(), right.data()};
+    reader.read(channels, 2, left.size());
+    double energy = 0.0;
+    for (size_t i = 0; i < left.size(); ++i) {
+        REQUIRE(std::isfinite(left[i]));
+        energy += left[i] * left[i];
+    }
+    REQUIRE(energy / left.size() > 1e-4);
+    REQUIRE(left == right);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Synth renders 64 voices in a fraction of the period", "[Synth][.benchmark]") {
+    const size_t frames = 512;
+    const double periodSeconds = frames / kRate;
+    std::vector<float> left(frames), right(frames);
+
+    Synth scalarSynth(kRate, 64), simdSynth(kRate, 64);
+    for (int i = 0; i < 64; ++i) {
+        scalarSynth.noteOn(36 + i, 100);
+        simdSynth.noteOn(36 + i, 100);
+    }
+    const double scalar = TestSupport::bestOf(20, [&] {
+        scalarSynth.processScalar(left.data(), right.data(), frames);
+    });
+    const double simd = TestSupport::bestOf(20, [&] {
+        simdSynth.process(left.data(), right.data(), frames);
+    });
+    INFO("scalar " << scalar * 1e6 << " us, SIMD " << simd * 1e6 << " us per period");
+
+    REQUIRE(simd < periodSeconds * 0.25);
+    REQUIRE(simd <= scalar);
+}
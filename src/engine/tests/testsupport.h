@@ -0,0 +1,62 @@
+#ifndef TESTSUPPORT_H
+#define TESTSUPPORT_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+
+namespace AudioEngine {
+namespace TestSupport {
+
+// Suffix no other test process shares: random per process, counted within it
+inline std::string uniqueSuffix() {
+    static const unsigned long long process = std::random_device{}() ^
+        static_cast<unsigned long long>(std::chrono::steady_clock::now().time_since_epoch().count());
+    static std::atomic<unsigned> counter{0};
+    return std::to_string(process) + "_" + std::to_string(counter++);
+}
+
+// Fresh path in the system temp directory, e.g. cadence_<name>_<suffix>.wav.
+// Parallel ctest runs each get their own files.
+inline std::string tempPath(const std::string& name, const std::string& extension = ".wav") {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() /
+                                       ("cadence_" + name + "_" + uniqueSuffix() + extension);
+    return path.string();
+}
+
+// Fastest of several timed runs of run(), in seconds. prepare() runs untimed
+// before each one. Timings go in [.benchmark] tests, hidden from the default run.
+template <typename Run, typename Prepare>
+double bestOf(int runs, Run&& run, Prepare&& prepare) {
+    double best = std::numeric_limits<double>::max();
+    for (int r = 0; r < runs; ++r) {
+        prepare();
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    return best;
+}
+
+template <typename Run>
+double bestOf(int runs, Run&& run) {
+    return bestOf(runs, std::forward<Run>(run), [] {});
+}
+
+// Fresh, empty directory in the system temp directory; remove_all it when done
+inline std::string tempDirectory(const std::string& name) {
+    const std::string path = tempPath(name, "");
+    std::filesystem::create_directories(path);
+    return path;
+}
+
+} // namespace TestSupport
+} // namespace AudioEngine
+
+#endif // TESTSUPPORT_H
@@ -0,0 +1,182 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../dsp/timestretcher.h"
+#include "../io/stretchcache.h"
+#include "../io/wavfile.h"
+#include "testsupport.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace AudioEngine;
+
+namespace {
+
+constexpr double kRate = 48000.0;
+
+// Feed mono input in callback-sized blocks until `frames` of output exist
+std::vector<float> stretch(TimeStretcher& stretcher, const std::vector<float>& input, size_t frames) {
+    std::vector<float> output;
+    std::vector<float> block(512);
+    size_t fed = 0;
+    while (output.size() < frames) {
+        while (stretcher.available() < block.size()) {
+            const size_t need = std::min(stretcher.getSamplesRequired(), block.size());
+            std::vector<float> chunk(need, 0.0f);
+            for (size_t i = 0; i < need && fed + i < input.size(); ++i) {
+                chunk[i] = input[fed + i];
+            }
+            fed += need;
+            const float* channels[] = {chunk.data()};
+            REQUIRE(stretcher.process(channels, need) == need);
+        }
+        float* channels[] = {block.data()};
+        const size_t n = stretcher.retrieve(channels, block.size());
+        output.insert(output.end(), block.begin(), block.begin() + static_cast<ptrdiff_t>(n));
+    }
+    output.resize(frames);
+    return output;
+}
+
+std::vector<float> sine(double hz, size_t frames) {
+    std::vector<float> samples(frames);
+    for (size_t i = 0; i < frames; ++i) {
+        samples[i] = 0.5f * static_cast<float>(std::sin(2.0 * M_PI * hz * i / kRate));
+    }
+    return samples;
+}
+
+// Frequency from rising zero crossings over a window
+double measureFrequency(const std::vector<float>& samples, size_t begin, size_t end) {
+    size_t first = 0, last = 0;
+    int crossings = 0;
+    for (size_t i = begin + 1; i < end; ++i) {
+        if (samples[i - 1] < 0.0f && samples[i] >= 0.0f) {
+            if (crossings == 0) {
+                first = i;
+            }
+            last = i;
+            ++crossings;
+        }
+    }
+    return crossings > 1 ? (crossings - 1) * kRate / static_cast<double>(last - first) : 0.0;
+}
+
+double rms(const std::vector<float>& samples, size_t begin, size_t end) {
+    double sum = 0.0;
+    for (size_t i = begin; i < end; ++i) {
+        sum += static_cast<double>(samples[i]) * samples[i];
+    }
+    return std::sqrt(sum / static_cast<double>(end - begin));
+}
+
+}
+
+TEST_CASE("TimeStretcher changes duration but keeps pitch", "[TimeStretch]") {
+    for (auto quality : {TimeStretcher::Quality::Playback, TimeStretcher::Quality::HighQuality}) {
+        INFO("quality " << static_cast<int>(quality));
+        TimeStretcher stretcher(1, kRate, quality);
+
+        for (double ratio : {0.5, 1.5}) {
+            INFO("ratio " << ratio);
+            stretcher.reset();
+            stretcher.setTimeRatio(ratio);
+            const std::vector<float> output = stretch(stretcher, sine(440.0, 96000), 96000);
+
+            REQUIRE(std::abs(measureFrequency(output, 10000, 40000) - 440.0) < 2.0);
+            REQUIRE(std::abs(rms(output, 10000, 40000) - 0.5 / std::sqrt(2.0)) < 0.05);
+        }
+    }
+}
+
+TEST_CASE("TimeStretcher shifts pitch without changing duration", "[TimeStretch]") {
+    for (auto quality : {TimeStretcher::Quality::Playback, TimeStretcher::Quality::HighQuality}) {
+        INFO("quality " << static_cast<int>(quality));
+        TimeStretcher stretcher(1, kRate, quality);
+        stretcher.setPitchRatio(1.5);
+        const std::vector<float> output = stretch(stretcher, sine(440.0, 96000), 48000);
+        REQUIRE(std::abs(measureFrequency(output, 10000, 40000) - 660.0) < 3.0);
+    }
+}
+
+TEST_CASE("TimeStretcher output stays aligned with its input", "[TimeStretch]") {
+    // A click at 0.25 s lands at ratio * 0.25 s, with no added latency
+    std::vector<float> input(48000, 0.0f);
+    for (size_t i = 12000; i < 12048; ++i) {
+        input[i] = 1.0f - static_cast<float>(i - 12000) / 48.0f;
+    }
+
+    for (auto quality : {TimeStretcher::Quality::Playback, TimeStretcher::Quality::HighQuality}) {
+        INFO("quality " << static_cast<int>(quality));
+        TimeStretcher stretcher(1, kRate, quality);
+        stretcher.setTimeRatio(2.0);
+        const std::vector<float> output = stretch(stretcher, input, 48000);
+
+        size_t peak = 0;
+        for (size_t i = 0; i < output.size(); ++i) {
+            if (std::abs(output[i]) > std::abs(output[peak])) {
+                peak = i;
+            }
+        }
+        INFO("peak at " << peak);
+        REQUIRE(std::abs(static_cast<double>(peak) - 24000.0) < 0.005 * kRate);
+        REQUIRE(std::abs(output[peak]) > 0.3f);
+    }
+}
+
+TEST_CASE("TimeStretcher reports input it cannot take", "[TimeStretch]") {
+    // Nothing is retrieved, so the output fills and then the input buffer
+    const std::vector<float> input = sine(440.0, 8 * TimeStretcher::kMaxBlockFrames);
+    TimeStretcher stretcher(1, kRate, TimeStretcher::Quality::Playback);
+    size_t fed = 0;
+    size_t taken = 0;
+    do {
+        const float* channels[] = {input.data() + fed};
+        taken = stretcher.process(channels, input.size() - fed);
+        REQUIRE((fed > 0 || taken >= TimeStretcher::kMaxBlockFrames));
+        fed += taken;
+    } while (taken > 0 && fed < input.size());
+    REQUIRE(taken == 0);
+    REQUIRE(fed < input.size());
+
+    // Draining the output lets it take more
+    std::vector<float> out(TimeStretcher::kMaxBlockFrames);
+    float* outputs[] = {out.data()};
+    while (stretcher.retrieve(outputs, out.size()) > 0) {
+    }
+    const float* rest[] = {input.data() + fed};
+    REQUIRE(stretcher.process(rest, input.size() - fed) > 0);
+}
+
+TEST_CASE("StretchCache renders clips in the background", "[TimeStretch]") {
+    const std::string directory = TestSupport::tempDirectory("stretch");
+    const std::string source = directory + "/source.wav";
+    {
+        WavWriter writer;
+        writer.open(source, WavFormat{48000, 2, SampleFormat::Float32});
+        const std::vector<float> tone = sine(440.0, 24000);
+        const float* channels[] = {tone.data(), tone.data()};
+        writer.write(channels, tone.size());
+    }
+
+    StretchCache cache(directory);
+    REQUIRE(cache.lookup(source, 1.5, 1.0).empty());
+
+    cache.request(source, 1.5, 1.0);
+    cache.request(source, 1.5, 1.0);  // Deduplicated
+    cache.request(directory + "/missing.wav", 2.0, 1.0);
+    cache.waitIdle();
+
+    const std::string rendered = cache.lookup(source, 1.5, 1.0);
+    REQUIRE(rendered == cache.cachePath(source, 1.5, 1.0));
+    REQUIRE(cache.getFailedCount() == 1);
+
+    WavReader reader;
+    reader.open(rendered);
+    REQUIRE(reader.format().channels == 2);
+    REQUIRE(reader.frameCount() == 36000);
+    reader.close();
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,62 @@
+#include <catch2/catch_test_macros.hpp>
+#include "../realtime/triplebuffer.h"
+#include "../common/enginesnapshot.h"
+#include <atomic>
+#include <thread>
+
+using namespace AudioEngine;
+
+TEST_CASE("TripleBuffer publishes latest value", "[TripleBuffer]") {
+    TripleBuffer<EngineSnapshot> buffer;
+
+    REQUIRE_FALSE(buffer.update());
+    REQUIRE(buffer.readBuffer().sequence == 0);
+
+    for (uint64_t i = 1; i <= 3; ++i) {
+        buffer.writeBuffer().sequence = i;
+        buffer.publish();
+    }
+
+    // Intermediate values are skipped, the newest wins
+    REQUIRE(buffer.update());
+    REQUIRE(buffer.readBuffer().sequence == 3);
+    REQUIRE_FALSE(buffer.update());
+    REQUIRE(buffer.read().sequence == 3);
+}
+
+TEST_CASE("TripleBuffer never tears", "[TripleBuffer]") {
+    TripleBuffer<EngineSnapshot> buffer;
+    std::atomic<bool> running{true};
+
+    // Writer publishes snapshots whose fields are all derived from one counter
+    std::thread writer([&] {
+        for (uint64_t period = 1; period <= 200000; ++period) {
+            EngineSnapshot& snapshot = buffer.writeBuffer();
+            snapshot.sequence = period;
+            snapshot.framePosition = period * 64;
+            snapshot.streamTime = period * 64 / 48000.0;
+            snapshot.xruns = static_cast<int>(period % 1000);
+            buffer.publish();
+        }
+        running = false;
+    });
+
+    uint64_t lastSequence = 0;
+    int reads = 0;
+    int torn = 0;
+    while (running || buffer.update()) {
+        const EngineSnapshot& snapshot = buffer.read();
+        if (snapshot.framePosition != snapshot.sequence * 64 ||
+            snapshot.xruns != static_cast<int>(snapshot.sequence % 1000) ||
+            snapshot.sequence < lastSequence) {
+            torn++;
+        }
+        lastSequence = snapshot.sequence;
+        reads++;
+    }
+
+    writer.join();
+    REQUIRE(torn == 0);
+    REQUIRE(reads > 0);
+    REQUIRE(buffer.read().sequence == 200000);
+}
@@ -0,0 +1,117 @@
+#include "meterwidget.h"
+
+#include <QMouseEvent>
+#include <QPainter>
+#include <algorithm>
+#include <cmath>
+
+MeterWidget::MeterWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setMinimumSize(40, 120);
+    m_clock.start();
+}
+
+float MeterWidget::toDb(float linear)
+{
+    if (linear <= 0.0f) {
+        return kFloorDb;
+    }
+    return std::max(kFloorDb, 20.0f * std::log10(linear));
+}
+
+float MeterWidget::dbToFraction(float db) const
+{
+    return std::clamp((db - kFloorDb) / -kFloorDb, 0.0f, 1.0f);
+}
+
+void MeterWidget::updateFromSnapshot(const AudioEngine::EngineSnapshot &snapshot)
+{
+    if (static_cast<int>(m_channels.size()) != snapshot.meterCount) {
+        m_channels.assign(static_cast<size_t>(snapshot.meterCount), ChannelState{});
+    }
+
+    const qint64 nowMs = m_clock.elapsed();
+    const float dt = std::max(0.0f, (nowMs - m_lastUpdateMs) / 1000.0f);
+    m_lastUpdateMs = nowMs;
+
+    const float rmsCoeff = 1.0f - std::exp(-dt / kRmsTimeConstantSeconds);
+
+    for (int i = 0; i < snapshot.meterCount; ++i) {
+        const AudioEngine::MeterReading &reading = snapshot.meters[i];
+        ChannelState &state = m_channels[static_cast<size_t>(i)];
+
+        // Peak: instant attack, linear release in dB
+        const float peakDb = toDb(reading.peak);
+        state.peakDb = std::max(peakDb, state.peakDb - kReleaseDbPerSecond * dt);
+
+        // Hold marker
+        if (peakDb >= state.holdDb || nowMs > state.holdUntilMs) {
+            state.holdDb = peakDb;
+            state.holdUntilMs = nowMs + kPeakHoldMs;
+        }
+
+        // RMS: exponential integration
+        state.rmsDb += (toDb(reading.rms) - state.rmsDb) * rmsCoeff;
+
+        // Clip stays lit until clicked
+        if (reading.clipCount != state.lastClipCount) {
+            state.clipLit = true;
+            state.lastClipCount = reading.clipCount;
+        }
+    }
+
+    update();
+}
+
+void MeterWidget::resetClipIndicators()
+{
+    for (ChannelState &state : m_channels) {
+        state.clipLit = false;
+    }
+    update();
+}
+
+void MeterWidget::mousePressEvent(QMouseEvent *event)
+{
+    resetClipIndicators();
+    QWidget::mousePressEvent(event);
+}
+
+void MeterWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(24, 24, 24));
+
+    if (m_channels.empty()) {
+        return;
+    }
+
+    const int clipHeight = 6;
+    const int meterHeight = height() - clipHeight - 2;
+    const qreal channelWidth = static_cast<qreal>(width()) / m_channels.size();
+
+    for (size_t i = 0; i < m_channels.size(); ++i) {
+        const ChannelState &state = m_channels[i];
+        const qreal x = i * channelWidth + 1;
+        const qreal w = std::max<qreal>(1.0, channelWidth - 2);
+
+        // Clip indicator
+        painter.fillRect(QRectF(x, 0, w, clipHeight),
+                         state.clipLit ? QColor(220, 40, 40) : QColor(60, 20, 20));
+
+        // RMS body
+        const qreal rmsHeight = dbToFraction(state.rmsDb) * meterHeight;
+        painter.fillRect(QRectF(x, height() - rmsHeight, w, rmsHeight), QColor(40, 170, 80));
+
+        // Peak bar
+        const qreal peakY = height() - dbToFraction(state.peakDb) * meterHeight;
+        painter.fillRect(QRectF(x, peakY, w, 2), QColor(150, 230, 150));
+
+        // Hold marker
+        const qreal holdY = height() - dbToFraction(state.holdDb) * meterHeight;
+        painter.fillRect(QRectF(x, holdY, w, 1), QColor(240, 200, 80));
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef METERWIDGET_H
+#define METERWIDGET_H
+
+#include <QElapsedTimer>
+#include <QWidget>
+#include <vector>
+#include "engine/common/enginesnapshot.h"
+
+// Channel meters drawn from engine snapshots
+// The engine only delivers raw per-window peak/RMS values; ballistics (peak
+// hold, release and RMS integration) are applied here at the UI frame rate.
+class MeterWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MeterWidget(QWidget *parent = nullptr);
+
+    // Call from the UI timer with the snapshot read from the backend
+    void updateFromSnapshot(const AudioEngine::EngineSnapshot &snapshot);
+    void resetClipIndicators();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+
+private:
+    static constexpr float kFloorDb = -60.0f;
+    static constexpr float kReleaseDbPerSecond = 20.0f;
+    static constexpr float kRmsTimeConstantSeconds = 0.3f;
+    static constexpr qint64 kPeakHoldMs = 1500;
+
+    struct ChannelState {
+        float peakDb = kFloorDb;
+        float rmsDb = kFloorDb;
+        float holdDb = kFloorDb;
+        qint64 holdUntilMs = 0;
+        uint32_t lastClipCount = 0;
+        bool clipLit = false;
+    };
+
+    static float toDb(float linear);
+    float dbToFraction(float db) const;
+
+    std::vector<ChannelState> m_channels;
+    QElapsedTimer m_clock;
+    qint64 m_lastUpdateMs = 0;
+};
+
+#endif // METERWIDGET_H
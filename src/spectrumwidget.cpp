@@ -0,0 +1,94 @@
+#include "spectrumwidget.h"
+
+#include <QPainter>
+#include <QPainterPath>
+#include <algorithm>
+#include <cmath>
+
+SpectrumWidget::SpectrumWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setMinimumSize(160, 80);
+    m_clock.start();
+}
+
+float SpectrumWidget::dbToFraction(float db) const
+{
+    return std::clamp((db - kFloorDb) / -kFloorDb, 0.0f, 1.0f);
+}
+
+qreal SpectrumWidget::frequencyToX(float hz) const
+{
+    const qreal position = std::log(hz / m_minHz) / std::log(m_maxHz / m_minHz);
+    return position * width();
+}
+
+void SpectrumWidget::updateFromAnalyzer(AudioEngine::SpectrumAnalyzer &analyzer)
+{
+    const size_t bandCount = static_cast<size_t>(analyzer.bandCount());
+    if (m_centersHz.size() != bandCount) {
+        m_centersHz.resize(bandCount);
+        for (size_t i = 0; i < bandCount; ++i) {
+            m_centersHz[i] = analyzer.bandCenterHz(static_cast<int>(i));
+        }
+        m_minHz = analyzer.options().minHz;
+        m_maxHz = std::max(m_centersHz.back(), m_minHz * 2.0f);
+        m_bandsDb.assign(bandCount, kFloorDb);
+    }
+
+    const qint64 nowMs = m_clock.elapsed();
+    const float dt = std::max(0.0f, (nowMs - m_lastUpdateMs) / 1000.0f);
+    m_lastUpdateMs = nowMs;
+
+    // Instant attack, linear release in dB; keeps falling between analyses
+    const bool fresh = analyzer.update();
+    const std::vector<float> &latest = analyzer.frame().bandsDb;
+    for (size_t i = 0; i < bandCount; ++i) {
+        float &band = m_bandsDb[i];
+        band = std::max(kFloorDb, band - kReleaseDbPerSecond * dt);
+        if (fresh && i < latest.size()) {
+            band = std::max(band, latest[i]);
+        }
+    }
+
+    update();
+}
+
+void SpectrumWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(24, 24, 24));
+
+    // Decade grid lines
+    painter.setPen(QColor(50, 50, 50));
+    for (float decade = 10.0f; decade < m_maxHz; decade *= 10.0f) {
+        for (int multiple = 1; multiple < 10; ++multiple) {
+            const float hz = decade * multiple;
+            if (hz > m_minHz && hz < m_maxHz) {
+                const qreal x = frequencyToX(hz);
+                painter.drawLine(QPointF(x, 0), QPointF(x, height()));
+            }
+        }
+    }
+
+    if (m_bandsDb.empty()) {
+        return;
+    }
+
+    QPainterPath path;
+    path.moveTo(0, height());
+    for (size_t i = 0; i < m_bandsDb.size(); ++i) {
+        const qreal x = frequencyToX(m_centersHz[i]);
+        const qreal y = height() - dbToFraction(m_bandsDb[i]) * height();
+        path.lineTo(x, y);
+    }
+    path.lineTo(width(), height());
+    path.closeSubpath();
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.fillPath(path, QColor(40, 170, 80, 140));
+    painter.setPen(QColor(150, 230, 150));
+    painter.drawPath(path);
+}
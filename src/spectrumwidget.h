@@ -0,0 +1,40 @@
+#ifndef SPECTRUMWIDGET_H
+#define SPECTRUMWIDGET_H
+
+#include <QElapsedTimer>
+#include <QWidget>
+#include <vector>
+#include "engine/dsp/spectrumanalyzer.h"
+
+// Spectrum display drawn from precomputed analyzer bands
+// The analyzer thread does the windowing, FFT and log binning; this widget
+// only applies release ballistics at the UI frame rate and paints.
+class SpectrumWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SpectrumWidget(QWidget *parent = nullptr);
+
+    // Call from the UI timer; picks up the analyzer's latest bands if any
+    void updateFromAnalyzer(AudioEngine::SpectrumAnalyzer &analyzer);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    static constexpr float kFloorDb = -90.0f;
+    static constexpr float kReleaseDbPerSecond = 40.0f;
+
+    float dbToFraction(float db) const;
+    qreal frequencyToX(float hz) const;
+
+    std::vector<float> m_bandsDb;
+    std::vector<float> m_centersHz;
+    float m_minHz = 20.0f;
+    float m_maxHz = 20000.0f;
+    QElapsedTimer m_clock;
+    qint64 m_lastUpdateMs = 0;
+};
+
+#endif // SPECTRUMWIDGET_H